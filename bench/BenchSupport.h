@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "utils/AllocationTracker.h"
+#include "utils/PerfCounters.h"
+
+// Wraps a benchmark's timed loop and reports per-unit counters next to the standard columns:
+//
+//   items_per_second    units per second on the benchmark's threads
+//   time_per_<unit>     seconds per unit (shown as e.g. 912n)
+//   allocs_per_<unit>   heap allocations per unit, from AllocationTracker
+//   cycles_per_<unit>,  only where perf_event_open works (see utils/PerfCounters.h)
+//   ipc
+//
+// Allocation and hardware counts are the calling thread's, so start() and stop() belong
+// on the thread that runs the loop. AllocationTracker must be enabled for allocations. In
+// multithreaded benchmarks every thread measures itself; the per-unit counters are averaged
+// over the threads, so time_per_<unit> is the latency one thread sees, while
+// items_per_second is the total.
+class BenchMeasurement {
+public:
+    BenchMeasurement(benchmark::State& state, const char* unit) : state_(state), unit_(unit) {}
+
+    void start() {
+        allocations_ = *AllocationTracker::threadCounts();
+        perf_ = PerfCounters::read();
+    }
+
+    void stop(double units_per_iteration) {
+        const PerfSample perf = PerfCounters::read();
+        const AllocationCounts allocations = *AllocationTracker::threadCounts() - allocations_;
+        const double units = static_cast<double>(state_.iterations()) * units_per_iteration;
+        if (units <= 0) return;
+
+        state_.SetItemsProcessed(static_cast<int64_t>(units));
+        state_.counters["time_per_" + unit_] =
+            benchmark::Counter(units, benchmark::Counter::kAvgThreadsRate | benchmark::Counter::kInvert);
+        state_.counters["allocs_per_" + unit_] = perThread(allocations.allocations / units);
+        if (perf_.hardware && perf.hardware) {
+            const double cycles = delta(perf, PerfCounter::CYCLES);
+            state_.counters["cycles_per_" + unit_] = perThread(cycles / units);
+            if (cycles > 0) state_.counters["ipc"] = perThread(delta(perf, PerfCounter::INSTRUCTIONS) / cycles);
+        }
+    }
+
+private:
+    static benchmark::Counter perThread(double value) {
+        return benchmark::Counter(value, benchmark::Counter::kAvgThreads);
+    }
+
+    double delta(const PerfSample& end, PerfCounter counter) const {
+        const size_t i = static_cast<size_t>(counter);
+        return static_cast<double>(end.values[i] - perf_.values[i]);
+    }
+
+    benchmark::State& state_;
+    std::string unit_;
+    AllocationCounts allocations_;
+    PerfSample perf_;
+};
@@ -0,0 +1,220 @@
+// Latency of pricing in-process through libblackscholes against pricing through the service.
+//
+//   black_scholes_capi_bench [--target=host:port] [--benchmark_filter=REGEX] ...
+//
+// capi/price/<type>    bs_price on the shared library, one option per call
+// capi/batch/<type>    bs_price_batch, 256 options per call; counters are per option
+// capi/greeks/<type>   bs_compute_greeks, one option per call
+// http/<type>          the same options POSTed to /api/calculate of a running service over one
+//                      keep-alive connection; skipped without --target (or BSS_BENCH_TARGET)
+//
+// Both paths draw their options from the same seeded ranges; random expiration keeps sigmaH / H
+// fixed, as pipeline_bench does, so the node table stays warm. The HTTP inputs are distinct for
+// the first 65536 requests, more than a default run sends, so the service's result cache does
+// not answer them. The difference between http/<type> and capi/price/<type> is what an
+// in-process caller saves: loopback networking, the event loop, JSON and the request pipeline.
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "BenchSupport.h"
+#include "HttpConnection.h"
+#include "capi/blackscholes.h"
+#include "utils/AllocationTracker.h"
+
+namespace {
+
+constexpr size_t kInputs = 256;          // a power of two, so cycling is a mask
+constexpr size_t kHttpInputs = 1 << 16;
+constexpr uint64_t kSeed = 20261018;
+constexpr double kHoldingPeriodCv = 0.5;
+
+std::string target;
+
+struct OptionKind {
+    const char* name;
+    int32_t type;
+    const char* api_type;
+};
+
+const OptionKind kKinds[] = {
+    {"regular",                    BS_REGULAR,                       "regular"},
+    {"binary",                     BS_BINARY,                        "binary"},
+    {"random_expiration",          BS_RANDOM_EXPIRATION_CALL,        "randomExpirationCall"},
+    {"random_expiration_binary",   BS_RANDOM_EXPIRATION_BINARY_CALL, "randomExpirationBinaryCall"},
+};
+
+double draw(std::mt19937_64& rng, double lo, double hi) {
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+std::vector<bs_option> makeOptions(const OptionKind& kind, size_t count) {
+    std::mt19937_64 rng(kSeed);
+    std::vector<bs_option> options(count);
+    for (bs_option& option : options) {
+        option = bs_option{};
+        option.type = kind.type;
+        option.stock_price = draw(rng, 50.0, 150.0);
+        option.strike_price = draw(rng, 50.0, 150.0);
+        option.volatility = draw(rng, 0.1, 0.6);
+        option.risk_free_rate = draw(rng, 0.0, 0.08);
+        option.time_to_maturity = draw(rng, 0.1, 3.0);
+        option.holding_period = draw(rng, 0.5, 10.0);
+        option.volatility_around_holding_period = kHoldingPeriodCv * option.holding_period;
+    }
+    return options;
+}
+
+std::string requestBody(const OptionKind& kind, const bs_option& option) {
+    char body[512];
+    const bool random_expiration = (kind.type == BS_RANDOM_EXPIRATION_CALL ||
+                                    kind.type == BS_RANDOM_EXPIRATION_BINARY_CALL);
+    if (random_expiration) {
+        std::snprintf(body, sizeof(body),
+                      "{\"type\":\"%s\",\"stock_price\":%.17g,\"strike_price\":%.17g,\"volatility\":%.17g,"
+                      "\"risk_free_rate\":%.17g,\"holding_period\":%.17g,\"volatility_around_holding_period\":%.17g}",
+                      kind.api_type, option.stock_price, option.strike_price, option.volatility,
+                      option.risk_free_rate, option.holding_period, option.volatility_around_holding_period);
+    } else {
+        std::snprintf(body, sizeof(body),
+                      "{\"type\":\"%s\",\"stock_price\":%.17g,\"strike_price\":%.17g,\"volatility\":%.17g,"
+                      "\"risk_free_rate\":%.17g,\"time_to_maturity\":%.17g}",
+                      kind.api_type, option.stock_price, option.strike_price, option.volatility,
+                      option.risk_free_rate, option.time_to_maturity);
+    }
+    return body;
+}
+
+void priceBenchmark(benchmark::State& state, const OptionKind& kind) {
+    const std::vector<bs_option> options = makeOptions(kind, kInputs);
+    BenchMeasurement measurement(state, "option");
+    size_t i = 0;
+    double price = 0.0;
+    measurement.start();
+    for (auto _ : state) {
+        if (bs_price(&options[i++ & (kInputs - 1)], nullptr, &price, nullptr) != BS_OK) {
+            state.SkipWithError("bs_price failed");
+            break;
+        }
+        benchmark::DoNotOptimize(price);
+    }
+    measurement.stop(1.0);
+}
+
+void batchBenchmark(benchmark::State& state, const OptionKind& kind) {
+    const std::vector<bs_option> options = makeOptions(kind, kInputs);
+    std::vector<double> prices(kInputs);
+    BenchMeasurement measurement(state, "option");
+    measurement.start();
+    for (auto _ : state) {
+        if (bs_price_batch(options.data(), options.size(), nullptr, prices.data(), nullptr) != BS_OK) {
+            state.SkipWithError("bs_price_batch failed");
+            break;
+        }
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::ClobberMemory();
+    }
+    measurement.stop(static_cast<double>(kInputs));
+}
+
+void greeksBenchmark(benchmark::State& state, const OptionKind& kind) {
+    const std::vector<bs_option> options = makeOptions(kind, kInputs);
+    BenchMeasurement measurement(state, "option");
+    size_t i = 0;
+    bs_greeks greeks;
+    measurement.start();
+    for (auto _ : state) {
+        if (bs_compute_greeks(&options[i++ & (kInputs - 1)], nullptr, &greeks, nullptr) != BS_OK) {
+            state.SkipWithError("bs_compute_greeks failed");
+            break;
+        }
+        benchmark::DoNotOptimize(greeks);
+    }
+    measurement.stop(1.0);
+}
+
+void httpBenchmark(benchmark::State& state, const OptionKind& kind) {
+    std::string host, error;
+    uint16_t port = 0;
+    if (target.empty()) {
+        state.SkipWithError("no service to call; pass --target=host:port or set BSS_BENCH_TARGET");
+        return;
+    }
+    if (!parseTarget(target, host, port, error)) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const std::vector<bs_option> options = makeOptions(kind, kHttpInputs);
+    std::vector<std::string> bodies;
+    bodies.reserve(options.size());
+    for (const bs_option& option : options) bodies.push_back(requestBody(kind, option));
+
+    HttpConnection connection(host, port);
+    BenchMeasurement measurement(state, "option");
+    size_t i = 0;
+    int status = 0;
+    std::string response;
+    measurement.start();
+    for (auto _ : state) {
+        if (!connection.post("/api/calculate", bodies[i++ & (kHttpInputs - 1)], status, response, error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        if (status != 200) {
+            state.SkipWithError(("HTTP " + std::to_string(status) + ": " + response).c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(response.data());
+    }
+    measurement.stop(1.0);
+}
+
+void registerBenchmarks() {
+    for (const OptionKind& kind : kKinds) {
+        const std::string name = kind.name;
+        benchmark::RegisterBenchmark(("capi/price/" + name).c_str(), priceBenchmark, kind);
+        benchmark::RegisterBenchmark(("capi/batch/" + name).c_str(), batchBenchmark, kind);
+        benchmark::RegisterBenchmark(("capi/greeks/" + name).c_str(), greeksBenchmark, kind);
+        benchmark::RegisterBenchmark(("http/" + name).c_str(), httpBenchmark, kind)->UseRealTime();
+    }
+}
+
+// Takes this binary's own flags out of argv before Google Benchmark sees it
+void parseOwnFlags(int& argc, char** argv) {
+    if (const char* env = std::getenv("BSS_BENCH_TARGET")) target = env;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--target=", 9) == 0) {
+            target = argv[i] + 9;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    parseOwnFlags(argc, argv);
+    AllocationTracker::setEnabled(true);
+
+    char version[256];
+    bs_engine_version(version, sizeof(version));
+    benchmark::AddCustomContext("engine_version", version);
+    benchmark::AddCustomContext("api_version", std::to_string(bs_api_version()));
+    if (!target.empty()) benchmark::AddCustomContext("target", target);
+
+    registerBenchmarks();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
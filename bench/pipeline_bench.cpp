@@ -0,0 +1,317 @@
+// In-process benchmarks of the /api/calculate pipeline; no network or event loop involved.
+//
+//   black_scholes_pipeline_bench [--benchmark_filter=REGEX] [--benchmark_format=json] ...
+//
+// pipeline/<mix> drives BlackScholesController::calculate with prebuilt HttpRequest objects and
+// a callback that only keeps the response, so it measures everything the service does per
+// request except the socket. Its phase counters come from the request's own PhaseTimer (via
+// MetricsService) and split each request into body copy, JSON parse, DTO validation, pricing
+// with response assembly, and serialization; price_share is the pricing phase's fraction of
+// their sum. Time outside the phases (response objects, metrics) is the rest of time_per_request.
+//
+// stage/<stage> isolates each step over the realistic mix, so a change to one of them can be
+// measured without the rest of the request around it.
+//
+// The result cache is disabled except in pipeline/cache_hits, which prices nothing: every
+// request was answered once before timing starts. Counters are per request (BenchSupport.h).
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <drogon/drogon.h>
+#include <jsoncpp/json/json.h>
+#include "BenchSupport.h"
+#include "controllers/BlackScholesController.h"
+#include "requests/BlackScholesRequestDto.h"
+#include "services/BlackScholesService.h"
+#include "services/MetricsService.h"
+#include "services/ResultCache.h"
+#include "utils/AllocationTracker.h"
+#include "utils/ControllerUtils.h"
+#include "utils/PhaseTimer.h"
+
+namespace {
+
+constexpr size_t kMixSize = 256;  // a power of two, so cycling is a mask
+constexpr uint64_t kSeed = 20261018;
+
+// Share of each request type in a mix; the rest of the fields are drawn per request
+struct Mix {
+    const char* name;
+    double regular, binary, random_expiration, random_expiration_binary;
+    double diagnostics;        // fraction asking for diagnostics
+    double malformed_json;     // fraction whose body does not parse
+    double invalid_request;    // fraction that parses but fails validation
+    bool cached;               // leave the result cache on and answer everything once first
+};
+
+// realistic mirrors the production request split; random expiration keeps sigmaH / H fixed,
+// which keeps the Gauss-Laguerre shape (and so the thread's node table) the same across
+// holding periods, as a steady stream of similar contracts does.
+const Mix kMixes[] = {
+    {"closed_form",       0.5,  0.5,  0.0,  0.0,  0.0, 0.0,  0.0,  false},
+    {"random_expiration", 0.0,  0.0,  0.7,  0.3,  0.0, 0.0,  0.0,  false},
+    {"realistic",         0.45, 0.2,  0.25, 0.1,  0.1, 0.0,  0.0,  false},
+    {"rejected",          0.0,  0.0,  0.0,  0.0,  0.0, 0.5,  0.5,  false},
+    {"cache_hits",        0.0,  0.0,  0.7,  0.3,  0.0, 0.0,  0.0,  true},
+};
+
+const Mix& realisticMix() { return kMixes[2]; }
+
+double draw(std::mt19937_64& rng, double lo, double hi) {
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+std::vector<std::string> makeBodies(const Mix& mix) {
+    std::mt19937_64 rng(kSeed);
+    const double shares[] = {mix.regular, mix.binary, mix.random_expiration, mix.random_expiration_binary,
+                             mix.malformed_json, mix.invalid_request};
+    std::discrete_distribution<int> pick(std::begin(shares), std::end(shares));
+    const char* types[] = {"regular", "binary", "randomExpirationCall", "randomExpirationBinaryCall"};
+    Json::FastWriter writer;
+
+    std::vector<std::string> bodies;
+    for (size_t i = 0; i < kMixSize; ++i) {
+        const int kind = pick(rng);
+        if (kind == 4) {
+            bodies.push_back("{\"type\": \"regular\", \"stock_price\": 100.0, \"strike_price\": ");
+            continue;
+        }
+        Json::Value body;
+        body["type"] = types[kind == 5 ? 0 : kind];
+        body["stock_price"] = draw(rng, 90, 110);
+        body["strike_price"] = body["stock_price"].asDouble() * draw(rng, 0.8, 1.2);
+        body["volatility"] = draw(rng, 0.15, 0.35);
+        body["risk_free_rate"] = draw(rng, 0.0, 0.05);
+        if (kind < 2 || kind == 5) {
+            body["time_to_maturity"] = draw(rng, 0.25, 2.0);
+        } else {
+            const double holding_period = draw(rng, 0.5, 5.0);
+            body["holding_period"] = holding_period;
+            body["volatility_around_holding_period"] = 0.5 * holding_period;
+        }
+        if (kind == 5) body["stock_price"] = -body["stock_price"].asDouble();
+        if (draw(rng, 0, 1) < mix.diagnostics) body["diagnostics"] = true;
+        bodies.push_back(writer.write(body));
+    }
+    return bodies;
+}
+
+std::vector<HttpRequestPtr> makeRequests(const std::vector<std::string>& bodies) {
+    std::vector<HttpRequestPtr> requests;
+    for (const auto& body : bodies) {
+        auto req = HttpRequest::newHttpRequest();
+        req->setMethod(Post);
+        req->setPath("/api/calculate");
+        req->setBody(body);
+        requests.push_back(req);
+    }
+    return requests;
+}
+
+// Disables the result cache for the benchmark's lifetime unless the mix wants it
+class CacheGuard {
+public:
+    explicit CacheGuard(bool enabled) {
+        ResultCache::instance().clear();
+        ResultCache::instance().setCapacity(enabled ? ResultCache::kDefaultCapacity : 0);
+    }
+    ~CacheGuard() {
+        ResultCache::instance().clear();
+        ResultCache::instance().setCapacity(ResultCache::kDefaultCapacity);
+    }
+};
+
+struct PhaseTotals {
+    uint64_t nanos[PhaseTimer::kPhaseCount] = {};
+
+    static PhaseTotals read() {
+        PhaseTotals totals;
+        for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+            totals.nanos[i] = MetricsService::phaseLatency(static_cast<RequestPhase>(i)).sum_ns;
+        }
+        return totals;
+    }
+};
+
+void registerPipelines() {
+    for (const auto& mix : kMixes) {
+        const auto requests = std::make_shared<const std::vector<HttpRequestPtr>>(makeRequests(makeBodies(mix)));
+        const bool cached = mix.cached;
+        benchmark::RegisterBenchmark((std::string("pipeline/") + mix.name).c_str(),
+            [requests, cached](benchmark::State& state) {
+                CacheGuard cache(cached);
+                BlackScholesController controller;
+                HttpResponsePtr last;
+                auto respond = [&last](const HttpResponsePtr& resp) { last = resp; };
+                // Warms node tables and, for cache_hits, answers every request once
+                for (const auto& req : *requests) controller.calculate(req, respond);
+
+                const PhaseTotals before = PhaseTotals::read();
+                BenchMeasurement measurement(state, "request");
+                size_t i = 0;
+                measurement.start();
+                for (auto _ : state) {
+                    controller.calculate((*requests)[i], respond);
+                    benchmark::DoNotOptimize(last.get());
+                    i = (i + 1) & (kMixSize - 1);
+                }
+                measurement.stop(1);
+
+                const PhaseTotals after = PhaseTotals::read();
+                const double iterations = static_cast<double>(std::max<int64_t>(state.iterations(), 1));
+                double total = 0;
+                for (size_t p = 0; p < PhaseTimer::kPhaseCount; ++p) {
+                    const double ns = (after.nanos[p] - before.nanos[p]) / iterations;
+                    state.counters[std::string(PhaseTimer::phaseName(static_cast<RequestPhase>(p))) + "_ns"] = ns;
+                    total += ns;
+                }
+                const size_t price = static_cast<size_t>(RequestPhase::PRICE);
+                if (total > 0) state.counters["price_share"] = (after.nanos[price] - before.nanos[price]) / iterations / total;
+            });
+    }
+}
+
+// Inputs of each stage, produced by running the stages before it once
+struct StageInputs {
+    std::vector<HttpRequestPtr> requests;
+    std::vector<std::string> bodies;
+    std::vector<Json::Value> parsed;
+    std::vector<dto::BlackScholesRequestDto> dtos;
+    std::vector<Json::Value> responses;
+
+    StageInputs() {
+        bodies = makeBodies(realisticMix());
+        requests = makeRequests(bodies);
+        Json::Reader reader;
+        for (const auto& body : bodies) {
+            parsed.emplace_back();
+            reader.parse(body, parsed.back());
+            std::string error;
+            if (auto dto = dto::BlackScholesRequestDto::fromJson(parsed.back(), error)) dtos.push_back(*dto);
+        }
+        for (const auto& dto : dtos) responses.push_back(ControllerUtils::createSuccessResponse(price(dto)));
+    }
+
+    // The pricing half of BlackScholesController::respondWithPrice
+    static Json::Value price(const dto::BlackScholesRequestDto& dto) {
+        Json::Value data;
+        switch (dto.getOptionType()) {
+            case dto::OptionType::RANDOM_EXPIRATION_CALL:
+            case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL: {
+                const bool binary = dto.getOptionType() == dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL;
+                const RandomExpirationCallOption result = binary
+                    ? BlackScholesService::calculateRandomExpirationBinaryCall(
+                          dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(), dto.getRiskFreeRate(),
+                          dto.getHoldingPeriod().value(), dto.getVolatilityAroundHoldingPeriod().value())
+                    : BlackScholesService::calculateRandomExpirationCall(
+                          dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(), dto.getRiskFreeRate(),
+                          dto.getHoldingPeriod().value(), dto.getVolatilityAroundHoldingPeriod().value());
+                data["type"] = result.type;
+                data["value"] = result.value;
+                data["holding_period"] = result.holding_period;
+                data["volatility_around_holding_period"] = result.volatility_around_holding_period;
+                if (dto.wantsDiagnostics()) {
+                    data["diagnostics"] = ControllerUtils::createDiagnostics(result.diagnostics, result.cached);
+                }
+                break;
+            }
+            case dto::OptionType::BINARY:
+            case dto::OptionType::REGULAR: {
+                const CallOption result = dto.getOptionType() == dto::OptionType::BINARY
+                    ? BlackScholesService::calculateBinaryCall(dto.getStockPrice(), dto.getStrikePrice(),
+                                                               dto.getTimeToMaturity().value(), dto.getVolatility(),
+                                                               dto.getRiskFreeRate())
+                    : BlackScholesService::calculateRegularCall(dto.getStockPrice(), dto.getStrikePrice(),
+                                                                dto.getTimeToMaturity().value(), dto.getVolatility(),
+                                                                dto.getRiskFreeRate());
+                data["type"] = result.type;
+                data["value"] = result.value;
+                if (dto.wantsDiagnostics()) {
+                    data["diagnostics"] = ControllerUtils::createDiagnostics(BlackScholesUtil::PricingDiagnostics{}, false);
+                }
+                break;
+            }
+        }
+        return data;
+    }
+};
+
+// Runs stage(i) over n prebuilt inputs, one request per iteration
+void runStage(benchmark::State& state, size_t n, const std::function<void(size_t)>& stage) {
+    CacheGuard cache(false);
+    for (size_t i = 0; i < n; ++i) stage(i);
+    BenchMeasurement measurement(state, "request");
+    size_t i = 0;
+    measurement.start();
+    for (auto _ : state) {
+        stage(i);
+        if (++i == n) i = 0;
+    }
+    measurement.stop(1);
+}
+
+void registerStages() {
+    const auto inputs = std::make_shared<const StageInputs>();
+
+    benchmark::RegisterBenchmark("stage/body_copy", [inputs](benchmark::State& state) {
+        runStage(state, inputs->requests.size(), [&](size_t i) {
+            std::string body(inputs->requests[i]->getBody());
+            benchmark::DoNotOptimize(body.data());
+        });
+    });
+    benchmark::RegisterBenchmark("stage/json_parse", [inputs](benchmark::State& state) {
+        runStage(state, inputs->bodies.size(), [&](size_t i) {
+            Json::Value body;
+            Json::Reader reader;
+            benchmark::DoNotOptimize(reader.parse(inputs->bodies[i], body));
+        });
+    });
+    benchmark::RegisterBenchmark("stage/dto_from_json", [inputs](benchmark::State& state) {
+        runStage(state, inputs->parsed.size(), [&](size_t i) {
+            std::string error;
+            auto dto = dto::BlackScholesRequestDto::fromJson(inputs->parsed[i], error);
+            benchmark::DoNotOptimize(dto);
+        });
+    });
+    benchmark::RegisterBenchmark("stage/price", [inputs](benchmark::State& state) {
+        runStage(state, inputs->dtos.size(), [&](size_t i) {
+            Json::Value data = StageInputs::price(inputs->dtos[i]);
+            benchmark::DoNotOptimize(data);
+        });
+    });
+    benchmark::RegisterBenchmark("stage/response_build", [inputs](benchmark::State& state) {
+        runStage(state, inputs->responses.size(), [&](size_t i) {
+            Json::Value response = ControllerUtils::createSuccessResponse(inputs->responses[i]["data"]);
+            benchmark::DoNotOptimize(response);
+        });
+    });
+    benchmark::RegisterBenchmark("stage/serialize", [inputs](benchmark::State& state) {
+        runStage(state, inputs->responses.size(), [&](size_t i) {
+            std::string text = inputs->responses[i].toStyledString();
+            benchmark::DoNotOptimize(text.data());
+        });
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    AllocationTracker::setEnabled(true);
+    PhaseTimer::calibrate();
+    benchmark::AddCustomContext("engine_version", BlackScholesUtil::engineVersion());
+    benchmark::AddCustomContext("hardware_counters", PerfCounters::hardwareAvailable() ? "yes" : "no");
+
+    registerPipelines();
+    registerStages();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
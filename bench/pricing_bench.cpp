@@ -0,0 +1,339 @@
+// Google Benchmark suite for the pricing kernels in utils/BlackScholesUtil.h.
+//
+//   black_scholes_bench [--benchmark_filter=REGEX] [--benchmark_format=json]
+//                       [--benchmark_out=FILE --benchmark_out_format=json] ...
+//
+// Every kernel runs on one thread over a fixed, seeded grid of parameter sets that it cycles
+// through, so branch predictors and caches see a realistic mix rather than one point. Grids
+// come in representative regimes (what the service mostly prices) and adversarial ones
+// (extreme strikes and volatilities, near expiry, Gauss-Laguerre table churn). The counters
+// are per option (see BenchSupport.h), so items_per_second is options per second on one
+// core. Random expiration benchmarks are labelled with the engine mix the grid routes to.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "BenchSupport.h"
+#include "utils/AllocationTracker.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/PerfCounters.h"
+#include "utils/TuningConfig.h"
+
+namespace {
+
+using BlackScholesUtil::PricingEngine;
+
+struct Range {
+    double lo, hi;
+};
+
+// Parameter space of one regime; holding_cv is sigmaH / H
+struct Regime {
+    const char* name;
+    Range stock, moneyness, maturity, volatility, rate, holding, holding_cv;
+};
+
+struct Params {
+    double S, K, T, vol, r, H, sigmaH;
+};
+
+constexpr size_t kGridSize = 1024;  // a power of two, so cycling is a mask
+constexpr uint64_t kSeed = 20261018;
+
+// Fixed maturity regimes for the closed-form kernels
+const Regime kClosedFormRegimes[] = {
+    {"atm",         {90, 110}, {0.9, 1.1},  {0.25, 2.0},   {0.15, 0.35}, {0.0, 0.05}, {1, 1}, {0, 0}},
+    {"wide",        {10, 500}, {0.5, 2.0},  {0.02, 10.0},  {0.05, 0.8},  {0.0, 0.1},  {1, 1}, {0, 0}},
+    {"adversarial", {1, 1000}, {0.05, 20},  {1e-4, 0.01},  {0.005, 3.0}, {0.0, 0.2},  {1, 1}, {0, 0}},
+};
+
+// Random expiration regimes, named after the engine the default thresholds pick. The
+// gauss_laguerre grid keeps H and sigmaH fixed so every price reuses the thread's node table;
+// gl_table_churn varies them, so every price rebuilds it.
+const Regime kRandomExpirationRegimes[] = {
+    {"analytic_shortcut", {90, 110}, {0.8, 1.2},  {1, 1}, {0.15, 0.35}, {0.0, 0.05}, {0.5, 5.0}, {1e-4, 0.015}},
+    {"gauss_laguerre",    {90, 110}, {0.8, 1.2},  {1, 1}, {0.15, 0.35}, {0.0, 0.05}, {2.0, 2.0}, {0.5, 0.5}},
+    {"gl_table_churn",    {90, 110}, {0.8, 1.2},  {1, 1}, {0.15, 0.35}, {0.0, 0.05}, {0.5, 5.0}, {0.1, 1.0}},
+    {"gsl_qagiu",         {90, 110}, {0.8, 1.2},  {1, 1}, {0.15, 0.35}, {0.0, 0.05}, {0.5, 5.0}, {1.6, 4.0}},
+    {"adversarial",       {1, 1000}, {0.05, 20},  {1, 1}, {0.005, 3.0}, {0.0, 0.2},  {1e-3, 50}, {1e-3, 10}},
+};
+
+// A degenerate range is a fixed value, exactly: the warm Gauss-Laguerre grid relies on it
+double draw(std::mt19937_64& rng, Range range) {
+    if (range.lo == range.hi) return range.lo;
+    return std::uniform_real_distribution<double>(range.lo, std::nextafter(range.hi, range.hi + 1))(rng);
+}
+
+std::vector<Params> makeGrid(const Regime& regime) {
+    std::mt19937_64 rng(kSeed);
+    std::vector<Params> grid(kGridSize);
+    for (auto& p : grid) {
+        p.S = draw(rng, regime.stock);
+        p.K = p.S * draw(rng, regime.moneyness);
+        p.T = draw(rng, regime.maturity);
+        p.vol = draw(rng, regime.volatility);
+        p.r = draw(rng, regime.rate);
+        p.H = draw(rng, regime.holding);
+        p.sigmaH = p.H * draw(rng, regime.holding_cv);
+    }
+    return grid;
+}
+
+// Runs price(params) over the grid, one option per iteration. The first price is untimed so
+// the thread's node table and workspaces exist before measuring.
+template <typename Price>
+void runGrid(benchmark::State& state, const std::vector<Params>& grid, Price price) {
+    BenchMeasurement measurement(state, "option");
+    size_t i = 0;
+    benchmark::DoNotOptimize(price(grid[0]));
+    measurement.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(price(grid[i]));
+        i = (i + 1) & (kGridSize - 1);
+    }
+    measurement.stop(1);
+}
+
+// "gauss_laguerre 97%, gsl_qagiu 3%" for the engines a random expiration grid routes to
+std::string engineMix(const std::vector<Params>& grid, bool binary) {
+    std::map<std::string, size_t> counts;
+    for (const auto& p : grid) {
+        BlackScholesUtil::PricingDiagnostics diagnostics;
+        if (binary) {
+            BlackScholesUtil::calculateRandomExpirationBinaryCall(p.S, p.K, p.vol, p.r, p.H, p.sigmaH, &diagnostics);
+        } else {
+            BlackScholesUtil::calculateRandomExpirationCall(p.S, p.K, p.vol, p.r, p.H, p.sigmaH, &diagnostics);
+        }
+        ++counts[BlackScholesUtil::engineName(diagnostics.engine)];
+    }
+    std::string mix;
+    for (const auto& entry : counts) {
+        if (!mix.empty()) mix += ", ";
+        mix += entry.first + " " + std::to_string(entry.second * 100 / grid.size()) + "%";
+    }
+    return mix;
+}
+
+void registerClosedForm() {
+    for (const auto& regime : kClosedFormRegimes) {
+        const auto grid = std::make_shared<const std::vector<Params>>(makeGrid(regime));
+        benchmark::RegisterBenchmark((std::string("standard_call/") + regime.name).c_str(),
+            [grid](benchmark::State& state) {
+                runGrid(state, *grid, [](const Params& p) {
+                    return BlackScholesUtil::calculateStandardCall(p.S, p.K, p.T, p.vol, p.r);
+                });
+            });
+        benchmark::RegisterBenchmark((std::string("binary_call/") + regime.name).c_str(),
+            [grid](benchmark::State& state) {
+                runGrid(state, *grid, [](const Params& p) {
+                    return BlackScholesUtil::calculateBinaryCall(p.S, p.K, p.T, p.vol, p.r);
+                });
+            });
+    }
+}
+
+void registerRandomExpiration() {
+    for (const auto& regime : kRandomExpirationRegimes) {
+        const auto grid = std::make_shared<const std::vector<Params>>(makeGrid(regime));
+        benchmark::RegisterBenchmark((std::string("random_expiration_call/") + regime.name).c_str(),
+            [grid](benchmark::State& state) {
+                state.SetLabel(engineMix(*grid, false));
+                runGrid(state, *grid, [](const Params& p) {
+                    return BlackScholesUtil::calculateRandomExpirationCall(p.S, p.K, p.vol, p.r, p.H, p.sigmaH);
+                });
+            });
+        benchmark::RegisterBenchmark((std::string("random_expiration_binary_call/") + regime.name).c_str(),
+            [grid](benchmark::State& state) {
+                state.SetLabel(engineMix(*grid, true));
+                runGrid(state, *grid, [](const Params& p) {
+                    return BlackScholesUtil::calculateRandomExpirationBinaryCall(p.S, p.K, p.vol, p.r, p.H, p.sigmaH);
+                });
+            });
+    }
+}
+
+// Each engine forced over the warm Gauss-Laguerre grid: orders, kernel variants and QAGIU
+// tolerances side by side on the same inputs
+void registerEngines() {
+    const auto grid = std::make_shared<const std::vector<Params>>(makeGrid(kRandomExpirationRegimes[1]));
+
+    for (auto isa : {BlackScholesUtil::KernelIsa::SCALAR, BlackScholesUtil::KernelIsa::AVX2}) {
+        if (!BlackScholesUtil::kernelIsaSupported(isa)) continue;
+        const std::string name = std::string("engine/gauss_laguerre_") + BlackScholesUtil::kernelIsaName(isa);
+        benchmark::RegisterBenchmark(name.c_str(), [grid, isa](benchmark::State& state) {
+            const auto previous = BlackScholesUtil::kernelIsa();
+            BlackScholesUtil::setKernelIsa(isa);
+            const int order = static_cast<int>(state.range(0));
+            runGrid(state, *grid, [order](const Params& p) {
+                return BlackScholesUtil::priceRandomExpirationWithEngine(PricingEngine::GAUSS_LAGUERRE, false, p.S, p.K,
+                                                                         p.vol, p.r, p.H, p.sigmaH, order);
+            });
+            BlackScholesUtil::setKernelIsa(previous);
+        })->ArgName("order")->Arg(16)->Arg(32)->Arg(64)->Arg(128);
+    }
+
+    benchmark::RegisterBenchmark("engine/gsl_qagiu", [grid](benchmark::State& state) {
+        const double tolerance = std::pow(10.0, -static_cast<double>(state.range(0)));
+        runGrid(state, *grid, [tolerance](const Params& p) {
+            return BlackScholesUtil::priceRandomExpirationWithEngine(PricingEngine::GSL_QAGIU, false, p.S, p.K, p.vol,
+                                                                     p.r, p.H, p.sigmaH, 0, tolerance);
+        });
+    })->ArgName("neg_log10_tol")->Arg(6)->Arg(9)->Arg(12);
+}
+
+// The batch entry points take one vector per parameter
+struct Columns {
+    std::vector<double> S, K, T, vol, r, H, sigmaH;
+
+    Columns(const std::vector<Params>& grid, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const Params& p = grid[i % grid.size()];
+            S.push_back(p.S); K.push_back(p.K); T.push_back(p.T); vol.push_back(p.vol);
+            r.push_back(p.r); H.push_back(p.H); sigmaH.push_back(p.sigmaH);
+        }
+    }
+};
+
+void registerBatches() {
+    using Batch = std::function<std::vector<double>(const Columns&)>;
+    struct BatchKernel {
+        const char* name;
+        const Regime& regime;
+        Batch run;
+    };
+    const BatchKernel kernels[] = {
+        {"batch/standard_calls", kClosedFormRegimes[0], [](const Columns& c) {
+            return BlackScholesUtil::calculateMultipleStandardCalls(c.S, c.K, c.T, c.vol, c.r);
+        }},
+        {"batch/binary_calls", kClosedFormRegimes[0], [](const Columns& c) {
+            return BlackScholesUtil::calculateMultipleBinaryCalls(c.S, c.K, c.T, c.vol, c.r);
+        }},
+        {"batch/random_expiration_calls", kRandomExpirationRegimes[1], [](const Columns& c) {
+            return BlackScholesUtil::calculateMultipleRandomExpirationCalls(c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+        }},
+        {"batch/random_expiration_binary_calls", kRandomExpirationRegimes[1], [](const Columns& c) {
+            return BlackScholesUtil::calculateMultipleRandomExpirationBinaryCalls(c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+        }},
+    };
+    for (const auto& kernel : kernels) {
+        const auto grid = std::make_shared<const std::vector<Params>>(makeGrid(kernel.regime));
+        Batch run = kernel.run;
+        benchmark::RegisterBenchmark(kernel.name, [grid, run](benchmark::State& state) {
+            const size_t n = static_cast<size_t>(state.range(0));
+            const Columns columns(*grid, n);
+            BenchMeasurement measurement(state, "option");
+            measurement.start();
+            for (auto _ : state) {
+                auto prices = run(columns);
+                benchmark::DoNotOptimize(prices.data());
+            }
+            measurement.stop(static_cast<double>(n));
+        })->ArgName("options")->Arg(64)->Arg(1024)->Arg(16384);
+    }
+}
+
+// A listed chain of strikes x maturities on one underlying, priced by the chain API and, on
+// the same cells, row by row through the batch entry point. Both use the kernel variant the
+// host picked, and counters are per option.
+struct Chain {
+    double S = 100.0, r = 0.03;
+    std::vector<double> strikes, maturities, vols;
+
+    Chain(size_t strike_count, size_t maturity_count) {
+        std::mt19937_64 rng(kSeed);
+        for (size_t j = 0; j < strike_count; ++j) {
+            strikes.push_back(S * (0.5 + 1.5 * static_cast<double>(j) / std::max<size_t>(strike_count - 1, 1)));
+        }
+        for (size_t m = 0; m < maturity_count; ++m) maturities.push_back(draw(rng, {0.02, 3.0}));
+        std::sort(maturities.begin(), maturities.end());
+        for (size_t i = 0; i < strike_count * maturity_count; ++i) vols.push_back(draw(rng, {0.15, 0.45}));
+    }
+};
+
+void registerChains() {
+    benchmark::RegisterBenchmark("chain/standard_calls", [](benchmark::State& state) {
+        const Chain chain(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+        std::vector<double> prices(chain.vols.size());
+        BenchMeasurement measurement(state, "option");
+        measurement.start();
+        for (auto _ : state) {
+            BlackScholesUtil::calculateStandardCallChain(chain.S, chain.r, chain.strikes.data(), chain.strikes.size(),
+                                                         chain.maturities.data(), chain.maturities.size(),
+                                                         chain.vols.data(), prices.data());
+            benchmark::DoNotOptimize(prices.data());
+            benchmark::ClobberMemory();
+        }
+        measurement.stop(static_cast<double>(prices.size()));
+    })->ArgNames({"strikes", "maturities"})->Args({64, 16})->Args({256, 32});
+
+    benchmark::RegisterBenchmark("chain/row_by_row", [](benchmark::State& state) {
+        const Chain chain(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+        const size_t cells = chain.vols.size();
+        std::vector<double> S(cells, chain.S), K(cells), T(cells), r(cells, chain.r);
+        for (size_t i = 0; i < cells; ++i) {
+            K[i] = chain.strikes[i % chain.strikes.size()];
+            T[i] = chain.maturities[i / chain.strikes.size()];
+        }
+        BenchMeasurement measurement(state, "option");
+        measurement.start();
+        for (auto _ : state) {
+            auto prices = BlackScholesUtil::calculateMultipleStandardCalls(S, K, T, chain.vols, r);
+            benchmark::DoNotOptimize(prices.data());
+        }
+        measurement.stop(static_cast<double>(cells));
+    })->ArgNames({"strikes", "maturities"})->Args({64, 16})->Args({256, 32});
+}
+
+// One eigen-decomposition per iteration: alternating shapes defeat the per-thread table
+void registerTableBuilds() {
+    benchmark::RegisterBenchmark("gl_table_build", [](benchmark::State& state) {
+        const auto previous = TuningConfig::snapshot();
+        TuningParameters params = *previous;
+        params.gl_order = static_cast<int>(state.range(0));
+        std::string error;
+        if (!TuningConfig::publish(params, error)) {
+            state.SkipWithError(error.c_str());
+            return;
+        }
+        const uint64_t builds = BlackScholesUtil::glTableBuilds();
+        BenchMeasurement measurement(state, "option");
+        double alpha = 3.25;
+        measurement.start();
+        for (auto _ : state) {
+            BlackScholesUtil::prebuildGLTable(alpha);
+            alpha = alpha == 3.25 ? 4.75 : 3.25;
+        }
+        measurement.stop(1);
+        state.counters["builds_per_iteration"] =
+            static_cast<double>(BlackScholesUtil::glTableBuilds() - builds) / std::max<int64_t>(state.iterations(), 1);
+        TuningConfig::publish(*previous, error);
+    })->ArgName("order")->Arg(16)->Arg(32)->Arg(64)->Arg(128);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    AllocationTracker::setEnabled(true);
+    benchmark::AddCustomContext("kernel_isa", BlackScholesUtil::kernelIsaName(BlackScholesUtil::kernelIsa()));
+    benchmark::AddCustomContext("engine_version", BlackScholesUtil::engineVersion());
+    benchmark::AddCustomContext("hardware_counters", PerfCounters::hardwareAvailable() ? "yes" : "no");
+
+    registerClosedForm();
+    registerRandomExpiration();
+    registerEngines();
+    registerBatches();
+    registerChains();
+    registerTableBuilds();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,366 @@
+// Core-scaling benchmarks: every workload runs on 1, 2, 4, ... threads at once.
+//
+//   black_scholes_scaling_bench [--max_threads=N] [--efficiency_threshold=F]
+//                               [--benchmark_filter=REGEX] [--benchmark_out=FILE] ...
+//
+// Workloads:
+//
+//   request/<mix>   BlackScholesController::calculate, as in pipeline_bench, one controller and
+//                   request set per thread; cache_hits keeps the result cache on
+//   batch/<type>    the calculateMultiple* entry points, 256 options per call
+//   engine/<path>   one numerical path per workload through priceRandomExpirationWithEngine;
+//                   gauss_laguerre keeps one shape (a warm node table per thread),
+//                   gauss_laguerre_churn varies it so every option rebuilds the table
+//
+// Threads draw their own inputs and share only what the service shares: the result cache,
+// metrics, the allocator and the tuning parameters. After the standard output, a table gives
+// each workload's total throughput, the latency one thread sees, and the scaling efficiency,
+// throughput(n) / (n * throughput(1)). Rows below the threshold (default 0.8) are flagged as
+// contention. Rows with more threads than hardware threads are marked oversubscribed instead,
+// since they measure the scheduler. By default the thread counts stop at the hardware thread
+// count, up to 64.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <drogon/drogon.h>
+#include "BenchSupport.h"
+#include "RequestMix.h"
+#include "controllers/BlackScholesController.h"
+#include "services/ResultCache.h"
+#include "utils/AllocationTracker.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/PhaseTimer.h"
+
+namespace {
+
+using BlackScholesUtil::PricingEngine;
+
+constexpr size_t kInputs = 256;   // per thread; a power of two, so cycling is a mask
+constexpr size_t kBatchSize = 256;
+constexpr uint64_t kSeed = 20261018;
+constexpr int kMaxThreads = 64;
+
+int max_threads = 0;              // 0: hardware threads, capped at kMaxThreads
+double efficiency_threshold = 0.8;
+
+uint64_t threadSeed(const benchmark::State& state) {
+    return kSeed + static_cast<uint64_t>(state.thread_index());
+}
+
+double draw(std::mt19937_64& rng, double lo, double hi) {
+    if (lo == hi) return lo;
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+void enableCache(const benchmark::State&) {
+    ResultCache::instance().clear();
+    ResultCache::instance().setCapacity(ResultCache::kDefaultCapacity);
+}
+
+void disableCache(const benchmark::State&) {
+    ResultCache::instance().clear();
+    ResultCache::instance().setCapacity(0);
+}
+
+// Request mixes, named after pipeline_bench's
+struct Mix {
+    const char* name;
+    const char* weights;
+    const char* regime;
+    double diagnostics;
+    bool cached;
+};
+
+const Mix kMixes[] = {
+    {"closed_form",       "regular=50,binary=50",                                   "gauss_laguerre", 0.0, false},
+    {"random_expiration", "randomExpirationCall=70,randomExpirationBinaryCall=30",  "gauss_laguerre", 0.0, false},
+    {"realistic",         "regular=45,binary=20,randomExpirationCall=25,randomExpirationBinaryCall=10",
+                                                                                    "gauss_laguerre", 0.1, false},
+    {"mixed_engines",     "randomExpirationCall=70,randomExpirationBinaryCall=30",  "mixed",          0.0, false},
+    {"cache_hits",        "randomExpirationCall=70,randomExpirationBinaryCall=30",  "gauss_laguerre", 0.0, true},
+};
+
+void runRequests(benchmark::State& state, const Mix& mix) {
+    RequestMix generator;
+    std::string error;
+    generator.parseWeights(mix.weights, error);
+    generator.regime = mix.regime;
+    generator.diagnostics = mix.diagnostics;
+
+    std::vector<HttpRequestPtr> requests;
+    for (const auto& body : generator.bodies(kInputs, threadSeed(state))) {
+        auto req = HttpRequest::newHttpRequest();
+        req->setMethod(Post);
+        req->setPath("/api/calculate");
+        req->setBody(body);
+        requests.push_back(req);
+    }
+    BlackScholesController controller;
+    HttpResponsePtr last;
+    auto respond = [&last](const HttpResponsePtr& resp) { last = resp; };
+    // Warms this thread's node tables and, for cache_hits, answers every request once
+    for (const auto& req : requests) controller.calculate(req, respond);
+
+    BenchMeasurement measurement(state, "request");
+    size_t i = 0;
+    measurement.start();
+    for (auto _ : state) {
+        controller.calculate(requests[i], respond);
+        benchmark::DoNotOptimize(last.get());
+        i = (i + 1) & (kInputs - 1);
+    }
+    measurement.stop(1);
+}
+
+// Contract ranges of an engine or batch workload; cv is sigmaH / H
+struct Inputs {
+    double moneyness_lo, moneyness_hi;
+    double cv_lo, cv_hi;
+};
+
+struct Contract {
+    double S, K, T, vol, r, H, sigmaH;
+};
+
+std::vector<Contract> contracts(const benchmark::State& state, const Inputs& inputs, size_t count) {
+    std::mt19937_64 rng(threadSeed(state));
+    std::vector<Contract> all(count);
+    for (auto& c : all) {
+        c.S = draw(rng, 90, 110);
+        c.K = c.S * draw(rng, inputs.moneyness_lo, inputs.moneyness_hi);
+        c.T = draw(rng, 0.25, 2.0);
+        c.vol = draw(rng, 0.15, 0.35);
+        c.r = draw(rng, 0.0, 0.05);
+        c.H = draw(rng, 0.5, 5.0);
+        c.sigmaH = c.H * draw(rng, inputs.cv_lo, inputs.cv_hi);
+    }
+    return all;
+}
+
+struct Engine {
+    const char* name;
+    Inputs inputs;
+    std::function<double(const Contract&)> price;
+};
+
+double priceWith(PricingEngine engine, const Contract& c) {
+    return BlackScholesUtil::priceRandomExpirationWithEngine(engine, false, c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+}
+
+const Engine kEngines[] = {
+    {"closed_form", {0.8, 1.2, 0.5, 0.5}, [](const Contract& c) {
+        return BlackScholesUtil::calculateStandardCall(c.S, c.K, c.T, c.vol, c.r);
+    }},
+    {"analytic_shortcut", {0.8, 1.2, 0.001, 0.015}, [](const Contract& c) {
+        return priceWith(PricingEngine::ANALYTIC_SHORTCUT, c);
+    }},
+    {"gauss_laguerre", {0.8, 1.2, 0.5, 0.5}, [](const Contract& c) {
+        return priceWith(PricingEngine::GAUSS_LAGUERRE, c);
+    }},
+    {"gauss_laguerre_churn", {0.8, 1.2, 0.3, 1.5}, [](const Contract& c) {
+        return priceWith(PricingEngine::GAUSS_LAGUERRE, c);
+    }},
+    {"gsl_qagiu", {0.8, 1.2, 1.6, 4.0}, [](const Contract& c) {
+        return priceWith(PricingEngine::GSL_QAGIU, c);
+    }},
+};
+
+void runEngine(benchmark::State& state, const Engine& engine) {
+    const std::vector<Contract> inputs = contracts(state, engine.inputs, kInputs);
+    for (const auto& c : inputs) benchmark::DoNotOptimize(engine.price(c));
+
+    BenchMeasurement measurement(state, "option");
+    size_t i = 0;
+    measurement.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.price(inputs[i]));
+        i = (i + 1) & (kInputs - 1);
+    }
+    measurement.stop(1);
+}
+
+// The batch entry points take one vector per parameter
+struct Columns {
+    std::vector<double> S, K, T, vol, r, H, sigmaH;
+
+    explicit Columns(const std::vector<Contract>& all) {
+        for (const auto& c : all) {
+            S.push_back(c.S);
+            K.push_back(c.K);
+            T.push_back(c.T);
+            vol.push_back(c.vol);
+            r.push_back(c.r);
+            H.push_back(c.H);
+            sigmaH.push_back(c.sigmaH);
+        }
+    }
+};
+
+struct Batch {
+    const char* name;
+    std::function<std::vector<double>(const Columns&)> price;
+};
+
+const Batch kBatches[] = {
+    {"standard_calls", [](const Columns& c) {
+        return BlackScholesUtil::calculateMultipleStandardCalls(c.S, c.K, c.T, c.vol, c.r);
+    }},
+    {"random_expiration_calls", [](const Columns& c) {
+        return BlackScholesUtil::calculateMultipleRandomExpirationCalls(c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+    }},
+};
+
+void runBatch(benchmark::State& state, const Batch& batch) {
+    const Columns columns(contracts(state, {0.8, 1.2, 0.5, 0.5}, kBatchSize));
+    benchmark::DoNotOptimize(batch.price(columns));
+
+    BenchMeasurement measurement(state, "option");
+    measurement.start();
+    for (auto _ : state) {
+        std::vector<double> prices = batch.price(columns);
+        benchmark::DoNotOptimize(prices.data());
+    }
+    measurement.stop(kBatchSize);
+}
+
+std::vector<int> threadCounts() {
+    const int hardware = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int highest = max_threads > 0 ? max_threads : std::min(hardware, kMaxThreads);
+    std::vector<int> counts;
+    for (int n = 1; n < highest; n *= 2) counts.push_back(n);
+    counts.push_back(highest);
+    return counts;
+}
+
+void scale(benchmark::internal::Benchmark* benchmark) {
+    for (int n : threadCounts()) benchmark->Threads(n);
+    benchmark->UseRealTime();
+}
+
+void registerWorkloads() {
+    for (const auto& mix : kMixes) {
+        auto* b = benchmark::RegisterBenchmark((std::string("request/") + mix.name).c_str(),
+                                               [&mix](benchmark::State& state) { runRequests(state, mix); });
+        if (mix.cached) b->Setup(enableCache)->Teardown(disableCache);
+        scale(b);
+    }
+    for (const auto& batch : kBatches) {
+        scale(benchmark::RegisterBenchmark((std::string("batch/") + batch.name).c_str(),
+                                           [&batch](benchmark::State& state) { runBatch(state, batch); }));
+    }
+    for (const auto& engine : kEngines) {
+        scale(benchmark::RegisterBenchmark((std::string("engine/") + engine.name).c_str(),
+                                           [&engine](benchmark::State& state) { runEngine(state, engine); }));
+    }
+}
+
+// Console output followed by the scaling table
+class ScalingReporter : public benchmark::ConsoleReporter {
+public:
+    ScalingReporter() : benchmark::ConsoleReporter(OO_Tabular) {}
+
+    void ReportRuns(const std::vector<Run>& reports) override {
+        for (const auto& run : reports) {
+            if (run.error_occurred || run.run_type != Run::RT_Iteration) continue;
+            const auto rate = run.counters.find("items_per_second");
+            if (rate == run.counters.end()) continue;
+            auto& rows = workloads_[run.run_name.function_name];
+            rows.push_back({run.threads, rate->second.value});
+        }
+        ConsoleReporter::ReportRuns(reports);
+    }
+
+    void Finalize() override {
+        ConsoleReporter::Finalize();
+        const int64_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        std::ostream& out = GetOutputStream();
+        char line[160];
+        std::snprintf(line, sizeof(line), "\nScaling (%lld hardware threads; flagged below %.2f efficiency)\n",
+                      static_cast<long long>(hardware), efficiency_threshold);
+        out << line;
+        std::snprintf(line, sizeof(line), "%-32s %8s %14s %16s %11s\n", "workload", "threads", "items/s",
+                      "ns/item/thread", "efficiency");
+        out << line;
+
+        int flagged = 0;
+        for (const auto& workload : workloads_) {
+            double single = 0;
+            for (const auto& row : workload.second) {
+                if (row.threads == 1) single = row.items_per_second;
+            }
+            for (const auto& row : workload.second) {
+                const double latency = row.items_per_second > 0 ? 1e9 * row.threads / row.items_per_second : 0;
+                const double efficiency = single > 0 ? row.items_per_second / (single * row.threads) : 0;
+                const char* note = "";
+                if (row.threads > hardware) {
+                    note = "  oversubscribed";
+                } else if (single > 0 && efficiency < efficiency_threshold) {
+                    note = "  SUB-LINEAR: contention?";
+                    ++flagged;
+                }
+                std::snprintf(line, sizeof(line), "%-32s %8lld %14.0f %16.1f %11.2f%s\n", workload.first.c_str(),
+                              static_cast<long long>(row.threads), row.items_per_second, latency, efficiency, note);
+                out << line;
+            }
+        }
+        std::snprintf(line, sizeof(line), "%d row(s) scale sub-linearly\n", flagged);
+        out << line;
+    }
+
+private:
+    struct Row {
+        int64_t threads;
+        double items_per_second;
+    };
+    std::map<std::string, std::vector<Row>> workloads_;
+};
+
+// Takes this binary's own flags out of argv before Google Benchmark sees it
+bool parseOwnFlags(int& argc, char** argv) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--max_threads=", 14) == 0) {
+            max_threads = std::atoi(arg + 14);
+            if (max_threads < 1) return false;
+        } else if (std::strncmp(arg, "--efficiency_threshold=", 23) == 0) {
+            efficiency_threshold = std::atof(arg + 23);
+            if (!(efficiency_threshold > 0 && efficiency_threshold <= 1)) return false;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parseOwnFlags(argc, argv)) {
+        std::fprintf(stderr, "--max_threads must be at least 1 and --efficiency_threshold in (0, 1]\n");
+        return 1;
+    }
+    AllocationTracker::setEnabled(true);
+    PhaseTimer::calibrate();
+    ResultCache::instance().setCapacity(0);
+    benchmark::AddCustomContext("engine_version", BlackScholesUtil::engineVersion());
+
+    registerWorkloads();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ScalingReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,154 @@
+#ifndef BLACKSCHOLES_H
+#define BLACKSCHOLES_H
+
+/*
+ * libblackscholes: the service's pricing engines behind a C ABI, for in-process use from C and
+ * through FFI from other languages.
+ *
+ * The ABI is stable within an API version: structs only hold fixed-width fields, enums are
+ * passed as int32_t, and every buffer is owned by the caller. The library never allocates
+ * memory the caller has to free and never throws across the boundary. All functions are
+ * thread-safe; Gauss-Laguerre node tables are cached per thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+  #if defined(BLACKSCHOLES_BUILD_SHARED)
+    #define BS_EXPORT __declspec(dllexport)
+  #elif defined(BLACKSCHOLES_SHARED)
+    #define BS_EXPORT __declspec(dllimport)
+  #else
+    #define BS_EXPORT
+  #endif
+#else
+  #define BS_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define BS_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum bs_status {
+    BS_OK = 0,
+    BS_INVALID_ARGUMENT = 1,   /* a null pointer or a field the API would reject */
+    BS_NUMERICAL_ERROR = 2,    /* the engine produced a non-finite result */
+    BS_INTERNAL_ERROR = 3
+} bs_status;
+
+/* Same values and meaning as the "type" field of /api/calculate */
+typedef enum bs_option_type {
+    BS_REGULAR = 0,
+    BS_BINARY = 1,
+    BS_RANDOM_EXPIRATION_CALL = 2,
+    BS_RANDOM_EXPIRATION_BINARY_CALL = 3
+} bs_option_type;
+
+typedef enum bs_engine {
+    BS_ENGINE_AUTO = 0,               /* the service's routing; only valid in bs_engine_options */
+    BS_ENGINE_CLOSED_FORM = 1,
+    BS_ENGINE_ANALYTIC_SHORTCUT = 2,
+    BS_ENGINE_GAUSS_LAGUERRE = 3,
+    BS_ENGINE_GSL_QAGIU = 4
+} bs_engine;
+
+typedef struct bs_option {
+    int32_t type;                              /* bs_option_type */
+    int32_t reserved;                          /* must be 0 */
+    double stock_price;
+    double strike_price;
+    double volatility;
+    double risk_free_rate;
+    double time_to_maturity;                   /* BS_REGULAR and BS_BINARY */
+    double holding_period;                     /* random expiration types */
+    double volatility_around_holding_period;   /* NaN defaults to holding_period */
+} bs_option;
+
+/*
+ * Engine selection for the random expiration types; fixed-maturity options always use the
+ * closed form. A null bs_engine_options pointer means BS_ENGINE_AUTO. A positive gl_order or
+ * qagiu_tolerance overrides the tuned value for a forced engine.
+ */
+typedef struct bs_engine_options {
+    int32_t engine;                            /* bs_engine */
+    int32_t gl_order;
+    double qagiu_tolerance;
+} bs_engine_options;
+
+typedef struct bs_diagnostics {
+    int32_t engine;          /* bs_engine that produced the price */
+    int32_t evaluations;     /* quadrature nodes or integrand evaluations; 0 when not measured */
+    double abs_error;        /* QAGIU's error estimate, NaN otherwise */
+    double alpha;            /* gamma distribution of the expiration time, NaN when unused */
+    double beta;
+} bs_diagnostics;
+
+/*
+ * Theta is the change in value per year of time passing, -dV/dT. For the random expiration
+ * types it is the sensitivity to the holding period with its coefficient of variation fixed,
+ * and all Greeks are central differences of the selected engine.
+ */
+typedef struct bs_greeks {
+    double delta;
+    double gamma;
+    double vega;
+    double theta;
+    double rho;
+} bs_greeks;
+
+/* BS_API_VERSION of the loaded library */
+BS_EXPORT int32_t bs_api_version(void);
+
+/*
+ * Writes the engine version tag (the one result caches are keyed by) into buffer, truncated
+ * and NUL-terminated; returns the tag's full length
+ */
+BS_EXPORT size_t bs_engine_version(char* buffer, size_t size);
+
+/* Static strings; never null */
+BS_EXPORT const char* bs_status_string(int32_t status);
+BS_EXPORT const char* bs_engine_name(int32_t engine);
+
+/*
+ * Loads a tuning file (the service's BSS_TUNING_FILE format) for all later prices. On failure
+ * the previous tuning stays and error, if given, receives the reason.
+ */
+BS_EXPORT bs_status bs_load_tuning(const char* path, char* error, size_t error_size);
+
+/* Prices one option; engine_options and diagnostics may be null */
+BS_EXPORT bs_status bs_price(const bs_option* option, const bs_engine_options* engine_options,
+                             double* price, bs_diagnostics* diagnostics);
+
+/*
+ * Prices count options into prices[0..count). Options that fail get a NaN price and, when
+ * statuses is given, their status; the return value is the first failure or BS_OK.
+ */
+BS_EXPORT bs_status bs_price_batch(const bs_option* options, size_t count,
+                                   const bs_engine_options* engine_options,
+                                   double* prices, int32_t* statuses);
+
+/*
+ * Standard call prices over an option chain: one underlying and rate, strike_count strikes and
+ * maturity_count maturities. volatilities and prices are maturity-major grids of
+ * maturity_count * strike_count cells, the cell of maturity m and strike j at
+ * m * strike_count + j. Terms shared by a row or column are computed once, so this is much
+ * faster than bs_price_batch over the same cells. Every input must be valid as for BS_REGULAR;
+ * otherwise nothing is priced, prices is filled with NaN and BS_INVALID_ARGUMENT returned.
+ */
+BS_EXPORT bs_status bs_price_chain(double stock_price, double risk_free_rate,
+                                   const double* strikes, size_t strike_count,
+                                   const double* maturities, size_t maturity_count,
+                                   const double* volatilities, double* prices);
+
+/* Greeks of one option; engine_options and diagnostics may be null */
+BS_EXPORT bs_status bs_compute_greeks(const bs_option* option, const bs_engine_options* engine_options,
+                                      bs_greeks* greeks, bs_diagnostics* diagnostics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLACKSCHOLES_H */
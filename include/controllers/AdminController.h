@@ -0,0 +1,33 @@
+#pragma once
+#include <drogon/HttpController.h>
+#include <string>
+
+using namespace drogon;
+
+// Runtime tuning and the autotuner's report. A POST changes pricing for every client, so main
+// registers the controller only when BSS_ADMIN_TOKEN is set, and each request must carry that
+// token as "Authorization: Bearer <token>".
+class AdminController : public HttpController<AdminController, false> {
+public:
+    explicit AdminController(std::string token) : token_(std::move(token)) {}
+
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(AdminController::getTuning, "/admin/tuning", Get);
+    ADD_METHOD_TO(AdminController::updateTuning, "/admin/tuning", Post);
+    ADD_METHOD_TO(AdminController::getAutotune, "/admin/autotune", Get);
+    METHOD_LIST_END
+
+    void getTuning(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+
+    // Body holds the tuning fields to override; the rest keep their current values
+    void updateTuning(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+
+    // The startup autotuner's choices and the measurements behind them
+    void getAutotune(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+
+private:
+    // Answers 401 and returns false unless req carries the token
+    bool authorize(const HttpRequestPtr& req, const std::function<void(const HttpResponsePtr&)>& callback) const;
+
+    std::string token_;
+};
@@ -1,7 +1,12 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <jsoncpp/json/json.h>
+#include <string>
+#include "requests/BlackScholesRequestDto.h"
 #include "services/BlackScholesService.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/PhaseTimer.h"
+#include "utils/Tracer.h"
 
 using namespace drogon;
 
@@ -14,5 +19,27 @@ public:
     void calculate(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
 
 private:
-    // No private methods needed - DTO handles all parameter validation
+    // Per-request timing and trace state, carried to whichever path sends the response
+    struct RequestContext {
+        PhaseTimer timer;
+        RequestSpanAttributes trace;
+        // Set once pricing starts; what the slow request log records
+        const dto::BlackScholesRequestDto* request = nullptr;
+        BlackScholesUtil::PricingDiagnostics diagnostics;
+        bool cached = false;
+    };
+
+    // Peer that owns the request's cache key, or empty when it should be priced here
+    static std::string routeOwner(const HttpRequestPtr& req, const dto::BlackScholesRequestDto& dto);
+
+    static void respondWithPrice(const dto::BlackScholesRequestDto& dto,
+                                 const std::function<void(const HttpResponsePtr&)>& callback,
+                                 RequestContext& context);
+
+    // Records the request's phase timings, trace spans and slow request log entry and, when
+    // enabled, reports the timings in Server-Timing
+    static void sendTimed(const HttpResponsePtr& resp, const RequestContext& context,
+                          const std::function<void(const HttpResponsePtr&)>& callback);
+
+    static void logIfSlow(const RequestContext& context, int status_code);
 };
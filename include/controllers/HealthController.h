@@ -0,0 +1,14 @@
+#pragma once
+#include <drogon/HttpController.h>
+
+using namespace drogon;
+
+class HealthController : public HttpController<HealthController, false> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(HealthController::ready, "/ready", Get);
+    METHOD_LIST_END
+
+    // 200 once startup warmup has completed on every worker thread, 503 before that
+    void ready(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+};
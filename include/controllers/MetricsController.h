@@ -0,0 +1,22 @@
+#pragma once
+#include <drogon/HttpController.h>
+
+using namespace drogon;
+
+class MetricsController : public HttpController<MetricsController, false> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(MetricsController::metrics, "/metrics", Get);
+    ADD_METHOD_TO(MetricsController::perfCounters, "/debug/perf", Get);
+    ADD_METHOD_TO(MetricsController::allocations, "/debug/allocations", Get);
+    METHOD_LIST_END
+
+    // Request, pricing-path, node-table and cache metrics in the Prometheus text format
+    void metrics(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+
+    // Per-engine hardware counter (or software timing) averages, when BSS_PERF_COUNTERS is set
+    void perfCounters(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+
+    // Heap allocations per request phase and per engine call, when BSS_ALLOCATION_TRACKING is set
+    void allocations(const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback);
+};
@@ -13,6 +13,9 @@ enum class OptionType {
     RANDOM_EXPIRATION_BINARY_CALL
 };
 
+// The request's "type" string for an option type
+const char* optionTypeName(OptionType type);
+
 class BlackScholesRequestDto {
 public:
     // Constructor from JSON
@@ -31,6 +34,12 @@ public:
     OptionType getOptionType() const { return option_type_; }
     std::optional<double> getHoldingPeriod() const { return holding_period_; }
     std::optional<double> getVolatilityAroundHoldingPeriod() const { return volatility_around_holding_period_; }
+    // Whether the response should include how the price was computed
+    bool wantsDiagnostics() const { return diagnostics_; }
+    
+    // Canonical request body: every field the price depends on, with defaults filled in.
+    // Parsing it again yields the same DTO.
+    Json::Value toJson() const;
     
     // Static factory method
     static std::optional<BlackScholesRequestDto> fromJson(const Json::Value& json, std::string& error);
@@ -39,6 +48,7 @@ private:
     // Validation methods
     bool validateRequiredFields(const Json::Value& json, std::string& error);
     bool validateOptionTypeSpecificFields(const Json::Value& json, std::string& error);
+    bool validateOptionalFields(const Json::Value& json, std::string& error);
     bool validatePositiveDouble(const Json::Value& json, const std::string& field, double& value, std::string& error);
     bool validateNumericField(const Json::Value& json, const std::string& field, double& value, std::string& error);
     bool validateStringField(const Json::Value& json, const std::string& field, std::string& value, std::string& error);
@@ -53,6 +63,7 @@ private:
     OptionType option_type_;
     std::optional<double> holding_period_;
     std::optional<double> volatility_around_holding_period_;
+    bool diagnostics_;
     
     // Validation state
     bool is_valid_;
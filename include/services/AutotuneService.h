@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <jsoncpp/json/json.h>
+#include <string>
+#include <vector>
+#include "utils/BlackScholesUtil.h"
+
+struct AutotuneConfig {
+    bool enabled = false;
+    // Decisions are cached here, one file per CPU model; empty disables the cache
+    std::string cache_dir;
+    // Gauss-Laguerre orders must price within this (relative, floored at 1) of a tight QAGIU reference
+    double max_error = 1e-4;
+    std::vector<int> gl_orders = {16, 24, 32, 48, 64};
+    int repetitions = 200;           // timed calls per kernel sample
+
+    // BSS_AUTOTUNE=1 enables; BSS_AUTOTUNE_CACHE_DIR, defaulting to BSS_STORE_DIR
+    static AutotuneConfig fromEnvironment();
+};
+
+struct AutotuneResult {
+    std::string cpu_model;
+    std::string cache_key;
+    bool from_cache = false;
+    BlackScholesUtil::KernelIsa isa = BlackScholesUtil::KernelIsa::SCALAR;
+    int gl_order = 0;
+    // Timings and errors of every candidate, for the introspection endpoint
+    Json::Value measurements;
+
+    Json::Value toJson() const;
+    bool fromJson(const Json::Value& json, std::string& error);
+};
+
+// Startup autotuner. Micro-benchmarks the Gauss-Laguerre kernel variants the CPU supports and
+// the candidate Gauss-Laguerre orders. Variants that disagree with the scalar kernel and orders
+// that miss the accuracy target are rejected; the fastest remaining choice of each is pinned
+// process-wide.
+class AutotuneService {
+public:
+    // Loads the cached decision for this CPU or measures a new one, then applies it
+    static bool run(const AutotuneConfig& config, AutotuneResult& result, std::string& error);
+
+    static bool measure(const AutotuneConfig& config, AutotuneResult& result, std::string& error);
+    static bool apply(const AutotuneResult& result, std::string& error);
+
+    // The applied decision, or {"enabled": false} when the autotuner has not run
+    static Json::Value report();
+
+    static std::string cpuModel();
+    // Identifies a decision: CPU model, autotuner version and the candidate sets
+    static std::string cacheKey(const AutotuneConfig& config, const std::string& cpu_model);
+};
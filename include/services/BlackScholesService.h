@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "utils/BlackScholesUtil.h"
 
 struct CallOption {
     std::string type;
@@ -11,6 +12,9 @@ struct RandomExpirationCallOption {
     double value;
     double holding_period;
     double volatility_around_holding_period;
+    // How value was produced; only meaningful when cached is false
+    BlackScholesUtil::PricingDiagnostics diagnostics;
+    bool cached = false;
 };
 
 class BlackScholesService {
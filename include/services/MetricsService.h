@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <jsoncpp/json/json.h>
+#include "requests/BlackScholesRequestDto.h"
+#include "utils/AllocationTracker.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/PhaseTimer.h"
+
+// Latency histogram with power-of-two nanosecond buckets: bucket i counts observations
+// up to 2^(kFirstBucketShift + i) ns, the last bucket everything above.
+struct HistogramSnapshot {
+    static constexpr int kFirstBucketShift = 8;  // 256 ns
+    static constexpr size_t kBucketCount = 24;   // up to ~2.1 s, then +Inf
+
+    std::array<uint64_t, kBucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+
+    static size_t bucketFor(uint64_t nanos);
+    static double upperBoundSeconds(size_t bucket);
+};
+
+enum class RequestError {
+    INVALID_JSON,
+    INVALID_REQUEST,
+    FORWARD_FAILED,
+    INTERNAL
+};
+
+// Process-wide request and pricing metrics exported on /metrics. Every thread records into
+// its own block with plain relaxed loads and stores, so recording never takes a lock or a
+// contended cache line; readers sum the blocks of all threads that ever recorded.
+class MetricsService {
+public:
+    static constexpr size_t kOptionTypeCount = 4;
+    static constexpr size_t kPathCount = 5;  // the four PricingEngine values plus result cache hits
+    static constexpr size_t kErrorCount = 4;
+
+    static uint64_t nowNanos();
+
+    // Brackets one /api/calculate request; requestStarted returns the start timestamp.
+    static uint64_t requestStarted();
+    static void requestFinished(uint64_t started_ns, int status_code);
+    static void recordRequest(dto::OptionType type);
+    static void recordError(RequestError error);
+
+    static void recordPricing(dto::OptionType type, BlackScholesUtil::PricingEngine engine, uint64_t nanos);
+    static void recordCacheHit(dto::OptionType type, uint64_t nanos);
+    // Adds each phase the request reached to its phase histogram, and its allocations to the
+    // phase totals while allocation tracking is enabled
+    static void recordPhases(const PhaseTimer& timer);
+
+    static uint64_t requestCount(dto::OptionType type);
+    static uint64_t errorCount(RequestError error);
+    static int64_t inFlight();
+    static HistogramSnapshot requestLatency();
+    static HistogramSnapshot pricingLatency(dto::OptionType type, BlackScholesUtil::PricingEngine engine);
+    static HistogramSnapshot cacheHitLatency(dto::OptionType type);
+    static HistogramSnapshot phaseLatency(RequestPhase phase);
+    static AllocationCounts phaseAllocations(RequestPhase phase);
+
+    // Allocations per request for each phase and per invocation for each engine
+    static Json::Value allocationsJson();
+
+    // Prometheus text exposition format, version 0.0.4
+    static std::string renderPrometheus();
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+class MappedStore;
+
+// Canonical identity of a cacheable pricing request. Two requests with the same key are
+// guaranteed to produce the same price, so the key also decides which cluster node owns
+// the request (see ClusterRouter).
+struct ResultCacheKey {
+    enum Kind : uint32_t {
+        RANDOM_EXPIRATION_CALL = 1,
+        RANDOM_EXPIRATION_BINARY_CALL = 2
+    };
+
+    uint32_t kind = 0;
+    double params[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+    static ResultCacheKey make(Kind kind, double stock_price, double strike_price,
+                               double volatility, double risk_free_rate,
+                               double holding_period, double volatility_around_holding_period);
+
+    uint64_t hash() const;
+    bool operator==(const ResultCacheKey& other) const;
+};
+
+struct ResultCacheKeyHash {
+    size_t operator()(const ResultCacheKey& key) const { return static_cast<size_t>(key.hash()); }
+};
+
+// Process-wide LRU cache of computed prices, split into independently locked shards. An
+// optional persistent MappedStore acts as a second level that survives restarts.
+//
+// Prices depend on the tuning snapshot they were computed under, which the key does not
+// name. Each insert carries that snapshot's generation, and after invalidateAll(version, g)
+// inserts from generations below g are dropped, so a request that started before a reload
+// cannot put its price back once the cache has been cleared.
+class ResultCache {
+public:
+    static constexpr size_t kDefaultCapacity = 65536;
+
+    static ResultCache& instance();
+
+    explicit ResultCache(size_t capacity = kDefaultCapacity);
+
+    bool lookup(const ResultCacheKey& key, double& value);
+    // generation is the TuningParameters::generation read before the value was computed
+    void insert(const ResultCacheKey& key, double value, uint64_t generation);
+    void clear();
+    // Clears memory and the attached store, re-tagging the store with the new engine version,
+    // and from then on drops inserts from generations below generation
+    void invalidateAll(const std::string& engine_version, uint64_t generation);
+    void setCapacity(size_t capacity);
+
+    // Attach a persistent second-level store (nullptr detaches). Misses in memory are
+    // looked up there and every insert is written through.
+    void attachStore(MappedStore* store);
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    uint64_t storeHits() const { return store_hits_.load(std::memory_order_relaxed); }
+    size_t size() const;
+
+private:
+    static constexpr size_t kShardCount = 16;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<std::pair<ResultCacheKey, double>> lru;
+        std::unordered_map<ResultCacheKey, std::list<std::pair<ResultCacheKey, double>>::iterator,
+                           ResultCacheKeyHash> index;
+        size_t capacity = 0;
+    };
+
+    Shard& shardFor(const ResultCacheKey& key);
+
+    std::array<Shard, kShardCount> shards_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> store_hits_{0};
+    std::atomic<uint64_t> valid_from_{0};
+    std::atomic<MappedStore*> store_{nullptr};
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "requests/BlackScholesRequestDto.h"
+
+// Column-oriented batch of options of a single type. Only the columns used by the
+// option type need to be filled: time_to_maturities for regular/binary, holding_periods
+// and volatility_around_holding_periods for the random expiration types.
+struct BatchPricingJob {
+    dto::OptionType type = dto::OptionType::REGULAR;
+    std::vector<double> stock_prices;
+    std::vector<double> strike_prices;
+    std::vector<double> volatilities;
+    std::vector<double> risk_free_rates;
+    std::vector<double> time_to_maturities;
+    std::vector<double> holding_periods;
+    std::vector<double> volatility_around_holding_periods;
+
+    size_t size() const { return stock_prices.size(); }
+};
+
+struct ShardedBatchOptions {
+    int worker_count = 4;
+    size_t shard_size = 65536;
+    int max_shard_retries = 2;
+    // Jobs of at most this many rows are priced in the calling process, below the point
+    // where forking workers pays off
+    size_t inline_rows = 0;
+    // Invoked inside the worker process before each shard is priced with the shard index
+    // and its attempt number (0 for the first try). Used for fault injection in tests.
+    std::function<void(size_t shard, int attempt)> shard_hook;
+};
+
+// Forks worker processes without exec, so it must not be called from the multithreaded
+// server: the children allocate after fork() and can deadlock on a lock that another thread
+// held at the time of the fork. Single-threaded tools such as black_scholes_batch use it.
+class ShardedBatchExecutor {
+public:
+    // Splits the job into shards and prices them in worker_count forked processes. Workers
+    // write prices into a shared anonymous mapping, so results come back in input order.
+    // A worker that dies or throws mid-shard is replaced and its shard is retried up to
+    // max_shard_retries times before the whole job fails. Workers have no deadline: one that
+    // hangs is waited for forever, and so is the call.
+    static bool run(const BatchPricingJob& job, const ShardedBatchOptions& options,
+                    std::vector<double>& results, std::string& error);
+
+    // Runs price_shard(0 .. shard_count-1) across worker_count forked processes with the
+    // same retry policy as run(). price_shard runs in the child, so it must publish its
+    // results through memory shared with the parent. shard_size and inline_rows are unused.
+    // Only the workers this call forked are reaped; other children are left alone.
+    static bool runShards(size_t shard_count, const ShardedBatchOptions& options,
+                          const std::function<void(size_t shard)>& price_shard, std::string& error);
+
+    // Prices rows [begin, end) of the job in the calling process.
+    static void priceRange(const BatchPricingJob& job, size_t begin, size_t end, double* out);
+
+    static bool validate(const BatchPricingJob& job, std::string& error);
+};
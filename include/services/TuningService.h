@@ -0,0 +1,25 @@
+#pragma once
+#include <jsoncpp/json/json.h>
+#include <string>
+#include "utils/TuningConfig.h"
+
+// Applies tuning reloads: publishes the new TuningConfig snapshot and drops cached
+// results that were computed under the previous parameters.
+class TuningService {
+public:
+    static bool apply(const TuningParameters& params, std::string& error);
+
+    // Overrides the fields present in json on top of the current snapshot
+    static bool applyJson(const Json::Value& overrides, std::string& error);
+
+    // Fields the file omits take their baseline values
+    static bool reloadFile(const std::string& path, std::string& error);
+
+    // File-watch hook: reloads when the file's modification time has changed since the
+    // last successful load. Returns true when a reload happened.
+    static bool reloadIfChanged(const std::string& path, std::string& error);
+
+    // Values a tuning file starts from: the built-in defaults, or the autotuner's choices
+    static void setBaseline(const TuningParameters& params);
+    static TuningParameters baseline();
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+struct WarmupConfig {
+    bool enabled = true;
+    int iterations = 64;
+    // Gamma shape parameters (holding_period / volatility_around_holding_period)^2 whose
+    // Gauss-Laguerre tables are built up front into the persistent table store; skipped when
+    // no store is attached
+    std::vector<double> table_alphas = {0.5, 0.75, 1.0, 1.5625, 2.0, 4.0, 9.0, 16.0};
+
+    // BSS_WARMUP=0 disables warmup, BSS_WARMUP_ITERATIONS, BSS_WARMUP_TABLE_ALPHAS=a,b,...
+    static WarmupConfig fromEnvironment();
+};
+
+// Startup warmup and the readiness state reported by /ready. The service is ready once
+// every worker thread has finished warmCurrentThread.
+class WarmupService {
+public:
+    // Runs every pricing path (closed form, analytic shortcut, Gauss-Laguerre, GSL QAGIU)
+    // and the request parsing path on the calling thread, then builds the configured tables
+    // when a table store is attached.
+    static void warmCurrentThread(const WarmupConfig& config);
+
+    static void begin(size_t thread_count);
+    static void threadWarmed();
+    static void markReady();
+
+    static bool isReady();
+    static size_t warmedThreads();
+    static size_t totalThreads();
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "utils/BlackScholesUtil.h"
+
+// Heap activity of one thread, or charged to a request phase or a pricing engine
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;       // requested sizes; allocator overhead is not included
+    uint64_t frees = 0;
+
+    AllocationCounts operator-(const AllocationCounts& earlier) const {
+        return {allocations - earlier.allocations, bytes - earlier.bytes, frees - earlier.frees};
+    }
+    AllocationCounts& operator+=(const AllocationCounts& other) {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        frees += other.frees;
+        return *this;
+    }
+};
+
+// Totals for one pricing engine across all threads
+struct EngineAllocations {
+    uint64_t invocations = 0;
+    AllocationCounts counts;
+};
+
+// Opt-in heap allocation accounting. The global operator new and delete are replaced in this
+// module and, while tracking is enabled, bump plain thread-local counters; disabled, they
+// cost one relaxed load on top of malloc and free. Attribution works by differencing the
+// calling thread's counters: PhaseTimer charges request phases, AllocationScope charges
+// pricing kernels, and benchmarks can read threadCounts() around the code they measure.
+class AllocationTracker {
+public:
+    static constexpr size_t kEngineCount = 4;
+
+    static void setEnabled(bool enabled);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // The calling thread's running totals. Only that thread updates them, so reads from it
+    // need no synchronisation; the pointer stays valid while the thread runs.
+    static const AllocationCounts* threadCounts();
+
+    // Charges the allocations between two readings of the calling thread to an engine
+    static void recordEngine(BlackScholesUtil::PricingEngine engine,
+                             const AllocationCounts& begin, const AllocationCounts& end);
+    static EngineAllocations engineTotals(BlackScholesUtil::PricingEngine engine);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Brackets one kernel invocation; does nothing while tracking is disabled
+class AllocationScope {
+public:
+    AllocationScope() : active_(AllocationTracker::enabled()) {
+        if (active_) begin_ = *AllocationTracker::threadCounts();
+    }
+
+    void finish(BlackScholesUtil::PricingEngine engine) {
+        if (!active_) return;
+        AllocationTracker::recordEngine(engine, begin_, *AllocationTracker::threadCounts());
+        active_ = false;
+    }
+
+private:
+    bool active_;
+    AllocationCounts begin_;
+};
@@ -1,7 +1,78 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
 #include <vector>
 
+class MappedStore;
+
 namespace BlackScholesUtil {
+    /**
+     * Numerical path that produced a price
+     */
+    enum class PricingEngine {
+        CLOSED_FORM,        // Black-Scholes formula or an intrinsic-value edge case
+        ANALYTIC_SHORTCUT,  // holding period dispersion small enough to price at H
+        GAUSS_LAGUERRE,     // Gauss-Laguerre quadrature over the gamma density
+        GSL_QAGIU           // adaptive GSL QAGIU integration
+    };
+
+    /**
+     * How a single price was computed, filled in when the caller asks for it
+     */
+    struct PricingDiagnostics {
+        PricingEngine engine = PricingEngine::CLOSED_FORM;
+        // Quadrature nodes (Gauss-Laguerre) or integrand evaluations (QAGIU); 1 for closed forms
+        int evaluations = 1;
+        // QAGIU's absolute error estimate; NaN for engines that do not produce one
+        double abs_error = std::numeric_limits<double>::quiet_NaN();
+        // Gamma distribution of the expiration time; NaN when the engine did not need it
+        double alpha = std::numeric_limits<double>::quiet_NaN();
+        double beta = std::numeric_limits<double>::quiet_NaN();
+        // Whether the thread's Gauss-Laguerre table had to be rebuilt or reloaded for this price
+        bool table_rebuilt = false;
+    };
+
+    /**
+     * Label used for an engine in metrics and responses
+     */
+    const char* engineName(PricingEngine engine);
+
+    /**
+     * Instruction set of the Gauss-Laguerre kernels
+     */
+    enum class KernelIsa {
+        SCALAR,
+        AVX2
+    };
+
+    const char* kernelIsaName(KernelIsa isa);
+
+    /**
+     * Whether this build has the variant and the CPU can run it
+     */
+    bool kernelIsaSupported(KernelIsa isa);
+
+    /**
+     * Switch the Gauss-Laguerre kernels of all threads; fails for an unsupported variant.
+     * The default is AVX2 when the build targets it, scalar otherwise.
+     */
+    bool setKernelIsa(KernelIsa isa);
+    KernelIsa kernelIsa();
+
+    /**
+     * Price a random expiration call or binary call with a given engine, bypassing the routing
+     * heuristics; CLOSED_FORM and ANALYTIC_SHORTCUT both price a fixed maturity at H. A positive
+     * gl_order or qagiu_tolerance (absolute and relative) overrides the tuned value. For the
+     * autotuner and the offline tuning tools.
+     */
+    double priceRandomExpirationWithEngine(PricingEngine engine, bool binary,
+                                           double stock_price, double strike_price,
+                                           double volatility, double risk_free_rate,
+                                           double holding_period, double volatility_around_holding_period,
+                                           int gl_order = 0, double qagiu_tolerance = 0.0);
+
     /**
      * Calculate the standard Black-Scholes call option price
      */
@@ -21,14 +92,65 @@ namespace BlackScholesUtil {
      */
     double calculateRandomExpirationCall(double stock_price, double strike_price, 
                                        double volatility, double risk_free_rate, 
-                                       double holding_period, double volatility_around_holding_period);
+                                       double holding_period, double volatility_around_holding_period,
+                                       PricingDiagnostics* diagnostics = nullptr);
 
     /**
      * Calculate the random expiration binary call option price using Black-Scholes with gamma distribution
      */
     double calculateRandomExpirationBinaryCall(double stock_price, double strike_price, 
                                              double volatility, double risk_free_rate, 
-                                             double holding_period, double volatility_around_holding_period);
+                                             double holding_period, double volatility_around_holding_period,
+                                             PricingDiagnostics* diagnostics = nullptr);
+
+    /**
+     * Price sensitivities: delta and gamma to the stock price, vega and rho per unit of
+     * volatility and rate, and theta as the change in value per year of time passing, -dV/dT. For
+     * random expiration options theta is -dV/dH with the holding period's coefficient of
+     * variation held fixed.
+     */
+    struct Greeks {
+        double delta = 0.0;
+        double gamma = 0.0;
+        double vega = 0.0;
+        double theta = 0.0;
+        double rho = 0.0;
+    };
+
+    /**
+     * Closed-form Greeks of the standard and binary calls; all zero (delta a step at the strike
+     * for the call) in the edge cases the prices treat as intrinsic value
+     */
+    Greeks calculateStandardCallGreeks(double stock_price, double strike_price,
+                                       double time_to_maturity, double volatility,
+                                       double risk_free_rate);
+    Greeks calculateBinaryCallGreeks(double stock_price, double strike_price,
+                                     double time_to_maturity, double volatility,
+                                     double risk_free_rate);
+
+    /**
+     * Greeks of the random expiration options by central differences. Every bumped price uses
+     * the engine routed for the unbumped one, so the differences never straddle a routing
+     * boundary; diagnostics describes that price.
+     */
+    Greeks calculateRandomExpirationCallGreeks(double stock_price, double strike_price,
+                                               double volatility, double risk_free_rate,
+                                               double holding_period, double volatility_around_holding_period,
+                                               PricingDiagnostics* diagnostics = nullptr);
+    Greeks calculateRandomExpirationBinaryCallGreeks(double stock_price, double strike_price,
+                                                     double volatility, double risk_free_rate,
+                                                     double holding_period, double volatility_around_holding_period,
+                                                     PricingDiagnostics* diagnostics = nullptr);
+
+    /**
+     * Finite-difference Greeks of a random expiration call or binary call with a given engine,
+     * as priceRandomExpirationWithEngine prices it
+     */
+    Greeks greeksRandomExpirationWithEngine(PricingEngine engine, bool binary,
+                                            double stock_price, double strike_price,
+                                            double volatility, double risk_free_rate,
+                                            double holding_period, double volatility_around_holding_period,
+                                            int gl_order = 0, double qagiu_tolerance = 0.0);
 
     /**
      * Calculate multiple standard Black-Scholes call option prices
@@ -48,6 +170,23 @@ namespace BlackScholesUtil {
                                                     const std::vector<double>& volatilities,
                                                     const std::vector<double>& risk_free_rates);
 
+    /**
+     * Standard call prices over an option chain: one underlying and rate, strike_count strikes
+     * and maturity_count maturities. volatilities and prices are maturity-major grids, the
+     * cell of maturity m and strike j at m * strike_count + j. Terms shared by a maturity or a
+     * strike are computed once and each maturity's strikes go through the vector kernels, so
+     * this is much cheaper than pricing the cells one by one. Prices agree with
+     * calculateStandardCall to within about 1e-13 of max(1, price).
+     */
+    void calculateStandardCallChain(double stock_price, double risk_free_rate,
+                                    const double* strike_prices, size_t strike_count,
+                                    const double* time_to_maturities, size_t maturity_count,
+                                    const double* volatilities, double* prices);
+    std::vector<double> calculateStandardCallChain(double stock_price, double risk_free_rate,
+                                                   const std::vector<double>& strike_prices,
+                                                   const std::vector<double>& time_to_maturities,
+                                                   const std::vector<double>& volatilities);
+
     /**
      * Calculate multiple random expiration call option prices
      */
@@ -67,4 +206,34 @@ namespace BlackScholesUtil {
                                                                     const std::vector<double>& risk_free_rates,
                                                                     const std::vector<double>& holding_periods,
                                                                     const std::vector<double>& volatility_around_holding_periods);
+
+    /**
+     * Tag identifying the numerical configuration of the pricing engines. Persisted result
+     * caches are only reused when their tag matches.
+     */
+    std::string engineVersion();
+
+    /**
+     * Attach a persistent store for Gauss-Laguerre node tables, shared by all threads
+     * and processes that map the same file. Pass nullptr to detach.
+     */
+    void setGLTableStore(MappedStore* store);
+
+    /**
+     * Whether a persistent table store is attached
+     */
+    bool glTableStoreAttached();
+
+    /**
+     * Build the Gauss-Laguerre node table for a gamma shape parameter on the calling thread,
+     * writing it to the persistent table store if one is attached
+     */
+    void prebuildGLTable(double alpha);
+
+    /**
+     * Gauss-Laguerre node tables computed by eigen-decomposition, and tables loaded from the
+     * persistent store instead, across all threads since startup
+     */
+    uint64_t glTableBuilds();
+    uint64_t glTableStoreLoads();
 }
@@ -0,0 +1,35 @@
+#pragma once
+#include <drogon/HttpClient.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct ClusterConfig {
+    std::string self;                 // host:port of this node as listed in peers
+    std::vector<std::string> peers;   // static peer list, including self
+    int virtual_nodes = 128;
+    double forward_timeout_seconds = 0.5;
+
+    // BSS_CLUSTER_SELF=host:port, BSS_CLUSTER_PEERS=host:port,host:port,...
+    static ClusterConfig fromEnvironment();
+};
+
+// Routes cacheable requests to the node that owns their cache key on a consistent-hash
+// ring, so each node's ResultCache holds a disjoint slice of the keyspace.
+class ClusterRouter {
+public:
+    static constexpr const char* kForwardedHeader = "X-BSS-Forwarded-By";
+
+    static void configure(const ClusterConfig& config);
+    static bool enabled();
+
+    // Peer that owns the key, or an empty string when this node owns it.
+    static std::string ownerFor(uint64_t key_hash);
+
+    // Sends the request body to the peer. on_failure runs when the peer is unreachable,
+    // times out or answers with a server error, so the caller can price locally.
+    static void forward(const std::string& peer, const drogon::HttpRequestPtr& req,
+                        std::function<void(const drogon::HttpResponsePtr&)> on_success,
+                        std::function<void()> on_failure);
+};
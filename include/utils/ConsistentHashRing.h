@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Consistent-hash ring with virtual nodes. Adding or removing a node only moves the keys
+// adjacent to that node's points on the ring.
+class ConsistentHashRing {
+public:
+    explicit ConsistentHashRing(int virtual_nodes = 128);
+
+    void addNode(const std::string& node);
+    void removeNode(const std::string& node);
+
+    // Node owning the given key hash; empty when the ring has no nodes.
+    const std::string& nodeFor(uint64_t key_hash) const;
+
+    const std::vector<std::string>& nodes() const { return nodes_; }
+    bool empty() const { return nodes_.empty(); }
+
+    static uint64_t hashString(const std::string& value);
+
+private:
+    void rebuild();
+
+    int virtual_nodes_;
+    std::vector<std::string> nodes_;
+    std::vector<std::pair<uint64_t, size_t>> points_;
+};
@@ -1,12 +1,15 @@
 #pragma once
 #include <jsoncpp/json/json.h>
 #include <string>
+#include "utils/BlackScholesUtil.h"
 
 class ControllerUtils {
 public:
     // Common JSON response helpers
     static Json::Value createSuccessResponse(const Json::Value& data);
     static Json::Value createErrorResponse(const std::string& error, int statusCode = 400);
+    // Opt-in "diagnostics" block describing how a price was computed
+    static Json::Value createDiagnostics(const BlackScholesUtil::PricingDiagnostics& diagnostics, bool cached);
     
     // Common validation helpers
     static bool validatePositiveDouble(const Json::Value& body, const std::string& field, 
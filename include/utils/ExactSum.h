@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Exact sum of doubles (a superaccumulator). Every finite double is a multiple of 2^-1074
+// below 2^1024, so the running sum is kept as a fixed-point integer over that whole range,
+// in 32-bit digits with room for carries, and rounded to the nearest double only when read.
+// Adding is exact, so the result does not depend on the order of the additions or on how
+// they were split up: partial sums built on any number of threads over any chunking and then
+// merged give bitwise the same value() as one thread adding everything in order. That is what
+// lets totals over a parallel run reconcile exactly against a serial one.
+//
+// NaN, and +inf together with -inf, give NaN; otherwise an infinite addend gives that
+// infinity, and a finite sum beyond the double range rounds to infinity.
+class ExactSum {
+public:
+    void add(double x);
+    void add(const double* values, size_t count);
+
+    // Adds everything another accumulator has seen
+    void merge(const ExactSum& other);
+
+    // The exact sum rounded to the nearest double, ties to even
+    double value() const;
+
+    // Values added, directly or through merge
+    uint64_t count() const { return count_; }
+
+private:
+    // 2098 bits cover every finite double; two more digits hold sums of up to 2^64 of them
+    static constexpr int kDigits = 68;
+    static constexpr int kDigitBits = 32;
+    // Each add moves a digit by less than 2^32, so 2^30 adds fit an int64_t between carries
+    static constexpr uint32_t kAddsBetweenCarries = 1u << 30;
+
+    void propagateCarries();
+
+    std::array<int64_t, kDigits> digits_{};
+    uint32_t pending_ = 0;
+    uint64_t count_ = 0;
+    bool nan_ = false;
+    bool positive_infinity_ = false;
+    bool negative_infinity_ = false;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Fixed-size, open-addressing hash table living in a memory-mapped file. Each slot holds a
+// key and a value as opaque bytes and is guarded by a sequence counter, so readers never
+// block and a torn slot is treated as a miss. Opening an existing file only validates its
+// header, so a warm store is available in O(1) after a restart.
+//
+// Every slot is stamped with the store epoch its writer read, and only slots of the current
+// epoch are served. clear() and reset() drop all entries by bumping the epoch rather than
+// overwriting slots, so a writer still filling a slot cannot bring old data back. A slot
+// left claimed by a writer that died is taken over once the epoch has moved on by two.
+class MappedStore {
+public:
+    MappedStore() = default;
+    ~MappedStore();
+
+    MappedStore(const MappedStore&) = delete;
+    MappedStore& operator=(const MappedStore&) = delete;
+
+    // Opens or creates the store. A file whose layout or version tag differs from the
+    // requested one is replaced by a new, empty one (renamed into place, so processes that
+    // still map the old file are unaffected); entries computed by another engine version
+    // are never served.
+    bool open(const std::string& path, size_t slot_count, size_t max_payload,
+              const std::string& version, std::string& error);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // Copies the value for the key into value (up to capacity bytes). value_size receives
+    // the stored value length.
+    bool lookup(uint64_t hash, const void* key, size_t key_size,
+                void* value, size_t capacity, size_t* value_size = nullptr) const;
+    bool insert(uint64_t hash, const void* key, size_t key_size, const void* value, size_t value_size);
+    // Writes under an epoch read earlier; if the store was cleared since, the entry is dead
+    bool insert(uint64_t hash, const void* key, size_t key_size, const void* value, size_t value_size,
+                uint32_t epoch);
+    uint32_t epoch() const;
+
+    void clear();
+    // Drops every entry and stamps the file with a new version tag
+    void reset(const std::string& version);
+    size_t slotCount() const { return slot_count_; }
+    size_t countEntries() const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    Header* header() const { return static_cast<Header*>(base_); }
+    Slot* slotAt(size_t index) const;
+    void initialize(const std::string& version);
+
+    void* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    size_t slot_count_ = 0;
+    size_t slot_bytes_ = 0;
+    size_t max_payload_ = 0;
+    int fd_ = -1;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <jsoncpp/json/json.h>
+#include "utils/BlackScholesUtil.h"
+
+enum class PerfCounter {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES
+};
+
+// Cumulative readings of the calling thread's counter group
+struct PerfSample {
+    static constexpr size_t kCounterCount = 4;
+
+    uint64_t nanos = 0;                       // steady_clock
+    uint64_t values[kCounterCount] = {};      // indexed by PerfCounter, scaled for multiplexing
+    bool hardware = false;                    // false when only nanos could be read
+};
+
+// Totals for one pricing engine across all threads
+struct EngineCounters {
+    uint64_t invocations = 0;
+    uint64_t hardware_invocations = 0;        // invocations that also have hardware counts
+    uint64_t nanos = 0;
+    uint64_t values[PerfSample::kCounterCount] = {};
+};
+
+// Optional hardware performance counters around the pricing kernels. Each thread opens its
+// own perf_event_open group (cycles, instructions, cache misses, branch misses; user space
+// only) the first time it reads; where the group cannot be opened, as in many VMs or under a
+// strict perf_event_paranoid, invocations are still counted with software timing. Totals are
+// kept per thread and per engine with single-writer counters, as in MetricsService.
+class PerfCounters {
+public:
+    static constexpr size_t kEngineCount = 4;
+
+    static void setEnabled(bool enabled);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Whether the calling thread has a working counter group, opening it if needed
+    static bool hardwareAvailable();
+
+    static PerfSample read();
+    // Charges the counts between two readings of the calling thread to an engine
+    static void record(BlackScholesUtil::PricingEngine engine, const PerfSample& begin, const PerfSample& end);
+
+    static EngineCounters totals(BlackScholesUtil::PricingEngine engine);
+    static const char* counterName(PerfCounter counter);
+
+    // Per-engine averages per invocation; hardware figures are null without hardware samples
+    static Json::Value toJson();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Brackets one kernel invocation; does nothing while counters are disabled. The engine is
+// passed at the end because the random expiration paths pick it while they run.
+class PerfScope {
+public:
+    PerfScope() : active_(PerfCounters::enabled()) {
+        if (active_) begin_ = PerfCounters::read();
+    }
+
+    void finish(BlackScholesUtil::PricingEngine engine) {
+        if (!active_) return;
+        PerfCounters::record(engine, begin_, PerfCounters::read());
+        active_ = false;
+    }
+
+private:
+    bool active_;
+    PerfSample begin_;
+};
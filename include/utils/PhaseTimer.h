@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "utils/AllocationTracker.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define BSU_HAS_TSC 1
+#else
+  #define BSU_HAS_TSC 0
+#endif
+
+// Stages of /api/calculate, in the order they run
+enum class RequestPhase {
+    BODY,       // copying the request body
+    PARSE,      // Json::Reader
+    VALIDATE,   // building the request DTO
+    PRICE,      // service call and response assembly
+    SERIALIZE   // toStyledString
+};
+
+// Cheap per-request stopwatch. Each mark() charges the ticks since the previous mark to a
+// phase, so a request pays one rdtsc per phase. Ticks are converted to nanoseconds only
+// when read, using a rate calibrated once against steady_clock. Assumes an invariant TSC,
+// which every x86 server CPU of the last decade provides; elsewhere it reads steady_clock.
+// While AllocationTracker is enabled, marks also charge the thread's heap allocations since
+// the previous mark to the phase.
+class PhaseTimer {
+public:
+    static constexpr size_t kPhaseCount = 5;
+
+    PhaseTimer() : last_(ticks()) {
+        if (AllocationTracker::enabled()) {
+            allocation_source_ = AllocationTracker::threadCounts();
+            last_allocations_ = *allocation_source_;
+        }
+    }
+
+    static uint64_t ticks() {
+#if BSU_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void mark(RequestPhase phase) {
+        const uint64_t now = ticks();
+        phase_ticks_[static_cast<size_t>(phase)] += now - last_;
+        marked_ |= 1u << static_cast<unsigned>(phase);
+        last_ = now;
+        if (allocation_source_) chargeAllocations(phase);
+    }
+
+    // Whether the request got as far as this phase
+    bool reached(RequestPhase phase) const { return marked_ & (1u << static_cast<unsigned>(phase)); }
+    uint64_t nanos(RequestPhase phase) const;
+    // Zero unless allocation tracking was enabled when the timer started
+    const AllocationCounts& allocations(RequestPhase phase) const {
+        return phase_allocations_[static_cast<size_t>(phase)];
+    }
+
+    // "body;dur=0.004, parse;dur=0.011, ..." with durations in milliseconds, for reached phases
+    std::string serverTiming() const;
+
+    static const char* phaseName(RequestPhase phase);
+
+    // Measures the tick rate; called at startup so no request pays for it
+    static void calibrate();
+    static double nanosPerTick();
+
+    // Whether responses carry a Server-Timing header (BSS_SERVER_TIMING=1)
+    static void setServerTimingEnabled(bool enabled);
+    static bool serverTimingEnabled() { return server_timing_.load(std::memory_order_relaxed); }
+
+private:
+    void chargeAllocations(RequestPhase phase);
+
+    uint64_t last_;
+    uint32_t marked_ = 0;
+    std::array<uint64_t, kPhaseCount> phase_ticks_{};
+    const AllocationCounts* allocation_source_ = nullptr;
+    AllocationCounts last_allocations_;
+    std::array<AllocationCounts, kPhaseCount> phase_allocations_{};
+
+    static std::atomic<bool> server_timing_;
+};
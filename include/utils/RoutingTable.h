@@ -0,0 +1,55 @@
+#pragma once
+#include <jsoncpp/json/json.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/BlackScholesUtil.h"
+
+// Engine chosen for one random expiration price
+struct RouteDecision {
+    BlackScholesUtil::PricingEngine engine = BlackScholesUtil::PricingEngine::GAUSS_LAGUERRE;
+    int gl_order = 0;  // Gauss-Laguerre only
+};
+
+// Measured replacement for the hard-coded engine-selection thresholds, produced offline by
+// black_scholes_tune_routing. The (cv, total volatility, log-moneyness) space is cut into
+// cells, where cv = sigmaH / H, total volatility = vol * sqrt(H) and log-moneyness =
+// ln(S / K); each cell names the cheapest engine (and Gauss-Laguerre order) that met the
+// target error everywhere it was sampled. Calls and binary calls have separate cells.
+//
+// JSON form:
+//   {"version": 1, "target_error": 1e-6,
+//    "axes": {"cv": [...], "total_volatility": [...], "log_moneyness": [...]},
+//    "call": [cell, ...], "binary": [cell, ...]}
+// Each axis lists ascending bin boundaries; n boundaries make n + 1 bins and a value on a
+// boundary falls in the upper bin. Cells are {"engine": name} or {"engine":
+// "gauss_laguerre", "gl_order": n}, ordered by cv bin, then total volatility, then
+// log-moneyness.
+class RoutingTable {
+public:
+    static constexpr int kVersion = 1;
+
+    static std::shared_ptr<const RoutingTable> fromJson(const Json::Value& json, std::string& error);
+    Json::Value toJson() const { return json_; }
+
+    RouteDecision route(bool binary, double stock_price, double strike_price, double volatility,
+                        double holding_period, double volatility_around_holding_period) const;
+
+    double targetError() const { return target_error_; }
+    size_t cellCount() const { return call_cells_.size(); }
+    // Hash of the table's contents, for tagging cached results
+    const std::string& fingerprint() const { return fingerprint_; }
+
+private:
+    static size_t bin(const std::vector<double>& bounds, double value);
+
+    double target_error_ = 0.0;
+    std::vector<double> cv_bounds_;
+    std::vector<double> total_vol_bounds_;
+    std::vector<double> moneyness_bounds_;
+    std::vector<RouteDecision> call_cells_;
+    std::vector<RouteDecision> binary_cells_;
+    Json::Value json_;
+    std::string fingerprint_;
+};
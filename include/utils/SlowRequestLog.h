@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <jsoncpp/json/json.h>
+#include <string>
+#include <vector>
+
+struct SlowLogConfig {
+    std::string path;                // JSON Lines output file, appended to
+    double threshold_ms = 5.0;       // requests at least this slow, queue wait included, are logged
+    size_t capacity = 1024;          // records waiting for the writer; more slow requests are dropped
+
+    // BSS_SLOW_LOG_FILE enables the log; BSS_SLOW_LOG_MS, BSS_SLOW_LOG_CAPACITY
+    static SlowLogConfig fromEnvironment();
+};
+
+// Log of requests slower than a threshold. Request threads only queue a record; a background
+// thread serializes and appends it, one JSON object per line. Each line's "request" member is
+// the canonical /api/calculate body, so a log can be replayed as is (see readRequests).
+class SlowRequestLog {
+public:
+    static bool start(const SlowLogConfig& config, std::string& error);
+    // Writes the queued records and closes the file
+    static void stop();
+
+    static bool enabled() { return enabled_.load(std::memory_order_acquire); }
+    static uint64_t thresholdNanos();
+
+    // Queues a record for the writer; returns false and counts a drop when the queue is full
+    static bool submit(Json::Value record);
+
+    static uint64_t writtenRecords();
+    static uint64_t droppedRecords();
+
+    // The request bodies of a slow request log, in file order
+    static bool readRequests(const std::string& path, std::vector<Json::Value>& requests, std::string& error);
+
+private:
+    static std::atomic<bool> enabled_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Single-writer counter: only the owning thread writes, so a relaxed load and store is
+// enough and avoids a locked read-modify-write on the hot path.
+inline void bump(std::atomic<uint64_t>& counter, uint64_t delta = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// One block of per-thread counters per thread, registered so readers can sum them. Each
+// thread writes only its own block; readers walk all of them under the registry lock. Blocks
+// outlive their threads so counts never go backwards. The thread's block pointer is cached per
+// block type, so use one registry per type T.
+template <typename T>
+class ThreadBlocks {
+public:
+    // The calling thread's block, created and registered on first use
+    T& local() {
+        static thread_local T* block = nullptr;
+        if (!block) {
+            auto owned = std::make_unique<T>();
+            block = owned.get();
+            std::lock_guard<std::mutex> lock(mutex_);
+            blocks_.push_back(std::move(owned));
+        }
+        return *block;
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& block : blocks_) f(*block);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<T>> blocks_;
+};
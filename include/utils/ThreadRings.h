@@ -0,0 +1,140 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Single-producer, single-consumer ring owned by one recording thread
+template <typename Slot>
+struct ThreadRing {
+    ThreadRing(size_t capacity, uint32_t thread_id) : slots(new Slot[capacity]), mask(capacity - 1), thread(thread_id) {}
+
+    // The slot to fill next, or nullptr once the ring is full; the producer fills it and then
+    // calls publish()
+    Slot* claim() {
+        const size_t next = tail.load(std::memory_order_relaxed);
+        if (next - head.load(std::memory_order_acquire) > mask) return nullptr;
+        return &slots[next & mask];
+    }
+
+    void publish() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    void drop() { dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    std::unique_ptr<Slot[]> slots;
+    const size_t mask;
+    const uint32_t thread;                     // 1, 2, ... in order of first use
+    alignas(64) std::atomic<size_t> tail{0};   // written by the producer
+    std::atomic<uint64_t> dropped{0};          // written by the producer
+    alignas(64) std::atomic<size_t> head{0};   // written by the consumer
+};
+
+// Every thread's ring, for one consumer to drain. The thread's ring pointer is cached per slot
+// type, so use one ThreadRings per type Slot.
+template <typename Slot>
+class ThreadRings {
+public:
+    using Ring = ThreadRing<Slot>;
+
+    // Slots per ring for threads that record for the first time from now on, rounded up to a
+    // power of two
+    void setCapacity(size_t slots) {
+        size_t capacity = 2;
+        while (capacity < slots) capacity <<= 1;
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+    }
+
+    // The calling thread's ring, created and registered on first use
+    Ring& local() {
+        static thread_local Ring* ring = nullptr;
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto owned = std::make_unique<Ring>(capacity_, static_cast<uint32_t>(rings_.size() + 1));
+            ring = owned.get();
+            rings_.push_back(std::move(owned));
+        }
+        return *ring;
+    }
+
+    // Passes every published slot to consume, ring by ring, then hands the slots back to their
+    // producers. Callers serialize drains: each ring has a single consumer.
+    template <typename F>
+    void drain(F&& consume) {
+        for (Ring* ring : snapshot()) {
+            size_t head = ring->head.load(std::memory_order_relaxed);
+            const size_t tail = ring->tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) consume(ring->slots[head & ring->mask]);
+            ring->head.store(head, std::memory_order_release);
+        }
+    }
+
+    // Throws away whatever is buffered; a new session starts from here
+    void discard() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& ring : rings_) {
+            ring->head.store(ring->tail.load(std::memory_order_acquire), std::memory_order_release);
+        }
+    }
+
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = 0;
+        for (const auto& ring : rings_) total += ring->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    std::vector<Ring*> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Ring*> rings;
+        for (const auto& ring : rings_) rings.push_back(ring.get());
+        return rings;
+    }
+
+    mutable std::mutex mutex_;
+    // Rings outlive their threads and survive restarts, so a producer never sees one freed
+    std::vector<std::unique_ptr<Ring>> rings_;
+    size_t capacity_ = 2;
+};
+
+// Background thread that calls flush every interval until stopped
+class PeriodicFlusher {
+public:
+    void start(double interval_ms, std::function<void()> flush) {
+        stopping_ = false;
+        thread_ = std::thread([this, flush = std::move(flush),
+                               interval = std::chrono::microseconds(static_cast<int64_t>(interval_ms * 1000.0))]() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_) {
+                cv_.wait_for(lock, interval);
+                lock.unlock();
+                flush();
+                lock.lock();
+            }
+        });
+    }
+
+    // Wakes the thread and waits for it; what it has not flushed yet is left to the caller
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "utils/PhaseTimer.h"
+
+struct TraceConfig {
+    std::string path;                // Chrome trace (JSON array) output file
+    double sample_rate = 0.01;       // head sampling: share of requests traced regardless of latency
+    double slow_ms = 5.0;            // tail sampling: requests at least this slow are always traced
+    size_t buffer_spans = 4096;      // per-thread ring capacity, rounded up to a power of two
+    double flush_interval_ms = 100.0;
+
+    // BSS_TRACE_FILE enables tracing; BSS_TRACE_SAMPLE_RATE, BSS_TRACE_SLOW_MS
+    static TraceConfig fromEnvironment();
+};
+
+// One completed span. Names and attribute values must be string literals or otherwise
+// outlive the tracer, since only the pointers are buffered.
+struct TraceSpan {
+    const char* name = nullptr;
+    uint64_t trace_id = 0;
+    uint64_t start_ns = 0;           // steady_clock
+    uint64_t duration_ns = 0;
+    const char* option_type = nullptr;
+    const char* engine = nullptr;
+    uint32_t batch_size = 0;
+    uint32_t thread = 0;             // filled in by record()
+};
+
+// Attributes of a /api/calculate request, filled in as the request progresses
+struct RequestSpanAttributes {
+    bool head_sampled = false;
+    uint64_t queue_ns = 0;           // from the server accepting the request to the handler
+    const char* option_type = nullptr;
+    const char* engine = nullptr;
+};
+
+// Span recorder. Each thread appends to its own single-producer ring without locks or
+// allocation; a background thread drains the rings into the trace file. When tracing is off
+// every entry point returns after one atomic load.
+class Tracer {
+public:
+    static bool start(const TraceConfig& config, std::string& error);
+    // Drains the remaining spans, terminates the JSON array and closes the file
+    static void stop();
+
+    static bool enabled() { return enabled_.load(std::memory_order_acquire); }
+
+    // Head sampling decision for a new request
+    static bool sampleHead();
+    static uint64_t newTraceId();
+
+    // Appends a span to this thread's ring, or counts it as dropped when the ring is full
+    static void record(const TraceSpan& span);
+
+    // Records a request and its phases (queue, body, parse, validate, price, serialize) if it
+    // was head-sampled or is slower than the tail threshold
+    static void recordRequest(const PhaseTimer& timer, const RequestSpanAttributes& attributes);
+
+    // Writes everything buffered so far; the background thread calls this periodically
+    static void flush();
+
+    static uint64_t writtenSpans();
+    static uint64_t droppedSpans();
+
+private:
+    static std::atomic<bool> enabled_;
+};
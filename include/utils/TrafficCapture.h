@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct CaptureConfig {
+    std::string path;                // binary capture output file
+    size_t buffer_requests = 1024;   // per-thread ring capacity, rounded up to a power of two
+    double flush_interval_ms = 50.0;
+
+    // BSS_CAPTURE_FILE enables capture; BSS_CAPTURE_BUFFER
+    static CaptureConfig fromEnvironment();
+};
+
+// One request as read back from a capture file
+struct CapturedRequest {
+    uint64_t offset_ns = 0;          // arrival, relative to the start of the capture
+    uint64_t duration_ns = 0;        // until the response was handed to the server
+    uint16_t status = 0;
+    std::string body;
+};
+
+// Records /api/calculate request bodies and timings for replay. Like Tracer, each thread
+// copies into fixed slots of its own single-producer ring without locks or allocation, and a
+// background thread appends the rings to the capture file.
+//
+// File layout, native byte order: the 8-byte magic "BSSCAP1", the capture start as uint64
+// nanoseconds since the Unix epoch, then per request uint64 offset_ns, uint64 duration_ns,
+// uint16 status, uint16 reserved, uint32 body length and the body bytes.
+class TrafficCapture {
+public:
+    static constexpr size_t kMaxBodyBytes = 1024;   // larger bodies are counted as dropped
+
+    static bool start(const CaptureConfig& config, std::string& error);
+    static void stop();
+
+    static bool enabled() { return enabled_.load(std::memory_order_acquire); }
+
+    // started_ns and finished_ns are steady_clock readings (MetricsService::nowNanos)
+    static void record(uint64_t started_ns, uint64_t finished_ns, int status, std::string_view body);
+
+    static void flush();
+
+    static uint64_t capturedRequests();
+    static uint64_t droppedRequests();
+
+    // Reads a capture file, ordered by arrival
+    static bool readFile(const std::string& path, std::vector<CapturedRequest>& requests, std::string& error);
+
+private:
+    static std::atomic<bool> enabled_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <jsoncpp/json/json.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#ifndef BSU_GL_ORDER
+#define BSU_GL_ORDER 32
+#endif
+
+class RoutingTable;
+
+// Numerical tuning knobs of the random expiration engines.
+struct TuningParameters {
+    // Route to GSL QAGIU when sigmaH / H >= gsl_cv_threshold or alpha < gsl_alpha_threshold.
+    // Gauss-Laguerre at 32 nodes stays within 1e-4 below sigmaH / H = 0.5 but loses about 1e-2
+    // by 1, where the density reaches t = 0 and the price is not smooth there.
+    double gsl_cv_threshold = 0.5;
+    double gsl_alpha_threshold = 0.5;
+    // Price as a fixed-maturity option when H / sigmaH >= analytic_shortcut_ratio
+    double analytic_shortcut_ratio = 50.0;
+    int gl_order = BSU_GL_ORDER;
+    double qagiu_epsabs = 1e-9;
+    double qagiu_epsrel = 1e-9;
+    int qagiu_limit = 8192;
+    // Measured engine choices; when set they replace gsl_cv_threshold and gl_order above. The
+    // shortcut ratio and gsl_alpha_threshold still apply first, as they do without a table.
+    std::shared_ptr<const RoutingTable> routing_table;
+
+    uint64_t generation = 0;
+
+    bool validate(std::string& error) const;
+    // Applies the fields present in json on top of this snapshot
+    bool mergeJson(const Json::Value& json, std::string& error);
+    Json::Value toJson() const;
+    std::string fingerprint() const;
+};
+
+// Process-wide tuning snapshot, replaced RCU-style: writers publish a new immutable
+// snapshot, readers keep using the one they loaded until they ask again. A reader can
+// never observe a mix of two configurations.
+class TuningConfig {
+public:
+    static constexpr int kMaxGLOrder = 128;
+    // QAGIU bounds: each thread keeps a workspace of qagiu_limit subintervals, and tolerances
+    // below the floor only make it use all of them
+    static constexpr int kMaxQagiuLimit = 65536;
+    static constexpr double kMinQagiuTolerance = 1e-12;
+    static constexpr double kMaxQagiuTolerance = 1e-3;
+
+    // Snapshot for the calling thread. The reference stays valid until the same thread
+    // calls current() again, so take it once per pricing call.
+    static const TuningParameters& current();
+
+    static std::shared_ptr<const TuningParameters> snapshot();
+
+    // Validates and publishes a new snapshot; the generation is assigned here.
+    static bool publish(TuningParameters params, std::string& error);
+
+    // Fields the file omits keep their values in params
+    static bool loadFile(const std::string& path, TuningParameters& params, std::string& error);
+
+private:
+    static std::shared_ptr<const TuningParameters>& global();
+    static std::atomic<uint64_t> generation_;
+};
@@ -0,0 +1,298 @@
+#include "capi/blackscholes.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/TuningConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+
+namespace {
+
+using BlackScholesUtil::PricingDiagnostics;
+using BlackScholesUtil::PricingEngine;
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Copies text into a caller buffer, truncated and NUL-terminated
+void copyOut(const std::string& text, char* buffer, size_t size) {
+    if (!buffer || size == 0) return;
+    const size_t n = std::min(text.size(), size - 1);
+    std::memcpy(buffer, text.data(), n);
+    buffer[n] = '\0';
+}
+
+bool positive(double value) {
+    return std::isfinite(value) && value > 0;
+}
+
+// The /api/calculate rules for the option's type
+bool validOption(const bs_option& option) {
+    if (option.reserved != 0) return false;
+    if (!positive(option.stock_price) || !positive(option.strike_price) || !positive(option.volatility) ||
+        !std::isfinite(option.risk_free_rate)) {
+        return false;
+    }
+    switch (option.type) {
+        case BS_REGULAR:
+        case BS_BINARY:
+            return positive(option.time_to_maturity);
+        case BS_RANDOM_EXPIRATION_CALL:
+        case BS_RANDOM_EXPIRATION_BINARY_CALL:
+            return positive(option.holding_period) &&
+                   (std::isnan(option.volatility_around_holding_period) ||
+                    positive(option.volatility_around_holding_period));
+    }
+    return false;
+}
+
+bool validEngineOptions(const bs_engine_options* engine_options) {
+    if (!engine_options) return true;
+    return engine_options->engine >= BS_ENGINE_AUTO && engine_options->engine <= BS_ENGINE_GSL_QAGIU &&
+           (engine_options->gl_order == 0 ||
+            (engine_options->gl_order >= 2 && engine_options->gl_order <= TuningConfig::kMaxGLOrder)) &&
+           std::isfinite(engine_options->qagiu_tolerance) && engine_options->qagiu_tolerance >= 0;
+}
+
+bool forcedEngine(const bs_engine_options* engine_options) {
+    return engine_options && engine_options->engine != BS_ENGINE_AUTO;
+}
+
+PricingEngine toEngine(int32_t engine) {
+    return static_cast<PricingEngine>(engine - BS_ENGINE_CLOSED_FORM);
+}
+
+int32_t fromEngine(PricingEngine engine) {
+    return static_cast<int32_t>(engine) + BS_ENGINE_CLOSED_FORM;
+}
+
+double dispersion(const bs_option& option) {
+    return std::isnan(option.volatility_around_holding_period) ? option.holding_period
+                                                               : option.volatility_around_holding_period;
+}
+
+void fillDiagnostics(const PricingDiagnostics& source, bs_diagnostics* diagnostics) {
+    if (!diagnostics) return;
+    diagnostics->engine = fromEngine(source.engine);
+    diagnostics->evaluations = source.evaluations;
+    diagnostics->abs_error = source.abs_error;
+    diagnostics->alpha = source.alpha;
+    diagnostics->beta = source.beta;
+}
+
+// What is known about a price from a forced engine, which does not report its work
+void forcedDiagnostics(const bs_option& option, const bs_engine_options& engine_options,
+                       bs_diagnostics* diagnostics) {
+    if (!diagnostics) return;
+    const PricingEngine engine = toEngine(engine_options.engine);
+    diagnostics->engine = engine_options.engine;
+    diagnostics->evaluations = 0;
+    diagnostics->abs_error = kNaN;
+    diagnostics->alpha = kNaN;
+    diagnostics->beta = kNaN;
+    if (engine == PricingEngine::GAUSS_LAGUERRE || engine == PricingEngine::GSL_QAGIU) {
+        const double sigmaH = dispersion(option);
+        const double var_t = std::max(sigmaH * sigmaH, 1e-12);
+        diagnostics->alpha = std::max(option.holding_period * option.holding_period / var_t, 1e-12);
+        diagnostics->beta = option.holding_period / var_t;
+    }
+    if (engine == PricingEngine::GAUSS_LAGUERRE) {
+        diagnostics->evaluations = engine_options.gl_order > 0 ? engine_options.gl_order : TuningConfig::current().gl_order;
+    }
+}
+
+bs_status priceOne(const bs_option* option, const bs_engine_options* engine_options,
+                   double* price, bs_diagnostics* diagnostics) {
+    if (!option || !validOption(*option) || !validEngineOptions(engine_options)) {
+        return BS_INVALID_ARGUMENT;
+    }
+
+    const bs_option& o = *option;
+    const bool binary = (o.type == BS_BINARY || o.type == BS_RANDOM_EXPIRATION_BINARY_CALL);
+    double value;
+    if (o.type == BS_REGULAR || o.type == BS_BINARY) {
+        value = binary ? BlackScholesUtil::calculateBinaryCall(o.stock_price, o.strike_price, o.time_to_maturity,
+                                                               o.volatility, o.risk_free_rate)
+                       : BlackScholesUtil::calculateStandardCall(o.stock_price, o.strike_price, o.time_to_maturity,
+                                                                 o.volatility, o.risk_free_rate);
+        fillDiagnostics(PricingDiagnostics{}, diagnostics);
+    } else if (forcedEngine(engine_options)) {
+        value = BlackScholesUtil::priceRandomExpirationWithEngine(
+            toEngine(engine_options->engine), binary, o.stock_price, o.strike_price, o.volatility,
+            o.risk_free_rate, o.holding_period, dispersion(o), engine_options->gl_order,
+            engine_options->qagiu_tolerance);
+        forcedDiagnostics(o, *engine_options, diagnostics);
+    } else {
+        PricingDiagnostics routed;
+        value = binary ? BlackScholesUtil::calculateRandomExpirationBinaryCall(
+                             o.stock_price, o.strike_price, o.volatility, o.risk_free_rate,
+                             o.holding_period, dispersion(o), &routed)
+                       : BlackScholesUtil::calculateRandomExpirationCall(
+                             o.stock_price, o.strike_price, o.volatility, o.risk_free_rate,
+                             o.holding_period, dispersion(o), &routed);
+        fillDiagnostics(routed, diagnostics);
+    }
+
+    *price = value;
+    return std::isfinite(value) ? BS_OK : BS_NUMERICAL_ERROR;
+}
+
+} // namespace
+
+extern "C" {
+
+int32_t bs_api_version(void) {
+    return BS_API_VERSION;
+}
+
+size_t bs_engine_version(char* buffer, size_t size) {
+    try {
+        const std::string version = BlackScholesUtil::engineVersion();
+        copyOut(version, buffer, size);
+        return version.size();
+    } catch (...) {
+        copyOut("", buffer, size);
+        return 0;
+    }
+}
+
+const char* bs_status_string(int32_t status) {
+    switch (status) {
+        case BS_OK:               return "ok";
+        case BS_INVALID_ARGUMENT: return "invalid argument";
+        case BS_NUMERICAL_ERROR:  return "numerical error";
+        case BS_INTERNAL_ERROR:   return "internal error";
+    }
+    return "unknown status";
+}
+
+const char* bs_engine_name(int32_t engine) {
+    if (engine == BS_ENGINE_AUTO) return "auto";
+    if (engine < BS_ENGINE_CLOSED_FORM || engine > BS_ENGINE_GSL_QAGIU) return "unknown";
+    return BlackScholesUtil::engineName(toEngine(engine));
+}
+
+bs_status bs_load_tuning(const char* path, char* error, size_t error_size) {
+    if (!path) {
+        copyOut("path is null", error, error_size);
+        return BS_INVALID_ARGUMENT;
+    }
+    try {
+        TuningParameters params;
+        std::string message;
+        if (!TuningConfig::loadFile(path, params, message) || !TuningConfig::publish(params, message)) {
+            copyOut(message, error, error_size);
+            return BS_INVALID_ARGUMENT;
+        }
+        copyOut("", error, error_size);
+        return BS_OK;
+    } catch (const std::exception& e) {
+        copyOut(e.what(), error, error_size);
+        return BS_INTERNAL_ERROR;
+    }
+}
+
+bs_status bs_price(const bs_option* option, const bs_engine_options* engine_options,
+                   double* price, bs_diagnostics* diagnostics) {
+    if (!price) return BS_INVALID_ARGUMENT;
+    *price = kNaN;
+    try {
+        return priceOne(option, engine_options, price, diagnostics);
+    } catch (...) {
+        *price = kNaN;
+        return BS_INTERNAL_ERROR;
+    }
+}
+
+bs_status bs_price_batch(const bs_option* options, size_t count,
+                         const bs_engine_options* engine_options,
+                         double* prices, int32_t* statuses) {
+    if (count == 0) return BS_OK;
+    if (!options || !prices) return BS_INVALID_ARGUMENT;
+
+    bs_status first = BS_OK;
+    for (size_t i = 0; i < count; ++i) {
+        const bs_status status = bs_price(&options[i], engine_options, &prices[i], nullptr);
+        if (status != BS_OK) {
+            prices[i] = kNaN;
+            if (first == BS_OK) first = status;
+        }
+        if (statuses) statuses[i] = status;
+    }
+    return first;
+}
+
+bs_status bs_price_chain(double stock_price, double risk_free_rate,
+                         const double* strikes, size_t strike_count,
+                         const double* maturities, size_t maturity_count,
+                         const double* volatilities, double* prices) {
+    const size_t cells = strike_count * maturity_count;
+    if (cells == 0) return BS_OK;
+    if (!strikes || !maturities || !volatilities || !prices) return BS_INVALID_ARGUMENT;
+    if (strike_count != cells / maturity_count) return BS_INVALID_ARGUMENT;   // the grid size overflows
+
+    bool valid = positive(stock_price) && std::isfinite(risk_free_rate);
+    for (size_t j = 0; valid && j < strike_count; ++j) valid = positive(strikes[j]);
+    for (size_t m = 0; valid && m < maturity_count; ++m) valid = positive(maturities[m]);
+    for (size_t i = 0; valid && i < cells; ++i) valid = positive(volatilities[i]);
+    if (!valid) {
+        std::fill(prices, prices + cells, kNaN);
+        return BS_INVALID_ARGUMENT;
+    }
+
+    try {
+        BlackScholesUtil::calculateStandardCallChain(stock_price, risk_free_rate, strikes, strike_count,
+                                                     maturities, maturity_count, volatilities, prices);
+    } catch (...) {
+        std::fill(prices, prices + cells, kNaN);
+        return BS_INTERNAL_ERROR;
+    }
+    for (size_t i = 0; i < cells; ++i) {
+        if (!std::isfinite(prices[i])) return BS_NUMERICAL_ERROR;
+    }
+    return BS_OK;
+}
+
+bs_status bs_compute_greeks(const bs_option* option, const bs_engine_options* engine_options,
+                            bs_greeks* greeks, bs_diagnostics* diagnostics) {
+    if (!greeks || !option || !validOption(*option) || !validEngineOptions(engine_options)) {
+        return BS_INVALID_ARGUMENT;
+    }
+    try {
+        const bs_option& o = *option;
+        const bool binary = (o.type == BS_BINARY || o.type == BS_RANDOM_EXPIRATION_BINARY_CALL);
+        BlackScholesUtil::Greeks result;
+        if (o.type == BS_REGULAR || o.type == BS_BINARY) {
+            result = binary ? BlackScholesUtil::calculateBinaryCallGreeks(o.stock_price, o.strike_price, o.time_to_maturity,
+                                                                          o.volatility, o.risk_free_rate)
+                            : BlackScholesUtil::calculateStandardCallGreeks(o.stock_price, o.strike_price, o.time_to_maturity,
+                                                                            o.volatility, o.risk_free_rate);
+            fillDiagnostics(PricingDiagnostics{}, diagnostics);
+        } else if (forcedEngine(engine_options)) {
+            result = BlackScholesUtil::greeksRandomExpirationWithEngine(
+                toEngine(engine_options->engine), binary, o.stock_price, o.strike_price, o.volatility,
+                o.risk_free_rate, o.holding_period, dispersion(o), engine_options->gl_order,
+                engine_options->qagiu_tolerance);
+            forcedDiagnostics(o, *engine_options, diagnostics);
+        } else {
+            PricingDiagnostics routed;
+            result = binary ? BlackScholesUtil::calculateRandomExpirationBinaryCallGreeks(
+                                  o.stock_price, o.strike_price, o.volatility, o.risk_free_rate,
+                                  o.holding_period, dispersion(o), &routed)
+                            : BlackScholesUtil::calculateRandomExpirationCallGreeks(
+                                  o.stock_price, o.strike_price, o.volatility, o.risk_free_rate,
+                                  o.holding_period, dispersion(o), &routed);
+            fillDiagnostics(routed, diagnostics);
+        }
+
+        *greeks = bs_greeks{result.delta, result.gamma, result.vega, result.theta, result.rho};
+        const bool finite = std::isfinite(result.delta) && std::isfinite(result.gamma) &&
+                            std::isfinite(result.vega) && std::isfinite(result.theta) && std::isfinite(result.rho);
+        return finite ? BS_OK : BS_NUMERICAL_ERROR;
+    } catch (...) {
+        return BS_INTERNAL_ERROR;
+    }
+}
+
+} // extern "C"
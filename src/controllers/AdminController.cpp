@@ -0,0 +1,72 @@
+#include "controllers/AdminController.h"
+#include "services/AutotuneService.h"
+#include "services/TuningService.h"
+#include "utils/ControllerUtils.h"
+#include "utils/TuningConfig.h"
+
+bool AdminController::authorize(const HttpRequestPtr& req,
+                                const std::function<void(const HttpResponsePtr&)>& callback) const {
+    const std::string expected = "Bearer " + token_;
+    const std::string& given = req->getHeader("Authorization");
+    // Compares every byte whatever the first mismatch, so timing does not reveal the token
+    unsigned char diff = given.size() == expected.size() ? 0 : 1;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        diff |= static_cast<unsigned char>(expected[i] ^ (i < given.size() ? given[i] : 0));
+    }
+    if (diff == 0) return true;
+
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+    resp->setStatusCode(k401Unauthorized);
+    resp->setBody(ControllerUtils::createErrorResponse("Missing or wrong admin token", 401).toStyledString());
+    callback(resp);
+    return false;
+}
+
+void AdminController::getTuning(const HttpRequestPtr& req,
+                                std::function<void(const HttpResponsePtr&)>&& callback) {
+    if (!authorize(req, callback)) return;
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+    resp->setBody(ControllerUtils::createSuccessResponse(TuningConfig::snapshot()->toJson()).toStyledString());
+    callback(resp);
+}
+
+void AdminController::updateTuning(const HttpRequestPtr& req,
+                                   std::function<void(const HttpResponsePtr&)>&& callback) {
+    if (!authorize(req, callback)) return;
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+
+    Json::Value body;
+    Json::Reader reader;
+    std::string requestBody(req->getBody());
+    if (!reader.parse(requestBody, body)) {
+        auto errorResponse = ControllerUtils::createErrorResponse("Invalid JSON format", 400);
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(errorResponse.toStyledString());
+        callback(resp);
+        return;
+    }
+
+    std::string error;
+    if (!TuningService::applyJson(body, error)) {
+        auto errorResponse = ControllerUtils::createErrorResponse(error, 400);
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(errorResponse.toStyledString());
+        callback(resp);
+        return;
+    }
+
+    resp->setBody(ControllerUtils::createSuccessResponse(TuningConfig::snapshot()->toJson()).toStyledString());
+    callback(resp);
+}
+
+void AdminController::getAutotune(const HttpRequestPtr& req,
+                                  std::function<void(const HttpResponsePtr&)>&& callback) {
+    if (!authorize(req, callback)) return;
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+    resp->setBody(ControllerUtils::createSuccessResponse(AutotuneService::report()).toStyledString());
+    callback(resp);
+}
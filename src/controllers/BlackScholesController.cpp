@@ -1,6 +1,15 @@
 #include "controllers/BlackScholesController.h"
 #include "utils/ControllerUtils.h"
 #include "requests/BlackScholesRequestDto.h"
+#include "services/MetricsService.h"
+#include "services/ResultCache.h"
+#include "utils/AllocationTracker.h"
+#include "utils/ClusterRouter.h"
+#include "utils/SlowRequestLog.h"
+#include "utils/TrafficCapture.h"
+#include <chrono>
+#include <ctime>
+#include <memory>
 #include <stdexcept>
 
 #ifdef TEST_MODE
@@ -22,6 +31,24 @@ namespace TestBlackScholesService {
 
 void BlackScholesController::calculate(const HttpRequestPtr& req, 
                                        std::function<void(const HttpResponsePtr&)>&& callback) {
+    // Every exit path below answers through callback, so wrapping it here closes the request timer.
+    const uint64_t started = MetricsService::requestStarted();
+    HttpRequestPtr captured = TrafficCapture::enabled() ? req : HttpRequestPtr();
+    callback = [inner = std::move(callback), started, captured](const HttpResponsePtr& response) {
+        MetricsService::requestFinished(started, response->statusCode());
+        if (captured) {
+            TrafficCapture::record(started, MetricsService::nowNanos(), response->statusCode(), captured->getBody());
+        }
+        inner(response);
+    };
+    RequestContext context;
+    if (Tracer::enabled() || SlowRequestLog::enabled()) {
+        context.trace.head_sampled = Tracer::sampleHead();
+        const int64_t queued_us = trantor::Date::now().microSecondsSinceEpoch() -
+                                  req->creationDate().microSecondsSinceEpoch();
+        context.trace.queue_ns = queued_us > 0 ? static_cast<uint64_t>(queued_us) * 1000 : 0;
+    }
+    
     auto resp = HttpResponse::newHttpResponse();
     resp->setContentTypeCode(CT_APPLICATION_JSON);
     
@@ -29,101 +56,238 @@ void BlackScholesController::calculate(const HttpRequestPtr& req,
         Json::Value body;
         Json::Reader reader;
         std::string requestBody(req->getBody());
+        context.timer.mark(RequestPhase::BODY);
         if (!reader.parse(requestBody, body)) {
+            context.timer.mark(RequestPhase::PARSE);
+            MetricsService::recordError(RequestError::INVALID_JSON);
             auto errorResponse = ControllerUtils::createErrorResponse("Invalid JSON format", 400);
             resp->setStatusCode(k400BadRequest);
             resp->setBody(errorResponse.toStyledString());
-            callback(resp);
+            sendTimed(resp, context, callback);
             return;
         }
+        context.timer.mark(RequestPhase::PARSE);
         
         std::string error;
         auto dto = dto::BlackScholesRequestDto::fromJson(body, error);
+        context.timer.mark(RequestPhase::VALIDATE);
         if (!dto) {
+            MetricsService::recordError(RequestError::INVALID_REQUEST);
             auto errorResponse = ControllerUtils::createErrorResponse(error, 400);
             resp->setStatusCode(k400BadRequest);
             resp->setBody(errorResponse.toStyledString());
-            callback(resp);
+            sendTimed(resp, context, callback);
+            return;
+        }
+        MetricsService::recordRequest(dto->getOptionType());
+        context.trace.option_type = dto::optionTypeName(dto->getOptionType());
+        
+        std::string owner = routeOwner(req, *dto);
+        if (!owner.empty()) {
+            // Another node owns this request's cache key; fall back to local pricing if it fails.
+            // The handlers share a copy of the callback, so callback still answers the request
+            // if forward throws before it goes out.
+            auto shared_callback = std::make_shared<std::function<void(const HttpResponsePtr&)>>(callback);
+            auto forwarded = std::make_shared<dto::BlackScholesRequestDto>(*dto);
+            ClusterRouter::forward(owner, req,
+                [shared_callback, forwarded, context](const HttpResponsePtr& peerResp) mutable {
+                    // The peer's round trip stands in for pricing
+                    context.timer.mark(RequestPhase::PRICE);
+                    context.trace.engine = "forwarded";
+                    context.request = forwarded.get();
+                    auto relayed = HttpResponse::newHttpResponse();
+                    relayed->setContentTypeCode(CT_APPLICATION_JSON);
+                    relayed->setStatusCode(peerResp->statusCode());
+                    relayed->setBody(std::string(peerResp->getBody()));
+                    context.timer.mark(RequestPhase::SERIALIZE);
+                    sendTimed(relayed, context, *shared_callback);
+                },
+                [shared_callback, forwarded, context]() mutable {
+                    MetricsService::recordError(RequestError::FORWARD_FAILED);
+                    respondWithPrice(*forwarded, *shared_callback, context);
+                });
             return;
         }
         
-        switch (dto->getOptionType()) {
+        respondWithPrice(*dto, callback, context);
+        
+    } catch (const std::exception& e) {
+        auto errorResponse = ControllerUtils::createErrorResponse(e.what(), 500);
+        resp->setStatusCode(k500InternalServerError);
+        resp->setBody(errorResponse.toStyledString());
+        sendTimed(resp, context, callback);
+    }
+}
+
+std::string BlackScholesController::routeOwner(const HttpRequestPtr& req, const dto::BlackScholesRequestDto& dto) {
+    if (!ClusterRouter::enabled() || !req->getHeader(ClusterRouter::kForwardedHeader).empty()) {
+        return std::string();
+    }
+    
+    // Only the random expiration types are worth a network hop; closed forms are cheaper to recompute.
+    ResultCacheKey::Kind kind;
+    switch (dto.getOptionType()) {
+        case dto::OptionType::RANDOM_EXPIRATION_CALL:
+            kind = ResultCacheKey::RANDOM_EXPIRATION_CALL;
+            break;
+        case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL:
+            kind = ResultCacheKey::RANDOM_EXPIRATION_BINARY_CALL;
+            break;
+        default:
+            return std::string();
+    }
+    
+    auto key = ResultCacheKey::make(kind, dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(),
+                                    dto.getRiskFreeRate(), dto.getHoldingPeriod().value(),
+                                    dto.getVolatilityAroundHoldingPeriod().value());
+    return ClusterRouter::ownerFor(key.hash());
+}
+
+void BlackScholesController::respondWithPrice(const dto::BlackScholesRequestDto& dto,
+                                              const std::function<void(const HttpResponsePtr&)>& callback,
+                                              RequestContext& context) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+    context.request = &dto;
+    
+    try {
+        Json::Value data;
+        switch (dto.getOptionType()) {
             case dto::OptionType::RANDOM_EXPIRATION_CALL: {
 #ifdef TEST_MODE
                 RandomExpirationCallOption result = TestBlackScholesService::calculateRandomExpirationCall(
-                    dto->getStockPrice(), dto->getStrikePrice(), dto->getVolatility(), dto->getRiskFreeRate(),
-                    dto->getHoldingPeriod().value(), dto->getVolatilityAroundHoldingPeriod().value());
+                    dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(), dto.getRiskFreeRate(),
+                    dto.getHoldingPeriod().value(), dto.getVolatilityAroundHoldingPeriod().value());
 #else
                 RandomExpirationCallOption result = BlackScholesService::calculateRandomExpirationCall(
-                    dto->getStockPrice(), dto->getStrikePrice(), dto->getVolatility(), dto->getRiskFreeRate(),
-                    dto->getHoldingPeriod().value(), dto->getVolatilityAroundHoldingPeriod().value());
+                    dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(), dto.getRiskFreeRate(),
+                    dto.getHoldingPeriod().value(), dto.getVolatilityAroundHoldingPeriod().value());
 #endif
-                Json::Value data;
                 data["type"] = result.type;
                 data["value"] = result.value;
                 data["holding_period"] = result.holding_period;
                 data["volatility_around_holding_period"] = result.volatility_around_holding_period;
-                auto response = ControllerUtils::createSuccessResponse(data);
-                resp->setBody(response.toStyledString());
-                callback(resp);
-                return;
+                if (dto.wantsDiagnostics()) {
+                    data["diagnostics"] = ControllerUtils::createDiagnostics(result.diagnostics, result.cached);
+                }
+                context.trace.engine = result.cached ? "result_cache" : BlackScholesUtil::engineName(result.diagnostics.engine);
+                context.diagnostics = result.diagnostics;
+                context.cached = result.cached;
+                break;
             }
             
             case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL: {
 #ifdef TEST_MODE
                 RandomExpirationCallOption result = TestBlackScholesService::calculateRandomExpirationBinaryCall(
-                    dto->getStockPrice(), dto->getStrikePrice(), dto->getVolatility(), dto->getRiskFreeRate(),
-                    dto->getHoldingPeriod().value(), dto->getVolatilityAroundHoldingPeriod().value());
+                    dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(), dto.getRiskFreeRate(),
+                    dto.getHoldingPeriod().value(), dto.getVolatilityAroundHoldingPeriod().value());
 #else
                 RandomExpirationCallOption result = BlackScholesService::calculateRandomExpirationBinaryCall(
-                    dto->getStockPrice(), dto->getStrikePrice(), dto->getVolatility(), dto->getRiskFreeRate(),
-                    dto->getHoldingPeriod().value(), dto->getVolatilityAroundHoldingPeriod().value());
+                    dto.getStockPrice(), dto.getStrikePrice(), dto.getVolatility(), dto.getRiskFreeRate(),
+                    dto.getHoldingPeriod().value(), dto.getVolatilityAroundHoldingPeriod().value());
 #endif
-                Json::Value data;
                 data["type"] = result.type;
                 data["value"] = result.value;
                 data["holding_period"] = result.holding_period;
                 data["volatility_around_holding_period"] = result.volatility_around_holding_period;
-                auto response = ControllerUtils::createSuccessResponse(data);
-                resp->setBody(response.toStyledString());
-                callback(resp);
-                return;
+                if (dto.wantsDiagnostics()) {
+                    data["diagnostics"] = ControllerUtils::createDiagnostics(result.diagnostics, result.cached);
+                }
+                context.trace.engine = result.cached ? "result_cache" : BlackScholesUtil::engineName(result.diagnostics.engine);
+                context.diagnostics = result.diagnostics;
+                context.cached = result.cached;
+                break;
             }
             
             case dto::OptionType::BINARY:
             case dto::OptionType::REGULAR: {
                 CallOption result;
-                if (dto->getOptionType() == dto::OptionType::BINARY) {
+                if (dto.getOptionType() == dto::OptionType::BINARY) {
 #ifdef TEST_MODE
-                    result = TestBlackScholesService::calculateBinaryCall(dto->getStockPrice(), dto->getStrikePrice(),
-                                                                   dto->getTimeToMaturity().value(), dto->getVolatility(), dto->getRiskFreeRate());
+                    result = TestBlackScholesService::calculateBinaryCall(dto.getStockPrice(), dto.getStrikePrice(),
+                                                                   dto.getTimeToMaturity().value(), dto.getVolatility(), dto.getRiskFreeRate());
 #else
-                    result = BlackScholesService::calculateBinaryCall(dto->getStockPrice(), dto->getStrikePrice(),
-                                                                   dto->getTimeToMaturity().value(), dto->getVolatility(), dto->getRiskFreeRate());
+                    result = BlackScholesService::calculateBinaryCall(dto.getStockPrice(), dto.getStrikePrice(),
+                                                                   dto.getTimeToMaturity().value(), dto.getVolatility(), dto.getRiskFreeRate());
 #endif
                 } else {
 #ifdef TEST_MODE
-                    result = TestBlackScholesService::calculateRegularCall(dto->getStockPrice(), dto->getStrikePrice(),
-                                                                    dto->getTimeToMaturity().value(), dto->getVolatility(), dto->getRiskFreeRate());
+                    result = TestBlackScholesService::calculateRegularCall(dto.getStockPrice(), dto.getStrikePrice(),
+                                                                    dto.getTimeToMaturity().value(), dto.getVolatility(), dto.getRiskFreeRate());
 #else
-                    result = BlackScholesService::calculateRegularCall(dto->getStockPrice(), dto->getStrikePrice(),
-                                                                    dto->getTimeToMaturity().value(), dto->getVolatility(), dto->getRiskFreeRate());
+                    result = BlackScholesService::calculateRegularCall(dto.getStockPrice(), dto.getStrikePrice(),
+                                                                    dto.getTimeToMaturity().value(), dto.getVolatility(), dto.getRiskFreeRate());
 #endif
                 }
-                Json::Value data;
                 data["type"] = result.type;
                 data["value"] = result.value;
-                auto response = ControllerUtils::createSuccessResponse(data);
-                resp->setBody(response.toStyledString());
-                callback(resp);
+                if (dto.wantsDiagnostics()) {
+                    data["diagnostics"] = ControllerUtils::createDiagnostics(BlackScholesUtil::PricingDiagnostics{}, false);
+                }
+                context.trace.engine = BlackScholesUtil::engineName(BlackScholesUtil::PricingEngine::CLOSED_FORM);
                 break;
             }
         }
         
+        auto response = ControllerUtils::createSuccessResponse(data);
+        context.timer.mark(RequestPhase::PRICE);
+        resp->setBody(response.toStyledString());
+        context.timer.mark(RequestPhase::SERIALIZE);
+        sendTimed(resp, context, callback);
+        
     } catch (const std::exception& e) {
+        context.timer.mark(RequestPhase::PRICE);
         auto errorResponse = ControllerUtils::createErrorResponse(e.what(), 500);
         resp->setStatusCode(k500InternalServerError);
         resp->setBody(errorResponse.toStyledString());
-        callback(resp);
+        sendTimed(resp, context, callback);
     }
 }
+
+void BlackScholesController::sendTimed(const HttpResponsePtr& resp, const RequestContext& context,
+                                       const std::function<void(const HttpResponsePtr&)>& callback) {
+    MetricsService::recordPhases(context.timer);
+    Tracer::recordRequest(context.timer, context.trace);
+    if (SlowRequestLog::enabled()) {
+        logIfSlow(context, resp->statusCode());
+    }
+    if (PhaseTimer::serverTimingEnabled()) {
+        resp->addHeader("Server-Timing", context.timer.serverTiming());
+    }
+    callback(resp);
+}
+
+void BlackScholesController::logIfSlow(const RequestContext& context, int status_code) {
+    // Requests rejected before pricing have nothing to replay
+    if (!context.request) return;
+
+    uint64_t total_ns = context.trace.queue_ns;
+    Json::Value phases;
+    Json::Value allocations;
+    for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        if (!context.timer.reached(phase)) continue;
+        total_ns += context.timer.nanos(phase);
+        phases[PhaseTimer::phaseName(phase)] = context.timer.nanos(phase) * 1e-6;
+        allocations[PhaseTimer::phaseName(phase)] = Json::UInt64(context.timer.allocations(phase).allocations);
+    }
+    if (total_ns < SlowRequestLog::thresholdNanos()) return;
+
+    char timestamp[32];
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc;
+    gmtime_r(&now, &utc);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+    Json::Value record;
+    record["time"] = timestamp;
+    record["status"] = status_code;
+    record["total_ms"] = total_ns * 1e-6;
+    record["queue_ms"] = context.trace.queue_ns * 1e-6;
+    record["phases_ms"] = phases;
+    if (AllocationTracker::enabled()) record["phase_allocations"] = allocations;
+    record["engine"] = context.trace.engine ? context.trace.engine : "none";
+    record["diagnostics"] = ControllerUtils::createDiagnostics(context.diagnostics, context.cached);
+    record["request"] = context.request->toJson();
+    SlowRequestLog::submit(std::move(record));
+}
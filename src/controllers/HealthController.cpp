@@ -0,0 +1,24 @@
+#include "controllers/HealthController.h"
+#include "services/WarmupService.h"
+#include "utils/ControllerUtils.h"
+
+void HealthController::ready(const HttpRequestPtr& req,
+                             std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+
+    Json::Value data;
+    data["ready"] = WarmupService::isReady();
+    data["warmed_threads"] = static_cast<Json::UInt64>(WarmupService::warmedThreads());
+    data["total_threads"] = static_cast<Json::UInt64>(WarmupService::totalThreads());
+
+    if (WarmupService::isReady()) {
+        resp->setBody(ControllerUtils::createSuccessResponse(data).toStyledString());
+    } else {
+        auto errorResponse = ControllerUtils::createErrorResponse("Warmup in progress", 503);
+        errorResponse["data"] = data;
+        resp->setStatusCode(k503ServiceUnavailable);
+        resp->setBody(errorResponse.toStyledString());
+    }
+    callback(resp);
+}
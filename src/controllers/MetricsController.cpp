@@ -0,0 +1,28 @@
+#include "controllers/MetricsController.h"
+#include "services/MetricsService.h"
+#include "utils/ControllerUtils.h"
+#include "utils/PerfCounters.h"
+
+void MetricsController::metrics(const HttpRequestPtr& req,
+                                std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCodeAndCustomString(CT_TEXT_PLAIN, "text/plain; version=0.0.4; charset=utf-8");
+    resp->setBody(MetricsService::renderPrometheus());
+    callback(resp);
+}
+
+void MetricsController::perfCounters(const HttpRequestPtr& req,
+                                     std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+    resp->setBody(ControllerUtils::createSuccessResponse(PerfCounters::toJson()).toStyledString());
+    callback(resp);
+}
+
+void MetricsController::allocations(const HttpRequestPtr& req,
+                                    std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(CT_APPLICATION_JSON);
+    resp->setBody(ControllerUtils::createSuccessResponse(MetricsService::allocationsJson()).toStyledString());
+    callback(resp);
+}
@@ -1,9 +1,161 @@
 #include <drogon/drogon.h>
+#include <cstdlib>
+#include <iostream>
+#include "controllers/AdminController.h"
 #include "controllers/BlackScholesController.h"
+#include "controllers/HealthController.h"
+#include "controllers/MetricsController.h"
+#include "services/AutotuneService.h"
+#include "services/ResultCache.h"
+#include "services/TuningService.h"
+#include "services/WarmupService.h"
+#include "utils/AllocationTracker.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/ClusterRouter.h"
+#include "utils/MappedStore.h"
+#include "utils/PerfCounters.h"
+#include "utils/PhaseTimer.h"
+#include "utils/SlowRequestLog.h"
+#include "utils/Tracer.h"
+#include "utils/TrafficCapture.h"
+
+namespace {
+
+size_t envSize(const char* name, size_t fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+// Largest Gauss-Laguerre order whose node table fits a persistent table slot
+const size_t kMaxStoredGLOrder = 128;
+
+// Opens the persistent result and node-table stores under BSS_STORE_DIR, if set.
+void openPersistentStores(MappedStore& results, MappedStore& tables) {
+    const char* dir = std::getenv("BSS_STORE_DIR");
+    if (!dir) return;
+
+    std::string error;
+    const std::string base(dir);
+    if (results.open(base + "/results.bss", envSize("BSS_STORE_RESULT_SLOTS", 1 << 18), 64,
+                     BlackScholesUtil::engineVersion(), error)) {
+        ResultCache::instance().attachStore(&results);
+    } else {
+        std::cerr << "Persistent result store disabled: " << error << std::endl;
+    }
+
+    error.clear();
+    if (tables.open(base + "/gl_tables.bss", envSize("BSS_STORE_TABLE_SLOTS", 4096),
+                    16 + 2 * sizeof(double) * kMaxStoredGLOrder, "gl-nodes-2", error)) {
+        BlackScholesUtil::setGLTableStore(&tables);
+    } else {
+        std::cerr << "Persistent node table store disabled: " << error << std::endl;
+    }
+}
+
+// Loads BSS_TUNING_FILE, if set, and polls it for changes every BSS_TUNING_POLL_SECONDS.
+void watchTuningFile() {
+    const char* path = std::getenv("BSS_TUNING_FILE");
+    if (!path) return;
+
+    std::string error;
+    if (!TuningService::reloadFile(path, error)) {
+        std::cerr << "Tuning file not applied: " << error << std::endl;
+    }
+
+    const char* poll = std::getenv("BSS_TUNING_POLL_SECONDS");
+    const double interval = poll ? std::atof(poll) : 2.0;
+    const std::string file(path);
+    drogon::app().getLoop()->runEvery(interval, [file]() {
+        std::string reload_error;
+        if (!TuningService::reloadIfChanged(file, reload_error) && !reload_error.empty()) {
+            std::cerr << "Tuning reload failed: " << reload_error << std::endl;
+        }
+    });
+}
+
+// Warms every IO thread once the listeners are up; /ready flips once all have finished.
+void scheduleWarmup(const WarmupConfig& config) {
+    const size_t threads = drogon::app().getThreadNum();
+    WarmupService::begin(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        drogon::app().getIOLoop(i)->queueInLoop([config]() {
+            WarmupService::warmCurrentThread(config);
+            WarmupService::threadWarmed();
+        });
+    }
+}
+
+} // namespace
 
 int main() {
+    const char* port = std::getenv("BSS_PORT");
+    ResultCache::instance().setCapacity(envSize("BSS_RESULT_CACHE_CAPACITY", ResultCache::kDefaultCapacity));
+    ClusterRouter::configure(ClusterConfig::fromEnvironment());
+    PhaseTimer::calibrate();
+
+    // Ahead of the counters, tracing and capture so its benchmarks are not recorded, and ahead
+    // of the tuning file, which layers on top of the autotuned values
+    const AutotuneConfig autotune = AutotuneConfig::fromEnvironment();
+    if (autotune.enabled) {
+        AutotuneResult autotuned;
+        std::string autotune_error;
+        if (!AutotuneService::run(autotune, autotuned, autotune_error)) {
+            std::cerr << "Autotuning disabled: " << autotune_error << std::endl;
+        }
+    }
+
+    const char* server_timing = std::getenv("BSS_SERVER_TIMING");
+    PhaseTimer::setServerTimingEnabled(server_timing && std::atoi(server_timing) != 0);
+    const char* perf_counters = std::getenv("BSS_PERF_COUNTERS");
+    PerfCounters::setEnabled(perf_counters && std::atoi(perf_counters) != 0);
+    const char* allocation_tracking = std::getenv("BSS_ALLOCATION_TRACKING");
+    AllocationTracker::setEnabled(allocation_tracking && std::atoi(allocation_tracking) != 0);
+
+    const TraceConfig trace = TraceConfig::fromEnvironment();
+    std::string trace_error;
+    if (!trace.path.empty() && !Tracer::start(trace, trace_error)) {
+        std::cerr << "Tracing disabled: " << trace_error << std::endl;
+    }
+
+    const SlowLogConfig slow_log = SlowLogConfig::fromEnvironment();
+    std::string slow_log_error;
+    if (!slow_log.path.empty() && !SlowRequestLog::start(slow_log, slow_log_error)) {
+        std::cerr << "Slow request log disabled: " << slow_log_error << std::endl;
+    }
+
+    const CaptureConfig capture = CaptureConfig::fromEnvironment();
+    std::string capture_error;
+    if (!capture.path.empty() && !TrafficCapture::start(capture, capture_error)) {
+        std::cerr << "Traffic capture disabled: " << capture_error << std::endl;
+    }
+
+    // Before the stores open, so the result store is tagged with the loaded tuning
+    watchTuningFile();
+
+    static MappedStore result_store;
+    static MappedStore table_store;
+    openPersistentStores(result_store, table_store);
+
+    const WarmupConfig warmup = WarmupConfig::fromEnvironment();
+    if (warmup.enabled) {
+        drogon::app().registerBeginningAdvice([warmup]() { scheduleWarmup(warmup); });
+    } else {
+        WarmupService::markReady();
+    }
+
     drogon::app()
-        .addListener("0.0.0.0", 8080)
+        .addListener("0.0.0.0", port ? static_cast<uint16_t>(std::atoi(port)) : 8080)
         .registerController(std::make_shared<BlackScholesController>())
-        .run();
+        .registerController(std::make_shared<HealthController>())
+        .registerController(std::make_shared<MetricsController>());
+    // The admin endpoints change pricing for every client; without a token they do not exist
+    const char* admin_token = std::getenv("BSS_ADMIN_TOKEN");
+    if (admin_token && *admin_token) {
+        drogon::app().registerController(std::make_shared<AdminController>(admin_token));
+    }
+    drogon::app().run();
+
+    TrafficCapture::stop();
+    SlowRequestLog::stop();
+    Tracer::stop();
 }
@@ -3,11 +3,22 @@
 
 namespace dto {
 
+const char* optionTypeName(OptionType type) {
+    switch (type) {
+        case OptionType::REGULAR:                       return "regular";
+        case OptionType::BINARY:                        return "binary";
+        case OptionType::RANDOM_EXPIRATION_CALL:        return "randomExpirationCall";
+        case OptionType::RANDOM_EXPIRATION_BINARY_CALL: return "randomExpirationBinaryCall";
+    }
+    return "unknown";
+}
+
 BlackScholesRequestDto::BlackScholesRequestDto(const Json::Value& json) 
-    : is_valid_(false), validation_error_("") {
+    : diagnostics_(false), is_valid_(false), validation_error_("") {
     
     std::string error;
-    if (validateRequiredFields(json, error) && validateOptionTypeSpecificFields(json, error)) {
+    if (validateRequiredFields(json, error) && validateOptionTypeSpecificFields(json, error) &&
+        validateOptionalFields(json, error)) {
         is_valid_ = true;
     } else {
         validation_error_ = error;
@@ -32,6 +43,26 @@ std::optional<BlackScholesRequestDto> BlackScholesRequestDto::fromJson(const Jso
     }
 }
 
+Json::Value BlackScholesRequestDto::toJson() const {
+    Json::Value json;
+    json["type"] = optionTypeName(option_type_);
+    json["stock_price"] = stock_price_;
+    json["strike_price"] = strike_price_;
+    json["volatility"] = volatility_;
+    json["risk_free_rate"] = risk_free_rate_;
+    if (time_to_maturity_) {
+        json["time_to_maturity"] = *time_to_maturity_;
+    }
+    if (holding_period_) {
+        json["holding_period"] = *holding_period_;
+        json["volatility_around_holding_period"] = volatility_around_holding_period_.value();
+    }
+    if (diagnostics_) {
+        json["diagnostics"] = true;
+    }
+    return json;
+}
+
 bool BlackScholesRequestDto::validateRequiredFields(const Json::Value& json, std::string& error) {
     if (!validatePositiveDouble(json, "stock_price", stock_price_, error)) {
         return false;
@@ -91,6 +122,18 @@ bool BlackScholesRequestDto::validateOptionTypeSpecificFields(const Json::Value&
     return true;
 }
 
+bool BlackScholesRequestDto::validateOptionalFields(const Json::Value& json, std::string& error) {
+    if (json.isMember("diagnostics")) {
+        if (!json["diagnostics"].isBool()) {
+            error = "Field diagnostics must be a boolean";
+            return false;
+        }
+        diagnostics_ = json["diagnostics"].asBool();
+    }
+    
+    return true;
+}
+
 bool BlackScholesRequestDto::validatePositiveDouble(const Json::Value& json, const std::string& field, 
                                                    double& value, std::string& error) {
     if (!json.isMember(field)) {
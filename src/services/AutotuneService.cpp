@@ -0,0 +1,296 @@
+#include "services/AutotuneService.h"
+#include "services/TuningService.h"
+#include "utils/TuningConfig.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+using BlackScholesUtil::KernelIsa;
+using BlackScholesUtil::PricingEngine;
+
+namespace {
+
+const char* kAutotuneVersion = "autotune-2";
+
+std::mutex report_mutex;
+Json::Value applied_report;
+
+// Parameters the routing sends to Gauss-Laguerre: moderate dispersion, alpha from 1.5 to 16
+struct KernelSample {
+    double S, K, vol, r, H, sigmaH;
+    bool binary;
+};
+
+std::vector<KernelSample> kernelSamples() {
+    const double holdings[][2] = {{1.0, 0.25}, {2.0, 1.0}, {5.0, 2.5}, {0.5, 0.4}};
+    std::vector<KernelSample> samples;
+    for (const auto& h : holdings) {
+        for (double K : {80.0, 100.0, 125.0}) {
+            for (double vol : {0.2, 0.6}) {
+                for (bool binary : {false, true}) {
+                    samples.push_back({100.0, K, vol, 0.03, h[0], h[1], binary});
+                }
+            }
+        }
+    }
+    return samples;
+}
+
+double elapsedNanos(std::chrono::steady_clock::time_point since) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+double gaussLaguerre(const KernelSample& s, int order) {
+    return BlackScholesUtil::priceRandomExpirationWithEngine(PricingEngine::GAUSS_LAGUERRE, s.binary, s.S, s.K,
+                                                             s.vol, s.r, s.H, s.sigmaH, order);
+}
+
+// Prices every sample with the current kernel variant; returns nanoseconds per price. Each
+// sample is warmed first so node table builds stay out of the timing.
+double timeKernel(const std::vector<KernelSample>& samples, int order, int repetitions, std::vector<double>& prices) {
+    prices.clear();
+    double total = 0.0;
+    volatile double sink = 0.0;
+    for (const auto& sample : samples) {
+        prices.push_back(gaussLaguerre(sample, order));
+        const auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; ++i) sink = sink + gaussLaguerre(sample, order);
+        total += elapsedNanos(started);
+    }
+    return total / (static_cast<double>(samples.size()) * std::max(repetitions, 1));
+}
+
+double scaledError(double value, double reference) {
+    return std::abs(value - reference) / std::max(1.0, std::abs(reference));
+}
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string cachePath(const AutotuneConfig& config, const std::string& key) {
+    return config.cache_dir + "/autotune-" + key + ".json";
+}
+
+bool loadCached(const std::string& path, const std::string& key, AutotuneResult& result) {
+    std::ifstream in(path);
+    if (!in) return false;
+    Json::Value json;
+    Json::Reader reader;
+    std::string error;
+    AutotuneResult cached;
+    if (!reader.parse(in, json) || !cached.fromJson(json, error) || cached.cache_key != key) return false;
+    // A cached variant the CPU cannot run means the file came from another machine
+    if (!BlackScholesUtil::kernelIsaSupported(cached.isa)) return false;
+    cached.from_cache = true;
+    result = cached;
+    return true;
+}
+
+void saveCached(const std::string& path, const AutotuneResult& result) {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) return;
+        out << result.toJson().toStyledString();
+        if (!out) return;
+    }
+    std::rename(tmp.c_str(), path.c_str());
+}
+
+} // namespace
+
+AutotuneConfig AutotuneConfig::fromEnvironment() {
+    AutotuneConfig config;
+    const char* enabled = std::getenv("BSS_AUTOTUNE");
+    config.enabled = enabled && std::atoi(enabled) != 0;
+    if (const char* dir = std::getenv("BSS_AUTOTUNE_CACHE_DIR")) {
+        config.cache_dir = dir;
+    } else if (const char* store = std::getenv("BSS_STORE_DIR")) {
+        config.cache_dir = store;
+    }
+    return config;
+}
+
+Json::Value AutotuneResult::toJson() const {
+    Json::Value json;
+    json["cpu_model"] = cpu_model;
+    json["cache_key"] = cache_key;
+    json["from_cache"] = from_cache;
+    json["isa"] = BlackScholesUtil::kernelIsaName(isa);
+    json["gl_order"] = gl_order;
+    json["measurements"] = measurements;
+    return json;
+}
+
+bool AutotuneResult::fromJson(const Json::Value& json, std::string& error) {
+    if (!json.isObject() || !json["isa"].isString() || !json["gl_order"].isInt()) {
+        error = "Malformed autotune result";
+        return false;
+    }
+    const std::string isa_name = json["isa"].asString();
+    if (isa_name == BlackScholesUtil::kernelIsaName(KernelIsa::AVX2)) {
+        isa = KernelIsa::AVX2;
+    } else if (isa_name == BlackScholesUtil::kernelIsaName(KernelIsa::SCALAR)) {
+        isa = KernelIsa::SCALAR;
+    } else {
+        error = "Unknown kernel variant " + isa_name;
+        return false;
+    }
+    cpu_model = json["cpu_model"].asString();
+    cache_key = json["cache_key"].asString();
+    from_cache = json["from_cache"].asBool();
+    gl_order = json["gl_order"].asInt();
+    measurements = json["measurements"];
+    return true;
+}
+
+std::string AutotuneService::cpuModel() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            const size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                const size_t begin = line.find_first_not_of(' ', colon + 1);
+                return begin == std::string::npos ? std::string() : line.substr(begin);
+            }
+        }
+    }
+    return "unknown";
+}
+
+std::string AutotuneService::cacheKey(const AutotuneConfig& config, const std::string& cpu_model) {
+    std::ostringstream signature;
+    signature << kAutotuneVersion << '|' << cpu_model << '|' << config.max_error;
+    for (int order : config.gl_orders) signature << "|gl" << order;
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(fnv1a(signature.str())));
+    return hex;
+}
+
+bool AutotuneService::measure(const AutotuneConfig& config, AutotuneResult& result, std::string& error) {
+    if (config.gl_orders.empty() || config.repetitions < 1) {
+        error = "Autotune needs candidate orders and positive repetitions";
+        return false;
+    }
+
+    const int current_order = TuningConfig::current().gl_order;
+    const std::vector<KernelSample> samples = kernelSamples();
+    Json::Value measurements;
+
+    // Kernel variants, at the current order, checked against the scalar kernel
+    std::vector<double> scalar_prices, prices;
+    double best_ns = std::numeric_limits<double>::infinity();
+    result.isa = KernelIsa::SCALAR;
+    for (KernelIsa isa : {KernelIsa::SCALAR, KernelIsa::AVX2}) {
+        if (!BlackScholesUtil::setKernelIsa(isa)) continue;
+        const double ns = timeKernel(samples, current_order, config.repetitions,
+                                     isa == KernelIsa::SCALAR ? scalar_prices : prices);
+        const std::vector<double>& mine = isa == KernelIsa::SCALAR ? scalar_prices : prices;
+        double deviation = 0.0;
+        for (size_t i = 0; i < mine.size(); ++i) deviation = std::max(deviation, scaledError(mine[i], scalar_prices[i]));
+        const bool agrees = deviation <= 1e-12;
+
+        Json::Value entry;
+        entry["ns_per_price"] = ns;
+        entry["max_deviation_from_scalar"] = deviation;
+        entry["accepted"] = agrees;
+        measurements["isa"][BlackScholesUtil::kernelIsaName(isa)] = entry;
+        if (agrees && ns < best_ns) {
+            best_ns = ns;
+            result.isa = isa;
+        }
+    }
+    BlackScholesUtil::setKernelIsa(result.isa);
+
+    // Gauss-Laguerre orders against a tight QAGIU reference
+    std::vector<double> reference;
+    for (const auto& s : samples) {
+        reference.push_back(BlackScholesUtil::priceRandomExpirationWithEngine(
+            PricingEngine::GSL_QAGIU, s.binary, s.S, s.K, s.vol, s.r, s.H, s.sigmaH, 0, 1e-12));
+    }
+    best_ns = std::numeric_limits<double>::infinity();
+    result.gl_order = current_order;
+    for (int order : config.gl_orders) {
+        if (order < 1 || order > TuningConfig::kMaxGLOrder) continue;
+        const double ns = timeKernel(samples, order, config.repetitions, prices);
+        double max_error = 0.0;
+        for (size_t i = 0; i < prices.size(); ++i) max_error = std::max(max_error, scaledError(prices[i], reference[i]));
+        const bool accurate = max_error <= config.max_error;
+
+        Json::Value entry;
+        entry["ns_per_price"] = ns;
+        entry["max_error"] = max_error;
+        entry["accepted"] = accurate;
+        measurements["gl_order"][std::to_string(order)] = entry;
+        if (accurate && ns < best_ns) {
+            best_ns = ns;
+            result.gl_order = order;
+        }
+    }
+    measurements["gl_order_fallback"] = best_ns == std::numeric_limits<double>::infinity();
+
+    result.measurements = measurements;
+    result.from_cache = false;
+    return true;
+}
+
+bool AutotuneService::apply(const AutotuneResult& result, std::string& error) {
+    if (!BlackScholesUtil::setKernelIsa(result.isa)) {
+        error = std::string("Kernel variant ") + BlackScholesUtil::kernelIsaName(result.isa) + " is not supported here";
+        return false;
+    }
+    TuningParameters params = *TuningConfig::snapshot();
+    params.gl_order = result.gl_order;
+    if (!TuningService::apply(params, error)) {
+        return false;
+    }
+    TuningParameters baseline = TuningService::baseline();
+    baseline.gl_order = result.gl_order;
+    TuningService::setBaseline(baseline);
+
+    Json::Value report = result.toJson();
+    report["enabled"] = true;
+    std::lock_guard<std::mutex> lock(report_mutex);
+    applied_report = report;
+    return true;
+}
+
+bool AutotuneService::run(const AutotuneConfig& config, AutotuneResult& result, std::string& error) {
+    const std::string cpu = cpuModel();
+    const std::string key = cacheKey(config, cpu);
+    const std::string path = config.cache_dir.empty() ? std::string() : cachePath(config, key);
+
+    if (path.empty() || !loadCached(path, key, result)) {
+        if (!measure(config, result, error)) {
+            return false;
+        }
+        result.cpu_model = cpu;
+        result.cache_key = key;
+        if (!path.empty()) saveCached(path, result);
+    }
+    return apply(result, error);
+}
+
+Json::Value AutotuneService::report() {
+    std::lock_guard<std::mutex> lock(report_mutex);
+    if (applied_report.isNull()) {
+        Json::Value disabled;
+        disabled["enabled"] = false;
+        return disabled;
+    }
+    return applied_report;
+}
@@ -1,12 +1,24 @@
 #include "services/BlackScholesService.h"
+#include "services/MetricsService.h"
+#include "services/ResultCache.h"
+#include "utils/AllocationTracker.h"
 #include "utils/BlackScholesUtil.h"
+#include "utils/PerfCounters.h"
+#include "utils/TuningConfig.h"
 
 CallOption BlackScholesService::calculateRegularCall(double stock_price, double strike_price, 
                                                     double time_to_maturity, double volatility, 
                                                     double risk_free_rate) {
     CallOption result;
     result.type = "regular";
+    const uint64_t started = MetricsService::nowNanos();
+    PerfScope perf;
+    AllocationScope allocations;
     result.value = BlackScholesUtil::calculateStandardCall(stock_price, strike_price, time_to_maturity, volatility, risk_free_rate);
+    allocations.finish(BlackScholesUtil::PricingEngine::CLOSED_FORM);
+    perf.finish(BlackScholesUtil::PricingEngine::CLOSED_FORM);
+    MetricsService::recordPricing(dto::OptionType::REGULAR, BlackScholesUtil::PricingEngine::CLOSED_FORM,
+                                  MetricsService::nowNanos() - started);
     return result;
 }
 
@@ -15,7 +27,14 @@ CallOption BlackScholesService::calculateBinaryCall(double stock_price, double s
                                                    double risk_free_rate) {
     CallOption result;
     result.type = "binary";
+    const uint64_t started = MetricsService::nowNanos();
+    PerfScope perf;
+    AllocationScope allocations;
     result.value = BlackScholesUtil::calculateBinaryCall(stock_price, strike_price, time_to_maturity, volatility, risk_free_rate);
+    allocations.finish(BlackScholesUtil::PricingEngine::CLOSED_FORM);
+    perf.finish(BlackScholesUtil::PricingEngine::CLOSED_FORM);
+    MetricsService::recordPricing(dto::OptionType::BINARY, BlackScholesUtil::PricingEngine::CLOSED_FORM,
+                                  MetricsService::nowNanos() - started);
     return result;
 }
 
@@ -24,7 +43,23 @@ RandomExpirationCallOption BlackScholesService::calculateRandomExpirationCall(do
                                                                              double holding_period, double volatility_around_holding_period) {
     RandomExpirationCallOption result;
     result.type = "random_expiration";
-    result.value = BlackScholesUtil::calculateRandomExpirationCall(stock_price, strike_price, volatility, risk_free_rate, holding_period, volatility_around_holding_period);
+    const auto key = ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_CALL, stock_price, strike_price,
+                                          volatility, risk_free_rate, holding_period, volatility_around_holding_period);
+    // Read before pricing: the price comes from this snapshot or a newer one, never an older one
+    const uint64_t generation = TuningConfig::current().generation;
+    const uint64_t started = MetricsService::nowNanos();
+    if (ResultCache::instance().lookup(key, result.value)) {
+        result.cached = true;
+        MetricsService::recordCacheHit(dto::OptionType::RANDOM_EXPIRATION_CALL, MetricsService::nowNanos() - started);
+    } else {
+        PerfScope perf;
+        AllocationScope allocations;
+        result.value = BlackScholesUtil::calculateRandomExpirationCall(stock_price, strike_price, volatility, risk_free_rate, holding_period, volatility_around_holding_period, &result.diagnostics);
+        allocations.finish(result.diagnostics.engine);
+        perf.finish(result.diagnostics.engine);
+        ResultCache::instance().insert(key, result.value, generation);
+        MetricsService::recordPricing(dto::OptionType::RANDOM_EXPIRATION_CALL, result.diagnostics.engine, MetricsService::nowNanos() - started);
+    }
     result.holding_period = holding_period;
     result.volatility_around_holding_period = volatility_around_holding_period;
     return result;
@@ -35,7 +70,23 @@ RandomExpirationCallOption BlackScholesService::calculateRandomExpirationBinaryC
                                                                                    double holding_period, double volatility_around_holding_period) {
     RandomExpirationCallOption result;
     result.type = "random_expiration_binary";
-    result.value = BlackScholesUtil::calculateRandomExpirationBinaryCall(stock_price, strike_price, volatility, risk_free_rate, holding_period, volatility_around_holding_period);
+    const auto key = ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_BINARY_CALL, stock_price, strike_price,
+                                          volatility, risk_free_rate, holding_period, volatility_around_holding_period);
+    // Read before pricing: the price comes from this snapshot or a newer one, never an older one
+    const uint64_t generation = TuningConfig::current().generation;
+    const uint64_t started = MetricsService::nowNanos();
+    if (ResultCache::instance().lookup(key, result.value)) {
+        result.cached = true;
+        MetricsService::recordCacheHit(dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL, MetricsService::nowNanos() - started);
+    } else {
+        PerfScope perf;
+        AllocationScope allocations;
+        result.value = BlackScholesUtil::calculateRandomExpirationBinaryCall(stock_price, strike_price, volatility, risk_free_rate, holding_period, volatility_around_holding_period, &result.diagnostics);
+        allocations.finish(result.diagnostics.engine);
+        perf.finish(result.diagnostics.engine);
+        ResultCache::instance().insert(key, result.value, generation);
+        MetricsService::recordPricing(dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL, result.diagnostics.engine, MetricsService::nowNanos() - started);
+    }
     result.holding_period = holding_period;
     result.volatility_around_holding_period = volatility_around_holding_period;
     return result;
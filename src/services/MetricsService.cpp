@@ -0,0 +1,367 @@
+#include "services/MetricsService.h"
+#include "services/ResultCache.h"
+#include "utils/ThreadBlocks.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct ThreadHistogram {
+    std::atomic<uint64_t> buckets[HistogramSnapshot::kBucketCount] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_ns{0};
+
+    void observe(uint64_t nanos) {
+        bump(buckets[HistogramSnapshot::bucketFor(nanos)]);
+        bump(count);
+        bump(sum_ns, nanos);
+    }
+
+    void addTo(HistogramSnapshot& snapshot) const {
+        for (size_t i = 0; i < HistogramSnapshot::kBucketCount; ++i) {
+            snapshot.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += count.load(std::memory_order_relaxed);
+        snapshot.sum_ns += sum_ns.load(std::memory_order_relaxed);
+    }
+};
+
+struct alignas(64) ThreadMetrics {
+    ThreadHistogram request;
+    ThreadHistogram phases[PhaseTimer::kPhaseCount];
+    // Requests, allocations and bytes per phase while allocation tracking is enabled
+    std::atomic<uint64_t> tracked_phases[PhaseTimer::kPhaseCount] = {};
+    std::atomic<uint64_t> phase_allocations[PhaseTimer::kPhaseCount] = {};
+    std::atomic<uint64_t> phase_bytes[PhaseTimer::kPhaseCount] = {};
+    ThreadHistogram pricing[MetricsService::kOptionTypeCount][MetricsService::kPathCount];
+    std::atomic<uint64_t> requests[MetricsService::kOptionTypeCount] = {};
+    std::atomic<uint64_t> errors[MetricsService::kErrorCount] = {};
+    // Requests started minus finished on this thread; only the sum over threads is meaningful
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> finished{0};
+};
+
+const size_t kCachePath = MetricsService::kPathCount - 1;
+
+ThreadBlocks<ThreadMetrics>& registry() {
+    static ThreadBlocks<ThreadMetrics> blocks;
+    return blocks;
+}
+
+ThreadMetrics& local() {
+    return registry().local();
+}
+
+template <typename F>
+void forEachThread(F&& f) {
+    registry().forEach(std::forward<F>(f));
+}
+
+const char* typeLabel(size_t type) {
+    return dto::optionTypeName(static_cast<dto::OptionType>(type));
+}
+
+const char* pathLabel(size_t path) {
+    return path == kCachePath ? "result_cache"
+                              : BlackScholesUtil::engineName(static_cast<BlackScholesUtil::PricingEngine>(path));
+}
+
+const char* errorLabel(size_t error) {
+    static const char* const labels[] = {"invalid_json", "invalid_request", "forward_failed", "internal"};
+    return labels[error];
+}
+
+void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+void appendf(std::string& out, const char* format, ...) {
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    const int n = std::vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (n > 0) out.append(buf, std::min<size_t>(static_cast<size_t>(n), sizeof(buf) - 1));
+}
+
+void appendHistogram(std::string& out, const char* name, const std::string& labels,
+                     const HistogramSnapshot& h) {
+    const std::string sep = labels.empty() ? "" : ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i + 1 < HistogramSnapshot::kBucketCount; ++i) {
+        cumulative += h.buckets[i];
+        appendf(out, "%s_bucket{%s%sle=\"%.9g\"} %llu\n", name, labels.c_str(), sep.c_str(),
+                HistogramSnapshot::upperBoundSeconds(i), static_cast<unsigned long long>(cumulative));
+    }
+    appendf(out, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels.c_str(), sep.c_str(),
+            static_cast<unsigned long long>(h.count));
+    const std::string braces = labels.empty() ? "" : "{" + labels + "}";
+    appendf(out, "%s_sum%s %.9g\n", name, braces.c_str(), static_cast<double>(h.sum_ns) * 1e-9);
+    appendf(out, "%s_count%s %llu\n", name, braces.c_str(), static_cast<unsigned long long>(h.count));
+}
+
+} // namespace
+
+size_t HistogramSnapshot::bucketFor(uint64_t nanos) {
+    if (nanos <= (1ULL << kFirstBucketShift)) return 0;
+    // Smallest k with nanos <= 2^k, i.e. the bit length of nanos - 1
+    const size_t k = 64 - static_cast<size_t>(__builtin_clzll(nanos - 1));
+    return std::min(k - kFirstBucketShift, kBucketCount - 1);
+}
+
+double HistogramSnapshot::upperBoundSeconds(size_t bucket) {
+    return static_cast<double>(1ULL << (kFirstBucketShift + bucket)) * 1e-9;
+}
+
+uint64_t MetricsService::nowNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t MetricsService::requestStarted() {
+    bump(local().started);
+    return nowNanos();
+}
+
+void MetricsService::requestFinished(uint64_t started_ns, int status_code) {
+    ThreadMetrics& m = local();
+    m.request.observe(nowNanos() - started_ns);
+    bump(m.finished);
+    if (status_code >= 500) bump(m.errors[static_cast<size_t>(RequestError::INTERNAL)]);
+}
+
+void MetricsService::recordRequest(dto::OptionType type) {
+    bump(local().requests[static_cast<size_t>(type)]);
+}
+
+void MetricsService::recordError(RequestError error) {
+    bump(local().errors[static_cast<size_t>(error)]);
+}
+
+void MetricsService::recordPricing(dto::OptionType type, BlackScholesUtil::PricingEngine engine, uint64_t nanos) {
+    local().pricing[static_cast<size_t>(type)][static_cast<size_t>(engine)].observe(nanos);
+}
+
+void MetricsService::recordCacheHit(dto::OptionType type, uint64_t nanos) {
+    local().pricing[static_cast<size_t>(type)][kCachePath].observe(nanos);
+}
+
+void MetricsService::recordPhases(const PhaseTimer& timer) {
+    ThreadMetrics& m = local();
+    for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        if (!timer.reached(phase)) continue;
+        m.phases[i].observe(timer.nanos(phase));
+        if (AllocationTracker::enabled()) {
+            bump(m.tracked_phases[i]);
+            bump(m.phase_allocations[i], timer.allocations(phase).allocations);
+            bump(m.phase_bytes[i], timer.allocations(phase).bytes);
+        }
+    }
+}
+
+uint64_t MetricsService::requestCount(dto::OptionType type) {
+    uint64_t total = 0;
+    forEachThread([&](const ThreadMetrics& m) {
+        total += m.requests[static_cast<size_t>(type)].load(std::memory_order_relaxed);
+    });
+    return total;
+}
+
+uint64_t MetricsService::errorCount(RequestError error) {
+    uint64_t total = 0;
+    forEachThread([&](const ThreadMetrics& m) {
+        total += m.errors[static_cast<size_t>(error)].load(std::memory_order_relaxed);
+    });
+    return total;
+}
+
+int64_t MetricsService::inFlight() {
+    uint64_t started = 0, finished = 0;
+    forEachThread([&](const ThreadMetrics& m) {
+        started += m.started.load(std::memory_order_relaxed);
+        finished += m.finished.load(std::memory_order_relaxed);
+    });
+    return static_cast<int64_t>(started - finished);
+}
+
+HistogramSnapshot MetricsService::requestLatency() {
+    HistogramSnapshot snapshot;
+    forEachThread([&](const ThreadMetrics& m) { m.request.addTo(snapshot); });
+    return snapshot;
+}
+
+HistogramSnapshot MetricsService::pricingLatency(dto::OptionType type, BlackScholesUtil::PricingEngine engine) {
+    HistogramSnapshot snapshot;
+    forEachThread([&](const ThreadMetrics& m) {
+        m.pricing[static_cast<size_t>(type)][static_cast<size_t>(engine)].addTo(snapshot);
+    });
+    return snapshot;
+}
+
+HistogramSnapshot MetricsService::phaseLatency(RequestPhase phase) {
+    HistogramSnapshot snapshot;
+    forEachThread([&](const ThreadMetrics& m) { m.phases[static_cast<size_t>(phase)].addTo(snapshot); });
+    return snapshot;
+}
+
+AllocationCounts MetricsService::phaseAllocations(RequestPhase phase) {
+    AllocationCounts counts;
+    const size_t i = static_cast<size_t>(phase);
+    forEachThread([&](const ThreadMetrics& m) {
+        counts.allocations += m.phase_allocations[i].load(std::memory_order_relaxed);
+        counts.bytes += m.phase_bytes[i].load(std::memory_order_relaxed);
+    });
+    return counts;
+}
+
+Json::Value MetricsService::allocationsJson() {
+    auto perCall = [](uint64_t total, uint64_t calls) {
+        return calls > 0 ? Json::Value(static_cast<double>(total) / calls) : Json::Value(Json::nullValue);
+    };
+    Json::Value json;
+    json["enabled"] = AllocationTracker::enabled();
+
+    Json::Value phases(Json::objectValue);
+    for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        uint64_t requests = 0;
+        forEachThread([&](const ThreadMetrics& m) { requests += m.tracked_phases[i].load(std::memory_order_relaxed); });
+        const AllocationCounts counts = phaseAllocations(phase);
+        Json::Value entry;
+        entry["requests"] = Json::UInt64(requests);
+        entry["allocations_per_request"] = perCall(counts.allocations, requests);
+        entry["bytes_per_request"] = perCall(counts.bytes, requests);
+        phases[PhaseTimer::phaseName(phase)] = entry;
+    }
+    json["phases"] = phases;
+
+    Json::Value engines(Json::objectValue);
+    for (size_t e = 0; e < AllocationTracker::kEngineCount; ++e) {
+        const auto engine = static_cast<BlackScholesUtil::PricingEngine>(e);
+        const EngineAllocations totals = AllocationTracker::engineTotals(engine);
+        Json::Value entry;
+        entry["invocations"] = Json::UInt64(totals.invocations);
+        entry["allocations_per_call"] = perCall(totals.counts.allocations, totals.invocations);
+        entry["bytes_per_call"] = perCall(totals.counts.bytes, totals.invocations);
+        engines[BlackScholesUtil::engineName(engine)] = entry;
+    }
+    json["engines"] = engines;
+    return json;
+}
+
+HistogramSnapshot MetricsService::cacheHitLatency(dto::OptionType type) {
+    HistogramSnapshot snapshot;
+    forEachThread([&](const ThreadMetrics& m) { m.pricing[static_cast<size_t>(type)][kCachePath].addTo(snapshot); });
+    return snapshot;
+}
+
+std::string MetricsService::renderPrometheus() {
+    std::string out;
+    out.reserve(64 * 1024);
+
+    out += "# HELP bss_requests_total Pricing requests accepted, by option type.\n";
+    out += "# TYPE bss_requests_total counter\n";
+    for (size_t t = 0; t < kOptionTypeCount; ++t) {
+        appendf(out, "bss_requests_total{type=\"%s\"} %llu\n", typeLabel(t),
+                static_cast<unsigned long long>(requestCount(static_cast<dto::OptionType>(t))));
+    }
+
+    out += "# HELP bss_request_errors_total Requests rejected or failed, by reason.\n";
+    out += "# TYPE bss_request_errors_total counter\n";
+    for (size_t e = 0; e < kErrorCount; ++e) {
+        appendf(out, "bss_request_errors_total{reason=\"%s\"} %llu\n", errorLabel(e),
+                static_cast<unsigned long long>(errorCount(static_cast<RequestError>(e))));
+    }
+
+    out += "# HELP bss_requests_in_flight Requests received and not yet answered.\n";
+    out += "# TYPE bss_requests_in_flight gauge\n";
+    appendf(out, "bss_requests_in_flight %lld\n", static_cast<long long>(inFlight()));
+
+    out += "# HELP bss_request_duration_seconds Time from receiving a request to handing the response to the server.\n";
+    out += "# TYPE bss_request_duration_seconds histogram\n";
+    appendHistogram(out, "bss_request_duration_seconds", "", requestLatency());
+
+    out += "# HELP bss_request_phase_seconds Time spent in each stage of /api/calculate.\n";
+    out += "# TYPE bss_request_phase_seconds histogram\n";
+    for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        appendHistogram(out, "bss_request_phase_seconds",
+                        std::string("phase=\"") + PhaseTimer::phaseName(phase) + "\"", phaseLatency(phase));
+    }
+
+    out += "# HELP bss_pricing_duration_seconds Time spent producing one price, by option type and numerical path.\n";
+    out += "# TYPE bss_pricing_duration_seconds histogram\n";
+    for (size_t t = 0; t < kOptionTypeCount; ++t) {
+        for (size_t p = 0; p < kPathCount; ++p) {
+            HistogramSnapshot h;
+            forEachThread([&](const ThreadMetrics& m) { m.pricing[t][p].addTo(h); });
+            if (h.count == 0) continue;
+            const std::string labels = std::string("type=\"") + typeLabel(t) + "\",path=\"" + pathLabel(p) + "\"";
+            appendHistogram(out, "bss_pricing_duration_seconds", labels, h);
+        }
+    }
+
+    if (AllocationTracker::enabled()) {
+        out += "# HELP bss_request_phase_allocations_total Heap allocations made in each stage of /api/calculate.\n";
+        out += "# TYPE bss_request_phase_allocations_total counter\n";
+        for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+            const auto phase = static_cast<RequestPhase>(i);
+            appendf(out, "bss_request_phase_allocations_total{phase=\"%s\"} %llu\n", PhaseTimer::phaseName(phase),
+                    static_cast<unsigned long long>(phaseAllocations(phase).allocations));
+        }
+        out += "# HELP bss_request_phase_allocated_bytes_total Heap bytes requested in each stage of /api/calculate.\n";
+        out += "# TYPE bss_request_phase_allocated_bytes_total counter\n";
+        for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+            const auto phase = static_cast<RequestPhase>(i);
+            appendf(out, "bss_request_phase_allocated_bytes_total{phase=\"%s\"} %llu\n", PhaseTimer::phaseName(phase),
+                    static_cast<unsigned long long>(phaseAllocations(phase).bytes));
+        }
+        out += "# HELP bss_engine_allocations_total Heap allocations made inside each pricing engine.\n";
+        out += "# TYPE bss_engine_allocations_total counter\n";
+        for (size_t e = 0; e < AllocationTracker::kEngineCount; ++e) {
+            appendf(out, "bss_engine_allocations_total{engine=\"%s\"} %llu\n", pathLabel(e),
+                    static_cast<unsigned long long>(
+                        AllocationTracker::engineTotals(static_cast<BlackScholesUtil::PricingEngine>(e)).counts.allocations));
+        }
+        out += "# HELP bss_engine_allocated_bytes_total Heap bytes requested inside each pricing engine.\n";
+        out += "# TYPE bss_engine_allocated_bytes_total counter\n";
+        for (size_t e = 0; e < AllocationTracker::kEngineCount; ++e) {
+            appendf(out, "bss_engine_allocated_bytes_total{engine=\"%s\"} %llu\n", pathLabel(e),
+                    static_cast<unsigned long long>(
+                        AllocationTracker::engineTotals(static_cast<BlackScholesUtil::PricingEngine>(e)).counts.bytes));
+        }
+    }
+
+    out += "# HELP bss_gl_table_builds_total Gauss-Laguerre node tables computed by eigen-decomposition.\n";
+    out += "# TYPE bss_gl_table_builds_total counter\n";
+    appendf(out, "bss_gl_table_builds_total %llu\n",
+            static_cast<unsigned long long>(BlackScholesUtil::glTableBuilds()));
+    out += "# HELP bss_gl_table_store_loads_total Gauss-Laguerre node tables loaded from the persistent store.\n";
+    out += "# TYPE bss_gl_table_store_loads_total counter\n";
+    appendf(out, "bss_gl_table_store_loads_total %llu\n",
+            static_cast<unsigned long long>(BlackScholesUtil::glTableStoreLoads()));
+
+    ResultCache& cache = ResultCache::instance();
+    const uint64_t hits = cache.hits();
+    const uint64_t misses = cache.misses();
+    out += "# HELP bss_result_cache_hits_total Result cache lookups answered from memory or the persistent store.\n";
+    out += "# TYPE bss_result_cache_hits_total counter\n";
+    appendf(out, "bss_result_cache_hits_total %llu\n", static_cast<unsigned long long>(hits));
+    out += "# HELP bss_result_cache_store_hits_total Result cache lookups answered from the persistent store.\n";
+    out += "# TYPE bss_result_cache_store_hits_total counter\n";
+    appendf(out, "bss_result_cache_store_hits_total %llu\n", static_cast<unsigned long long>(cache.storeHits()));
+    out += "# HELP bss_result_cache_misses_total Result cache lookups that had to price.\n";
+    out += "# TYPE bss_result_cache_misses_total counter\n";
+    appendf(out, "bss_result_cache_misses_total %llu\n", static_cast<unsigned long long>(misses));
+    out += "# HELP bss_result_cache_hit_ratio Share of result cache lookups that hit since startup.\n";
+    out += "# TYPE bss_result_cache_hit_ratio gauge\n";
+    appendf(out, "bss_result_cache_hit_ratio %.6g\n",
+            hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses));
+    out += "# HELP bss_result_cache_entries Entries held in memory by the result cache.\n";
+    out += "# TYPE bss_result_cache_entries gauge\n";
+    appendf(out, "bss_result_cache_entries %llu\n", static_cast<unsigned long long>(cache.size()));
+
+    return out;
+}
@@ -0,0 +1,189 @@
+#include "services/ResultCache.h"
+#include "utils/MappedStore.h"
+#include <cstring>
+
+namespace {
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t doubleBits(double v) {
+    if (v == 0.0) v = 0.0; // fold -0.0 into +0.0
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+// Byte image of a key as stored in the persistent store, with -0.0 folded into +0.0.
+struct StoredKey {
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t params[6];
+};
+
+StoredKey storedKey(const ResultCacheKey& key) {
+    StoredKey stored{key.kind, 0, {}};
+    for (int i = 0; i < 6; ++i) stored.params[i] = doubleBits(key.params[i]);
+    return stored;
+}
+
+} // namespace
+
+ResultCacheKey ResultCacheKey::make(Kind kind, double stock_price, double strike_price,
+                                    double volatility, double risk_free_rate,
+                                    double holding_period, double volatility_around_holding_period) {
+    ResultCacheKey key;
+    key.kind = kind;
+    key.params[0] = stock_price;
+    key.params[1] = strike_price;
+    key.params[2] = volatility;
+    key.params[3] = risk_free_rate;
+    key.params[4] = holding_period;
+    key.params[5] = volatility_around_holding_period;
+    return key;
+}
+
+uint64_t ResultCacheKey::hash() const {
+    uint64_t h = mix64(0x9e3779b97f4a7c15ULL ^ kind);
+    for (double p : params) {
+        h = mix64(h ^ doubleBits(p));
+    }
+    return h;
+}
+
+bool ResultCacheKey::operator==(const ResultCacheKey& other) const {
+    if (kind != other.kind) return false;
+    for (int i = 0; i < 6; ++i) {
+        if (doubleBits(params[i]) != doubleBits(other.params[i])) return false;
+    }
+    return true;
+}
+
+ResultCache& ResultCache::instance() {
+    static ResultCache cache;
+    return cache;
+}
+
+ResultCache::ResultCache(size_t capacity) {
+    setCapacity(capacity);
+}
+
+ResultCache::Shard& ResultCache::shardFor(const ResultCacheKey& key) {
+    // ClusterRouter finds a key's owner by where the whole hash falls on its ring, which the
+    // high bits decide, so the keys one node owns share them. Remix before picking a shard so
+    // those keys still spread over every shard.
+    uint64_t h = key.hash();
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return shards_[h % kShardCount];
+}
+
+bool ResultCache::lookup(const ResultCacheKey& key, double& value) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        value = it->second->second;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    MappedStore* store = store_.load(std::memory_order_acquire);
+    const StoredKey stored = storedKey(key);
+    if (store && store->lookup(key.hash(), &stored, sizeof(stored), &value, sizeof(value))) {
+        if (shard.capacity > 0) {
+            if (shard.index.size() >= shard.capacity) {
+                shard.index.erase(shard.lru.back().first);
+                shard.lru.pop_back();
+            }
+            shard.lru.emplace_front(key, value);
+            shard.index[key] = shard.lru.begin();
+        }
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        store_hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void ResultCache::insert(const ResultCacheKey& key, double value, uint64_t generation) {
+    if (MappedStore* store = store_.load(std::memory_order_acquire)) {
+        // The epoch is read before the generation check: invalidateAll raises valid_from_
+        // before it bumps the epoch, so a stale value either fails the check or lands under
+        // an epoch that is already dead
+        const uint32_t epoch = store->epoch();
+        if (generation < valid_from_.load(std::memory_order_acquire)) return;
+        const StoredKey stored = storedKey(key);
+        store->insert(key.hash(), &stored, sizeof(stored), &value, sizeof(value), epoch);
+    }
+
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // Checked under the shard lock, which invalidateAll takes to clear the shard
+    if (shard.capacity == 0 || generation < valid_from_.load(std::memory_order_acquire)) return;
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->second->second = value;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    if (shard.index.size() >= shard.capacity) {
+        shard.index.erase(shard.lru.back().first);
+        shard.lru.pop_back();
+    }
+    shard.lru.emplace_front(key, value);
+    shard.index[key] = shard.lru.begin();
+}
+
+void ResultCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+    }
+}
+
+void ResultCache::invalidateAll(const std::string& engine_version, uint64_t generation) {
+    uint64_t valid_from = valid_from_.load();
+    while (valid_from < generation && !valid_from_.compare_exchange_weak(valid_from, generation)) {
+    }
+    if (MappedStore* store = store_.load(std::memory_order_acquire)) {
+        store->reset(engine_version);
+    }
+    clear();
+}
+
+void ResultCache::setCapacity(size_t capacity) {
+    const size_t per_shard = (capacity + kShardCount - 1) / kShardCount;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.capacity = per_shard;
+        while (shard.index.size() > per_shard) {
+            shard.index.erase(shard.lru.back().first);
+            shard.lru.pop_back();
+        }
+    }
+}
+
+void ResultCache::attachStore(MappedStore* store) {
+    store_.store(store, std::memory_order_release);
+}
+
+size_t ResultCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.index.size();
+    }
+    return total;
+}
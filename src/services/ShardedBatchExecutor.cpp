@@ -0,0 +1,314 @@
+#include "services/ShardedBatchExecutor.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/Tracer.h"
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+// A shard is pending, done, or claimed by the worker in slot (state - SHARD_CLAIMED)
+enum ShardState : int { SHARD_PENDING = 0, SHARD_DONE = 1, SHARD_CLAIMED = 2 };
+
+// Lives at the start of the shared mapping; followed by the per-shard arrays.
+struct SharedControl {
+    std::atomic<long> next_shard;
+};
+
+struct SharedLayout {
+    void* base = nullptr;
+    size_t bytes = 0;
+    SharedControl* control = nullptr;
+    std::atomic<int>* shard_state = nullptr;
+    int* shard_attempt = nullptr;   // written by the coordinator before it puts a shard back
+};
+
+size_t alignUp(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+bool mapShared(size_t shard_count, SharedLayout& layout) {
+    const size_t control_bytes = alignUp(sizeof(SharedControl), 64);
+    const size_t state_bytes   = alignUp(shard_count * sizeof(std::atomic<int>), 64);
+    const size_t attempt_bytes = shard_count * sizeof(int);
+
+    layout.bytes = control_bytes + state_bytes + attempt_bytes;
+    layout.base = mmap(nullptr, layout.bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (layout.base == MAP_FAILED) {
+        layout.base = nullptr;
+        return false;
+    }
+
+    char* p = static_cast<char*>(layout.base);
+    layout.control = new (p) SharedControl{};
+    layout.control->next_shard.store(0);
+    p += control_bytes;
+    layout.shard_state = reinterpret_cast<std::atomic<int>*>(p);
+    for (size_t i = 0; i < shard_count; ++i) new (&layout.shard_state[i]) std::atomic<int>(SHARD_PENDING);
+    p += state_bytes;
+    layout.shard_attempt = reinterpret_cast<int*>(p);
+    return true;
+}
+
+bool claim(const SharedLayout& layout, size_t shard, size_t slot) {
+    int pending = SHARD_PENDING;
+    return layout.shard_state[shard].compare_exchange_strong(pending, SHARD_CLAIMED + static_cast<int>(slot));
+}
+
+// Body of a worker process. Takes shards from the shared counter, then sweeps for shards that
+// were put back for a retry or skipped by a worker that died before claiming them. The claim
+// names the worker's slot, so the coordinator knows which shard a dead worker held. An
+// exception must not unwind into the parent's code that called fork(), so it ends the worker
+// like a crash and the shard is retried.
+[[noreturn]] void workerMain(const ShardedBatchOptions& options, const SharedLayout& layout, size_t shard_count,
+                             size_t slot, const std::function<void(size_t)>& price_shard) {
+    for (;;) {
+        try {
+            long shard = layout.control->next_shard.fetch_add(1);
+            if (static_cast<size_t>(shard) >= shard_count) {
+                shard = -1;
+                for (size_t s = 0; s < shard_count && shard < 0; ++s) {
+                    if (claim(layout, s, slot)) shard = static_cast<long>(s);
+                }
+                if (shard < 0) _exit(0);
+            } else if (!claim(layout, static_cast<size_t>(shard), slot)) {
+                continue;
+            }
+            if (options.shard_hook) options.shard_hook(static_cast<size_t>(shard), layout.shard_attempt[shard]);
+            price_shard(static_cast<size_t>(shard));
+            layout.shard_state[shard].store(SHARD_DONE);
+        } catch (...) {
+            _exit(1);
+        }
+    }
+}
+
+// Waits for one of our own workers to exit. waitpid(-1) would also reap children that other
+// code in the process waits for, and swallow their exit status, so the known pids are polled.
+pid_t waitForWorker(const std::unordered_map<pid_t, size_t>& workers, int& status, std::string& error) {
+    useconds_t pause = 50;
+    for (;;) {
+        for (const auto& worker : workers) {
+            const pid_t pid = waitpid(worker.first, &status, WNOHANG);
+            if (pid == worker.first) return pid;
+            if (pid < 0 && errno != EINTR) {
+                error = std::string("waitpid failed: ") + std::strerror(errno);
+                return -1;
+            }
+        }
+        usleep(pause);
+        pause = std::min<useconds_t>(pause * 2, 2000);
+    }
+}
+
+} // namespace
+
+bool ShardedBatchExecutor::validate(const BatchPricingJob& job, std::string& error) {
+    const size_t n = job.size();
+    if (job.strike_prices.size() != n || job.volatilities.size() != n || job.risk_free_rates.size() != n) {
+        error = "Batch columns stock_price, strike_price, volatility and risk_free_rate must have equal length";
+        return false;
+    }
+
+    switch (job.type) {
+        case dto::OptionType::REGULAR:
+        case dto::OptionType::BINARY:
+            if (job.time_to_maturities.size() != n) {
+                error = "Batch column time_to_maturity must match the batch length";
+                return false;
+            }
+            break;
+
+        case dto::OptionType::RANDOM_EXPIRATION_CALL:
+        case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL:
+            if (job.holding_periods.size() != n || job.volatility_around_holding_periods.size() != n) {
+                error = "Batch columns holding_period and volatility_around_holding_period must match the batch length";
+                return false;
+            }
+            break;
+    }
+    return true;
+}
+
+void ShardedBatchExecutor::priceRange(const BatchPricingJob& job, size_t begin, size_t end, double* out) {
+    switch (job.type) {
+        case dto::OptionType::REGULAR:
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = BlackScholesUtil::calculateStandardCall(job.stock_prices[i], job.strike_prices[i],
+                                                                 job.time_to_maturities[i], job.volatilities[i],
+                                                                 job.risk_free_rates[i]);
+            }
+            break;
+
+        case dto::OptionType::BINARY:
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = BlackScholesUtil::calculateBinaryCall(job.stock_prices[i], job.strike_prices[i],
+                                                               job.time_to_maturities[i], job.volatilities[i],
+                                                               job.risk_free_rates[i]);
+            }
+            break;
+
+        case dto::OptionType::RANDOM_EXPIRATION_CALL:
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = BlackScholesUtil::calculateRandomExpirationCall(job.stock_prices[i], job.strike_prices[i],
+                                                                         job.volatilities[i], job.risk_free_rates[i],
+                                                                         job.holding_periods[i],
+                                                                         job.volatility_around_holding_periods[i]);
+            }
+            break;
+
+        case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL:
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = BlackScholesUtil::calculateRandomExpirationBinaryCall(job.stock_prices[i], job.strike_prices[i],
+                                                                               job.volatilities[i], job.risk_free_rates[i],
+                                                                               job.holding_periods[i],
+                                                                               job.volatility_around_holding_periods[i]);
+            }
+            break;
+    }
+}
+
+bool ShardedBatchExecutor::runShards(size_t shard_count, const ShardedBatchOptions& options,
+                                     const std::function<void(size_t shard)>& price_shard, std::string& error) {
+    if (options.worker_count < 1) {
+        error = "worker_count must be positive";
+        return false;
+    }
+    if (shard_count == 0) {
+        return true;
+    }
+    const size_t worker_count = std::min(static_cast<size_t>(options.worker_count), shard_count);
+
+    SharedLayout layout;
+    if (!mapShared(shard_count, layout)) {
+        error = std::string("Failed to map shared shard state: ") + std::strerror(errno);
+        return false;
+    }
+
+    std::vector<int> retries(shard_count, 0);
+    std::unordered_map<pid_t, size_t> workers;
+
+    auto spawn = [&](size_t slot) -> bool {
+        pid_t pid = fork();
+        if (pid < 0) {
+            error = std::string("Failed to fork batch worker: ") + std::strerror(errno);
+            return false;
+        }
+        if (pid == 0) {
+            workerMain(options, layout, shard_count, slot, price_shard);
+        }
+        workers[pid] = slot;
+        return true;
+    };
+
+    // Hands a shard that was not finished to whichever worker sweeps next
+    auto requeue = [&](size_t shard) -> bool {
+        const int attempt = ++retries[shard];
+        if (attempt > options.max_shard_retries) {
+            error = "Shard " + std::to_string(shard) + " failed after " +
+                    std::to_string(options.max_shard_retries) + " retries";
+            return false;
+        }
+        layout.shard_attempt[shard] = attempt;
+        layout.shard_state[shard].store(SHARD_PENDING);
+        return true;
+    };
+
+    bool ok = true;
+    for (size_t slot = 0; slot < worker_count && ok; ++slot) {
+        ok = spawn(slot);
+    }
+
+    while (ok) {
+        if (workers.empty()) {
+            // Every worker finished; re-dispatch any shard that is still not done
+            size_t shard = 0;
+            while (shard < shard_count && layout.shard_state[shard].load() == SHARD_DONE) ++shard;
+            if (shard == shard_count) break;
+            ok = requeue(shard) && spawn(0);
+            continue;
+        }
+
+        int status = 0;
+        const pid_t pid = waitForWorker(workers, status, error);
+        if (pid < 0) {
+            ok = false;
+            break;
+        }
+        const size_t slot = workers[pid];
+        workers.erase(pid);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) continue;
+
+        // The worker died. Put back the shard it had claimed, if any, and replace it.
+        for (size_t shard = 0; shard < shard_count && ok; ++shard) {
+            if (layout.shard_state[shard].load() == SHARD_CLAIMED + static_cast<int>(slot)) ok = requeue(shard);
+        }
+        ok = ok && spawn(slot);
+    }
+
+    if (!ok) {
+        for (const auto& w : workers) kill(w.first, SIGKILL);
+        for (const auto& w : workers) waitpid(w.first, nullptr, 0);
+    }
+    munmap(layout.base, layout.bytes);
+    return ok;
+}
+
+bool ShardedBatchExecutor::run(const BatchPricingJob& job, const ShardedBatchOptions& options,
+                               std::vector<double>& results, std::string& error) {
+    if (!validate(job, error)) {
+        return false;
+    }
+    if (options.worker_count < 1 || options.shard_size == 0) {
+        error = "worker_count and shard_size must be positive";
+        return false;
+    }
+
+    const size_t rows = job.size();
+    results.assign(rows, 0.0);
+    if (rows == 0) {
+        return true;
+    }
+    if (rows <= options.inline_rows) {
+        priceRange(job, 0, rows, results.data());
+        return true;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const size_t price_bytes = rows * sizeof(double);
+    void* prices = mmap(nullptr, price_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (prices == MAP_FAILED) {
+        error = std::string("Failed to map shared result buffer: ") + std::strerror(errno);
+        return false;
+    }
+
+    const size_t shard_count = (rows + options.shard_size - 1) / options.shard_size;
+    const bool ok = runShards(shard_count, options, [&](size_t shard) {
+        const size_t begin = shard * options.shard_size;
+        priceRange(job, begin, std::min(rows, begin + options.shard_size), static_cast<double*>(prices));
+    }, error);
+    if (ok) {
+        std::memcpy(results.data(), prices, price_bytes);
+    }
+    munmap(prices, price_bytes);
+
+    if (Tracer::enabled()) {
+        TraceSpan span;
+        span.name = "batch";
+        span.trace_id = Tracer::newTraceId();
+        span.start_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            started.time_since_epoch()).count());
+        span.duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count());
+        span.option_type = dto::optionTypeName(job.type);
+        span.batch_size = static_cast<uint32_t>(std::min<size_t>(rows, UINT32_MAX));
+        Tracer::record(span);
+    }
+    return ok;
+}
@@ -0,0 +1,73 @@
+#include "services/TuningService.h"
+#include "services/ResultCache.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/TuningConfig.h"
+#include <mutex>
+#include <sys/stat.h>
+
+namespace {
+
+std::mutex g_file_mutex;
+struct timespec g_loaded_mtime = {0, 0};
+TuningParameters g_baseline;
+
+} // namespace
+
+bool TuningService::apply(const TuningParameters& params, std::string& error) {
+    const std::string before = TuningConfig::snapshot()->fingerprint();
+    if (!TuningConfig::publish(params, error)) {
+        return false;
+    }
+    if (params.fingerprint() != before) {
+        ResultCache::instance().invalidateAll(BlackScholesUtil::engineVersion(),
+                                              TuningConfig::current().generation);
+    }
+    return true;
+}
+
+bool TuningService::applyJson(const Json::Value& overrides, std::string& error) {
+    TuningParameters params = *TuningConfig::snapshot();
+    if (!params.mergeJson(overrides, error)) {
+        return false;
+    }
+    return apply(params, error);
+}
+
+bool TuningService::reloadFile(const std::string& path, std::string& error) {
+    std::lock_guard<std::mutex> lock(g_file_mutex);
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        error = "Cannot stat tuning file " + path;
+        return false;
+    }
+    TuningParameters params = g_baseline;
+    if (!TuningConfig::loadFile(path, params, error) || !apply(params, error)) {
+        return false;
+    }
+    g_loaded_mtime = st.st_mtim;
+    return true;
+}
+
+bool TuningService::reloadIfChanged(const std::string& path, std::string& error) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_file_mutex);
+        if (st.st_mtim.tv_sec == g_loaded_mtime.tv_sec && st.st_mtim.tv_nsec == g_loaded_mtime.tv_nsec) {
+            return false;
+        }
+    }
+    return reloadFile(path, error);
+}
+
+void TuningService::setBaseline(const TuningParameters& params) {
+    std::lock_guard<std::mutex> lock(g_file_mutex);
+    g_baseline = params;
+}
+
+TuningParameters TuningService::baseline() {
+    std::lock_guard<std::mutex> lock(g_file_mutex);
+    return g_baseline;
+}
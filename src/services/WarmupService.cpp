@@ -0,0 +1,108 @@
+#include "services/WarmupService.h"
+#include "requests/BlackScholesRequestDto.h"
+#include "utils/BlackScholesUtil.h"
+#include <jsoncpp/json/json.h>
+#include <atomic>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::atomic<size_t> g_total_threads{0};
+std::atomic<size_t> g_warmed_threads{0};
+std::atomic<bool>   g_ready{false};
+
+// Keeps the warmup results observable so the calls are not optimized away
+std::atomic<double> g_sink{0.0};
+
+const char* kSampleRequest =
+    "{\"stock_price\": 100, \"strike_price\": 100, \"volatility\": 0.9, \"risk_free_rate\": 0.05,"
+    " \"type\": \"randomExpirationCall\", \"holding_period\": 5.0, \"volatility_around_holding_period\": 5.0}";
+
+} // namespace
+
+WarmupConfig WarmupConfig::fromEnvironment() {
+    WarmupConfig config;
+    if (const char* enabled = std::getenv("BSS_WARMUP")) {
+        config.enabled = std::string(enabled) != "0";
+    }
+    if (const char* iterations = std::getenv("BSS_WARMUP_ITERATIONS")) {
+        config.iterations = std::atoi(iterations);
+    }
+    if (const char* alphas = std::getenv("BSS_WARMUP_TABLE_ALPHAS")) {
+        config.table_alphas.clear();
+        std::stringstream ss(alphas);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) config.table_alphas.push_back(std::atof(item.c_str()));
+        }
+    }
+    return config;
+}
+
+void WarmupService::warmCurrentThread(const WarmupConfig& config) {
+    double sink = 0.0;
+    for (int i = 0; i < config.iterations; ++i) {
+        const double strike = 90.0 + (i % 20);
+        const double vol = 0.2 + 0.01 * (i % 10);
+
+        sink += BlackScholesUtil::calculateStandardCall(100.0, strike, 0.25, vol, 0.05);
+        sink += BlackScholesUtil::calculateBinaryCall(100.0, strike, 0.25, vol, 0.05);
+
+        // H/sigmaH >= 50 takes the analytic shortcut, cv = 0.25 the Gauss-Laguerre kernels and
+        // cv = 2 GSL QAGIU, which also allocates this thread's integration workspace.
+        sink += BlackScholesUtil::calculateRandomExpirationCall(100.0, strike, vol, 0.05, 5.0, 0.05);
+        sink += BlackScholesUtil::calculateRandomExpirationCall(100.0, strike, vol, 0.05, 5.0, 1.25);
+        sink += BlackScholesUtil::calculateRandomExpirationCall(100.0, strike, vol, 0.05, 5.0, 10.0);
+        sink += BlackScholesUtil::calculateRandomExpirationBinaryCall(100.0, strike, vol, 0.05, 5.0, 0.05);
+        sink += BlackScholesUtil::calculateRandomExpirationBinaryCall(100.0, strike, vol, 0.05, 5.0, 1.25);
+        sink += BlackScholesUtil::calculateRandomExpirationBinaryCall(100.0, strike, vol, 0.05, 5.0, 10.0);
+
+        Json::Value body;
+        Json::Reader reader;
+        if (reader.parse(kSampleRequest, body)) {
+            std::string error;
+            auto dto = dto::BlackScholesRequestDto::fromJson(body, error);
+            if (dto) sink += dto->getStockPrice();
+        }
+    }
+
+    // A thread keeps one node table, so without a store to hold them each prebuilt table would
+    // only replace the one before it
+    if (BlackScholesUtil::glTableStoreAttached()) {
+        for (double alpha : config.table_alphas) {
+            if (alpha > 0.0) BlackScholesUtil::prebuildGLTable(alpha);
+        }
+    }
+    g_sink.store(sink, std::memory_order_relaxed);
+}
+
+void WarmupService::begin(size_t thread_count) {
+    g_ready.store(false);
+    g_warmed_threads.store(0);
+    g_total_threads.store(thread_count);
+    if (thread_count == 0) markReady();
+}
+
+void WarmupService::threadWarmed() {
+    if (g_warmed_threads.fetch_add(1) + 1 >= g_total_threads.load()) {
+        markReady();
+    }
+}
+
+void WarmupService::markReady() {
+    g_ready.store(true, std::memory_order_release);
+}
+
+bool WarmupService::isReady() {
+    return g_ready.load(std::memory_order_acquire);
+}
+
+size_t WarmupService::warmedThreads() {
+    return g_warmed_threads.load();
+}
+
+size_t WarmupService::totalThreads() {
+    return g_total_threads.load();
+}
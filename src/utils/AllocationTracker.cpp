@@ -0,0 +1,124 @@
+#include "utils/AllocationTracker.h"
+#include "utils/ThreadBlocks.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<bool> AllocationTracker::enabled_{false};
+
+namespace {
+
+using BlackScholesUtil::PricingEngine;
+
+// Constant-initialized, so touching it from operator new never allocates or runs a guard
+thread_local AllocationCounts thread_counts;
+
+inline void countAllocation(size_t size) {
+    if (!AllocationTracker::enabled()) return;
+    ++thread_counts.allocations;
+    thread_counts.bytes += size;
+}
+
+inline void countFree(void* ptr) {
+    if (ptr && AllocationTracker::enabled()) ++thread_counts.frees;
+}
+
+void* allocate(size_t size) {
+    countAllocation(size);
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* ptr = std::malloc(size)) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* allocateAligned(size_t size, size_t alignment) {
+    countAllocation(size);
+    if (size == 0) size = 1;
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    for (;;) {
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, alignment, size) == 0) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+struct alignas(64) ThreadEngines {
+    struct Engine {
+        std::atomic<uint64_t> invocations{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> frees{0};
+    };
+    Engine engines[AllocationTracker::kEngineCount];
+};
+
+ThreadBlocks<ThreadEngines>& registry() {
+    static ThreadBlocks<ThreadEngines> blocks;
+    return blocks;
+}
+
+} // namespace
+
+// The standard library routes the array and nothrow forms through these. The sized deletes
+// are replaced too, as replacing only the unsized ones leaves them on the library's defaults.
+void* operator new(size_t size) {
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    countFree(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    countFree(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    countFree(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    countFree(ptr);
+    std::free(ptr);
+}
+
+void AllocationTracker::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+const AllocationCounts* AllocationTracker::threadCounts() {
+    return &thread_counts;
+}
+
+void AllocationTracker::recordEngine(PricingEngine engine, const AllocationCounts& begin, const AllocationCounts& end) {
+    const AllocationCounts delta = end - begin;
+    ThreadEngines::Engine& slot = registry().local().engines[static_cast<size_t>(engine)];
+    bump(slot.invocations);
+    bump(slot.allocations, delta.allocations);
+    bump(slot.bytes, delta.bytes);
+    bump(slot.frees, delta.frees);
+}
+
+EngineAllocations AllocationTracker::engineTotals(PricingEngine engine) {
+    EngineAllocations totals;
+    const size_t e = static_cast<size_t>(engine);
+    registry().forEach([&](const ThreadEngines& block) {
+        const ThreadEngines::Engine& slot = block.engines[e];
+        totals.invocations += slot.invocations.load(std::memory_order_relaxed);
+        totals.counts.allocations += slot.allocations.load(std::memory_order_relaxed);
+        totals.counts.bytes += slot.bytes.load(std::memory_order_relaxed);
+        totals.counts.frees += slot.frees.load(std::memory_order_relaxed);
+    });
+    return totals;
+}
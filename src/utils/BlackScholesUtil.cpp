@@ -1,22 +1,39 @@
 // utils/BlackScholesUtil.cpp
 
 #include "utils/BlackScholesUtil.h"
+#include "utils/MappedStore.h"
+#include "utils/RoutingTable.h"
+#include "utils/TuningConfig.h"
 #include <boost/math/distributions/normal.hpp>
 #include <boost/math/distributions/gamma.hpp>
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_eigen.h>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <limits>
+#include <string>
 #include <vector>
 
 #if defined(__AVX2__)
-  #include <immintrin.h>
   #define BSU_HAS_AVX2 1
 #else
   #define BSU_HAS_AVX2 0
 #endif
 
+// The AVX2 kernels are also compiled into baseline x86-64 builds and picked at runtime
+// (setKernelIsa) on CPUs that support them.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  #include <immintrin.h>
+  #define BSU_CAN_DISPATCH_AVX2 1
+  #define BSU_AVX2_TARGET __attribute__((target("avx2")))
+#else
+  #define BSU_CAN_DISPATCH_AVX2 0
+  #define BSU_AVX2_TARGET
+#endif
+
 #if defined(__INTEL_COMPILER) || defined(__INTEL_LLVM_COMPILER)
   #define BSU_HAS_SVML 1
 #else
@@ -31,10 +48,6 @@
 #define BSU_FORCE_GSL_IN_FAST 0
 #endif
 
-#ifndef BSU_GL_ORDER
-#define BSU_GL_ORDER 32
-#endif
-
 namespace BlackScholesUtil {
 
 const double INTEGRATION_UPPER_BOUND = std::numeric_limits<double>::infinity();
@@ -194,8 +207,62 @@ struct GLTable {
 };
 static thread_local GLTable _glt = {0, std::numeric_limits<double>::quiet_NaN(), {}, {}};
 
-inline void _ensure_gl_table(int n, double a) {
-    if (_glt.n == n && std::abs(_glt.a - a) <= 0.0) return;
+static std::atomic<MappedStore*> _gl_store{nullptr};
+
+// Rebuilds are rare and cost an eigen-decomposition, so shared counters are fine here
+static std::atomic<uint64_t> _gl_builds{0};
+static std::atomic<uint64_t> _gl_store_loads{0};
+
+struct GLTableKey {
+    int32_t n;
+    int32_t reserved;
+    double  a;
+};
+
+inline uint64_t _gl_key_hash(const GLTableKey& key) {
+    uint64_t bits;
+    std::memcpy(&bits, &key.a, sizeof(bits));
+    uint64_t h = bits ^ (static_cast<uint64_t>(key.n) * 0x9e3779b97f4a7c15ULL);
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+// Node tables are stored as x[0..n) followed by w[0..n).
+inline bool _load_gl_table(MappedStore* store, int n, double a) {
+    const GLTableKey key{n, 0, a};
+    static thread_local std::vector<double> buf;
+    buf.resize(2 * static_cast<size_t>(n));
+    size_t size = 0;
+    if (!store->lookup(_gl_key_hash(key), &key, sizeof(key), buf.data(), buf.size() * sizeof(double), &size) ||
+        size != buf.size() * sizeof(double)) {
+        return false;
+    }
+    _glt.n = n;
+    _glt.a = a;
+    _glt.x.assign(buf.begin(), buf.begin() + n);
+    _glt.w.assign(buf.begin() + n, buf.end());
+    return true;
+}
+
+inline void _save_gl_table(MappedStore* store) {
+    const GLTableKey key{_glt.n, 0, _glt.a};
+    static thread_local std::vector<double> buf;
+    buf.assign(_glt.x.begin(), _glt.x.end());
+    buf.insert(buf.end(), _glt.w.begin(), _glt.w.end());
+    store->insert(_gl_key_hash(key), &key, sizeof(key), buf.data(), buf.size() * sizeof(double));
+}
+
+// Returns true when the thread's table had to be replaced.
+inline bool _ensure_gl_table(int n, double a) {
+    if (_glt.n == n && std::abs(_glt.a - a) <= 0.0) return false;
+
+    MappedStore* store = _gl_store.load(std::memory_order_acquire);
+    if (store && _load_gl_table(store, n, a)) {
+        _gl_store_loads.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    _gl_builds.fetch_add(1, std::memory_order_relaxed);
 
     gsl_matrix* J = gsl_matrix_calloc(n, n);
     for (int i = 0; i < n; ++i) {
@@ -221,30 +288,36 @@ inline void _ensure_gl_table(int n, double a) {
     _glt.x.resize(n);
     _glt.w.resize(n);
 
-    const double mu0 = std::tgamma(a + 1.0);
+    // Weights normalized by the total mass Gamma(a + 1), so the sums are expectations under
+    // the gamma density directly; Gamma(a + 1) itself overflows once alpha passes about 171
     for (int j = 0; j < n; ++j) {
         const double xj = gsl_vector_get(eval, j);
         const double v0 = gsl_matrix_get(evec, 0, j);
         _glt.x[j] = xj;
-        _glt.w[j] = mu0 * (v0 * v0);
+        _glt.w[j] = v0 * v0;
     }
 
     gsl_matrix_free(evec);
     gsl_vector_free(eval);
     gsl_matrix_free(J);
+
+    if (store) _save_gl_table(store);
+    return true;
 }
 
-#if BSU_HAS_AVX2
-  static inline __m256d vset1(double x){ return _mm256_set1_pd(x); }
-  static inline __m256d vloadu(const double* p){ return _mm256_loadu_pd(p); }
-  static inline void     vstoreu(double* p, __m256d v){ _mm256_storeu_pd(p, v); }
-  static inline __m256d vmul(__m256d a, __m256d b){ return _mm256_mul_pd(a,b); }
-  static inline __m256d vadd(__m256d a, __m256d b){ return _mm256_add_pd(a,b); }
-  static inline __m256d vsub(__m256d a, __m256d b){ return _mm256_sub_pd(a,b); }
-  static inline __m256d vdiv(__m256d a, __m256d b){ return _mm256_div_pd(a,b); }
-  static inline __m256d vsqrt(__m256d a){ return _mm256_sqrt_pd(a); }
+static std::atomic<int> _kernel_isa{static_cast<int>(BSU_HAS_AVX2 ? KernelIsa::AVX2 : KernelIsa::SCALAR)};
+
+#if BSU_CAN_DISPATCH_AVX2
+  BSU_AVX2_TARGET static inline __m256d vset1(double x){ return _mm256_set1_pd(x); }
+  BSU_AVX2_TARGET static inline __m256d vloadu(const double* p){ return _mm256_loadu_pd(p); }
+  BSU_AVX2_TARGET static inline void     vstoreu(double* p, __m256d v){ _mm256_storeu_pd(p, v); }
+  BSU_AVX2_TARGET static inline __m256d vmul(__m256d a, __m256d b){ return _mm256_mul_pd(a,b); }
+  BSU_AVX2_TARGET static inline __m256d vadd(__m256d a, __m256d b){ return _mm256_add_pd(a,b); }
+  BSU_AVX2_TARGET static inline __m256d vsub(__m256d a, __m256d b){ return _mm256_sub_pd(a,b); }
+  BSU_AVX2_TARGET static inline __m256d vdiv(__m256d a, __m256d b){ return _mm256_div_pd(a,b); }
+  BSU_AVX2_TARGET static inline __m256d vsqrt(__m256d a){ return _mm256_sqrt_pd(a); }
 
-  static inline __m256d vexp(__m256d a){
+  BSU_AVX2_TARGET static inline __m256d vexp(__m256d a){
   #if BSU_HAS_SVML
       return _mm256_exp_pd(a);
   #else
@@ -253,7 +326,7 @@ inline void _ensure_gl_table(int n, double a) {
       return vloadu(tmp);
   #endif
   }
-  static inline __m256d verfc(__m256d a){
+  BSU_AVX2_TARGET static inline __m256d verfc(__m256d a){
   #if BSU_HAS_SVML
       return _mm256_erfc_pd(a);
   #else
@@ -263,7 +336,7 @@ inline void _ensure_gl_table(int n, double a) {
   #endif
   }
 
-  static inline double hsum(__m256d v){
+  BSU_AVX2_TARGET static inline double hsum(__m256d v){
       __m256d t = _mm256_hadd_pd(v, v);
       __m128d lo = _mm256_castpd256_pd128(t);
       __m128d hi = _mm256_extractf128_pd(t, 1);
@@ -273,23 +346,17 @@ inline void _ensure_gl_table(int n, double a) {
       return out[0];
   }
 
-  static inline __m256d vphi(__m256d x){
+  BSU_AVX2_TARGET static inline __m256d vphi(__m256d x){
       const __m256d c = vset1(-M_SQRT1_2);
       return vmul(vset1(0.5), verfc(vmul(c, x)));
   }
 
-#endif
-
-inline double _gl_price_call_simd(double S, double K, double vol, double r,
-                                  double alpha, double beta, int n){
-    const double invGamma = 1.0 / std::tgamma(alpha);
-    _ensure_gl_table(n, /*a=*/alpha - 1.0);
-
-#if BSU_HAS_AVX2
+// Weighted sums over the thread's node table: expectations under the gamma density
+BSU_AVX2_TARGET static double _gl_sum_call_avx2(double S, double K, double vol, double r,
+                                                double beta, int n){
     const __m256d vS   = vset1(S);
     const __m256d vK   = vset1(K);
     const __m256d vVol = vset1(vol);
-    const __m256d vR   = vset1(r);
     const __m256d vB   = vset1(r + 0.5 * vol * vol);
     const __m256d vA   = vset1(std::log(S / K));
     const __m256d vBeta= vset1(beta);
@@ -327,27 +394,12 @@ inline double _gl_price_call_simd(double S, double K, double vol, double r,
         const double price = S * _fast_norm_cdf(d1) - K * std::exp(-r*t) * _fast_norm_cdf(d2);
         sum += _glt.w[i] * price;
     }
-    return invGamma * sum;
-#else
-    double sum = 0.0;
-    for (int i=0;i<n;++i){
-        const double t  = _glt.x[i] / beta;
-        const double price = _fast_bs_call(S, K, t, vol, r);
-        sum += _glt.w[i] * price;
-    }
-    return invGamma * sum;
-#endif
+    return sum;
 }
 
-inline double _gl_price_binary_simd(double S, double K, double vol, double r,
-                                    double alpha, double beta, int n){
-    const double invGamma = 1.0 / std::tgamma(alpha);
-    _ensure_gl_table(n, /*a=*/alpha - 1.0);
-
-#if BSU_HAS_AVX2
-    const __m256d vK   = vset1(K);
+BSU_AVX2_TARGET static double _gl_sum_binary_avx2(double S, double K, double vol, double r,
+                                                  double beta, int n){
     const __m256d vVol = vset1(vol);
-    const __m256d vR   = vset1(r);
     const __m256d vB   = vset1(r + 0.5 * vol * vol);
     const __m256d vA   = vset1(std::log(S / K));
     const __m256d vBeta= vset1(beta);
@@ -377,74 +429,245 @@ inline double _gl_price_binary_simd(double S, double K, double vol, double r,
         const double price = _fast_bs_binary_call(S, K, t, vol, r);
         sum += _glt.w[i] * price;
     }
-    return invGamma * sum;
-#else
+    return sum;
+}
+
+// One maturity row of an option chain: S, log S, sqrt(T) and exp(-rT) are shared by the row,
+// log K by every row. Cells with a non-positive strike or volatility are left for the caller.
+BSU_AVX2_TARGET static void _chain_row_avx2(double S, double logS, double r, double T, double sqrtT, double disc,
+                                            const double* K, const double* logK, const double* vol,
+                                            size_t n, double* out){
+    const __m256d vS     = vset1(S);
+    const __m256d vLogS  = vset1(logS);
+    const __m256d vR     = vset1(r);
+    const __m256d vT     = vset1(T);
+    const __m256d vSqrtT = vset1(sqrtT);
+    const __m256d vDisc  = vset1(disc);
+    const __m256d vHalf  = vset1(0.5);
+
+    size_t i = 0;
+    for (; i + 3 < n; i += 4) {
+        __m256d k   = vloadu(&K[i]);
+        __m256d v   = vloadu(&vol[i]);
+        __m256d vs  = vmul(v, vSqrtT);
+        __m256d num = vadd(vsub(vLogS, vloadu(&logK[i])), vmul(vadd(vR, vmul(vHalf, vmul(v, v))), vT));
+        __m256d d1  = vdiv(num, vs);
+        __m256d d2  = vsub(d1, vs);
+        vstoreu(&out[i], vsub(vmul(vS, vphi(d1)), vmul(k, vmul(vDisc, vphi(d2)))));
+    }
+    for (; i < n; ++i) {
+        const double vs = vol[i] * sqrtT;
+        const double d1 = (logS - logK[i] + (r + 0.5 * vol[i] * vol[i]) * T) / vs;
+        out[i] = S * _fast_norm_cdf(d1) - K[i] * disc * _fast_norm_cdf(d1 - vs);
+    }
+}
+
+#endif
+
+static void _chain_row_scalar(double S, double logS, double r, double T, double sqrtT, double disc,
+                              const double* K, const double* logK, const double* vol,
+                              size_t n, double* out){
+    for (size_t i = 0; i < n; ++i) {
+        const double vs = vol[i] * sqrtT;
+        const double d1 = (logS - logK[i] + (r + 0.5 * vol[i] * vol[i]) * T) / vs;
+        out[i] = S * _fast_norm_cdf(d1) - K[i] * disc * _fast_norm_cdf(d1 - vs);
+    }
+}
+
+static double _gl_sum_call_scalar(double S, double K, double vol, double r, double beta, int n){
+    double sum = 0.0;
+    for (int i=0;i<n;++i){
+        const double t  = _glt.x[i] / beta;
+        const double price = _fast_bs_call(S, K, t, vol, r);
+        sum += _glt.w[i] * price;
+    }
+    return sum;
+}
+
+static double _gl_sum_binary_scalar(double S, double K, double vol, double r, double beta, int n){
     double sum = 0.0;
     for (int i=0;i<n;++i){
         const double t  = _glt.x[i] / beta;
         const double price = _fast_bs_binary_call(S, K, t, vol, r);
         sum += _glt.w[i] * price;
     }
-    return invGamma * sum;
+    return sum;
+}
+
+inline double _gl_price_simd(double S, double K, double vol, double r,
+                             double alpha, double beta, int n, bool is_binary, KernelIsa isa,
+                             PricingDiagnostics* diagnostics){
+    const bool rebuilt = _ensure_gl_table(n, /*a=*/alpha - 1.0);
+    if (diagnostics) {
+        diagnostics->evaluations = n;
+        diagnostics->table_rebuilt = rebuilt;
+    }
+
+#if BSU_CAN_DISPATCH_AVX2
+    if (isa == KernelIsa::AVX2) {
+        return is_binary ? _gl_sum_binary_avx2(S, K, vol, r, beta, n)
+                         : _gl_sum_call_avx2(S, K, vol, r, beta, n);
+    }
 #endif
+    return is_binary ? _gl_sum_binary_scalar(S, K, vol, r, beta, n)
+                     : _gl_sum_call_scalar(S, K, vol, r, beta, n);
+}
+
+inline double _gl_price_call_simd(double S, double K, double vol, double r,
+                                  double alpha, double beta, int n,
+                                  PricingDiagnostics* diagnostics){
+    return _gl_price_simd(S, K, vol, r, alpha, beta, n, /*is_binary=*/false,
+                          static_cast<KernelIsa>(_kernel_isa.load(std::memory_order_relaxed)), diagnostics);
+}
+
+inline double _gl_price_binary_simd(double S, double K, double vol, double r,
+                                    double alpha, double beta, int n,
+                                    PricingDiagnostics* diagnostics){
+    return _gl_price_simd(S, K, vol, r, alpha, beta, n, /*is_binary=*/true,
+                          static_cast<KernelIsa>(_kernel_isa.load(std::memory_order_relaxed)), diagnostics);
 }
 
 struct _GslFastParams {
     double S, K, vol, r;
     double alpha;
-    double beta;
+    double beta;          // of the density of x = t / scale
+    double scale;
     double lognorm;
     bool   is_binary;
+    bool   in_power;      // integrating over u = x^alpha; see _integrate_gsl_fast_call
+    size_t evaluations;
 };
 
-static double _gsl_fast_integrand(double t, void* pp){
-    const _GslFastParams* p = static_cast<const _GslFastParams*>(pp);
-    if (t <= 0.0) return 0.0;
+static double _gsl_fast_integrand(double x, void* pp){
+    _GslFastParams* p = static_cast<_GslFastParams*>(pp);
+    ++p->evaluations;
+    double lp;
+    if (p->in_power) {
+        // u = x^alpha carries the density's x^(alpha - 1) factor, leaving 1 / alpha in lognorm
+        const double u = x;
+        x = std::pow(u, 1.0 / p->alpha);
+        if (x <= 0.0) return 0.0;
+        lp = -p->beta * x + p->lognorm;
+    } else {
+        if (x <= 0.0) return 0.0;
+        lp = (p->alpha - 1.0) * std::log(x) - p->beta * x + p->lognorm;
+    }
+
+    // The tail where the weight underflows is skipped, including x beyond the double range
+    const double weight = std::isfinite(lp) ? std::exp(lp) : 0.0;
+    if (weight == 0.0) return 0.0;
 
+    const double t = p->scale * x;
     double price = p->is_binary
         ? _fast_bs_binary_call(p->S, p->K, t, p->vol, p->r)
         : _fast_bs_call       (p->S, p->K, t, p->vol, p->r);
-
-    const double lp = (p->alpha - 1.0) * std::log(t) - p->beta * t + p->lognorm;
-    return std::isfinite(lp) ? price * std::exp(lp) : 0.0;
+    return price * weight;
 }
 
-static gsl_integration_workspace* _gsl_ws_fast(){
-    static thread_local gsl_integration_workspace* w = gsl_integration_workspace_alloc(8192);
+static gsl_integration_workspace* _gsl_ws_fast(size_t limit){
+    // Grows when a reload raises qagiu_limit above the current workspace size
+    static thread_local gsl_integration_workspace* w = nullptr;
+    static thread_local size_t w_size = 0;
+    limit = std::max<size_t>(limit, 8192);
+    if (w_size < limit) {
+        if (w) gsl_integration_workspace_free(w);
+        w = gsl_integration_workspace_alloc(limit);
+        w_size = limit;
+    }
     return w;
 }
 
 inline double _integrate_gsl_fast_call(double S,double K,double vol,double r,
-                                       double alpha,double beta,bool is_binary){
+                                       double alpha,double beta,bool is_binary,
+                                       const TuningParameters& tuning,
+                                       PricingDiagnostics* diagnostics){
+    // QAGIU's first panels cover an integration variable of order 1, so over t they would step
+    // past the narrow peak of a long holding period and return 0. The integral runs over
+    // x = t / scale instead, with the density's mass at x of order 1 whatever the holding period.
+    // Below alpha = 1 the density is singular at x = 0, and QAGIU loses the mass piled up
+    // there; over u = x^alpha the integrand is smooth, with the option's intrinsic value at 0.
+    // There the scale is 1 / beta, which leaves a weight flat in u up to u = 1 and negligible
+    // past 2, where the mean would leave most of the mass in a tail the first panels skip.
+    const bool in_power = alpha < 1.0;
+    const double scale = in_power ? 1.0 / beta : alpha / beta;
     _GslFastParams P{
         S, K, vol, r,
-        alpha, beta,
-        alpha * std::log(beta) - std::lgamma(alpha),
-        is_binary
+        alpha, beta * scale, scale,
+        alpha * std::log(beta * scale) - std::lgamma(alpha) - (in_power ? std::log(alpha) : 0.0),
+        is_binary,
+        in_power,
+        0
     };
     gsl_function F; F.function = &_gsl_fast_integrand; F.params = &P;
     double result = 0.0, error = 0.0;
-    gsl_integration_qagiu(&F, 0.0, 1e-9, 1e-9, 8192, _gsl_ws_fast(), &result, &error);
+    gsl_integration_qagiu(&F, 0.0, tuning.qagiu_epsabs, tuning.qagiu_epsrel, tuning.qagiu_limit,
+                          _gsl_ws_fast(tuning.qagiu_limit), &result, &error);
+    if (diagnostics) {
+        diagnostics->evaluations = static_cast<int>(P.evaluations);
+        diagnostics->abs_error = error;
+    }
     return result;
 }
 
-inline bool _prefer_gsl_for_gamma(double H, double sigmaH, double alpha){
+inline void _note_engine(PricingDiagnostics* diagnostics, PricingEngine engine){
+    if (diagnostics) diagnostics->engine = engine;
+}
+
+inline void _note_gamma(PricingDiagnostics* diagnostics, double alpha, double beta){
+    if (!diagnostics) return;
+    diagnostics->alpha = alpha;
+    diagnostics->beta  = beta;
+}
+
+inline bool _prefer_gsl_for_gamma(double H, double sigmaH, double alpha, const TuningParameters& tuning){
     if (H <= 0.0 || sigmaH <= 0.0) return false;
     const double cv = sigmaH / H;
-    return (cv >= 1.5) || (alpha < 0.5);
+    return (cv >= tuning.gsl_cv_threshold) || (alpha < tuning.gsl_alpha_threshold);
+}
+
+// Above this shape the density is so narrow that QAGIU's first panels can step over its
+// peak and return 0; Gauss-Laguerre nodes follow the shape and stay accurate
+constexpr double kQagiuMaxAlpha = 1000.0;
+
+// Below this vol * sqrt(H) a price is nearly a kink in the expiration time (a step for a
+// binary), which Gauss-Laguerre's fixed nodes miss by up to 1e-1; QAGIU adapts to it
+constexpr double kGLMinVolSqrtH = 0.03;
+
+
+// Engine for a random expiration price with S, K, vol and H positive. The shortcut ratio and
+// the alpha limits hold whatever a loaded routing table says; between them the table's cell
+// decides, or the threshold heuristics without one.
+inline RouteDecision _route(bool is_binary, double S, double K, double vol, double H, double sigmaH,
+                            const TuningParameters& tuning){
+    if (sigmaH == 0) return {PricingEngine::ANALYTIC_SHORTCUT, 0};
+    if (H / std::max(sigmaH, 1e-300) >= tuning.analytic_shortcut_ratio) return {PricingEngine::ANALYTIC_SHORTCUT, 0};
+
+    const double var_t = std::max(sigmaH * sigmaH, 1e-12);
+    const double alpha = std::max((H * H) / var_t, 1e-12);
+    if (alpha < tuning.gsl_alpha_threshold) return {PricingEngine::GSL_QAGIU, 0};
+    if (alpha >= kQagiuMaxAlpha) return {PricingEngine::GAUSS_LAGUERRE, tuning.gl_order};
+    if (tuning.routing_table) return tuning.routing_table->route(is_binary, S, K, vol, H, sigmaH);
+    if (_prefer_gsl_for_gamma(H, std::sqrt(var_t), alpha, tuning)) return {PricingEngine::GSL_QAGIU, 0};
+    if (vol * std::sqrt(H) < kGLMinVolSqrtH) return {PricingEngine::GSL_QAGIU, 0};
+    return {PricingEngine::GAUSS_LAGUERRE, tuning.gl_order};
 }
 
 }
 
 double calculateRandomExpirationCall(double stock_price, double strike_price,
                                      double volatility, double risk_free_rate,
-                                     double holding_period, double volatility_around_holding_period) {
+                                     double holding_period, double volatility_around_holding_period,
+                                     PricingDiagnostics* diagnostics) {
+    if (diagnostics) *diagnostics = PricingDiagnostics{};
     if (strike_price <= 0) return stock_price;
     if (stock_price <= 0)  return 0.0;
     if (volatility <= 0 || holding_period <= 0) return std::max(0.0, stock_price - strike_price);
 
-    if (volatility_around_holding_period == 0 ||
-        holding_period / std::max(volatility_around_holding_period, 1e-300) >= 50) {
+    const TuningParameters& tuning = TuningConfig::current();
+    const RouteDecision route = _route(/*is_binary=*/false, stock_price, strike_price, volatility,
+                                       holding_period, volatility_around_holding_period, tuning);
+    if (route.engine == PricingEngine::ANALYTIC_SHORTCUT) {
+        _note_engine(diagnostics, PricingEngine::ANALYTIC_SHORTCUT);
         return _fast_bs_call(stock_price, strike_price, holding_period, volatility, risk_free_rate);
     }
 
@@ -452,33 +675,42 @@ double calculateRandomExpirationCall(double stock_price, double strike_price,
     const double var_t = std::max(volatility_around_holding_period * volatility_around_holding_period, 1e-12);
     const double alpha = std::max((holding_period * holding_period) / var_t, 1e-12);
     const double beta  = holding_period / var_t;
+    _note_engine(diagnostics, PricingEngine::GSL_QAGIU);
+    _note_gamma(diagnostics, alpha, beta);
     return _integrate_gsl_fast_call(stock_price, strike_price, volatility, risk_free_rate,
-                                    alpha, beta, /*is_binary=*/false);
+                                    alpha, beta, /*is_binary=*/false, tuning, diagnostics);
 #else
     const double var_t  = std::max(volatility_around_holding_period * volatility_around_holding_period, 1e-12);
     const double alpha  = std::max((holding_period * holding_period) / var_t, 1e-12);
     const double beta   = holding_period / var_t;
-    const double sigmaH = std::sqrt(var_t);
+    _note_gamma(diagnostics, alpha, beta);
 
-    if (_prefer_gsl_for_gamma(holding_period, sigmaH, alpha)) {
+    if (route.engine == PricingEngine::GSL_QAGIU) {
+        _note_engine(diagnostics, PricingEngine::GSL_QAGIU);
         return _integrate_gsl_fast_call(stock_price, strike_price, volatility, risk_free_rate,
-                                        alpha, beta, /*is_binary=*/false);
+                                        alpha, beta, /*is_binary=*/false, tuning, diagnostics);
     } else {
+        _note_engine(diagnostics, PricingEngine::GAUSS_LAGUERRE);
         return _gl_price_call_simd(stock_price, strike_price, volatility, risk_free_rate,
-                                   alpha, beta, BSU_GL_ORDER);
+                                   alpha, beta, route.gl_order, diagnostics);
     }
 #endif
 }
 
 double calculateRandomExpirationBinaryCall(double stock_price, double strike_price,
                                            double volatility, double risk_free_rate,
-                                           double holding_period, double volatility_around_holding_period) {
+                                           double holding_period, double volatility_around_holding_period,
+                                           PricingDiagnostics* diagnostics) {
+    if (diagnostics) *diagnostics = PricingDiagnostics{};
     if (strike_price <= 0) return 1.0;
     if (stock_price <= 0)  return 0.0;
     if (volatility <= 0 || holding_period <= 0) return (stock_price > strike_price) ? 1.0 : 0.0;
 
-    if (volatility_around_holding_period == 0 ||
-        holding_period / std::max(volatility_around_holding_period, 1e-300) >= 50) {
+    const TuningParameters& tuning = TuningConfig::current();
+    const RouteDecision route = _route(/*is_binary=*/true, stock_price, strike_price, volatility,
+                                       holding_period, volatility_around_holding_period, tuning);
+    if (route.engine == PricingEngine::ANALYTIC_SHORTCUT) {
+        _note_engine(diagnostics, PricingEngine::ANALYTIC_SHORTCUT);
         return _fast_bs_binary_call(stock_price, strike_price, holding_period, volatility, risk_free_rate);
     }
 
@@ -486,24 +718,119 @@ double calculateRandomExpirationBinaryCall(double stock_price, double strike_pri
     const double var_t = std::max(volatility_around_holding_period * volatility_around_holding_period, 1e-12);
     const double alpha = std::max((holding_period * holding_period) / var_t, 1e-12);
     const double beta  = holding_period / var_t;
+    _note_engine(diagnostics, PricingEngine::GSL_QAGIU);
+    _note_gamma(diagnostics, alpha, beta);
     return _integrate_gsl_fast_call(stock_price, strike_price, volatility, risk_free_rate,
-                                    alpha, beta, /*is_binary=*/true);
+                                    alpha, beta, /*is_binary=*/true, tuning, diagnostics);
 #else
     const double var_t  = std::max(volatility_around_holding_period * volatility_around_holding_period, 1e-12);
     const double alpha  = std::max((holding_period * holding_period) / var_t, 1e-12);
     const double beta   = holding_period / var_t;
-    const double sigmaH = std::sqrt(var_t);
+    _note_gamma(diagnostics, alpha, beta);
 
-    if (_prefer_gsl_for_gamma(holding_period, sigmaH, alpha)) {
+    if (route.engine == PricingEngine::GSL_QAGIU) {
+        _note_engine(diagnostics, PricingEngine::GSL_QAGIU);
         return _integrate_gsl_fast_call(stock_price, strike_price, volatility, risk_free_rate,
-                                        alpha, beta, /*is_binary=*/true);
+                                        alpha, beta, /*is_binary=*/true, tuning, diagnostics);
     } else {
+        _note_engine(diagnostics, PricingEngine::GAUSS_LAGUERRE);
         return _gl_price_binary_simd(stock_price, strike_price, volatility, risk_free_rate,
-                                     alpha, beta, BSU_GL_ORDER);
+                                     alpha, beta, route.gl_order, diagnostics);
     }
 #endif
 }
 
+Greeks calculateStandardCallGreeks(double stock_price, double strike_price,
+                                   double time_to_maturity, double volatility,
+                                   double risk_free_rate) {
+    Greeks greeks;
+    if (strike_price <= 0) {
+        greeks.delta = 1.0;
+        return greeks;
+    }
+    if (stock_price <= 0) return greeks;
+    if (volatility <= 0 || time_to_maturity <= 0) {
+        greeks.delta = (stock_price > strike_price) ? 1.0 : 0.0;
+        return greeks;
+    }
+
+    const double rt = std::sqrt(time_to_maturity);
+    const double vs = volatility * rt;
+    const double d1 = (std::log(stock_price / strike_price) + (risk_free_rate + 0.5 * volatility * volatility) * time_to_maturity) / vs;
+    const double d2 = d1 - vs;
+    const double discounted_strike = strike_price * std::exp(-risk_free_rate * time_to_maturity);
+
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    const double pdf_d1 = boost::math::pdf(normal, d1);
+    const double cdf_d2 = boost::math::cdf(normal, d2);
+    greeks.delta = boost::math::cdf(normal, d1);
+    greeks.gamma = pdf_d1 / (stock_price * vs);
+    greeks.vega  = stock_price * pdf_d1 * rt;
+    greeks.theta = -stock_price * pdf_d1 * volatility / (2.0 * rt) - risk_free_rate * discounted_strike * cdf_d2;
+    greeks.rho   = time_to_maturity * discounted_strike * cdf_d2;
+    return greeks;
+}
+
+Greeks calculateBinaryCallGreeks(double stock_price, double strike_price,
+                                 double time_to_maturity, double volatility,
+                                 double risk_free_rate) {
+    Greeks greeks;
+    if (strike_price <= 0 || stock_price <= 0 || volatility <= 0 || time_to_maturity <= 0) return greeks;
+
+    const double rt = std::sqrt(time_to_maturity);
+    const double vs = volatility * rt;
+    const double d1 = (std::log(stock_price / strike_price) + (risk_free_rate + 0.5 * volatility * volatility) * time_to_maturity) / vs;
+    const double d2 = d1 - vs;
+    const double discount = std::exp(-risk_free_rate * time_to_maturity);
+
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    const double pdf_d2 = discount * boost::math::pdf(normal, d2);
+    const double cdf_d2 = discount * boost::math::cdf(normal, d2);
+    // d(d2)/dT, for theta
+    const double dd2_dt = (risk_free_rate - 0.5 * volatility * volatility) / vs - d2 / (2.0 * time_to_maturity);
+    greeks.delta = pdf_d2 / (stock_price * vs);
+    greeks.gamma = -pdf_d2 * d1 / (stock_price * stock_price * vs * vs);
+    greeks.vega  = -pdf_d2 * d1 / volatility;
+    greeks.theta = risk_free_rate * cdf_d2 - pdf_d2 * dd2_dt;
+    greeks.rho   = -time_to_maturity * cdf_d2 + pdf_d2 * rt / volatility;
+    return greeks;
+}
+
+namespace {
+
+// Relative bump of the stock price, volatility and holding period, and absolute bump of the
+// rate, for the finite-difference Greeks
+constexpr double kRelativeBump = 1e-3;
+constexpr double kRateBump = 1e-4;
+
+Greeks _random_expiration_greeks(bool is_binary, double S, double K, double vol, double r,
+                                 double H, double sigmaH, PricingDiagnostics* diagnostics){
+    PricingDiagnostics route;
+    if (is_binary) calculateRandomExpirationBinaryCall(S, K, vol, r, H, sigmaH, &route);
+    else           calculateRandomExpirationCall(S, K, vol, r, H, sigmaH, &route);
+    if (diagnostics) *diagnostics = route;
+    const int gl_order = (route.engine == PricingEngine::GAUSS_LAGUERRE) ? route.evaluations : 0;
+    return greeksRandomExpirationWithEngine(route.engine, is_binary, S, K, vol, r, H, sigmaH, gl_order);
+}
+
+}
+
+Greeks calculateRandomExpirationCallGreeks(double stock_price, double strike_price,
+                                           double volatility, double risk_free_rate,
+                                           double holding_period, double volatility_around_holding_period,
+                                           PricingDiagnostics* diagnostics) {
+    return _random_expiration_greeks(/*is_binary=*/false, stock_price, strike_price, volatility, risk_free_rate,
+                                     holding_period, volatility_around_holding_period, diagnostics);
+}
+
+Greeks calculateRandomExpirationBinaryCallGreeks(double stock_price, double strike_price,
+                                                 double volatility, double risk_free_rate,
+                                                 double holding_period, double volatility_around_holding_period,
+                                                 PricingDiagnostics* diagnostics) {
+    return _random_expiration_greeks(/*is_binary=*/true, stock_price, strike_price, volatility, risk_free_rate,
+                                     holding_period, volatility_around_holding_period, diagnostics);
+}
+
 std::vector<double> calculateMultipleStandardCalls(const std::vector<double>& stock_prices,
                                                   const std::vector<double>& strike_prices,
                                                   const std::vector<double>& time_to_maturities,
@@ -534,6 +861,68 @@ std::vector<double> calculateMultipleBinaryCalls(const std::vector<double>& stoc
     return results;
 }
 
+void calculateStandardCallChain(double stock_price, double risk_free_rate,
+                                const double* strike_prices, size_t strike_count,
+                                const double* time_to_maturities, size_t maturity_count,
+                                const double* volatilities, double* prices) {
+    if (strike_count == 0 || maturity_count == 0) return;
+    if (stock_price <= 0) {
+        std::fill(prices, prices + strike_count * maturity_count, 0.0);
+        return;
+    }
+
+    static thread_local std::vector<double> log_strikes;
+    log_strikes.resize(strike_count);
+    for (size_t j = 0; j < strike_count; ++j) {
+        log_strikes[j] = strike_prices[j] > 0 ? std::log(strike_prices[j]) : 0.0;
+    }
+    const double log_stock = std::log(stock_price);
+#if BSU_CAN_DISPATCH_AVX2
+    const bool avx2 = kernelIsa() == KernelIsa::AVX2;
+#endif
+
+    for (size_t m = 0; m < maturity_count; ++m) {
+        const double T = time_to_maturities[m];
+        const double* vol = volatilities + m * strike_count;
+        double* row = prices + m * strike_count;
+        if (T <= 0) {
+            for (size_t j = 0; j < strike_count; ++j) {
+                row[j] = _fast_bs_call(stock_price, strike_prices[j], T, vol[j], risk_free_rate);
+            }
+            continue;
+        }
+
+        const double sqrtT = std::sqrt(T);
+        const double disc = std::exp(-risk_free_rate * T);
+#if BSU_CAN_DISPATCH_AVX2
+        if (avx2) {
+            _chain_row_avx2(stock_price, log_stock, risk_free_rate, T, sqrtT, disc,
+                            strike_prices, log_strikes.data(), vol, strike_count, row);
+        } else
+#endif
+        _chain_row_scalar(stock_price, log_stock, risk_free_rate, T, sqrtT, disc,
+                          strike_prices, log_strikes.data(), vol, strike_count, row);
+
+        // The kernels assume a positive strike and volatility; the rest take the edge cases
+        for (size_t j = 0; j < strike_count; ++j) {
+            if (!(strike_prices[j] > 0) || !(vol[j] > 0)) {
+                row[j] = _fast_bs_call(stock_price, strike_prices[j], T, vol[j], risk_free_rate);
+            }
+        }
+    }
+}
+
+std::vector<double> calculateStandardCallChain(double stock_price, double risk_free_rate,
+                                               const std::vector<double>& strike_prices,
+                                               const std::vector<double>& time_to_maturities,
+                                               const std::vector<double>& volatilities) {
+    std::vector<double> results(strike_prices.size() * time_to_maturities.size());
+    calculateStandardCallChain(stock_price, risk_free_rate, strike_prices.data(), strike_prices.size(),
+                               time_to_maturities.data(), time_to_maturities.size(), volatilities.data(),
+                               results.data());
+    return results;
+}
+
 std::vector<double> calculateMultipleRandomExpirationCalls(const std::vector<double>& stock_prices,
                                                           const std::vector<double>& strike_prices,
                                                           const std::vector<double>& volatilities,
@@ -568,4 +957,161 @@ std::vector<double> calculateMultipleRandomExpirationBinaryCalls(const std::vect
     return results;
 }
 
+const char* kernelIsaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::SCALAR: return "scalar";
+        case KernelIsa::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+bool kernelIsaSupported(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::SCALAR:
+            return true;
+        case KernelIsa::AVX2:
+#if BSU_CAN_DISPATCH_AVX2
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+bool setKernelIsa(KernelIsa isa) {
+    if (!kernelIsaSupported(isa)) return false;
+    _kernel_isa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    return true;
+}
+
+KernelIsa kernelIsa() {
+    return static_cast<KernelIsa>(_kernel_isa.load(std::memory_order_relaxed));
+}
+
+namespace {
+
+// Tuned parameters with a caller's positive gl_order or qagiu_tolerance on top
+TuningParameters _tuning_with_overrides(int gl_order, double qagiu_tolerance){
+    TuningParameters tuning = TuningConfig::current();
+    if (gl_order > 0) tuning.gl_order = std::min(gl_order, TuningConfig::kMaxGLOrder);
+    if (qagiu_tolerance > 0.0) {
+        tuning.qagiu_epsabs = qagiu_tolerance;
+        tuning.qagiu_epsrel = qagiu_tolerance;
+    }
+    return tuning;
+}
+
+// A quadrature engine's price over a given gamma distribution of the expiration time
+inline double _price_with_gamma(PricingEngine engine, bool binary, double S, double K, double vol, double r,
+                                double alpha, double beta, const TuningParameters& tuning){
+    if (engine == PricingEngine::GAUSS_LAGUERRE) {
+        return _gl_price_simd(S, K, vol, r, alpha, beta, tuning.gl_order, binary, kernelIsa(), nullptr);
+    }
+    return _integrate_gsl_fast_call(S, K, vol, r, alpha, beta, binary, tuning, nullptr);
+}
+
+}
+
+double priceRandomExpirationWithEngine(PricingEngine engine, bool binary,
+                                       double stock_price, double strike_price,
+                                       double volatility, double risk_free_rate,
+                                       double holding_period, double volatility_around_holding_period,
+                                       int gl_order, double qagiu_tolerance) {
+    const TuningParameters tuning = _tuning_with_overrides(gl_order, qagiu_tolerance);
+    const double var_t = std::max(volatility_around_holding_period * volatility_around_holding_period, 1e-12);
+    const double alpha = std::max((holding_period * holding_period) / var_t, 1e-12);
+    const double beta  = holding_period / var_t;
+    switch (engine) {
+        case PricingEngine::CLOSED_FORM:
+        case PricingEngine::ANALYTIC_SHORTCUT:
+            return binary ? _fast_bs_binary_call(stock_price, strike_price, holding_period, volatility, risk_free_rate)
+                          : _fast_bs_call(stock_price, strike_price, holding_period, volatility, risk_free_rate);
+        case PricingEngine::GAUSS_LAGUERRE:
+        case PricingEngine::GSL_QAGIU:
+            return _price_with_gamma(engine, binary, stock_price, strike_price, volatility, risk_free_rate,
+                                     alpha, beta, tuning);
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+Greeks greeksRandomExpirationWithEngine(PricingEngine engine, bool binary,
+                                        double stock_price, double strike_price,
+                                        double volatility, double risk_free_rate,
+                                        double holding_period, double volatility_around_holding_period,
+                                        int gl_order, double qagiu_tolerance) {
+    // Edge cases and the shortcut price a fixed maturity at H, whose Greeks are exact
+    if (engine == PricingEngine::CLOSED_FORM || engine == PricingEngine::ANALYTIC_SHORTCUT ||
+        strike_price <= 0 || stock_price <= 0 || volatility <= 0 || holding_period <= 0) {
+        return binary ? calculateBinaryCallGreeks(stock_price, strike_price, holding_period, volatility, risk_free_rate)
+                      : calculateStandardCallGreeks(stock_price, strike_price, holding_period, volatility, risk_free_rate);
+    }
+
+    const TuningParameters tuning = _tuning_with_overrides(gl_order, qagiu_tolerance);
+    const double S = stock_price;
+    const double vol = volatility;
+    const double r = risk_free_rate;
+    const double H = holding_period;
+    const double var_t = std::max(volatility_around_holding_period * volatility_around_holding_period, 1e-12);
+    const double alpha = std::max((H * H) / var_t, 1e-12);
+    const double beta  = H / var_t;
+    // Every bump keeps the gamma shape, and so the thread's Gauss-Laguerre table; moving the
+    // mean H with alpha fixed holds sigmaH / H fixed
+    auto price = [&](double s, double v, double rate, double b) {
+        return _price_with_gamma(engine, binary, s, strike_price, v, rate, alpha, b, tuning);
+    };
+
+    const double dS = kRelativeBump * S;
+    const double dv = kRelativeBump * vol;
+    const double dH = kRelativeBump * H;
+    const double center = price(S, vol, r, beta);
+    const double up = price(S + dS, vol, r, beta);
+    const double down = price(S - dS, vol, r, beta);
+
+    Greeks greeks;
+    greeks.delta = (up - down) / (2.0 * dS);
+    greeks.gamma = (up - 2.0 * center + down) / (dS * dS);
+    greeks.vega  = (price(S, vol + dv, r, beta) - price(S, vol - dv, r, beta)) / (2.0 * dv);
+    greeks.theta = -(price(S, vol, r, alpha / (H + dH)) - price(S, vol, r, alpha / (H - dH))) / (2.0 * dH);
+    greeks.rho   = (price(S, vol, r + kRateBump, beta) - price(S, vol, r - kRateBump, beta)) / (2.0 * kRateBump);
+    return greeks;
+}
+
+std::string engineVersion() {
+    std::string version = "bsu-2;" + TuningConfig::current().fingerprint();
+    version += BSU_FORCE_GSL_IN_FAST ? ";force_gsl" : "";
+    version += std::string(";") + kernelIsaName(kernelIsa());
+    return version;
+}
+
+void setGLTableStore(MappedStore* store) {
+    _gl_store.store(store, std::memory_order_release);
+}
+
+bool glTableStoreAttached() {
+    return _gl_store.load(std::memory_order_acquire) != nullptr;
+}
+
+void prebuildGLTable(double alpha) {
+    _ensure_gl_table(TuningConfig::current().gl_order, std::max(alpha, 1e-12) - 1.0);
+}
+
+uint64_t glTableBuilds() {
+    return _gl_builds.load(std::memory_order_relaxed);
+}
+
+uint64_t glTableStoreLoads() {
+    return _gl_store_loads.load(std::memory_order_relaxed);
+}
+
+const char* engineName(PricingEngine engine) {
+    switch (engine) {
+        case PricingEngine::CLOSED_FORM:       return "closed_form";
+        case PricingEngine::ANALYTIC_SHORTCUT: return "analytic_shortcut";
+        case PricingEngine::GAUSS_LAGUERRE:    return "gauss_laguerre";
+        case PricingEngine::GSL_QAGIU:         return "gsl_qagiu";
+    }
+    return "unknown";
+}
+
 } // namespace BlackScholesUtil
@@ -0,0 +1,95 @@
+#include "utils/ClusterRouter.h"
+#include "utils/ConsistentHashRing.h"
+#include <trantor/net/EventLoop.h>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+struct RouterState {
+    ClusterConfig config;
+    ConsistentHashRing ring;
+};
+
+// Written once at startup before the listeners start, read-only afterwards.
+std::shared_ptr<const RouterState>& routerState() {
+    static std::shared_ptr<const RouterState> state;
+    return state;
+}
+
+drogon::HttpClientPtr clientFor(const std::string& peer) {
+    // HttpClient is bound to an event loop, so keep one client per peer per IO thread.
+    static thread_local std::unordered_map<std::string, drogon::HttpClientPtr> clients;
+    auto it = clients.find(peer);
+    if (it != clients.end()) return it->second;
+    auto client = drogon::HttpClient::newHttpClient("http://" + peer,
+                                                    trantor::EventLoop::getEventLoopOfCurrentThread());
+    clients.emplace(peer, client);
+    return client;
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+} // namespace
+
+ClusterConfig ClusterConfig::fromEnvironment() {
+    ClusterConfig config;
+    if (const char* self = std::getenv("BSS_CLUSTER_SELF")) config.self = self;
+    if (const char* peers = std::getenv("BSS_CLUSTER_PEERS")) config.peers = splitList(peers);
+    if (const char* vnodes = std::getenv("BSS_CLUSTER_VIRTUAL_NODES")) config.virtual_nodes = std::atoi(vnodes);
+    if (const char* timeout = std::getenv("BSS_CLUSTER_FORWARD_TIMEOUT")) config.forward_timeout_seconds = std::atof(timeout);
+    return config;
+}
+
+void ClusterRouter::configure(const ClusterConfig& config) {
+    auto state = std::make_shared<RouterState>(RouterState{config, ConsistentHashRing(config.virtual_nodes)});
+    for (const auto& peer : config.peers) state->ring.addNode(peer);
+    if (!config.self.empty()) state->ring.addNode(config.self);
+    routerState() = state;
+}
+
+bool ClusterRouter::enabled() {
+    const auto& state = routerState();
+    return state && !state->config.self.empty() && state->ring.nodes().size() > 1;
+}
+
+std::string ClusterRouter::ownerFor(uint64_t key_hash) {
+    const auto& state = routerState();
+    if (!state) return std::string();
+    const std::string& owner = state->ring.nodeFor(key_hash);
+    return owner == state->config.self ? std::string() : owner;
+}
+
+void ClusterRouter::forward(const std::string& peer, const drogon::HttpRequestPtr& req,
+                            std::function<void(const drogon::HttpResponsePtr&)> on_success,
+                            std::function<void()> on_failure) {
+    const auto& state = routerState();
+    auto forwarded = drogon::HttpRequest::newHttpRequest();
+    forwarded->setMethod(drogon::Post);
+    forwarded->setPath(req->path());
+    forwarded->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+    forwarded->setBody(std::string(req->getBody()));
+    forwarded->addHeader(kForwardedHeader, state ? state->config.self : std::string());
+
+    clientFor(peer)->sendRequest(
+        forwarded,
+        [on_success = std::move(on_success), on_failure = std::move(on_failure)](
+            drogon::ReqResult result, const drogon::HttpResponsePtr& resp) {
+            if (result != drogon::ReqResult::Ok || !resp || resp->statusCode() >= drogon::k500InternalServerError) {
+                on_failure();
+                return;
+            }
+            on_success(resp);
+        },
+        state ? state->config.forward_timeout_seconds : 0.5);
+}
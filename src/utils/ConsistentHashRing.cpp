@@ -0,0 +1,59 @@
+#include "utils/ConsistentHashRing.h"
+#include <algorithm>
+
+namespace {
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+ConsistentHashRing::ConsistentHashRing(int virtual_nodes)
+    : virtual_nodes_(std::max(virtual_nodes, 1)) {}
+
+uint64_t ConsistentHashRing::hashString(const std::string& value) {
+    // FNV-1a followed by a finalizer so that similar node names spread over the ring
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : value) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return mix64(h);
+}
+
+void ConsistentHashRing::addNode(const std::string& node) {
+    if (std::find(nodes_.begin(), nodes_.end(), node) != nodes_.end()) return;
+    nodes_.push_back(node);
+    rebuild();
+}
+
+void ConsistentHashRing::removeNode(const std::string& node) {
+    auto it = std::find(nodes_.begin(), nodes_.end(), node);
+    if (it == nodes_.end()) return;
+    nodes_.erase(it);
+    rebuild();
+}
+
+void ConsistentHashRing::rebuild() {
+    points_.clear();
+    points_.reserve(nodes_.size() * static_cast<size_t>(virtual_nodes_));
+    for (size_t n = 0; n < nodes_.size(); ++n) {
+        for (int v = 0; v < virtual_nodes_; ++v) {
+            points_.emplace_back(hashString(nodes_[n] + "#" + std::to_string(v)), n);
+        }
+    }
+    std::sort(points_.begin(), points_.end());
+}
+
+const std::string& ConsistentHashRing::nodeFor(uint64_t key_hash) const {
+    static const std::string none;
+    if (points_.empty()) return none;
+
+    auto it = std::lower_bound(points_.begin(), points_.end(), std::make_pair(key_hash, size_t{0}));
+    if (it == points_.end()) it = points_.begin();
+    return nodes_[it->second];
+}
@@ -1,4 +1,14 @@
 #include "utils/ControllerUtils.h"
+#include <cmath>
+
+namespace {
+
+// JSON has no NaN; quantities an engine did not produce are reported as null
+Json::Value finiteOrNull(double value) {
+    return std::isfinite(value) ? Json::Value(value) : Json::Value(Json::nullValue);
+}
+
+} // namespace
 
 Json::Value ControllerUtils::createSuccessResponse(const Json::Value& data) {
     Json::Value response;
@@ -15,6 +25,22 @@ Json::Value ControllerUtils::createErrorResponse(const std::string& error, int s
     return response;
 }
 
+Json::Value ControllerUtils::createDiagnostics(const BlackScholesUtil::PricingDiagnostics& diagnostics, bool cached) {
+    Json::Value block;
+    block["cached"] = cached;
+    if (cached) {
+        block["engine"] = "result_cache";
+        return block;
+    }
+    block["engine"] = BlackScholesUtil::engineName(diagnostics.engine);
+    block["evaluations"] = diagnostics.evaluations;
+    block["abs_error"] = finiteOrNull(diagnostics.abs_error);
+    block["alpha"] = finiteOrNull(diagnostics.alpha);
+    block["beta"] = finiteOrNull(diagnostics.beta);
+    block["table_rebuilt"] = diagnostics.table_rebuilt;
+    return block;
+}
+
 bool ControllerUtils::validatePositiveDouble(const Json::Value& body, const std::string& field, 
                                            double& value, std::string& error) {
     if (!body.isMember(field)) {
@@ -0,0 +1,110 @@
+#include "utils/ExactSum.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+void ExactSum::add(double x) {
+    ++count_;
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const int exponent = static_cast<int>((bits >> 52) & 0x7ff);
+    const bool negative = (bits >> 63) != 0;
+    if (exponent == 0x7ff) {
+        if ((bits & ((uint64_t(1) << 52) - 1)) != 0) {
+            nan_ = true;
+        } else {
+            (negative ? negative_infinity_ : positive_infinity_) = true;
+        }
+        return;
+    }
+
+    // x = mantissa * 2^(position - 1074): subnormals have no implicit bit and share the
+    // smallest normal exponent
+    uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+    if (exponent != 0) mantissa |= uint64_t(1) << 52;
+    if (mantissa == 0) return;
+    const int position = (exponent == 0 ? 1 : exponent) - 1;
+
+    const int digit = position / kDigitBits;
+    const unsigned __int128 shifted = static_cast<unsigned __int128>(mantissa) << (position % kDigitBits);
+    const int64_t parts[3] = {static_cast<int64_t>(shifted & 0xffffffffu),
+                              static_cast<int64_t>((shifted >> 32) & 0xffffffffu),
+                              static_cast<int64_t>(shifted >> 64)};
+    for (int i = 0; i < 3 && digit + i < kDigits; ++i) {
+        digits_[digit + i] += negative ? -parts[i] : parts[i];
+    }
+    if (++pending_ == kAddsBetweenCarries) propagateCarries();
+}
+
+void ExactSum::add(const double* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) add(values[i]);
+}
+
+void ExactSum::merge(const ExactSum& other) {
+    ExactSum carried = other;
+    carried.propagateCarries();
+    propagateCarries();
+    for (int i = 0; i < kDigits; ++i) digits_[i] += carried.digits_[i];
+    pending_ = 2;   // each digit is now the sum of two below 2^32
+    count_ += other.count_;
+    nan_ = nan_ || other.nan_;
+    positive_infinity_ = positive_infinity_ || other.positive_infinity_;
+    negative_infinity_ = negative_infinity_ || other.negative_infinity_;
+}
+
+// Leaves every digit but the top one in [0, 2^32); the top one carries the sign
+void ExactSum::propagateCarries() {
+    for (int i = 0; i + 1 < kDigits; ++i) {
+        const int64_t carry = digits_[i] >> kDigitBits;   // floor division, also for negative digits
+        digits_[i] -= carry * (int64_t(1) << kDigitBits);
+        digits_[i + 1] += carry;
+    }
+    pending_ = 0;
+}
+
+double ExactSum::value() const {
+    if (nan_ || (positive_infinity_ && negative_infinity_)) return std::numeric_limits<double>::quiet_NaN();
+    if (positive_infinity_) return std::numeric_limits<double>::infinity();
+    if (negative_infinity_) return -std::numeric_limits<double>::infinity();
+
+    ExactSum magnitude = *this;
+    magnitude.propagateCarries();
+    const bool negative = magnitude.digits_[kDigits - 1] < 0;
+    if (negative) {
+        for (int64_t& d : magnitude.digits_) d = -d;
+        magnitude.propagateCarries();
+    }
+
+    int top = kDigits - 1;
+    while (top >= 0 && magnitude.digits_[top] == 0) --top;
+    if (top < 0) return 0.0;
+
+    // The top three digits hold at least 65 significant bits whenever anything lies below
+    // them, so rounding them to 53 bits with a sticky bit for the rest is correct rounding.
+    // Below 2^-1022 there are at most 52 significant bits and nothing is rounded.
+    const int low = top >= 2 ? top - 2 : 0;
+    unsigned __int128 window = 0;
+    for (int i = top; i >= low; --i) {
+        window = (window << kDigitBits) | static_cast<uint64_t>(magnitude.digits_[i]);
+    }
+    bool sticky = false;
+    for (int i = 0; i < low; ++i) sticky = sticky || magnitude.digits_[i] != 0;
+
+    int width = 0;
+    for (unsigned __int128 w = window; w != 0; w >>= 1) ++width;
+    int shift = width > 53 ? width - 53 : 0;
+    uint64_t kept = static_cast<uint64_t>(window >> shift);
+    if (shift > 0) {
+        const unsigned __int128 rest = window & ((static_cast<unsigned __int128>(1) << shift) - 1);
+        const unsigned __int128 half = static_cast<unsigned __int128>(1) << (shift - 1);
+        if (rest > half || (rest == half && (sticky || (kept & 1)))) {
+            ++kept;
+            if (kept == uint64_t(1) << 53) {
+                kept >>= 1;
+                ++shift;
+            }
+        }
+    }
+    const double result = std::ldexp(static_cast<double>(kept), low * kDigitBits + shift - 1074);
+    return negative ? -result : result;
+}
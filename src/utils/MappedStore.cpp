@@ -0,0 +1,264 @@
+#include "utils/MappedStore.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char   kMagic[8]      = {'B', 'S', 'S', 'T', 'O', 'R', 'E', '3'};
+const size_t kMaxProbe      = 8;
+const size_t kVersionBytes  = 120;
+// A slot still owned by a writer this many epochs after it was claimed belongs to a writer
+// that died mid-write; live writers hold a slot for well under a microsecond.
+const uint32_t kReclaimAfterEpochs = 2;
+
+inline size_t alignUp(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+// A slot's state packs the epoch it was written in (high half) with a sequence counter (low
+// half), so a writer claims the slot and stamps its epoch in one compare-exchange. State 0
+// is a never-written slot; an odd counter means a writer owns the slot.
+inline uint64_t packState(uint32_t epoch, uint32_t seq) { return (static_cast<uint64_t>(epoch) << 32) | seq; }
+inline uint32_t stateEpoch(uint64_t state) { return static_cast<uint32_t>(state >> 32); }
+inline bool stateOwned(uint64_t state) { return (state & 1u) != 0; }
+
+inline bool abandoned(uint64_t state, uint32_t epoch) {
+    return stateOwned(state) && static_cast<uint32_t>(epoch - stateEpoch(state)) >= kReclaimAfterEpochs;
+}
+
+} // namespace
+
+struct MappedStore::Header {
+    char     magic[8];
+    uint64_t slot_count;
+    uint64_t slot_bytes;
+    uint64_t max_payload;
+    char     version[kVersionBytes];
+    std::atomic<uint32_t> epoch;
+    uint32_t reserved;
+};
+
+// A slot whose state names another epoch than the header's holds a dropped entry and counts
+// as free.
+struct MappedStore::Slot {
+    std::atomic<uint64_t> state;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint64_t hash;
+    unsigned char payload[1];
+};
+
+MappedStore::~MappedStore() {
+    close();
+}
+
+bool MappedStore::open(const std::string& path, size_t slot_count, size_t max_payload,
+                       const std::string& version, std::string& error) {
+    close();
+    if (slot_count == 0 || max_payload == 0) {
+        error = "slot_count and max_payload must be positive";
+        return false;
+    }
+    if (version.size() >= kVersionBytes) {
+        error = "version tag too long";
+        return false;
+    }
+
+    const size_t slot_bytes = alignUp(offsetof(Slot, payload) + max_payload, 64);
+    const size_t header_bytes = alignUp(sizeof(Header), 64);
+    const size_t total = header_bytes + slot_count * slot_bytes;
+
+    // Reuse the file as-is only when its layout and version tag match exactly
+    bool reuse = false;
+    fd_ = ::open(path.c_str(), O_RDWR);
+    struct stat st;
+    if (fd_ >= 0 && fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) == total) {
+        Header existing;
+        if (pread(fd_, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing))) {
+            reuse = std::memcmp(existing.magic, kMagic, sizeof(kMagic)) == 0 &&
+                    existing.slot_count == slot_count &&
+                    existing.slot_bytes == slot_bytes &&
+                    existing.max_payload == max_payload &&
+                    std::strncmp(existing.version, version.c_str(), kVersionBytes) == 0;
+        }
+    }
+
+    // Anything else is replaced by a new file built aside and renamed into place. Truncating
+    // the old one would raise SIGBUS in other processes that still have it mapped; they keep
+    // their mapping of the old file instead.
+    std::string fresh;
+    auto fail = [&](const std::string& what, const std::string& file) {
+        error = what + " " + file + ": " + std::strerror(errno);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        if (!fresh.empty()) ::unlink(fresh.c_str());
+        return false;
+    };
+    if (!reuse) {
+        if (fd_ >= 0) ::close(fd_);
+        fresh = path + ".new." + std::to_string(getpid());
+        fd_ = ::open(fresh.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return fail("Failed to open", fresh);
+        if (ftruncate(fd_, static_cast<off_t>(total)) != 0) return fail("Failed to size", fresh);
+    }
+
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) return fail("Failed to map", reuse ? path : fresh);
+
+    base_ = base;
+    mapped_bytes_ = total;
+    slot_count_ = slot_count;
+    slot_bytes_ = slot_bytes;
+    max_payload_ = max_payload;
+
+    if (!reuse) {
+        initialize(version);
+        if (std::rename(fresh.c_str(), path.c_str()) != 0) {
+            const int saved = errno;
+            close();
+            ::unlink(fresh.c_str());
+            error = "Failed to replace " + path + ": " + std::strerror(saved);
+            return false;
+        }
+    }
+    return true;
+}
+
+void MappedStore::initialize(const std::string& version) {
+    // A freshly sized file is zero-filled, which is the empty state for every slot and
+    // epoch 0.
+    Header* header = this->header();
+    header->slot_count = slot_count_;
+    header->slot_bytes = slot_bytes_;
+    header->max_payload = max_payload_;
+    std::strncpy(header->version, version.c_str(), kVersionBytes - 1);
+    // Written last so that a crash mid-initialization leaves an invalid file behind.
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, kMagic, sizeof(kMagic));
+    msync(base_, sizeof(Header), MS_ASYNC);
+}
+
+void MappedStore::close() {
+    if (base_) {
+        munmap(base_, mapped_bytes_);
+        base_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    mapped_bytes_ = slot_count_ = slot_bytes_ = max_payload_ = 0;
+}
+
+MappedStore::Slot* MappedStore::slotAt(size_t index) const {
+    char* slots = static_cast<char*>(base_) + alignUp(sizeof(Header), 64);
+    return reinterpret_cast<Slot*>(slots + index * slot_bytes_);
+}
+
+uint32_t MappedStore::epoch() const {
+    return base_ ? header()->epoch.load(std::memory_order_acquire) : 0;
+}
+
+bool MappedStore::lookup(uint64_t hash, const void* key, size_t key_size,
+                         void* value, size_t capacity, size_t* value_size) const {
+    if (!base_) return false;
+
+    const uint32_t epoch = this->epoch();
+    for (size_t probe = 0; probe < kMaxProbe; ++probe) {
+        Slot* slot = slotAt((hash + probe) % slot_count_);
+        const uint64_t before = slot->state.load(std::memory_order_acquire);
+        if (before == 0) return false;
+        if (stateOwned(before) || stateEpoch(before) != epoch) continue;
+        if (slot->hash != hash || slot->key_size != key_size) continue;
+
+        const uint32_t stored_size = slot->value_size;
+        if (key_size + stored_size > max_payload_) continue;
+        if (std::memcmp(slot->payload, key, key_size) != 0) continue;
+        std::memcpy(value, slot->payload + key_size, std::min<size_t>(stored_size, capacity));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->state.load(std::memory_order_relaxed) != before) continue;
+        if (value_size) *value_size = stored_size;
+        return true;
+    }
+    return false;
+}
+
+bool MappedStore::insert(uint64_t hash, const void* key, size_t key_size, const void* value, size_t value_size) {
+    return insert(hash, key, key_size, value, value_size, epoch());
+}
+
+bool MappedStore::insert(uint64_t hash, const void* key, size_t key_size, const void* value, size_t value_size,
+                         uint32_t epoch) {
+    if (!base_ || key_size + value_size > max_payload_) return false;
+
+    // Prefer an existing entry for the key, then an empty, dropped or abandoned slot, else
+    // evict the home slot.
+    Slot* target = nullptr;
+    for (size_t probe = 0; probe < kMaxProbe && !target; ++probe) {
+        Slot* slot = slotAt((hash + probe) % slot_count_);
+        const uint64_t state = slot->state.load(std::memory_order_acquire);
+        if (state == 0 || abandoned(state, epoch) ||
+            (!stateOwned(state) && (stateEpoch(state) != epoch ||
+                                    (slot->hash == hash && slot->key_size == key_size &&
+                                     std::memcmp(slot->payload, key, key_size) == 0)))) {
+            target = slot;
+        }
+    }
+    if (!target) target = slotAt(hash % slot_count_);
+
+    uint64_t state = target->state.load(std::memory_order_relaxed);
+    if (stateOwned(state) && !abandoned(state, epoch)) {
+        return false; // another writer owns the slot; caching is best effort
+    }
+    const uint32_t seq = static_cast<uint32_t>(state) + (stateOwned(state) ? 2 : 1);
+    const uint64_t writing = packState(epoch, seq);
+    if (!target->state.compare_exchange_strong(state, writing, std::memory_order_acquire)) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    target->hash = hash;
+    target->key_size = static_cast<uint32_t>(key_size);
+    target->value_size = static_cast<uint32_t>(value_size);
+    std::memcpy(target->payload, key, key_size);
+    std::memcpy(target->payload + key_size, value, value_size);
+
+    // Skip 0 on wrap-around, it marks a never-written slot. If the slot was reclaimed from
+    // under this writer, the new owner publishes it.
+    const uint32_t done = seq + 1 == 0 ? 2 : seq + 1;
+    uint64_t expected = writing;
+    return target->state.compare_exchange_strong(expected, packState(epoch, done), std::memory_order_release,
+                                                 std::memory_order_relaxed);
+}
+
+void MappedStore::clear() {
+    if (!base_) return;
+    header()->epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void MappedStore::reset(const std::string& version) {
+    if (!base_ || version.size() >= kVersionBytes) return;
+    // The old entries are dead before the tag changes, so a crash mid-reset never leaves
+    // them under the new tag
+    clear();
+    Header* header = this->header();
+    std::memset(header->version, 0, kVersionBytes);
+    std::strncpy(header->version, version.c_str(), kVersionBytes - 1);
+    msync(base_, sizeof(Header), MS_ASYNC);
+}
+
+size_t MappedStore::countEntries() const {
+    const uint32_t epoch = this->epoch();
+    size_t count = 0;
+    for (size_t i = 0; i < slot_count_; ++i) {
+        const uint64_t state = slotAt(i)->state.load(std::memory_order_relaxed);
+        if (state != 0 && !stateOwned(state) && stateEpoch(state) == epoch) ++count;
+    }
+    return count;
+}
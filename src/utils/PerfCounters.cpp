@@ -0,0 +1,180 @@
+#include "utils/PerfCounters.h"
+#include "utils/ThreadBlocks.h"
+#include <chrono>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+std::atomic<bool> PerfCounters::enabled_{false};
+
+namespace {
+
+using BlackScholesUtil::PricingEngine;
+
+const uint64_t kEventConfigs[PerfSample::kCounterCount] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+// The calling thread's counter group; the leader is the cycles event
+struct CounterGroup {
+    bool opened = false;
+    bool available = false;
+    int fds[PerfSample::kCounterCount] = {-1, -1, -1, -1};
+
+    ~CounterGroup() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    void open() {
+        opened = true;
+        for (size_t i = 0; i < PerfSample::kCounterCount; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = kEventConfigs[i];
+            attr.disabled = i == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+            if (fd < 0) return;
+            fds[i] = static_cast<int>(fd);
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        available = true;
+    }
+
+    bool read(uint64_t* values) {
+        if (!opened) open();
+        if (!available) return false;
+        // nr, time_enabled, time_running, then one value per event
+        uint64_t buf[3 + PerfSample::kCounterCount];
+        const ssize_t n = ::read(fds[0], buf, sizeof(buf));
+        if (n != static_cast<ssize_t>(sizeof(buf)) || buf[0] != PerfSample::kCounterCount) return false;
+        const uint64_t enabled = buf[1];
+        const uint64_t running = buf[2];
+        for (size_t i = 0; i < PerfSample::kCounterCount; ++i) {
+            // Scale up when the group shared the PMU with other events
+            values[i] = running > 0 && running < enabled
+                ? static_cast<uint64_t>(static_cast<double>(buf[3 + i]) * enabled / running)
+                : buf[3 + i];
+        }
+        return true;
+    }
+};
+
+CounterGroup& localGroup() {
+    static thread_local CounterGroup group;
+    return group;
+}
+
+struct alignas(64) ThreadCounters {
+    struct Engine {
+        std::atomic<uint64_t> invocations{0};
+        std::atomic<uint64_t> hardware_invocations{0};
+        std::atomic<uint64_t> nanos{0};
+        std::atomic<uint64_t> values[PerfSample::kCounterCount] = {};
+    };
+    Engine engines[PerfCounters::kEngineCount];
+};
+
+ThreadBlocks<ThreadCounters>& registry() {
+    static ThreadBlocks<ThreadCounters> blocks;
+    return blocks;
+}
+
+Json::Value perCall(uint64_t total, uint64_t calls) {
+    return calls > 0 ? Json::Value(static_cast<double>(total) / calls) : Json::Value(Json::nullValue);
+}
+
+} // namespace
+
+void PerfCounters::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool PerfCounters::hardwareAvailable() {
+    uint64_t values[PerfSample::kCounterCount];
+    return localGroup().read(values);
+}
+
+PerfSample PerfCounters::read() {
+    PerfSample sample;
+    sample.hardware = localGroup().read(sample.values);
+    sample.nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    return sample;
+}
+
+void PerfCounters::record(PricingEngine engine, const PerfSample& begin, const PerfSample& end) {
+    ThreadCounters::Engine& slot = registry().local().engines[static_cast<size_t>(engine)];
+    bump(slot.invocations);
+    bump(slot.nanos, end.nanos - begin.nanos);
+    if (!begin.hardware || !end.hardware) return;
+    bump(slot.hardware_invocations);
+    for (size_t i = 0; i < PerfSample::kCounterCount; ++i) {
+        // Scaled readings can step back slightly; never record a negative delta
+        if (end.values[i] > begin.values[i]) bump(slot.values[i], end.values[i] - begin.values[i]);
+    }
+}
+
+EngineCounters PerfCounters::totals(PricingEngine engine) {
+    EngineCounters totals;
+    const size_t e = static_cast<size_t>(engine);
+    registry().forEach([&](const ThreadCounters& block) {
+        const ThreadCounters::Engine& slot = block.engines[e];
+        totals.invocations += slot.invocations.load(std::memory_order_relaxed);
+        totals.hardware_invocations += slot.hardware_invocations.load(std::memory_order_relaxed);
+        totals.nanos += slot.nanos.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < PerfSample::kCounterCount; ++i) {
+            totals.values[i] += slot.values[i].load(std::memory_order_relaxed);
+        }
+    });
+    return totals;
+}
+
+const char* PerfCounters::counterName(PerfCounter counter) {
+    switch (counter) {
+        case PerfCounter::CYCLES: return "cycles";
+        case PerfCounter::INSTRUCTIONS: return "instructions";
+        case PerfCounter::CACHE_MISSES: return "cache_misses";
+        case PerfCounter::BRANCH_MISSES: return "branch_misses";
+    }
+    return "unknown";
+}
+
+Json::Value PerfCounters::toJson() {
+    Json::Value json;
+    json["enabled"] = enabled();
+    json["hardware"] = hardwareAvailable();
+
+    Json::Value engines(Json::objectValue);
+    for (size_t e = 0; e < kEngineCount; ++e) {
+        const auto engine = static_cast<PricingEngine>(e);
+        const EngineCounters totals = PerfCounters::totals(engine);
+        Json::Value entry;
+        entry["invocations"] = Json::UInt64(totals.invocations);
+        entry["hardware_invocations"] = Json::UInt64(totals.hardware_invocations);
+        entry["nanos_per_call"] = perCall(totals.nanos, totals.invocations);
+        for (size_t i = 0; i < PerfSample::kCounterCount; ++i) {
+            entry[std::string(counterName(static_cast<PerfCounter>(i))) + "_per_call"] =
+                perCall(totals.values[i], totals.hardware_invocations);
+        }
+        const uint64_t cycles = totals.values[static_cast<size_t>(PerfCounter::CYCLES)];
+        entry["ipc"] = cycles > 0
+            ? Json::Value(static_cast<double>(totals.values[static_cast<size_t>(PerfCounter::INSTRUCTIONS)]) / cycles)
+            : Json::Value(Json::nullValue);
+        engines[BlackScholesUtil::engineName(engine)] = entry;
+    }
+    json["engines"] = engines;
+    return json;
+}
@@ -0,0 +1,79 @@
+#include "utils/PhaseTimer.h"
+#include <cstdio>
+#include <thread>
+
+std::atomic<bool> PhaseTimer::server_timing_{false};
+
+namespace {
+
+double measureNanosPerTick() {
+#if BSU_HAS_TSC
+    using Clock = std::chrono::steady_clock;
+    const auto wall_start = Clock::now();
+    const uint64_t tick_start = PhaseTimer::ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const uint64_t tick_end = PhaseTimer::ticks();
+    const auto wall_end = Clock::now();
+
+    const double nanos = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count());
+    const uint64_t ticks = tick_end - tick_start;
+    return ticks > 0 ? nanos / static_cast<double>(ticks) : 1.0;
+#else
+    using Period = std::chrono::steady_clock::period;
+    return 1e9 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+#endif
+}
+
+} // namespace
+
+void PhaseTimer::chargeAllocations(RequestPhase phase) {
+    // A request resumed on another thread (a failed cluster forward) starts counting afresh
+    const AllocationCounts* source = AllocationTracker::threadCounts();
+    if (source == allocation_source_) {
+        phase_allocations_[static_cast<size_t>(phase)] += *source - last_allocations_;
+    }
+    allocation_source_ = source;
+    last_allocations_ = *source;
+}
+
+void PhaseTimer::calibrate() {
+    nanosPerTick();
+}
+
+double PhaseTimer::nanosPerTick() {
+    static const double rate = measureNanosPerTick();
+    return rate;
+}
+
+uint64_t PhaseTimer::nanos(RequestPhase phase) const {
+    return static_cast<uint64_t>(static_cast<double>(phase_ticks_[static_cast<size_t>(phase)]) * nanosPerTick());
+}
+
+const char* PhaseTimer::phaseName(RequestPhase phase) {
+    switch (phase) {
+        case RequestPhase::BODY:      return "body";
+        case RequestPhase::PARSE:     return "parse";
+        case RequestPhase::VALIDATE:  return "validate";
+        case RequestPhase::PRICE:     return "price";
+        case RequestPhase::SERIALIZE: return "serialize";
+    }
+    return "unknown";
+}
+
+std::string PhaseTimer::serverTiming() const {
+    std::string header;
+    char buf[64];
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        if (!reached(phase)) continue;
+        std::snprintf(buf, sizeof(buf), "%s%s;dur=%.3f", header.empty() ? "" : ", ", phaseName(phase),
+                      static_cast<double>(nanos(phase)) * 1e-6);
+        header += buf;
+    }
+    return header;
+}
+
+void PhaseTimer::setServerTimingEnabled(bool enabled) {
+    server_timing_.store(enabled, std::memory_order_relaxed);
+}
@@ -0,0 +1,107 @@
+#include "utils/RoutingTable.h"
+#include "utils/TuningConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+using BlackScholesUtil::PricingEngine;
+
+namespace {
+
+bool readBounds(const Json::Value& axes, const char* name, std::vector<double>& bounds, std::string& error) {
+    const Json::Value& values = axes[name];
+    if (!values.isArray()) {
+        error = std::string("Routing table axis ") + name + " must be an array";
+        return false;
+    }
+    for (const auto& value : values) {
+        if (!value.isNumeric() || !std::isfinite(value.asDouble()) ||
+            (!bounds.empty() && value.asDouble() <= bounds.back())) {
+            error = std::string("Routing table axis ") + name + " must hold ascending finite numbers";
+            return false;
+        }
+        bounds.push_back(value.asDouble());
+    }
+    return true;
+}
+
+bool readCells(const Json::Value& json, const char* name, size_t expected,
+               std::vector<RouteDecision>& cells, std::string& error) {
+    const Json::Value& values = json[name];
+    if (!values.isArray() || values.size() != expected) {
+        error = std::string("Routing table ") + name + " must hold " + std::to_string(expected) + " cells";
+        return false;
+    }
+    for (const auto& value : values) {
+        const std::string engine = value.isObject() ? value["engine"].asString() : std::string();
+        RouteDecision cell;
+        if (engine == BlackScholesUtil::engineName(PricingEngine::ANALYTIC_SHORTCUT)) {
+            cell.engine = PricingEngine::ANALYTIC_SHORTCUT;
+        } else if (engine == BlackScholesUtil::engineName(PricingEngine::GSL_QAGIU)) {
+            cell.engine = PricingEngine::GSL_QAGIU;
+        } else if (engine == BlackScholesUtil::engineName(PricingEngine::GAUSS_LAGUERRE)) {
+            cell.engine = PricingEngine::GAUSS_LAGUERRE;
+            const Json::Value& order = value["gl_order"];
+            if (!order.isIntegral() || order.asInt() < 2 || order.asInt() > TuningConfig::kMaxGLOrder) {
+                error = "Routing table gl_order must be between 2 and " + std::to_string(TuningConfig::kMaxGLOrder);
+                return false;
+            }
+            cell.gl_order = order.asInt();
+        } else {
+            error = "Unknown routing table engine " + engine;
+            return false;
+        }
+        cells.push_back(cell);
+    }
+    return true;
+}
+
+} // namespace
+
+std::shared_ptr<const RoutingTable> RoutingTable::fromJson(const Json::Value& json, std::string& error) {
+    if (!json.isObject() || !json["version"].isIntegral() || json["version"].asInt() != kVersion) {
+        error = "Routing table must be an object with version " + std::to_string(kVersion);
+        return nullptr;
+    }
+    auto table = std::make_shared<RoutingTable>();
+    const Json::Value& axes = json["axes"];
+    if (!readBounds(axes, "cv", table->cv_bounds_, error) ||
+        !readBounds(axes, "total_volatility", table->total_vol_bounds_, error) ||
+        !readBounds(axes, "log_moneyness", table->moneyness_bounds_, error)) {
+        return nullptr;
+    }
+    const size_t cells = (table->cv_bounds_.size() + 1) * (table->total_vol_bounds_.size() + 1) *
+                         (table->moneyness_bounds_.size() + 1);
+    if (!readCells(json, "call", cells, table->call_cells_, error) ||
+        !readCells(json, "binary", cells, table->binary_cells_, error)) {
+        return nullptr;
+    }
+    table->target_error_ = json["target_error"].asDouble();
+    table->json_ = json;
+
+    // FNV-1a over the compact form
+    Json::FastWriter writer;
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : writer.write(json)) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+    table->fingerprint_ = hex;
+    return table;
+}
+
+size_t RoutingTable::bin(const std::vector<double>& bounds, double value) {
+    return static_cast<size_t>(std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+}
+
+RouteDecision RoutingTable::route(bool binary, double stock_price, double strike_price, double volatility,
+                                  double holding_period, double volatility_around_holding_period) const {
+    const size_t cv = bin(cv_bounds_, volatility_around_holding_period / holding_period);
+    const size_t total_vol = bin(total_vol_bounds_, volatility * std::sqrt(holding_period));
+    const size_t moneyness = bin(moneyness_bounds_, std::log(stock_price / strike_price));
+    const size_t index = (cv * (total_vol_bounds_.size() + 1) + total_vol) * (moneyness_bounds_.size() + 1) + moneyness;
+    return binary ? binary_cells_[index] : call_cells_[index];
+}
@@ -0,0 +1,162 @@
+#include "utils/SlowRequestLog.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+std::atomic<bool> SlowRequestLog::enabled_{false};
+
+namespace {
+
+struct LogState {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Json::Value> queue;
+    bool stopping = false;
+
+    SlowLogConfig config;
+    uint64_t threshold_ns = 0;
+    FILE* file = nullptr;
+    std::thread writer;
+
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+LogState& state() {
+    static LogState s;
+    return s;
+}
+
+void writerMain() {
+    LogState& s = state();
+    Json::FastWriter writer;
+    std::deque<Json::Value> batch;
+    std::unique_lock<std::mutex> lock(s.mutex);
+    for (;;) {
+        s.ready.wait(lock, [&s] { return s.stopping || !s.queue.empty(); });
+        batch.swap(s.queue);
+        const bool stopping = s.stopping;
+        lock.unlock();
+
+        for (const auto& record : batch) {
+            const std::string line = writer.write(record);  // ends with a newline
+            std::fwrite(line.data(), 1, line.size(), s.file);
+        }
+        std::fflush(s.file);
+        s.written.fetch_add(batch.size(), std::memory_order_relaxed);
+        batch.clear();
+
+        lock.lock();
+        if (stopping && s.queue.empty()) return;
+    }
+}
+
+} // namespace
+
+SlowLogConfig SlowLogConfig::fromEnvironment() {
+    SlowLogConfig config;
+    if (const char* path = std::getenv("BSS_SLOW_LOG_FILE")) config.path = path;
+    if (const char* ms = std::getenv("BSS_SLOW_LOG_MS")) config.threshold_ms = std::atof(ms);
+    if (const char* capacity = std::getenv("BSS_SLOW_LOG_CAPACITY")) config.capacity = std::strtoull(capacity, nullptr, 10);
+    return config;
+}
+
+bool SlowRequestLog::start(const SlowLogConfig& config, std::string& error) {
+    if (enabled()) {
+        error = "Slow request log is already running";
+        return false;
+    }
+    if (config.threshold_ms < 0.0 || config.capacity == 0) {
+        error = "threshold_ms must be non-negative and capacity positive";
+        return false;
+    }
+
+    FILE* file = std::fopen(config.path.c_str(), "a");
+    if (!file) {
+        error = "Cannot open slow request log " + config.path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    LogState& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.config = config;
+        s.threshold_ns = static_cast<uint64_t>(config.threshold_ms * 1e6);
+        s.file = file;
+        s.stopping = false;
+        s.queue.clear();
+    }
+    s.writer = std::thread(writerMain);
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+void SlowRequestLog::stop() {
+    if (!enabled_.exchange(false)) return;
+
+    LogState& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stopping = true;
+    }
+    s.ready.notify_one();
+    if (s.writer.joinable()) s.writer.join();
+    std::fclose(s.file);
+    s.file = nullptr;
+}
+
+uint64_t SlowRequestLog::thresholdNanos() {
+    return state().threshold_ns;
+}
+
+bool SlowRequestLog::submit(Json::Value record) {
+    if (!enabled()) return false;
+    LogState& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.stopping || s.queue.size() >= s.config.capacity) {
+            s.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        s.queue.push_back(std::move(record));
+    }
+    s.ready.notify_one();
+    return true;
+}
+
+uint64_t SlowRequestLog::writtenRecords() {
+    return state().written.load(std::memory_order_relaxed);
+}
+
+uint64_t SlowRequestLog::droppedRecords() {
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+bool SlowRequestLog::readRequests(const std::string& path, std::vector<Json::Value>& requests, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot open slow request log " + path;
+        return false;
+    }
+
+    Json::Reader reader;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty()) continue;
+        Json::Value record;
+        if (!reader.parse(line, record) || !record.isObject() || !record["request"].isObject()) {
+            error = "Malformed slow request record on line " + std::to_string(line_number);
+            return false;
+        }
+        requests.push_back(record["request"]);
+    }
+    return true;
+}
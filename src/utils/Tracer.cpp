@@ -0,0 +1,221 @@
+#include "utils/Tracer.h"
+#include "utils/ThreadRings.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+struct TracerState {
+    ThreadRings<TraceSpan> rings;
+
+    std::mutex writer_mutex;
+    FILE* file = nullptr;
+    bool first_event = true;
+    uint64_t written = 0;
+
+    TraceConfig config;
+    uint64_t slow_ns = 0;
+
+    PeriodicFlusher flusher;
+};
+
+TracerState& state() {
+    static TracerState s;
+    return s;
+}
+
+uint64_t steadyNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t& rngState() {
+    static thread_local uint64_t x = 0;
+    if (x == 0) {
+        x = steadyNanos() ^ (reinterpret_cast<uintptr_t>(&x) * 0x9e3779b97f4a7c15ULL);
+        if (x == 0) x = 1;
+    }
+    return x;
+}
+
+uint64_t nextRandom() {
+    uint64_t& x = rngState();
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+// Chrome trace "complete" event; timestamps are microseconds
+void writeEvent(TracerState& s, const TraceSpan& span) {
+    char buf[512];
+    int n = std::snprintf(buf, sizeof(buf),
+        "%s{\"name\":\"%s\",\"cat\":\"bss\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u,"
+        "\"args\":{\"trace_id\":\"%016llx\"",
+        s.first_event ? "" : ",\n", span.name, static_cast<double>(span.start_ns) * 1e-3,
+        static_cast<double>(span.duration_ns) * 1e-3, static_cast<int>(getpid()), span.thread,
+        static_cast<unsigned long long>(span.trace_id));
+    if (n < 0) return;
+    std::string event(buf, std::min<size_t>(static_cast<size_t>(n), sizeof(buf) - 1));
+    if (span.option_type) event += std::string(",\"type\":\"") + span.option_type + "\"";
+    if (span.engine) event += std::string(",\"engine\":\"") + span.engine + "\"";
+    if (span.batch_size) event += ",\"batch_size\":" + std::to_string(span.batch_size);
+    event += "}}";
+    std::fwrite(event.data(), 1, event.size(), s.file);
+    s.first_event = false;
+    ++s.written;
+}
+
+} // namespace
+
+TraceConfig TraceConfig::fromEnvironment() {
+    TraceConfig config;
+    if (const char* path = std::getenv("BSS_TRACE_FILE")) config.path = path;
+    if (const char* rate = std::getenv("BSS_TRACE_SAMPLE_RATE")) config.sample_rate = std::atof(rate);
+    if (const char* slow = std::getenv("BSS_TRACE_SLOW_MS")) config.slow_ms = std::atof(slow);
+    return config;
+}
+
+bool Tracer::start(const TraceConfig& config, std::string& error) {
+    if (enabled()) {
+        error = "Tracing is already running";
+        return false;
+    }
+    if (config.sample_rate < 0.0 || config.sample_rate > 1.0 || config.slow_ms < 0.0 ||
+        config.flush_interval_ms <= 0.0) {
+        error = "sample_rate must be in [0, 1], slow_ms non-negative and flush_interval_ms positive";
+        return false;
+    }
+
+    TracerState& s = state();
+    FILE* file = std::fopen(config.path.c_str(), "w");
+    if (!file) {
+        error = "Cannot open trace file " + config.path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s.writer_mutex);
+        s.file = file;
+        s.first_event = true;
+        s.written = 0;
+        std::fputs("[\n", s.file);
+    }
+    s.config = config;
+    s.slow_ns = static_cast<uint64_t>(config.slow_ms * 1e6);
+    s.rings.setCapacity(config.buffer_spans);
+    // Spans recorded while the previous session was stopping belong to no file
+    s.rings.discard();
+    s.flusher.start(config.flush_interval_ms, &Tracer::flush);
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+void Tracer::stop() {
+    if (!enabled_.exchange(false)) return;
+
+    TracerState& s = state();
+    s.flusher.stop();
+
+    flush();
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    std::fputs("\n]\n", s.file);
+    std::fclose(s.file);
+    s.file = nullptr;
+}
+
+bool Tracer::sampleHead() {
+    if (!enabled()) return false;
+    const double rate = state().config.sample_rate;
+    if (rate <= 0.0) return false;
+    // Top 53 bits as a uniform double in [0, 1)
+    return static_cast<double>(nextRandom() >> 11) * 0x1.0p-53 < rate;
+}
+
+uint64_t Tracer::newTraceId() {
+    return nextRandom();
+}
+
+void Tracer::record(const TraceSpan& span) {
+    if (!enabled()) return;
+    auto& ring = state().rings.local();
+    TraceSpan* slot = ring.claim();
+    if (!slot) {
+        ring.drop();
+        return;
+    }
+    *slot = span;
+    slot->thread = ring.thread;
+    ring.publish();
+}
+
+void Tracer::recordRequest(const PhaseTimer& timer, const RequestSpanAttributes& attributes) {
+    if (!enabled()) return;
+
+    uint64_t phase_ns[PhaseTimer::kPhaseCount];
+    uint64_t handler_ns = 0;
+    for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+        phase_ns[i] = timer.nanos(static_cast<RequestPhase>(i));
+        handler_ns += phase_ns[i];
+    }
+    const uint64_t total_ns = attributes.queue_ns + handler_ns;
+    if (!attributes.head_sampled && total_ns < state().slow_ns) return;
+
+    // Phases run back to back from the timer's construction to the last mark
+    const uint64_t handler_start = steadyNanos() - handler_ns;
+    const uint64_t request_start = handler_start - attributes.queue_ns;
+
+    TraceSpan span;
+    span.trace_id = newTraceId();
+    span.option_type = attributes.option_type;
+    span.engine = attributes.engine;
+    span.batch_size = 1;
+
+    span.name = "request";
+    span.start_ns = request_start;
+    span.duration_ns = total_ns;
+    record(span);
+
+    if (attributes.queue_ns > 0) {
+        span.name = "queue";
+        span.duration_ns = attributes.queue_ns;
+        record(span);
+    }
+
+    uint64_t offset = handler_start;
+    for (size_t i = 0; i < PhaseTimer::kPhaseCount; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        if (!timer.reached(phase)) continue;
+        span.name = PhaseTimer::phaseName(phase);
+        span.start_ns = offset;
+        span.duration_ns = phase_ns[i];
+        record(span);
+        offset += phase_ns[i];
+    }
+}
+
+void Tracer::flush() {
+    TracerState& s = state();
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    if (!s.file) return;
+    s.rings.drain([&](const TraceSpan& span) { writeEvent(s, span); });
+    std::fflush(s.file);
+}
+
+uint64_t Tracer::writtenSpans() {
+    TracerState& s = state();
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    return s.written;
+}
+
+uint64_t Tracer::droppedSpans() {
+    return state().rings.dropped();
+}
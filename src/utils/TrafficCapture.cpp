@@ -0,0 +1,198 @@
+#include "utils/TrafficCapture.h"
+#include "utils/ThreadRings.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+std::atomic<bool> TrafficCapture::enabled_{false};
+
+namespace {
+
+const char kMagic[8] = {'B', 'S', 'S', 'C', 'A', 'P', '1', '\0'};
+
+struct CaptureSlot {
+    uint64_t started_ns;
+    uint64_t duration_ns;
+    uint16_t status;
+    uint32_t length;
+    char body[TrafficCapture::kMaxBodyBytes];
+};
+
+struct CaptureState {
+    ThreadRings<CaptureSlot> rings;
+
+    std::mutex writer_mutex;
+    FILE* file = nullptr;
+    uint64_t written = 0;
+
+    CaptureConfig config;
+    uint64_t start_ns = 0;
+
+    PeriodicFlusher flusher;
+};
+
+CaptureState& state() {
+    static CaptureState s;
+    return s;
+}
+
+uint64_t steadyNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void writeRecord(CaptureState& s, const CaptureSlot& slot) {
+    const uint64_t offset = slot.started_ns > s.start_ns ? slot.started_ns - s.start_ns : 0;
+    const uint16_t reserved = 0;
+    std::fwrite(&offset, sizeof(offset), 1, s.file);
+    std::fwrite(&slot.duration_ns, sizeof(slot.duration_ns), 1, s.file);
+    std::fwrite(&slot.status, sizeof(slot.status), 1, s.file);
+    std::fwrite(&reserved, sizeof(reserved), 1, s.file);
+    std::fwrite(&slot.length, sizeof(slot.length), 1, s.file);
+    std::fwrite(slot.body, 1, slot.length, s.file);
+    ++s.written;
+}
+
+template <typename T>
+bool readValue(FILE* file, T& value) {
+    return std::fread(&value, sizeof(value), 1, file) == 1;
+}
+
+} // namespace
+
+CaptureConfig CaptureConfig::fromEnvironment() {
+    CaptureConfig config;
+    if (const char* path = std::getenv("BSS_CAPTURE_FILE")) config.path = path;
+    if (const char* buffer = std::getenv("BSS_CAPTURE_BUFFER")) config.buffer_requests = std::strtoull(buffer, nullptr, 10);
+    return config;
+}
+
+bool TrafficCapture::start(const CaptureConfig& config, std::string& error) {
+    if (enabled()) {
+        error = "Capture is already running";
+        return false;
+    }
+    if (config.buffer_requests == 0 || config.flush_interval_ms <= 0.0) {
+        error = "buffer_requests and flush_interval_ms must be positive";
+        return false;
+    }
+
+    FILE* file = std::fopen(config.path.c_str(), "wb");
+    if (!file) {
+        error = "Cannot open capture file " + config.path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    CaptureState& s = state();
+    const uint64_t wall_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    {
+        std::lock_guard<std::mutex> lock(s.writer_mutex);
+        s.file = file;
+        s.written = 0;
+        s.start_ns = steadyNanos();
+        std::fwrite(kMagic, 1, sizeof(kMagic), s.file);
+        std::fwrite(&wall_ns, sizeof(wall_ns), 1, s.file);
+    }
+    s.config = config;
+    s.rings.setCapacity(config.buffer_requests);
+    // Requests recorded while the previous capture was stopping belong to no file
+    s.rings.discard();
+    s.flusher.start(config.flush_interval_ms, &TrafficCapture::flush);
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+void TrafficCapture::stop() {
+    if (!enabled_.exchange(false)) return;
+
+    CaptureState& s = state();
+    s.flusher.stop();
+
+    flush();
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    std::fclose(s.file);
+    s.file = nullptr;
+}
+
+void TrafficCapture::record(uint64_t started_ns, uint64_t finished_ns, int status, std::string_view body) {
+    if (!enabled()) return;
+    auto& ring = state().rings.local();
+    CaptureSlot* slot = body.size() <= kMaxBodyBytes ? ring.claim() : nullptr;
+    if (!slot) {
+        ring.drop();
+        return;
+    }
+    slot->started_ns = started_ns;
+    slot->duration_ns = finished_ns > started_ns ? finished_ns - started_ns : 0;
+    slot->status = static_cast<uint16_t>(status);
+    slot->length = static_cast<uint32_t>(body.size());
+    std::memcpy(slot->body, body.data(), body.size());
+    ring.publish();
+}
+
+void TrafficCapture::flush() {
+    CaptureState& s = state();
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    if (!s.file) return;
+    s.rings.drain([&](const CaptureSlot& slot) { writeRecord(s, slot); });
+    std::fflush(s.file);
+}
+
+uint64_t TrafficCapture::capturedRequests() {
+    CaptureState& s = state();
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    return s.written;
+}
+
+uint64_t TrafficCapture::droppedRequests() {
+    return state().rings.dropped();
+}
+
+bool TrafficCapture::readFile(const std::string& path, std::vector<CapturedRequest>& requests, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "Cannot open capture file " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    uint64_t wall_ns;
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !readValue(file, wall_ns)) {
+        std::fclose(file);
+        error = "Not a capture file: " + path;
+        return false;
+    }
+
+    const size_t first = requests.size();
+    for (;;) {
+        CapturedRequest request;
+        uint16_t reserved;
+        uint32_t length;
+        if (!readValue(file, request.offset_ns)) break;  // clean end of file
+        if (!readValue(file, request.duration_ns) || !readValue(file, request.status) ||
+            !readValue(file, reserved) || !readValue(file, length) || length > kMaxBodyBytes) {
+            std::fclose(file);
+            error = "Truncated capture record " + std::to_string(requests.size() - first) + " in " + path;
+            return false;
+        }
+        request.body.resize(length);
+        if (length > 0 && std::fread(&request.body[0], 1, length, file) != length) {
+            std::fclose(file);
+            error = "Truncated capture record " + std::to_string(requests.size() - first) + " in " + path;
+            return false;
+        }
+        requests.push_back(std::move(request));
+    }
+    std::fclose(file);
+
+    // Threads' rings are drained one after another, so the file is only ordered per thread
+    std::stable_sort(requests.begin() + first, requests.end(),
+                     [](const CapturedRequest& a, const CapturedRequest& b) { return a.offset_ns < b.offset_ns; });
+    return true;
+}
@@ -0,0 +1,173 @@
+#include "utils/TuningConfig.h"
+#include "utils/RoutingTable.h"
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+std::atomic<uint64_t> TuningConfig::generation_{0};
+
+namespace {
+
+std::mutex& publishMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+bool readPositive(const Json::Value& json, const char* field, double& value, std::string& error) {
+    if (!json.isMember(field)) return true;
+    if (!json[field].isNumeric() || json[field].asDouble() <= 0) {
+        error = std::string("Field ") + field + " must be a positive number";
+        return false;
+    }
+    value = json[field].asDouble();
+    return true;
+}
+
+bool readInt(const Json::Value& json, const char* field, int& value, std::string& error) {
+    if (!json.isMember(field)) return true;
+    if (!json[field].isIntegral()) {
+        error = std::string("Field ") + field + " must be an integer";
+        return false;
+    }
+    value = json[field].asInt();
+    return true;
+}
+
+} // namespace
+
+bool TuningParameters::validate(std::string& error) const {
+    if (!(gsl_cv_threshold > 0) || !(gsl_alpha_threshold > 0) || !(analytic_shortcut_ratio > 0)) {
+        error = "Routing thresholds must be positive";
+        return false;
+    }
+    if (gl_order < 2 || gl_order > TuningConfig::kMaxGLOrder) {
+        error = "gl_order must be between 2 and " + std::to_string(TuningConfig::kMaxGLOrder);
+        return false;
+    }
+    auto tolerance = [](double eps) {
+        return eps >= TuningConfig::kMinQagiuTolerance && eps <= TuningConfig::kMaxQagiuTolerance;
+    };
+    if (!tolerance(qagiu_epsabs) || !tolerance(qagiu_epsrel)) {
+        error = "QAGIU tolerances must be between 1e-12 and 1e-3";
+        return false;
+    }
+    if (qagiu_limit < 1 || qagiu_limit > TuningConfig::kMaxQagiuLimit) {
+        error = "qagiu_limit must be between 1 and " + std::to_string(TuningConfig::kMaxQagiuLimit);
+        return false;
+    }
+    return true;
+}
+
+bool TuningParameters::mergeJson(const Json::Value& json, std::string& error) {
+    if (!json.isObject()) {
+        error = "Tuning configuration must be a JSON object";
+        return false;
+    }
+    TuningParameters merged = *this;
+    if (!readPositive(json, "gsl_cv_threshold", merged.gsl_cv_threshold, error) ||
+        !readPositive(json, "gsl_alpha_threshold", merged.gsl_alpha_threshold, error) ||
+        !readPositive(json, "analytic_shortcut_ratio", merged.analytic_shortcut_ratio, error) ||
+        !readInt(json, "gl_order", merged.gl_order, error) ||
+        !readPositive(json, "qagiu_epsabs", merged.qagiu_epsabs, error) ||
+        !readPositive(json, "qagiu_epsrel", merged.qagiu_epsrel, error) ||
+        !readInt(json, "qagiu_limit", merged.qagiu_limit, error)) {
+        return false;
+    }
+    if (json.isMember("routing_table")) {
+        // null goes back to the thresholds
+        const Json::Value& table = json["routing_table"];
+        if (table.isNull()) {
+            merged.routing_table.reset();
+        } else if (!(merged.routing_table = RoutingTable::fromJson(table, error))) {
+            return false;
+        }
+    }
+    if (!merged.validate(error)) {
+        return false;
+    }
+    *this = merged;
+    return true;
+}
+
+Json::Value TuningParameters::toJson() const {
+    Json::Value json;
+    json["gsl_cv_threshold"] = gsl_cv_threshold;
+    json["gsl_alpha_threshold"] = gsl_alpha_threshold;
+    json["analytic_shortcut_ratio"] = analytic_shortcut_ratio;
+    json["gl_order"] = gl_order;
+    json["qagiu_epsabs"] = qagiu_epsabs;
+    json["qagiu_epsrel"] = qagiu_epsrel;
+    json["qagiu_limit"] = qagiu_limit;
+    json["routing_table"] = routing_table ? routing_table->toJson() : Json::Value(Json::nullValue);
+    json["generation"] = static_cast<Json::UInt64>(generation);
+    return json;
+}
+
+std::string TuningParameters::fingerprint() const {
+    std::ostringstream out;
+    out.precision(17);
+    // A routing table takes the place of the thresholds and the order
+    if (routing_table) {
+        out << "routing=" << routing_table->fingerprint();
+    } else {
+        out << "gl=" << gl_order << ";gsl_cv=" << gsl_cv_threshold << ";gsl_alpha=" << gsl_alpha_threshold
+            << ";shortcut=" << analytic_shortcut_ratio;
+    }
+    out << ";qagiu=" << qagiu_epsabs << "/" << qagiu_epsrel << "/" << qagiu_limit;
+    return out.str();
+}
+
+std::shared_ptr<const TuningParameters>& TuningConfig::global() {
+    static std::shared_ptr<const TuningParameters> params = std::make_shared<const TuningParameters>();
+    return params;
+}
+
+const TuningParameters& TuningConfig::current() {
+    // Each thread holds its own reference to the snapshot, so the hot path is a single
+    // relaxed-contention atomic load instead of a shared reference count update.
+    static thread_local std::shared_ptr<const TuningParameters> local;
+    static thread_local uint64_t local_generation = ~uint64_t{0};
+
+    const uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (generation != local_generation || !local) {
+        local = std::atomic_load(&global());
+        local_generation = local->generation;
+    }
+    return *local;
+}
+
+std::shared_ptr<const TuningParameters> TuningConfig::snapshot() {
+    return std::atomic_load(&global());
+}
+
+bool TuningConfig::publish(TuningParameters params, std::string& error) {
+    if (!params.validate(error)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(publishMutex());
+    params.generation = generation_.load() + 1;
+    std::atomic_store(&global(), std::shared_ptr<const TuningParameters>(
+                                     std::make_shared<const TuningParameters>(params)));
+    generation_.store(params.generation, std::memory_order_release);
+    return true;
+}
+
+bool TuningConfig::loadFile(const std::string& path, TuningParameters& params, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot open tuning file " + path;
+        return false;
+    }
+    Json::Value json;
+    Json::Reader reader;
+    if (!reader.parse(in, json)) {
+        error = "Invalid JSON in tuning file " + path;
+        return false;
+    }
+    TuningParameters loaded = params;
+    if (!loaded.mergeJson(json, error)) {
+        return false;
+    }
+    params = loaded;
+    return true;
+}
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "capi/blackscholes.h"
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+bs_option regular(double S, double K, double T, double vol, double r) {
+    bs_option option{};
+    option.type = BS_REGULAR;
+    option.stock_price = S;
+    option.strike_price = K;
+    option.time_to_maturity = T;
+    option.volatility = vol;
+    option.risk_free_rate = r;
+    option.holding_period = kNaN;
+    option.volatility_around_holding_period = kNaN;
+    return option;
+}
+
+bs_option randomExpiration(int32_t type, double S, double K, double vol, double r, double H, double sigmaH) {
+    bs_option option = regular(S, K, kNaN, vol, r);
+    option.type = type;
+    option.holding_period = H;
+    option.volatility_around_holding_period = sigmaH;
+    return option;
+}
+
+double normalCdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double price(const bs_option& option, const bs_engine_options* engine_options = nullptr) {
+    double value = kNaN;
+    EXPECT_EQ(bs_price(&option, engine_options, &value, nullptr), BS_OK);
+    return value;
+}
+
+} // namespace
+
+TEST(BlackScholesCApiTest, PricesMatchTheClosedForms) {
+    const double S = 100, K = 95, T = 0.25, vol = 0.2, r = 0.05;
+    const double d1 = (std::log(S / K) + (r + 0.5 * vol * vol) * T) / (vol * std::sqrt(T));
+    const double d2 = d1 - vol * std::sqrt(T);
+
+    bs_diagnostics diagnostics;
+    double value = 0.0;
+    bs_option option = regular(S, K, T, vol, r);
+    ASSERT_EQ(bs_price(&option, nullptr, &value, &diagnostics), BS_OK);
+    EXPECT_NEAR(value, S * normalCdf(d1) - K * std::exp(-r * T) * normalCdf(d2), 1e-12);
+    EXPECT_EQ(diagnostics.engine, BS_ENGINE_CLOSED_FORM);
+
+    option.type = BS_BINARY;
+    EXPECT_NEAR(price(option), std::exp(-r * T) * normalCdf(d2), 1e-12);
+}
+
+TEST(BlackScholesCApiTest, RandomExpirationRoutesAndHonoursForcedEngines) {
+    // sigmaH absent defaults to H; a small dispersion takes the analytic shortcut
+    bs_option option = randomExpiration(BS_RANDOM_EXPIRATION_CALL, 100, 100, 0.2, 0.03, 2.0, kNaN);
+    bs_option explicit_dispersion = option;
+    explicit_dispersion.volatility_around_holding_period = 2.0;
+    EXPECT_EQ(price(option), price(explicit_dispersion));
+
+    bs_diagnostics diagnostics;
+    double value = 0.0;
+    option.volatility_around_holding_period = 0.01;
+    ASSERT_EQ(bs_price(&option, nullptr, &value, &diagnostics), BS_OK);
+    EXPECT_EQ(diagnostics.engine, BS_ENGINE_ANALYTIC_SHORTCUT);
+    EXPECT_NEAR(value, price(regular(100, 100, 2.0, 0.2, 0.03)), 1e-9);
+
+    option.volatility_around_holding_period = 1.0;
+    const bs_engine_options gauss_laguerre{BS_ENGINE_GAUSS_LAGUERRE, 64, 0.0};
+    const bs_engine_options qagiu{BS_ENGINE_GSL_QAGIU, 0, 1e-11};
+    ASSERT_EQ(bs_price(&option, &gauss_laguerre, &value, &diagnostics), BS_OK);
+    EXPECT_EQ(diagnostics.engine, BS_ENGINE_GAUSS_LAGUERRE);
+    EXPECT_EQ(diagnostics.evaluations, 64);
+    EXPECT_DOUBLE_EQ(diagnostics.alpha, 4.0);
+    EXPECT_NEAR(value, price(option, &qagiu), 1e-5);
+    EXPECT_NEAR(value, price(option), 1e-5);
+}
+
+TEST(BlackScholesCApiTest, RejectsWhatTheApiRejects) {
+    double value = 0.0;
+    const bs_option valid = regular(100, 95, 1, 0.2, 0.05);
+    EXPECT_EQ(bs_price(nullptr, nullptr, &value, nullptr), BS_INVALID_ARGUMENT);
+    EXPECT_EQ(bs_price(&valid, nullptr, nullptr, nullptr), BS_INVALID_ARGUMENT);
+
+    std::vector<bs_option> invalid(6, valid);
+    invalid[0].volatility = 0.0;
+    invalid[1].stock_price = -1.0;
+    invalid[2].risk_free_rate = kNaN;
+    invalid[3].time_to_maturity = kNaN;
+    invalid[4].type = 7;
+    invalid[5].reserved = 1;
+    for (const bs_option& option : invalid) {
+        EXPECT_EQ(bs_price(&option, nullptr, &value, nullptr), BS_INVALID_ARGUMENT);
+        EXPECT_TRUE(std::isnan(value));
+    }
+
+    const bs_option random = randomExpiration(BS_RANDOM_EXPIRATION_BINARY_CALL, 100, 95, 0.2, 0.05, 1.0, 0.0);
+    EXPECT_EQ(bs_price(&random, nullptr, &value, nullptr), BS_INVALID_ARGUMENT);
+
+    const bs_engine_options bad_engine{9, 0, 0.0};
+    const bs_engine_options bad_order{BS_ENGINE_GAUSS_LAGUERRE, 1, 0.0};
+    const bs_engine_options bad_tolerance{BS_ENGINE_GSL_QAGIU, 0, -1e-9};
+    for (const bs_engine_options* engine_options : {&bad_engine, &bad_order, &bad_tolerance}) {
+        EXPECT_EQ(bs_price(&valid, engine_options, &value, nullptr), BS_INVALID_ARGUMENT);
+    }
+}
+
+TEST(BlackScholesCApiTest, BatchReportsEachOptionAndTheFirstFailure) {
+    std::vector<bs_option> options = {
+        regular(100, 95, 1, 0.2, 0.05),
+        regular(100, 95, 1, -0.2, 0.05),
+        randomExpiration(BS_RANDOM_EXPIRATION_CALL, 100, 95, 0.2, 0.05, 1.0, 0.5),
+    };
+    std::vector<double> prices(options.size());
+    std::vector<int32_t> statuses(options.size());
+    EXPECT_EQ(bs_price_batch(options.data(), options.size(), nullptr, prices.data(), statuses.data()),
+              BS_INVALID_ARGUMENT);
+    EXPECT_EQ(statuses[0], BS_OK);
+    EXPECT_EQ(statuses[1], BS_INVALID_ARGUMENT);
+    EXPECT_EQ(statuses[2], BS_OK);
+    EXPECT_EQ(prices[0], price(options[0]));
+    EXPECT_TRUE(std::isnan(prices[1]));
+    EXPECT_EQ(prices[2], price(options[2]));
+
+    options.erase(options.begin() + 1);
+    EXPECT_EQ(bs_price_batch(options.data(), options.size(), nullptr, prices.data(), nullptr), BS_OK);
+    EXPECT_EQ(bs_price_batch(nullptr, 0, nullptr, nullptr, nullptr), BS_OK);
+    EXPECT_EQ(bs_price_batch(nullptr, 1, nullptr, prices.data(), nullptr), BS_INVALID_ARGUMENT);
+}
+
+TEST(BlackScholesCApiTest, BatchMixesTypesInRowOrder) {
+    bs_option binary = regular(100, 105, 0.5, 0.25, 0.03);
+    binary.type = BS_BINARY;
+    bs_option bad_random = randomExpiration(BS_RANDOM_EXPIRATION_CALL, 100, 95, 0.2, 0.05, -1.0, 0.5);
+    std::vector<bs_option> options = {
+        randomExpiration(BS_RANDOM_EXPIRATION_BINARY_CALL, 100, 95, 0.2, 0.05, 1.0, 0.5),
+        regular(100, 95, 1, 0.2, 0.05),
+        bad_random,
+        binary,
+        randomExpiration(BS_RANDOM_EXPIRATION_CALL, 90, 95, 0.3, 0.02, 2.0, 0.8),
+        regular(100, 110, 0.25, 0.3, 0.01),
+        regular(100, 95, 1, 0.2, -kNaN),
+    };
+    std::vector<double> prices(options.size());
+    std::vector<int32_t> statuses(options.size());
+    EXPECT_EQ(bs_price_batch(options.data(), options.size(), nullptr, prices.data(), statuses.data()),
+              BS_INVALID_ARGUMENT);
+    for (size_t i = 0; i < options.size(); ++i) {
+        if (i == 2 || i == 6) {
+            EXPECT_EQ(statuses[i], BS_INVALID_ARGUMENT);
+            EXPECT_TRUE(std::isnan(prices[i]));
+        } else {
+            EXPECT_EQ(statuses[i], BS_OK);
+            EXPECT_EQ(prices[i], price(options[i]));
+        }
+    }
+
+    const bs_engine_options forced{BS_ENGINE_GAUSS_LAGUERRE, 32, 0.0};
+    options.erase(options.begin() + 6);
+    options.erase(options.begin() + 2);
+    ASSERT_EQ(bs_price_batch(options.data(), options.size(), &forced, prices.data(), nullptr), BS_OK);
+    for (size_t i = 0; i < options.size(); ++i) EXPECT_EQ(prices[i], price(options[i], &forced));
+}
+
+TEST(BlackScholesCApiTest, ChainPricesEveryCell) {
+    const std::vector<double> strikes = {80, 90, 100, 110, 120};
+    const std::vector<double> maturities = {0.1, 0.5, 2.0};
+    std::vector<double> vols(strikes.size() * maturities.size());
+    for (size_t i = 0; i < vols.size(); ++i) vols[i] = 0.2 + 0.01 * static_cast<double>(i % strikes.size());
+
+    std::vector<double> prices(vols.size());
+    ASSERT_EQ(bs_price_chain(100, 0.03, strikes.data(), strikes.size(), maturities.data(), maturities.size(),
+                             vols.data(), prices.data()),
+              BS_OK);
+    for (size_t m = 0; m < maturities.size(); ++m) {
+        for (size_t j = 0; j < strikes.size(); ++j) {
+            const size_t cell = m * strikes.size() + j;
+            EXPECT_NEAR(prices[cell], price(regular(100, strikes[j], maturities[m], vols[cell], 0.03)), 1e-12);
+        }
+    }
+
+    // One invalid cell rejects the whole chain
+    vols[7] = kNaN;
+    EXPECT_EQ(bs_price_chain(100, 0.03, strikes.data(), strikes.size(), maturities.data(), maturities.size(),
+                             vols.data(), prices.data()),
+              BS_INVALID_ARGUMENT);
+    for (double value : prices) EXPECT_TRUE(std::isnan(value));
+    EXPECT_EQ(bs_price_chain(100, 0.03, nullptr, 0, maturities.data(), maturities.size(), nullptr, nullptr), BS_OK);
+    EXPECT_EQ(bs_price_chain(100, 0.03, strikes.data(), strikes.size(), maturities.data(), maturities.size(),
+                             vols.data(), nullptr),
+              BS_INVALID_ARGUMENT);
+}
+
+TEST(BlackScholesCApiTest, GreeksAgreeWithDifferencedPrices) {
+    const std::vector<bs_option> options = {
+        regular(100, 95, 0.5, 0.25, 0.03),
+        randomExpiration(BS_RANDOM_EXPIRATION_CALL, 100, 95, 0.25, 0.03, 2.0, 0.8),
+        randomExpiration(BS_RANDOM_EXPIRATION_BINARY_CALL, 100, 105, 0.25, 0.03, 2.0, 0.8),
+    };
+    for (const bs_option& option : options) {
+        bs_greeks greeks;
+        ASSERT_EQ(bs_compute_greeks(&option, nullptr, &greeks, nullptr), BS_OK);
+
+        const double h = 0.01;
+        bs_option up = option, down = option;
+        up.stock_price += h;
+        down.stock_price -= h;
+        EXPECT_NEAR(greeks.delta, (price(up) - price(down)) / (2 * h), 1e-5) << option.type;
+        EXPECT_NEAR(greeks.gamma, (price(up) - 2 * price(option) + price(down)) / (h * h), 1e-3) << option.type;
+
+        up = option;
+        down = option;
+        up.volatility += 1e-4;
+        down.volatility -= 1e-4;
+        EXPECT_NEAR(greeks.vega, (price(up) - price(down)) / 2e-4, 1e-4) << option.type;
+
+        up = option;
+        down = option;
+        up.risk_free_rate += 1e-4;
+        down.risk_free_rate -= 1e-4;
+        EXPECT_NEAR(greeks.rho, (price(up) - price(down)) / 2e-4, 1e-4) << option.type;
+    }
+
+    // Theta is the change in value as the remaining maturity shortens
+    bs_greeks greeks;
+    const bs_option call = regular(100, 95, 0.5, 0.25, 0.03);
+    ASSERT_EQ(bs_compute_greeks(&call, nullptr, &greeks, nullptr), BS_OK);
+    bs_option sooner = call;
+    sooner.time_to_maturity -= 1e-4;
+    EXPECT_NEAR(greeks.theta, (price(sooner) - price(call)) / 1e-4, 1e-3);
+    EXPECT_LT(greeks.theta, 0.0);
+    EXPECT_EQ(bs_compute_greeks(&call, nullptr, nullptr, nullptr), BS_INVALID_ARGUMENT);
+}
+
+TEST(BlackScholesCApiTest, VersionsAndNames) {
+    EXPECT_EQ(bs_api_version(), BS_API_VERSION);
+
+    char version[256];
+    const size_t length = bs_engine_version(version, sizeof(version));
+    ASSERT_GT(length, 0u);
+    EXPECT_EQ(std::strlen(version), length);
+    EXPECT_EQ(std::strncmp(version, "bsu-", 4), 0);
+
+    char truncated[5];
+    EXPECT_EQ(bs_engine_version(truncated, sizeof(truncated)), length);
+    EXPECT_STREQ(truncated, std::string(version, 4).c_str());
+    EXPECT_EQ(bs_engine_version(nullptr, 0), length);
+
+    EXPECT_STREQ(bs_engine_name(BS_ENGINE_GAUSS_LAGUERRE), "gauss_laguerre");
+    EXPECT_STREQ(bs_engine_name(BS_ENGINE_AUTO), "auto");
+    EXPECT_STREQ(bs_engine_name(42), "unknown");
+    EXPECT_STREQ(bs_status_string(BS_NUMERICAL_ERROR), "numerical error");
+    EXPECT_STREQ(bs_status_string(-1), "unknown status");
+}
+
+TEST(BlackScholesCApiTest, LoadTuningReportsErrors) {
+    char error[128];
+    EXPECT_EQ(bs_load_tuning("/nonexistent/tuning.json", error, sizeof(error)), BS_INVALID_ARGUMENT);
+    EXPECT_GT(std::strlen(error), 0u);
+
+    const std::string path = ::testing::TempDir() + "capi_tuning.json";
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    std::fputs("{\"gl_order\": 48}", file);
+    std::fclose(file);
+
+    char before[256], after[256];
+    bs_engine_version(before, sizeof(before));
+    ASSERT_EQ(bs_load_tuning(path.c_str(), error, sizeof(error)), BS_OK) << error;
+    bs_engine_version(after, sizeof(after));
+    EXPECT_STRNE(before, after);
+
+    const bs_option option = randomExpiration(BS_RANDOM_EXPIRATION_CALL, 100, 95, 0.2, 0.05, 2.0, 0.5);
+    bs_diagnostics diagnostics;
+    double value = 0.0;
+    ASSERT_EQ(bs_price(&option, nullptr, &value, &diagnostics), BS_OK);
+    EXPECT_EQ(diagnostics.evaluations, 48);
+    std::remove(path.c_str());
+}
@@ -6,6 +6,10 @@
 // Define test mode before including the controller
 
 #include "controllers/BlackScholesController.h"
+#include "utils/SlowRequestLog.h"
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
 
 // Mock service class
 class MockBlackScholesService {
@@ -49,7 +53,7 @@ namespace TestBlackScholesService {
                                                               volatility, risk_free_rate, 
                                                               holding_period, volatility_around_holding_period);
         }
-        return RandomExpirationCallOption{"random_expiration", 0.0, 0.0, 0.0};
+        return RandomExpirationCallOption{"random_expiration", 0.0, 0.0, 0.0, BlackScholesUtil::PricingDiagnostics{}};
     }
     
     RandomExpirationCallOption calculateRandomExpirationBinaryCall(double stock_price, double strike_price, 
@@ -60,7 +64,7 @@ namespace TestBlackScholesService {
                                                                     volatility, risk_free_rate, 
                                                                     holding_period, volatility_around_holding_period);
         }
-        return RandomExpirationCallOption{"random_expiration_binary", 0.0, 0.0, 0.0};
+        return RandomExpirationCallOption{"random_expiration_binary", 0.0, 0.0, 0.0, BlackScholesUtil::PricingDiagnostics{}};
     }
 }
 
@@ -80,7 +84,7 @@ protected:
 // Test case 1: Controller successfully handles valid random expiration call request
 TEST_F(BlackScholesControllerTest, RandomExpirationCall_Success) {
     // Setup mock expectations
-    RandomExpirationCallOption expectedResult{"random_expiration", 60.70572, 5.0, 5.0};
+    RandomExpirationCallOption expectedResult{"random_expiration", 60.70572, 5.0, 5.0, BlackScholesUtil::PricingDiagnostics{}};
     EXPECT_CALL(mockService, calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 5.0))
         .WillOnce(::testing::Return(expectedResult));
     
@@ -126,7 +130,7 @@ TEST_F(BlackScholesControllerTest, RandomExpirationCall_Success) {
 // Test case 2: Controller handles missing volatility_around_holding_period (defaults to holding_period)
 TEST_F(BlackScholesControllerTest, RandomExpirationCall_DefaultVolatilityAroundHoldingPeriod) {
     // Setup mock expectations - note that volatility_around_holding_period should default to holding_period
-    RandomExpirationCallOption expectedResult{"random_expiration", 63.62, 5.0, 5.0};
+    RandomExpirationCallOption expectedResult{"random_expiration", 63.62, 5.0, 5.0, BlackScholesUtil::PricingDiagnostics{}};
     EXPECT_CALL(mockService, calculateRandomExpirationCall(100.0, 85.0, 0.9, 0.0406, 5.0, 5.0))
         .WillOnce(::testing::Return(expectedResult));
     
@@ -439,7 +443,7 @@ TEST_F(BlackScholesControllerTest, ServiceException_ReturnsInternalServerError)
 // Test case 10: Controller successfully handles random expiration binary call request
 TEST_F(BlackScholesControllerTest, RandomExpirationBinaryCall_Success) {
     // Setup mock expectations
-    RandomExpirationCallOption expectedResult{"random_expiration_binary", 0.55, 5.0, 10.0};
+    RandomExpirationCallOption expectedResult{"random_expiration_binary", 0.55, 5.0, 10.0, BlackScholesUtil::PricingDiagnostics{}};
     EXPECT_CALL(mockService, calculateRandomExpirationBinaryCall(100.0, 100.0, 0.1, 0.0422, 5.0, 10.0))
         .WillOnce(::testing::Return(expectedResult));
     
@@ -485,7 +489,7 @@ TEST_F(BlackScholesControllerTest, RandomExpirationBinaryCall_Success) {
 // Test case 11: Controller handles random expiration binary call with default volatility_around_holding_period
 TEST_F(BlackScholesControllerTest, RandomExpirationBinaryCall_DefaultVolatilityAroundHoldingPeriod) {
     // Setup mock expectations - note that volatility_around_holding_period should default to holding_period
-    RandomExpirationCallOption expectedResult{"random_expiration_binary", 0.61, 5.0, 5.0};
+    RandomExpirationCallOption expectedResult{"random_expiration_binary", 0.61, 5.0, 5.0, BlackScholesUtil::PricingDiagnostics{}};
     EXPECT_CALL(mockService, calculateRandomExpirationBinaryCall(100.0, 100.0, 0.1, 0.0422, 5.0, 5.0))
         .WillOnce(::testing::Return(expectedResult));
     
@@ -528,6 +532,146 @@ TEST_F(BlackScholesControllerTest, RandomExpirationBinaryCall_DefaultVolatilityA
     EXPECT_TRUE(callbackCalled);
 }
 
+// Test case 12: Controller reports per-phase timings in Server-Timing when enabled
+TEST_F(BlackScholesControllerTest, ServerTimingHeader) {
+    EXPECT_CALL(mockService, calculateRegularCall(100.0, 100.0, 1.0, 0.2, 0.05))
+        .Times(2)
+        .WillRepeatedly(::testing::Return(CallOption{"regular", 10.45}));
+    
+    Json::Value requestBody;
+    requestBody["stock_price"] = 100.0;
+    requestBody["strike_price"] = 100.0;
+    requestBody["time_to_maturity"] = 1.0;
+    requestBody["volatility"] = 0.2;
+    requestBody["risk_free_rate"] = 0.05;
+    requestBody["type"] = "regular";
+    
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->setMethod(drogon::Post);
+    req->setPath("/api/calculate");
+    req->setBody(requestBody.toStyledString());
+    
+    BlackScholesController controller;
+    std::string header;
+    
+    PhaseTimer::setServerTimingEnabled(false);
+    controller.calculate(req, [&](const drogon::HttpResponsePtr& resp) {
+        header = resp->getHeader("Server-Timing");
+    });
+    EXPECT_TRUE(header.empty());
+    
+    PhaseTimer::setServerTimingEnabled(true);
+    controller.calculate(req, [&](const drogon::HttpResponsePtr& resp) {
+        header = resp->getHeader("Server-Timing");
+    });
+    PhaseTimer::setServerTimingEnabled(false);
+    
+    for (const char* phase : {"body;dur=", "parse;dur=", "validate;dur=", "price;dur=", "serialize;dur="}) {
+        EXPECT_NE(header.find(phase), std::string::npos) << header;
+    }
+}
+
+// Test case 13: Controller adds a diagnostics block only when the request asks for it
+TEST_F(BlackScholesControllerTest, RandomExpirationCall_Diagnostics) {
+    RandomExpirationCallOption expectedResult{"random_expiration", 60.70572, 5.0, 5.0, BlackScholesUtil::PricingDiagnostics{}};
+    expectedResult.diagnostics.engine = BlackScholesUtil::PricingEngine::GSL_QAGIU;
+    expectedResult.diagnostics.evaluations = 315;
+    expectedResult.diagnostics.abs_error = 2.5e-10;
+    expectedResult.diagnostics.alpha = 1.0;
+    expectedResult.diagnostics.beta = 0.2;
+    EXPECT_CALL(mockService, calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 5.0))
+        .Times(2)
+        .WillRepeatedly(::testing::Return(expectedResult));
+    
+    Json::Value requestBody;
+    requestBody["stock_price"] = 100.0;
+    requestBody["strike_price"] = 100.0;
+    requestBody["volatility"] = 0.9;
+    requestBody["risk_free_rate"] = 0.05;
+    requestBody["type"] = "randomExpirationCall";
+    requestBody["holding_period"] = 5.0;
+    requestBody["volatility_around_holding_period"] = 5.0;
+    
+    BlackScholesController controller;
+    Json::Value response;
+    auto call = [&](const Json::Value& body) {
+        auto req = drogon::HttpRequest::newHttpRequest();
+        req->setMethod(drogon::Post);
+        req->setPath("/api/calculate");
+        req->setBody(body.toStyledString());
+        controller.calculate(req, [&](const drogon::HttpResponsePtr& resp) {
+            EXPECT_EQ(resp->getStatusCode(), drogon::k200OK);
+            Json::Reader reader;
+            EXPECT_TRUE(reader.parse(std::string(resp->getBody()), response));
+        });
+    };
+    
+    call(requestBody);
+    EXPECT_FALSE(response["data"].isMember("diagnostics"));
+    
+    requestBody["diagnostics"] = true;
+    call(requestBody);
+    const Json::Value& diagnostics = response["data"]["diagnostics"];
+    EXPECT_EQ(diagnostics["engine"].asString(), "gsl_qagiu");
+    EXPECT_EQ(diagnostics["evaluations"].asInt(), 315);
+    EXPECT_DOUBLE_EQ(diagnostics["abs_error"].asDouble(), 2.5e-10);
+    EXPECT_DOUBLE_EQ(diagnostics["alpha"].asDouble(), 1.0);
+    EXPECT_DOUBLE_EQ(diagnostics["beta"].asDouble(), 0.2);
+    EXPECT_FALSE(diagnostics["table_rebuilt"].asBool());
+    EXPECT_FALSE(diagnostics["cached"].asBool());
+}
+
+// Test case 14: Slow request log records the canonical, replayable request
+TEST_F(BlackScholesControllerTest, SlowRequestLog_RecordsReplayableRequest) {
+    RandomExpirationCallOption expectedResult{"random_expiration", 60.70572, 5.0, 5.0, BlackScholesUtil::PricingDiagnostics{}};
+    expectedResult.diagnostics.engine = BlackScholesUtil::PricingEngine::GAUSS_LAGUERRE;
+    expectedResult.diagnostics.evaluations = 64;
+    EXPECT_CALL(mockService, calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 5.0))
+        .WillOnce(::testing::Return(expectedResult));
+    
+    SlowLogConfig config;
+    config.path = "/tmp/bss_controller_slow_" + std::to_string(getpid()) + ".jsonl";
+    config.threshold_ms = 0.0;
+    std::remove(config.path.c_str());
+    std::string error;
+    ASSERT_TRUE(SlowRequestLog::start(config, error)) << error;
+    
+    BlackScholesController controller;
+    auto call = [&](const std::string& body) {
+        auto req = drogon::HttpRequest::newHttpRequest();
+        req->setMethod(drogon::Post);
+        req->setPath("/api/calculate");
+        req->setBody(body);
+        controller.calculate(req, [](const drogon::HttpResponsePtr&) {});
+    };
+    // The volatility around the holding period is left to its default
+    call("{\"stock_price\": 100, \"strike_price\": 100, \"volatility\": 0.9, "
+         "\"risk_free_rate\": 0.05, \"type\": \"randomExpirationCall\", \"holding_period\": 5}");
+    call("{\"stock_price\": -1}");
+    SlowRequestLog::stop();
+    
+    std::vector<Json::Value> requests;
+    ASSERT_TRUE(SlowRequestLog::readRequests(config.path, requests, error)) << error;
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0]["type"].asString(), "randomExpirationCall");
+    EXPECT_DOUBLE_EQ(requests[0]["volatility_around_holding_period"].asDouble(), 5.0);
+    auto replayed = dto::BlackScholesRequestDto::fromJson(requests[0], error);
+    EXPECT_TRUE(replayed.has_value()) << error;
+    
+    std::ifstream in(config.path);
+    std::string line;
+    std::getline(in, line);
+    Json::Value record;
+    Json::Reader reader;
+    ASSERT_TRUE(reader.parse(line, record));
+    EXPECT_EQ(record["status"].asInt(), 200);
+    EXPECT_EQ(record["engine"].asString(), "gauss_laguerre");
+    EXPECT_EQ(record["diagnostics"]["evaluations"].asInt(), 64);
+    EXPECT_TRUE(record["phases_ms"].isMember("price"));
+    EXPECT_GE(record["total_ms"].asDouble(), record["queue_ms"].asDouble());
+    std::remove(config.path.c_str());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -241,6 +241,64 @@ TEST_F(BlackScholesRequestDtoTest, MissingHoldingPeriodForRandomExpirationBinary
     EXPECT_FALSE(error.empty());
 }
 
+// Test optional diagnostics flag
+TEST_F(BlackScholesRequestDtoTest, DiagnosticsFlag) {
+    Json::Value requestBody;
+    requestBody["stock_price"] = 100.0;
+    requestBody["strike_price"] = 100.0;
+    requestBody["volatility"] = 0.9;
+    requestBody["risk_free_rate"] = 0.05;
+    requestBody["type"] = "randomExpirationCall";
+    requestBody["holding_period"] = 5.0;
+    
+    std::string error;
+    auto dto = dto::BlackScholesRequestDto::fromJson(requestBody, error);
+    ASSERT_TRUE(dto.has_value());
+    EXPECT_FALSE(dto->wantsDiagnostics());
+    
+    requestBody["diagnostics"] = true;
+    dto = dto::BlackScholesRequestDto::fromJson(requestBody, error);
+    ASSERT_TRUE(dto.has_value());
+    EXPECT_TRUE(dto->wantsDiagnostics());
+    
+    requestBody["diagnostics"] = "yes";
+    dto = dto::BlackScholesRequestDto::fromJson(requestBody, error);
+    ASSERT_FALSE(dto.has_value());
+    EXPECT_EQ(error, "Field diagnostics must be a boolean");
+}
+
+// Test canonical JSON round trip
+TEST_F(BlackScholesRequestDtoTest, CanonicalJsonRoundTrip) {
+    Json::Value requestBody;
+    requestBody["stock_price"] = 101.25;
+    requestBody["strike_price"] = 0.1 + 0.2;
+    requestBody["volatility"] = 0.9;
+    requestBody["risk_free_rate"] = -0.01;
+    requestBody["type"] = "randomExpirationBinaryCall";
+    requestBody["holding_period"] = 5.0;
+    
+    std::string error;
+    auto dto = dto::BlackScholesRequestDto::fromJson(requestBody, error);
+    ASSERT_TRUE(dto.has_value());
+    
+    Json::Value canonical = dto->toJson();
+    EXPECT_EQ(canonical["type"].asString(), "randomExpirationBinaryCall");
+    EXPECT_DOUBLE_EQ(canonical["volatility_around_holding_period"].asDouble(), 5.0);
+    EXPECT_FALSE(canonical.isMember("time_to_maturity"));
+    EXPECT_FALSE(canonical.isMember("diagnostics"));
+    
+    // Doubles must survive text serialization bit for bit
+    Json::Value reparsed;
+    Json::Reader reader;
+    ASSERT_TRUE(reader.parse(Json::FastWriter().write(canonical), reparsed));
+    auto replayed = dto::BlackScholesRequestDto::fromJson(reparsed, error);
+    ASSERT_TRUE(replayed.has_value());
+    EXPECT_EQ(replayed->getStrikePrice(), dto->getStrikePrice());
+    EXPECT_EQ(replayed->getRiskFreeRate(), dto->getRiskFreeRate());
+    EXPECT_EQ(replayed->getOptionType(), dto->getOptionType());
+    EXPECT_EQ(replayed->getVolatilityAroundHoldingPeriod(), dto->getVolatilityAroundHoldingPeriod());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include "services/AutotuneService.h"
+#include "services/TuningService.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/TuningConfig.h"
+
+class AutotuneServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char tmpl[] = "/tmp/autotuneXXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir_ = tmpl;
+        original_isa_ = BlackScholesUtil::kernelIsa();
+    }
+
+    void TearDown() override {
+        std::string error;
+        ASSERT_TRUE(TuningConfig::publish(TuningParameters{}, error)) << error;
+        TuningService::setBaseline(TuningParameters{});
+        BlackScholesUtil::setKernelIsa(original_isa_);
+        std::system(("rm -rf " + dir_).c_str());
+    }
+
+    // Small candidate sets keep the run short
+    AutotuneConfig smallConfig() const {
+        AutotuneConfig config;
+        config.enabled = true;
+        config.cache_dir = dir_;
+        config.gl_orders = {8, 64};
+        config.repetitions = 2;
+        return config;
+    }
+
+    std::string dir_;
+    BlackScholesUtil::KernelIsa original_isa_;
+};
+
+// Orders that miss the accuracy target are never chosen, and every candidate is reported
+TEST_F(AutotuneServiceTest, RejectsInaccurateOrders) {
+    AutotuneResult result;
+    std::string error;
+    ASSERT_TRUE(AutotuneService::measure(smallConfig(), result, error)) << error;
+
+    EXPECT_FALSE(result.measurements["gl_order"]["8"]["accepted"].asBool());
+    EXPECT_TRUE(result.measurements["gl_order"]["64"]["accepted"].asBool());
+    EXPECT_EQ(result.gl_order, 64);
+    EXPECT_TRUE(BlackScholesUtil::kernelIsaSupported(result.isa));
+    EXPECT_TRUE(result.measurements["isa"]["scalar"]["accepted"].asBool());
+    EXPECT_FALSE(result.measurements.isMember("batch"));
+    EXPECT_FALSE(result.from_cache);
+}
+
+// With no order accurate enough the current order is kept
+TEST_F(AutotuneServiceTest, KeepsCurrentOrderWhenNoneQualify) {
+    AutotuneConfig config = smallConfig();
+    config.gl_orders = {4};
+    AutotuneResult result;
+    std::string error;
+    ASSERT_TRUE(AutotuneService::measure(config, result, error)) << error;
+    EXPECT_EQ(result.gl_order, BSU_GL_ORDER);
+    EXPECT_TRUE(result.measurements["gl_order_fallback"].asBool());
+}
+
+// The second run on the same CPU reuses the first run's decision
+TEST_F(AutotuneServiceTest, DecisionIsCachedPerCpu) {
+    const AutotuneConfig config = smallConfig();
+    AutotuneResult first;
+    std::string error;
+    ASSERT_TRUE(AutotuneService::run(config, first, error)) << error;
+    EXPECT_FALSE(first.from_cache);
+    EXPECT_EQ(first.cpu_model, AutotuneService::cpuModel());
+
+    const std::string path = dir_ + "/autotune-" + AutotuneService::cacheKey(config, first.cpu_model) + ".json";
+    ASSERT_EQ(access(path.c_str(), R_OK), 0);
+
+    AutotuneResult second;
+    ASSERT_TRUE(AutotuneService::run(config, second, error)) << error;
+    EXPECT_TRUE(second.from_cache);
+    EXPECT_EQ(second.isa, first.isa);
+    EXPECT_EQ(second.gl_order, first.gl_order);
+
+    // Different candidates are a different decision
+    AutotuneConfig other = config;
+    other.gl_orders = {32};
+    EXPECT_NE(AutotuneService::cacheKey(other, first.cpu_model), AutotuneService::cacheKey(config, first.cpu_model));
+}
+
+// Applying pins the kernel and the order, also under tuning files
+TEST_F(AutotuneServiceTest, ApplyPinsChoices) {
+    AutotuneResult result;
+    result.isa = BlackScholesUtil::KernelIsa::SCALAR;
+    result.gl_order = 48;
+
+    std::string error;
+    ASSERT_TRUE(AutotuneService::apply(result, error)) << error;
+    EXPECT_EQ(BlackScholesUtil::kernelIsa(), BlackScholesUtil::KernelIsa::SCALAR);
+    EXPECT_EQ(TuningConfig::current().gl_order, 48);
+    EXPECT_EQ(TuningService::baseline().gl_order, 48);
+
+    const Json::Value report = AutotuneService::report();
+    EXPECT_TRUE(report["enabled"].asBool());
+    EXPECT_EQ(report["isa"].asString(), "scalar");
+    EXPECT_EQ(report["gl_order"].asInt(), 48);
+}
+
+TEST_F(AutotuneServiceTest, ResultJsonRoundTrip) {
+    AutotuneResult result;
+    result.cpu_model = "Test CPU";
+    result.cache_key = "0123456789abcdef";
+    result.gl_order = 24;
+    result.measurements["note"] = "kept";
+
+    AutotuneResult parsed;
+    std::string error;
+    ASSERT_TRUE(parsed.fromJson(result.toJson(), error)) << error;
+    EXPECT_EQ(parsed.cpu_model, "Test CPU");
+    EXPECT_EQ(parsed.cache_key, result.cache_key);
+    EXPECT_EQ(parsed.isa, BlackScholesUtil::KernelIsa::SCALAR);
+    EXPECT_EQ(parsed.gl_order, 24);
+    EXPECT_EQ(parsed.measurements["note"].asString(), "kept");
+
+    Json::Value bad = result.toJson();
+    bad["isa"] = "avx512";
+    EXPECT_FALSE(parsed.fromJson(bad, error));
+    EXPECT_EQ(error, "Unknown kernel variant avx512");
+}
@@ -148,7 +148,7 @@ TEST_F(BlackScholesServiceTest, RandomExpirationCall_Test1) {
     );
     
     EXPECT_EQ(result.type, "random_expiration");
-    EXPECT_NEAR(result.value, 60.75179, 0.01);
+    EXPECT_NEAR(result.value, 60.70572, 0.01);
     EXPECT_EQ(result.holding_period, 5.0);
     EXPECT_EQ(result.volatility_around_holding_period, 5.0);
 }
@@ -165,7 +165,7 @@ TEST_F(BlackScholesServiceTest, RandomExpirationCall_Test2) {
     );
     
     EXPECT_EQ(result.type, "random_expiration");
-    EXPECT_NEAR(result.value, 63.64, 0.01);
+    EXPECT_NEAR(result.value, 63.62, 0.01);
     EXPECT_EQ(result.holding_period, 5.0);
     EXPECT_EQ(result.volatility_around_holding_period, 5.0);
 }
@@ -358,6 +358,20 @@ TEST_F(BlackScholesServiceTest, RandomExpirationBinaryCall_UserSample3) {
     EXPECT_EQ(result.volatility_around_holding_period, 5.0);
 }
 
+// Test case 13: Service reports how a random expiration price was computed
+TEST_F(BlackScholesServiceTest, RandomExpirationCall_Diagnostics) {
+    RandomExpirationCallOption first = BlackScholesService::calculateRandomExpirationCall(
+        101.0, 99.0, 0.7, 0.03, 3.0, 1.0);
+    EXPECT_FALSE(first.cached);
+    EXPECT_EQ(first.diagnostics.engine, BlackScholesUtil::PricingEngine::GAUSS_LAGUERRE);
+    EXPECT_DOUBLE_EQ(first.diagnostics.alpha, 9.0);
+    
+    RandomExpirationCallOption second = BlackScholesService::calculateRandomExpirationCall(
+        101.0, 99.0, 0.7, 0.03, 3.0, 1.0);
+    EXPECT_TRUE(second.cached);
+    EXPECT_EQ(second.value, first.value);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "services/BlackScholesService.h"
+#include "services/MetricsService.h"
+#include "services/ResultCache.h"
+#include "utils/AllocationTracker.h"
+
+using BlackScholesUtil::PricingEngine;
+
+class MetricsServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ResultCache::instance().clear();
+    }
+};
+
+TEST_F(MetricsServiceTest, BucketsArePowersOfTwoNanoseconds) {
+    EXPECT_EQ(HistogramSnapshot::bucketFor(0), 0u);
+    EXPECT_EQ(HistogramSnapshot::bucketFor(256), 0u);
+    EXPECT_EQ(HistogramSnapshot::bucketFor(257), 1u);
+    EXPECT_EQ(HistogramSnapshot::bucketFor(512), 1u);
+    EXPECT_EQ(HistogramSnapshot::bucketFor(1000000), 12u);  // 1 ms <= 2^20 ns
+    EXPECT_EQ(HistogramSnapshot::bucketFor(UINT64_MAX), HistogramSnapshot::kBucketCount - 1);
+    EXPECT_DOUBLE_EQ(HistogramSnapshot::upperBoundSeconds(0), 256e-9);
+}
+
+TEST_F(MetricsServiceTest, AggregatesAcrossThreads) {
+    const uint64_t before = MetricsService::requestCount(dto::OptionType::BINARY);
+    const auto latency_before = MetricsService::pricingLatency(dto::OptionType::BINARY, PricingEngine::CLOSED_FORM);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; ++i) {
+                MetricsService::recordRequest(dto::OptionType::BINARY);
+                MetricsService::recordPricing(dto::OptionType::BINARY, PricingEngine::CLOSED_FORM, 300);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(MetricsService::requestCount(dto::OptionType::BINARY) - before, 4000u);
+    const auto latency = MetricsService::pricingLatency(dto::OptionType::BINARY, PricingEngine::CLOSED_FORM);
+    EXPECT_EQ(latency.count - latency_before.count, 4000u);
+    EXPECT_EQ(latency.buckets[1] - latency_before.buckets[1], 4000u);
+    EXPECT_EQ(latency.sum_ns - latency_before.sum_ns, 4000u * 300u);
+}
+
+TEST_F(MetricsServiceTest, InFlightTracksUnfinishedRequests) {
+    const int64_t before = MetricsService::inFlight();
+    const uint64_t internal_before = MetricsService::errorCount(RequestError::INTERNAL);
+
+    const uint64_t a = MetricsService::requestStarted();
+    const uint64_t b = MetricsService::requestStarted();
+    EXPECT_EQ(MetricsService::inFlight() - before, 2);
+
+    // Finishing on another thread still balances the sum
+    std::thread([a]() { MetricsService::requestFinished(a, 200); }).join();
+    MetricsService::requestFinished(b, 500);
+    EXPECT_EQ(MetricsService::inFlight(), before);
+    EXPECT_EQ(MetricsService::errorCount(RequestError::INTERNAL) - internal_before, 1u);
+}
+
+TEST_F(MetricsServiceTest, ServiceRecordsNumericalPath) {
+    const auto gl_before = MetricsService::pricingLatency(dto::OptionType::RANDOM_EXPIRATION_CALL,
+                                                          PricingEngine::GAUSS_LAGUERRE).count;
+    const auto gsl_before = MetricsService::pricingLatency(dto::OptionType::RANDOM_EXPIRATION_CALL,
+                                                           PricingEngine::GSL_QAGIU).count;
+    const auto shortcut_before = MetricsService::pricingLatency(dto::OptionType::RANDOM_EXPIRATION_CALL,
+                                                                PricingEngine::ANALYTIC_SHORTCUT).count;
+    const auto cache_before = MetricsService::cacheHitLatency(dto::OptionType::RANDOM_EXPIRATION_CALL).count;
+
+    BlackScholesService::calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 2.0);   // GL
+    BlackScholesService::calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 10.0);  // GSL, cv >= 1.5
+    BlackScholesService::calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 0.01);  // shortcut
+    BlackScholesService::calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 2.0);   // cached
+
+    EXPECT_EQ(MetricsService::pricingLatency(dto::OptionType::RANDOM_EXPIRATION_CALL,
+                                             PricingEngine::GAUSS_LAGUERRE).count - gl_before, 1u);
+    EXPECT_EQ(MetricsService::pricingLatency(dto::OptionType::RANDOM_EXPIRATION_CALL,
+                                             PricingEngine::GSL_QAGIU).count - gsl_before, 1u);
+    EXPECT_EQ(MetricsService::pricingLatency(dto::OptionType::RANDOM_EXPIRATION_CALL,
+                                             PricingEngine::ANALYTIC_SHORTCUT).count - shortcut_before, 1u);
+    EXPECT_EQ(MetricsService::cacheHitLatency(dto::OptionType::RANDOM_EXPIRATION_CALL).count - cache_before, 1u);
+}
+
+TEST_F(MetricsServiceTest, RendersPrometheusText) {
+    BlackScholesService::calculateRegularCall(100.0, 100.0, 1.0, 0.2, 0.05);
+    BlackScholesService::calculateRandomExpirationBinaryCall(100.0, 100.0, 0.9, 0.05, 5.0, 2.0);
+    MetricsService::recordRequest(dto::OptionType::REGULAR);
+
+    const std::string text = MetricsService::renderPrometheus();
+    EXPECT_NE(text.find("# TYPE bss_pricing_duration_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("bss_pricing_duration_seconds_count{type=\"regular\",path=\"closed_form\"}"), std::string::npos);
+    EXPECT_NE(text.find("bss_pricing_duration_seconds_bucket{type=\"randomExpirationBinaryCall\",path=\"gauss_laguerre\",le=\"+Inf\"}"),
+              std::string::npos);
+    EXPECT_NE(text.find("bss_requests_total{type=\"regular\"}"), std::string::npos);
+    EXPECT_NE(text.find("bss_request_duration_seconds_bucket{le=\"2.56e-07\"}"), std::string::npos);
+    EXPECT_NE(text.find("bss_gl_table_builds_total"), std::string::npos);
+    EXPECT_NE(text.find("bss_result_cache_hit_ratio"), std::string::npos);
+    EXPECT_NE(text.find("bss_requests_in_flight"), std::string::npos);
+    EXPECT_NE(text.find("bss_request_phase_seconds_count{phase=\"serialize\"}"), std::string::npos);
+}
+
+TEST_F(MetricsServiceTest, ReportsAllocationsWhenTracking) {
+    EXPECT_EQ(MetricsService::renderPrometheus().find("bss_engine_allocations_total"), std::string::npos);
+
+    AllocationTracker::setEnabled(true);
+    PhaseTimer timer;
+    timer.mark(RequestPhase::BODY);
+    std::vector<double> parsed(16);
+    timer.mark(RequestPhase::PARSE);
+    BlackScholesService::calculateRegularCall(100.0, 100.0, 1.0, 0.2, 0.05);
+    MetricsService::recordPhases(timer);
+    const Json::Value json = MetricsService::allocationsJson();
+    const std::string text = MetricsService::renderPrometheus();
+    AllocationTracker::setEnabled(false);
+
+    EXPECT_TRUE(json["enabled"].asBool());
+    EXPECT_GE(json["phases"]["parse"]["requests"].asUInt64(), 1u);
+    EXPECT_GT(json["phases"]["parse"]["bytes_per_request"].asDouble(), 0.0);
+    EXPECT_GE(json["engines"]["closed_form"]["invocations"].asUInt64(), 1u);
+    EXPECT_NE(text.find("bss_request_phase_allocated_bytes_total{phase=\"parse\"}"), std::string::npos);
+    EXPECT_NE(text.find("bss_engine_allocations_total{engine=\"closed_form\"}"), std::string::npos);
+}
+
+TEST_F(MetricsServiceTest, CountsGLTableBuilds) {
+    const uint64_t before = BlackScholesUtil::glTableBuilds();
+    std::thread([]() { BlackScholesUtil::prebuildGLTable(3.25); }).join();
+    EXPECT_EQ(BlackScholesUtil::glTableBuilds() - before, 1u);
+}
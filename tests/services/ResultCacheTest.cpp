@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+#include "services/ResultCache.h"
+#include "utils/MappedStore.h"
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+    ResultCacheKey key(double strike) {
+        return ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_CALL, 100.0, strike, 0.9, 0.05, 5.0, 5.0);
+    }
+};
+
+TEST_F(ResultCacheTest, LookupReturnsInsertedValue) {
+    ResultCache cache(64);
+    double value = 0.0;
+    EXPECT_FALSE(cache.lookup(key(100.0), value));
+
+    cache.insert(key(100.0), 60.75, 0);
+    ASSERT_TRUE(cache.lookup(key(100.0), value));
+    EXPECT_EQ(value, 60.75);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+}
+
+TEST_F(ResultCacheTest, KeysAreCanonical) {
+    // -0.0 and +0.0 describe the same request
+    auto a = ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_CALL, 100.0, 100.0, 0.9, 0.0, 5.0, 5.0);
+    auto b = ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_CALL, 100.0, 100.0, 0.9, -0.0, 5.0, 5.0);
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(a.hash(), b.hash());
+
+    auto binary = ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_BINARY_CALL, 100.0, 100.0, 0.9, 0.0, 5.0, 5.0);
+    EXPECT_FALSE(a == binary);
+    EXPECT_NE(a.hash(), binary.hash());
+}
+
+TEST_F(ResultCacheTest, EvictsLeastRecentlyUsed) {
+    ResultCache cache(16); // one entry per shard
+    for (int i = 0; i < 1000; ++i) {
+        cache.insert(key(50.0 + i), static_cast<double>(i), 0);
+    }
+    EXPECT_LE(cache.size(), 16u);
+
+    double value = 0.0;
+    cache.insert(key(1.0), 1.0, 0);
+    EXPECT_TRUE(cache.lookup(key(1.0), value));
+}
+
+// Keys routed to one cluster node share the high bits of their hash; they must still use every
+// shard's capacity instead of crowding into one
+TEST_F(ResultCacheTest, KeysSharingHighHashBitsSpreadOverShards) {
+    const uint64_t top = key(100.0).hash() >> 56;
+    std::vector<ResultCacheKey> keys;
+    for (int i = 0; keys.size() < 32; ++i) {
+        ResultCacheKey candidate = key(50.0 + 0.001 * i);
+        if (candidate.hash() >> 56 == top) keys.push_back(candidate);
+    }
+
+    ResultCache cache(128);   // 8 per shard
+    for (const auto& k : keys) cache.insert(k, 1.0, 0);
+    EXPECT_EQ(cache.size(), keys.size());
+}
+
+TEST_F(ResultCacheTest, ZeroCapacityDisablesCaching) {
+    ResultCache cache(0);
+    cache.insert(key(100.0), 1.0, 0);
+    double value = 0.0;
+    EXPECT_FALSE(cache.lookup(key(100.0), value));
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(ResultCacheTest, ClearRemovesEntries) {
+    ResultCache cache(64);
+    cache.insert(key(100.0), 1.0, 0);
+    cache.clear();
+    double value = 0.0;
+    EXPECT_FALSE(cache.lookup(key(100.0), value));
+}
+
+TEST_F(ResultCacheTest, PersistentStoreServesColdCache) {
+    char tmpl[] = "/tmp/result_cache_storeXXXXXX";
+    int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(tmpl, 256, 64, "test", error)) << error;
+
+    ResultCache warm(64);
+    warm.attachStore(&store);
+    warm.insert(key(100.0), 60.75, 0);
+
+    // A fresh cache, as after a restart, is served from the store
+    ResultCache cold(64);
+    cold.attachStore(&store);
+    double value = 0.0;
+    ASSERT_TRUE(cold.lookup(key(100.0), value));
+    EXPECT_EQ(value, 60.75);
+    EXPECT_EQ(cold.storeHits(), 1u);
+
+    // and promotes the entry into memory
+    ASSERT_TRUE(cold.lookup(key(100.0), value));
+    EXPECT_EQ(cold.storeHits(), 1u);
+
+    store.close();
+    std::remove(tmpl);
+}
+
+// A request priced under the old tuning must not repopulate either level after a reload
+TEST_F(ResultCacheTest, InsertsOlderThanAnInvalidationAreDropped) {
+    char tmpl[] = "/tmp/result_cache_storeXXXXXX";
+    int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(tmpl, 256, 64, "v1", error)) << error;
+    ResultCache cache(64);
+    cache.attachStore(&store);
+    cache.insert(key(100.0), 1.0, 3);
+
+    cache.invalidateAll("v2", 4);
+    double value = 0.0;
+    EXPECT_FALSE(cache.lookup(key(100.0), value));
+    cache.insert(key(100.0), 1.0, 3);
+    EXPECT_FALSE(cache.lookup(key(100.0), value));
+    EXPECT_EQ(store.countEntries(), 0u);
+
+    cache.insert(key(100.0), 2.0, 4);
+    ASSERT_TRUE(cache.lookup(key(100.0), value));
+    EXPECT_EQ(value, 2.0);
+    ResultCache cold(64);
+    cold.attachStore(&store);
+    ASSERT_TRUE(cold.lookup(key(100.0), value));
+    EXPECT_EQ(value, 2.0);
+
+    store.close();
+    std::remove(tmpl);
+}
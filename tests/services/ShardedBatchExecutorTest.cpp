@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "services/ShardedBatchExecutor.h"
+#include "utils/BlackScholesUtil.h"
+
+class ShardedBatchExecutorTest : public ::testing::Test {
+protected:
+    BatchPricingJob makeRandomExpirationJob(size_t n) {
+        BatchPricingJob job;
+        job.type = dto::OptionType::RANDOM_EXPIRATION_CALL;
+        for (size_t i = 0; i < n; ++i) {
+            job.stock_prices.push_back(100.0);
+            job.strike_prices.push_back(80.0 + static_cast<double>(i % 40));
+            job.volatilities.push_back(0.2 + 0.01 * static_cast<double>(i % 7));
+            job.risk_free_rates.push_back(0.05);
+            job.holding_periods.push_back(5.0);
+            job.volatility_around_holding_periods.push_back(i % 3 == 0 ? 10.0 : 5.0);
+        }
+        return job;
+    }
+
+    BatchPricingJob makeRegularJob(size_t n) {
+        BatchPricingJob job;
+        job.type = dto::OptionType::REGULAR;
+        for (size_t i = 0; i < n; ++i) {
+            job.stock_prices.push_back(100.0);
+            job.strike_prices.push_back(50.0 + static_cast<double>(i % 100));
+            job.volatilities.push_back(0.2);
+            job.risk_free_rates.push_back(0.05);
+            job.time_to_maturities.push_back(0.25 + 0.01 * static_cast<double>(i % 10));
+        }
+        return job;
+    }
+};
+
+// Results must come back in input order and match in-process pricing exactly
+TEST_F(ShardedBatchExecutorTest, MatchesInProcessPricingInOrder) {
+    auto job = makeRandomExpirationJob(257);
+    ShardedBatchOptions options;
+    options.worker_count = 3;
+    options.shard_size = 16;
+
+    std::vector<double> results;
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::run(job, options, results, error)) << error;
+    ASSERT_EQ(results.size(), job.size());
+
+    for (size_t i = 0; i < job.size(); ++i) {
+        double expected = BlackScholesUtil::calculateRandomExpirationCall(
+            job.stock_prices[i], job.strike_prices[i], job.volatilities[i], job.risk_free_rates[i],
+            job.holding_periods[i], job.volatility_around_holding_periods[i]);
+        EXPECT_EQ(results[i], expected) << "row " << i;
+    }
+}
+
+// Small jobs stay in the calling process, so worker failures cannot affect them
+TEST_F(ShardedBatchExecutorTest, SmallJobsArePricedInline) {
+    auto job = makeRegularJob(32);
+    ShardedBatchOptions options;
+    options.shard_size = 4;
+    options.inline_rows = 32;
+    options.max_shard_retries = 0;
+    options.shard_hook = [](size_t, int) { _exit(1); };
+
+    std::vector<double> results;
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::run(job, options, results, error)) << error;
+    for (size_t i = 0; i < job.size(); ++i) {
+        EXPECT_EQ(results[i], BlackScholesUtil::calculateStandardCall(job.stock_prices[i], job.strike_prices[i],
+                                                                      job.time_to_maturities[i], job.volatilities[i],
+                                                                      job.risk_free_rates[i]));
+    }
+    
+    job = makeRegularJob(33);
+    EXPECT_FALSE(ShardedBatchExecutor::run(job, options, results, error));
+}
+
+TEST_F(ShardedBatchExecutorTest, RegularBatchWithMoreWorkersThanShards) {
+    auto job = makeRegularJob(10);
+    ShardedBatchOptions options;
+    options.worker_count = 8;
+    options.shard_size = 4;
+
+    std::vector<double> results;
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::run(job, options, results, error)) << error;
+    for (size_t i = 0; i < job.size(); ++i) {
+        EXPECT_EQ(results[i], BlackScholesUtil::calculateStandardCall(job.stock_prices[i], job.strike_prices[i],
+                                                                      job.time_to_maturities[i], job.volatilities[i],
+                                                                      job.risk_free_rates[i]));
+    }
+}
+
+// A worker that crashes mid-shard is replaced and the shard is retried
+TEST_F(ShardedBatchExecutorTest, RestartsFailedShard) {
+    auto job = makeRegularJob(100);
+    ShardedBatchOptions options;
+    options.worker_count = 2;
+    options.shard_size = 10;
+    options.shard_hook = [](size_t shard, int attempt) {
+        if (shard == 3 && attempt == 0) _exit(3);
+    };
+
+    std::vector<double> results;
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::run(job, options, results, error)) << error;
+    EXPECT_EQ(results[35], BlackScholesUtil::calculateStandardCall(job.stock_prices[35], job.strike_prices[35],
+                                                                   job.time_to_maturities[35], job.volatilities[35],
+                                                                   job.risk_free_rates[35]));
+}
+
+// An exception in a worker counts as a crash rather than unwinding into the caller's code
+TEST_F(ShardedBatchExecutorTest, RetriesShardThatThrew) {
+    auto job = makeRegularJob(100);
+    ShardedBatchOptions options;
+    options.worker_count = 2;
+    options.shard_size = 10;
+    options.shard_hook = [](size_t shard, int attempt) {
+        if (shard == 4 && attempt == 0) throw std::runtime_error("injected");
+    };
+
+    std::vector<double> results;
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::run(job, options, results, error)) << error;
+    EXPECT_EQ(results[45], BlackScholesUtil::calculateStandardCall(job.stock_prices[45], job.strike_prices[45],
+                                                                   job.time_to_maturities[45], job.volatilities[45],
+                                                                   job.risk_free_rates[45]));
+}
+
+TEST_F(ShardedBatchExecutorTest, FailsAfterRetriesExhausted) {
+    auto job = makeRegularJob(40);
+    ShardedBatchOptions options;
+    options.worker_count = 2;
+    options.shard_size = 10;
+    options.max_shard_retries = 1;
+    options.shard_hook = [](size_t shard, int) {
+        if (shard == 1) _exit(3);
+    };
+
+    std::vector<double> results;
+    std::string error;
+    EXPECT_FALSE(ShardedBatchExecutor::run(job, options, results, error));
+    EXPECT_NE(error.find("Shard 1"), std::string::npos);
+}
+
+// Each shard is priced exactly once even when workers die and shards are retried
+TEST_F(ShardedBatchExecutorTest, RunShardsCompletesEveryShardOnce) {
+    const size_t shard_count = 23;
+    void* shared = mmap(nullptr, shard_count * sizeof(std::atomic<int>), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(shared, MAP_FAILED);
+    auto* completions = static_cast<std::atomic<int>*>(shared);
+    for (size_t i = 0; i < shard_count; ++i) new (&completions[i]) std::atomic<int>(0);
+
+    ShardedBatchOptions options;
+    options.worker_count = 3;
+    options.shard_hook = [](size_t shard, int attempt) {
+        if (shard % 5 == 0 && attempt == 0) _exit(3);
+    };
+
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::runShards(shard_count, options, [&](size_t shard) {
+        completions[shard].fetch_add(1);
+    }, error)) << error;
+    for (size_t i = 0; i < shard_count; ++i) EXPECT_EQ(completions[i].load(), 1) << "shard " << i;
+    munmap(shared, shard_count * sizeof(std::atomic<int>));
+}
+
+// The executor reaps only its own workers; a child forked elsewhere keeps its exit status
+TEST_F(ShardedBatchExecutorTest, LeavesOtherChildrenAlone) {
+    pid_t other = fork();
+    ASSERT_GE(other, 0);
+    if (other == 0) _exit(7);
+
+    auto job = makeRegularJob(100);
+    ShardedBatchOptions options;
+    options.worker_count = 2;
+    options.shard_size = 10;
+    std::vector<double> results;
+    std::string error;
+    ASSERT_TRUE(ShardedBatchExecutor::run(job, options, results, error)) << error;
+
+    int status = 0;
+    ASSERT_EQ(waitpid(other, &status, 0), other);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 7);
+}
+
+TEST_F(ShardedBatchExecutorTest, RejectsMismatchedColumns) {
+    auto job = makeRegularJob(5);
+    job.time_to_maturities.pop_back();
+
+    std::vector<double> results;
+    std::string error;
+    EXPECT_FALSE(ShardedBatchExecutor::run(job, ShardedBatchOptions{}, results, error));
+    EXPECT_EQ(error, "Batch column time_to_maturity must match the batch length");
+}
+
+TEST_F(ShardedBatchExecutorTest, EmptyJobSucceeds) {
+    BatchPricingJob job;
+    std::vector<double> results;
+    std::string error;
+    EXPECT_TRUE(ShardedBatchExecutor::run(job, ShardedBatchOptions{}, results, error));
+    EXPECT_TRUE(results.empty());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "services/WarmupService.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/MappedStore.h"
+
+class WarmupServiceTest : public ::testing::Test {};
+
+TEST_F(WarmupServiceTest, ReadyOnlyAfterAllThreadsWarmed) {
+    WarmupService::begin(3);
+    EXPECT_FALSE(WarmupService::isReady());
+
+    WarmupService::threadWarmed();
+    WarmupService::threadWarmed();
+    EXPECT_FALSE(WarmupService::isReady());
+    EXPECT_EQ(WarmupService::warmedThreads(), 2u);
+
+    WarmupService::threadWarmed();
+    EXPECT_TRUE(WarmupService::isReady());
+    EXPECT_EQ(WarmupService::totalThreads(), 3u);
+}
+
+TEST_F(WarmupServiceTest, NoThreadsIsImmediatelyReady) {
+    WarmupService::begin(0);
+    EXPECT_TRUE(WarmupService::isReady());
+}
+
+TEST_F(WarmupServiceTest, WarmupPrebuildsConfiguredTables) {
+    char tmpl[] = "/tmp/warmup_storeXXXXXX";
+    int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(tmpl, 64, 16 + 2 * sizeof(double) * 128, "test", error)) << error;
+    BlackScholesUtil::setGLTableStore(&store);
+
+    WarmupConfig config;
+    config.iterations = 2;
+    config.table_alphas = {2.0, 4.0, 9.0};
+    WarmupService::warmCurrentThread(config);
+
+    // One table for the cv = 0.25 pricing path plus one per configured alpha
+    EXPECT_EQ(store.countEntries(), 4u);
+
+    BlackScholesUtil::setGLTableStore(nullptr);
+    store.close();
+    std::remove(tmpl);
+}
+
+// Each thread holds one table, so without a store prebuilding would only churn it
+TEST_F(WarmupServiceTest, SkipsPrebuildWithoutStore) {
+    WarmupConfig config;
+    config.iterations = 1;
+    config.table_alphas = {};
+    WarmupService::warmCurrentThread(config);
+    const uint64_t builds = BlackScholesUtil::glTableBuilds();
+
+    config.table_alphas = {3.0, 5.0, 7.0};
+    WarmupService::warmCurrentThread(config);
+    EXPECT_EQ(BlackScholesUtil::glTableBuilds(), builds);
+}
+
+TEST_F(WarmupServiceTest, ConfigFromEnvironment) {
+    setenv("BSS_WARMUP", "0", 1);
+    setenv("BSS_WARMUP_ITERATIONS", "5", 1);
+    setenv("BSS_WARMUP_TABLE_ALPHAS", "1,2.5", 1);
+    WarmupConfig config = WarmupConfig::fromEnvironment();
+    EXPECT_FALSE(config.enabled);
+    EXPECT_EQ(config.iterations, 5);
+    ASSERT_EQ(config.table_alphas.size(), 2u);
+    EXPECT_EQ(config.table_alphas[1], 2.5);
+    unsetenv("BSS_WARMUP");
+    unsetenv("BSS_WARMUP_ITERATIONS");
+    unsetenv("BSS_WARMUP_TABLE_ALPHAS");
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "BatchFile.h"
+
+namespace {
+
+BatchRow parseRow(const CsvBatchFormat& csv, const std::string& line) {
+    BatchRow row;
+    std::string error;
+    EXPECT_TRUE(csv.parseLine(line.data(), line.data() + line.size(), row, error)) << error;
+    return row;
+}
+
+} // namespace
+
+TEST(BatchFileTest, CsvHeaderMapsColumnsAndIgnoresOthers) {
+    const std::string text = "trade_id,type,stock_price,strike_price,volatility,risk_free_rate,time_to_maturity\n"
+                             "t1,binary,100,105,0.2,0.05,1\n";
+    CsvBatchFormat csv;
+    std::string error;
+    ASSERT_TRUE(csv.parseHeader(text.data(), text.size(), std::nullopt, error)) << error;
+    EXPECT_EQ(csv.bodyOffset(), text.find('\n') + 1);
+
+    BatchRow row = parseRow(csv, "t1,binary,100,105,0.2,0.05,1");
+    EXPECT_EQ(row.type, dto::OptionType::BINARY);
+    EXPECT_DOUBLE_EQ(row[BatchColumn::STOCK_PRICE], 100.0);
+    EXPECT_DOUBLE_EQ(row[BatchColumn::STRIKE_PRICE], 105.0);
+    EXPECT_DOUBLE_EQ(row[BatchColumn::TIME_TO_MATURITY], 1.0);
+    EXPECT_TRUE(std::isnan(row[BatchColumn::HOLDING_PERIOD]));
+    EXPECT_TRUE(validateBatchRow(row, error)) << error;
+}
+
+TEST(BatchFileTest, CsvWithoutTypeColumnNeedsADefault) {
+    const std::string text = "stock_price,strike_price,volatility,risk_free_rate,holding_period\n";
+    CsvBatchFormat csv;
+    std::string error;
+    EXPECT_FALSE(csv.parseHeader(text.data(), text.size(), std::nullopt, error));
+
+    ASSERT_TRUE(csv.parseHeader(text.data(), text.size(), dto::OptionType::RANDOM_EXPIRATION_CALL, error));
+    BatchRow row = parseRow(csv, " 100 , 95,0.3,0.01,2");
+    EXPECT_EQ(row.type, dto::OptionType::RANDOM_EXPIRATION_CALL);
+    ASSERT_TRUE(validateBatchRow(row, error)) << error;
+    // As in the API, the dispersion defaults to the holding period
+    EXPECT_DOUBLE_EQ(row[BatchColumn::VOLATILITY_AROUND_HOLDING_PERIOD], 2.0);
+}
+
+TEST(BatchFileTest, CsvRejectsMalformedRows) {
+    const std::string text = "type,stock_price,strike_price\n";
+    CsvBatchFormat csv;
+    std::string error;
+    ASSERT_TRUE(csv.parseHeader(text.data(), text.size(), std::nullopt, error));
+
+    BatchRow row;
+    for (const std::string line : {"regular,100", "regular,100,95,7", "regular,abc,95", "regular,1e5x,95", "bond,100,95"}) {
+        error.clear();
+        EXPECT_FALSE(csv.parseLine(line.data(), line.data() + line.size(), row, error)) << line;
+        EXPECT_FALSE(error.empty()) << line;
+    }
+    EXPECT_FALSE(csv.parseHeader("type,type\n", 10, std::nullopt, error));
+}
+
+TEST(BatchFileTest, ValidationFollowsTheApi) {
+    const std::string text = "type,stock_price,strike_price,volatility,risk_free_rate,time_to_maturity\n";
+    CsvBatchFormat csv;
+    std::string error;
+    ASSERT_TRUE(csv.parseHeader(text.data(), text.size(), std::nullopt, error));
+
+    BatchRow row = parseRow(csv, "regular,-100,95,0.2,0.05,1");
+    EXPECT_FALSE(validateBatchRow(row, error));
+    EXPECT_EQ(error, "Field stock_price must be positive");
+
+    row = parseRow(csv, "regular,100,95,0.2,,1");
+    EXPECT_FALSE(validateBatchRow(row, error));
+    EXPECT_EQ(error, "Missing required field: risk_free_rate");
+
+    row = parseRow(csv, "randomExpirationCall,100,95,0.2,0.05,1");
+    EXPECT_FALSE(validateBatchRow(row, error));
+    EXPECT_EQ(error, "Missing required field: holding_period");
+
+    row = parseRow(csv, "regular,100,95,0.2,-0.01,1");
+    EXPECT_TRUE(validateBatchRow(row, error)) << error;
+}
+
+TEST(BatchFileTest, ChunksEndOnLineBoundariesAndCountEveryRow) {
+    std::string text = "type,stock_price\n";
+    for (int i = 0; i < 1000; ++i) {
+        text += "regular," + std::to_string(100 + i) + "\n";
+        if (i % 7 == 0) text += "\r\n";   // blank lines are not rows
+    }
+    text += "regular,1";                    // no trailing newline
+    CsvBatchFormat csv;
+    std::string error;
+    ASSERT_TRUE(csv.parseHeader(text.data(), text.size(), std::nullopt, error));
+
+    for (size_t chunk_bytes : {1, 100, 4096, 1 << 20}) {
+        const auto chunks = csv.chunks(text.data(), text.size(), chunk_bytes);
+        ASSERT_FALSE(chunks.empty());
+        EXPECT_EQ(chunks.front().first, csv.bodyOffset());
+        EXPECT_EQ(chunks.back().second, text.size());
+        size_t rows = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (i > 0) {
+                EXPECT_EQ(chunks[i].first, chunks[i - 1].second);
+            }
+            if (chunks[i].second < text.size()) {
+                EXPECT_EQ(text[chunks[i].second - 1], '\n');
+            }
+            rows += CsvBatchFormat::countRows(text.data() + chunks[i].first, text.data() + chunks[i].second);
+        }
+        EXPECT_EQ(rows, 1001u) << chunk_bytes;
+    }
+}
+
+TEST(BatchFileTest, BinaryRoundTripsRowsAndTypes) {
+    std::vector<BatchRow> rows(3);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (double& v : rows[i].values) v = std::nan("");
+        rows[i][BatchColumn::STOCK_PRICE] = 100.0 + i;
+        rows[i][BatchColumn::STRIKE_PRICE] = 95.0;
+        rows[i][BatchColumn::HOLDING_PERIOD] = 1.5;
+    }
+    rows[1].type = dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL;
+    const uint32_t mask = (1u << static_cast<int>(BatchColumn::STOCK_PRICE)) |
+                          (1u << static_cast<int>(BatchColumn::STRIKE_PRICE)) |
+                          (1u << static_cast<int>(BatchColumn::HOLDING_PERIOD)) | kTypeColumnBit;
+    std::vector<char> file(BinaryBatchFormat::fileSize(rows.size(), mask));
+    BinaryBatchFormat::write(file.data(), rows, mask, dto::OptionType::REGULAR);
+
+    BinaryBatchFormat binary;
+    std::string error;
+    ASSERT_TRUE(binary.open(file.data(), file.size(), error)) << error;
+    ASSERT_EQ(binary.rows(), 3u);
+    BatchRow row;
+    binary.row(1, row);
+    EXPECT_EQ(row.type, dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL);
+    EXPECT_DOUBLE_EQ(row[BatchColumn::STOCK_PRICE], 101.0);
+    EXPECT_DOUBLE_EQ(row[BatchColumn::HOLDING_PERIOD], 1.5);
+    EXPECT_TRUE(std::isnan(row[BatchColumn::VOLATILITY]));
+    binary.row(2, row);
+    EXPECT_EQ(row.type, dto::OptionType::REGULAR);
+
+    EXPECT_FALSE(binary.open(file.data(), file.size() - 1, error));
+    file[0] = 'X';
+    EXPECT_FALSE(binary.open(file.data(), file.size(), error));
+}
+
+TEST(BatchFileTest, WriterPlacesRowsInAnyOrder) {
+    std::vector<BatchRow> rows(5);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (double& v : rows[i].values) v = std::nan("");
+        rows[i][BatchColumn::STOCK_PRICE] = 100.0 + i;
+        rows[i][BatchColumn::VOLATILITY] = 0.1 * (i + 1);
+        rows[i].type = static_cast<dto::OptionType>(i % 4);
+    }
+    const uint32_t mask = (1u << static_cast<int>(BatchColumn::STOCK_PRICE)) |
+                          (1u << static_cast<int>(BatchColumn::VOLATILITY)) | kTypeColumnBit;
+    std::vector<char> expected(BinaryBatchFormat::fileSize(rows.size(), mask));
+    BinaryBatchFormat::write(expected.data(), rows, mask, dto::OptionType::BINARY);
+
+    std::vector<char> file(expected.size());
+    const BinaryBatchWriter writer(file.data(), rows.size(), mask, dto::OptionType::BINARY);
+    for (size_t i = rows.size(); i-- > 0;) writer.write(i, rows[i]);
+    EXPECT_EQ(file, expected);
+}
+
+TEST(BatchFileTest, TextPricesHaveFixedWidthAndRoundTrip) {
+    for (double price : {0.0, 10.450583572185565, -1.7976931348623157e308, 4.9e-324, 123456789.125}) {
+        char line[PriceOutput::kTextWidth];
+        PriceOutput::formatText(price, line);
+        EXPECT_EQ(line[PriceOutput::kTextWidth - 1], '\n');
+        EXPECT_EQ(std::strtod(std::string(line, PriceOutput::kTextWidth).c_str(), nullptr), price);
+    }
+    char line[PriceOutput::kTextWidth];
+    PriceOutput::formatText(std::nan(""), line);
+    EXPECT_TRUE(std::isnan(std::strtod(std::string(line, PriceOutput::kTextWidth).c_str(), nullptr)));
+    EXPECT_EQ(PriceOutput::textSize(2), 6u + 2 * PriceOutput::kTextWidth);
+}
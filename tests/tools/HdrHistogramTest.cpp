@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include "HdrHistogram.h"
+
+TEST(HdrHistogramTest, EmptyHistogramReportsZero) {
+    HdrHistogram histogram(1, 1000000, 3);
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.valueAtPercentile(99.0), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+}
+
+TEST(HdrHistogramTest, SmallValuesAreExact) {
+    HdrHistogram histogram(1, 1000000, 3);
+    for (uint64_t v = 1; v <= 1000; ++v) histogram.record(v);
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 500u);
+    EXPECT_EQ(histogram.valueAtPercentile(99.0), 990u);
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), 1000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 500.5);
+}
+
+// Every value is reported within the requested significant digits
+TEST(HdrHistogramTest, LargeValuesKeepThreeSignificantDigits) {
+    for (uint64_t value : {12345ull, 987654ull, 55555555ull, 3000000000ull}) {
+        HdrHistogram histogram(1, 60000000000ull, 3);
+        histogram.record(value);
+        histogram.record(value + 1);
+        const double reported = static_cast<double>(histogram.valueAtPercentile(50.0));
+        EXPECT_LE(std::abs(reported - value) / value, 1e-3) << value;
+        EXPECT_LE(histogram.min(), value);
+    }
+}
+
+TEST(HdrHistogramTest, PercentilesOfAMixedDistribution) {
+    HdrHistogram histogram(1, 60000000000ull, 3);
+    for (int i = 0; i < 9900; ++i) histogram.record(100000);     // 100 us
+    for (int i = 0; i < 100; ++i) histogram.record(50000000);    // 50 ms
+    EXPECT_NEAR(histogram.valueAtPercentile(50.0), 100000, 100);
+    EXPECT_NEAR(histogram.valueAtPercentile(99.0), 100000, 100);
+    EXPECT_NEAR(histogram.valueAtPercentile(99.5), 50000000, 50000);
+    EXPECT_EQ(histogram.max(), 50000000u);
+}
+
+// The lowest value is the unit of resolution
+TEST(HdrHistogramTest, LowestValueSetsResolution) {
+    HdrHistogram histogram(1000, 60000000000ull, 3);
+    histogram.record(2000);
+    histogram.record(2100);
+    // Both land in [1536, 2048): 512 ns buckets at the bottom of the range
+    EXPECT_EQ(histogram.min(), 1536u);
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 2047u);
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), 2100u);  // capped at the recorded maximum
+}
+
+TEST(HdrHistogramTest, ClampsAboveHighest) {
+    HdrHistogram histogram(1, 1000, 2);
+    histogram.record(5000);
+    EXPECT_EQ(histogram.max(), 1000u);
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), 1000u);
+}
+
+TEST(HdrHistogramTest, AddMergesCounts) {
+    HdrHistogram a(1, 60000000000ull, 3), b(1, 60000000000ull, 3);
+    for (int i = 0; i < 10; ++i) a.record(2000);
+    for (int i = 0; i < 30; ++i) b.record(8000);
+    a.add(b);
+    EXPECT_EQ(a.count(), 40u);
+    EXPECT_NEAR(a.valueAtPercentile(25.0), 2000, 2);
+    EXPECT_NEAR(a.valueAtPercentile(26.0), 8000, 8);
+    EXPECT_EQ(a.max(), 8000u);
+
+    HdrHistogram other(1000, 1000000, 2);
+    EXPECT_THROW(a.add(other), std::invalid_argument);
+}
+
+TEST(HdrHistogramTest, RejectsInvalidLayout) {
+    EXPECT_THROW(HdrHistogram(0, 1000, 3), std::invalid_argument);
+    EXPECT_THROW(HdrHistogram(1, 1000, 6), std::invalid_argument);
+}
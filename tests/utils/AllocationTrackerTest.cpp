@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/AllocationTracker.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/PhaseTimer.h"
+
+using BlackScholesUtil::PricingEngine;
+
+class AllocationTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override { AllocationTracker::setEnabled(true); }
+    void TearDown() override { AllocationTracker::setEnabled(false); }
+
+    static AllocationCounts now() { return *AllocationTracker::threadCounts(); }
+};
+
+// Keeps the compiler from eliding a new/delete pair
+void* volatile escape;
+
+TEST_F(AllocationTrackerTest, CountsAllocationsAndBytes) {
+    const AllocationCounts before = now();
+    auto* value = new int64_t(7);
+    escape = value;
+    delete value;
+    std::vector<double> values(100);
+    escape = values.data();
+    const AllocationCounts delta = now() - before;
+    EXPECT_EQ(delta.allocations, 2u);
+    EXPECT_EQ(delta.bytes, sizeof(int64_t) + 100 * sizeof(double));
+    EXPECT_EQ(delta.frees, 1u);
+}
+
+TEST_F(AllocationTrackerTest, CountsAlignedAllocations) {
+    struct alignas(128) Block { char data[256]; };
+    const AllocationCounts before = now();
+    auto block = std::make_unique<Block>();
+    escape = block.get();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block.get()) % 128, 0u);
+    block.reset();
+    const AllocationCounts delta = now() - before;
+    EXPECT_EQ(delta.allocations, 1u);
+    EXPECT_EQ(delta.bytes, sizeof(Block));
+    EXPECT_EQ(delta.frees, 1u);
+}
+
+TEST_F(AllocationTrackerTest, CountsSizedFrees) {
+    struct alignas(128) Block { char data[256]; };
+    const AllocationCounts before = now();
+    void* plain = ::operator new(48);
+    escape = plain;
+    ::operator delete(plain, 48);
+    void* aligned = ::operator new(sizeof(Block), std::align_val_t(alignof(Block)));
+    escape = aligned;
+    ::operator delete(aligned, sizeof(Block), std::align_val_t(alignof(Block)));
+    const AllocationCounts delta = now() - before;
+    EXPECT_EQ(delta.allocations, 2u);
+    EXPECT_EQ(delta.frees, 2u);
+}
+
+TEST_F(AllocationTrackerTest, DisabledTrackingCountsNothing) {
+    AllocationTracker::setEnabled(false);
+    const AllocationCounts before = now();
+    std::string text(200, 'x');
+    escape = &text[0];
+    const AllocationCounts delta = now() - before;
+    EXPECT_EQ(delta.allocations, 0u);
+    EXPECT_EQ(delta.bytes, 0u);
+}
+
+// Counters are per thread
+TEST_F(AllocationTrackerTest, OtherThreadsAreNotCounted) {
+    const AllocationCounts before = now();
+    std::thread([] {
+        std::vector<int> values(1000);
+        escape = values.data();
+    }).join();
+    // Starting the thread allocates its state on this thread; the vector is not charged here
+    EXPECT_LT((now() - before).bytes, 1000 * sizeof(int));
+}
+
+TEST_F(AllocationTrackerTest, PhaseTimerChargesThePhaseThatAllocated) {
+    PhaseTimer timer;
+    std::string body(100, 'x');
+    escape = &body[0];
+    timer.mark(RequestPhase::BODY);
+    timer.mark(RequestPhase::PARSE);
+    std::vector<double> values(10);
+    escape = values.data();
+    timer.mark(RequestPhase::PRICE);
+
+    EXPECT_EQ(timer.allocations(RequestPhase::BODY).allocations, 1u);
+    EXPECT_EQ(timer.allocations(RequestPhase::BODY).bytes, 101u);
+    EXPECT_EQ(timer.allocations(RequestPhase::PARSE).allocations, 0u);
+    EXPECT_EQ(timer.allocations(RequestPhase::PRICE).bytes, 10 * sizeof(double));
+}
+
+TEST_F(AllocationTrackerTest, ScopeChargesEngine) {
+    const EngineAllocations before = AllocationTracker::engineTotals(PricingEngine::GSL_QAGIU);
+    AllocationScope scope;
+    std::vector<char> buffer(64);
+    escape = buffer.data();
+    scope.finish(PricingEngine::GSL_QAGIU);
+    const EngineAllocations after = AllocationTracker::engineTotals(PricingEngine::GSL_QAGIU);
+    EXPECT_EQ(after.invocations - before.invocations, 1u);
+    EXPECT_EQ(after.counts.allocations - before.counts.allocations, 1u);
+    EXPECT_EQ(after.counts.bytes - before.counts.bytes, 64u);
+}
+
+// The closed-form and quadrature kernels stay allocation-free once a thread has warmed up.
+// QAGIU is left out: its workspace is reused, but what happens inside GSL is not ours.
+TEST_F(AllocationTrackerTest, WarmKernelsDoNotAllocate) {
+    auto price = [] {
+        double sum = BlackScholesUtil::calculateStandardCall(100.0, 95.0, 0.5, 0.2, 0.05);
+        sum += BlackScholesUtil::calculateBinaryCall(100.0, 95.0, 0.5, 0.2, 0.05);
+        sum += BlackScholesUtil::calculateRandomExpirationCall(100.0, 95.0, 0.2, 0.05, 2.0, 0.5);
+        sum += BlackScholesUtil::calculateRandomExpirationBinaryCall(100.0, 95.0, 0.2, 0.05, 2.0, 0.5);
+        sum += BlackScholesUtil::calculateRandomExpirationCall(100.0, 95.0, 0.2, 0.05, 2.0, 0.001);
+        return sum;
+    };
+    price();
+    const AllocationCounts before = now();
+    const double second = price();
+    const AllocationCounts delta = now() - before;
+    EXPECT_GT(second, 0.0);
+    EXPECT_EQ(delta.allocations, 0u);
+}
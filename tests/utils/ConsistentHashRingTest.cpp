@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include "utils/ConsistentHashRing.h"
+
+class ConsistentHashRingTest : public ::testing::Test {
+protected:
+    ConsistentHashRing ring{128};
+
+    void SetUp() override {
+        ring.addNode("127.0.0.1:8081");
+        ring.addNode("127.0.0.1:8082");
+        ring.addNode("127.0.0.1:8083");
+    }
+};
+
+TEST_F(ConsistentHashRingTest, EmptyRingHasNoOwner) {
+    ConsistentHashRing empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.nodeFor(12345), "");
+}
+
+TEST_F(ConsistentHashRingTest, OwnershipIsDeterministic) {
+    ConsistentHashRing other{128};
+    other.addNode("127.0.0.1:8083");
+    other.addNode("127.0.0.1:8081");
+    other.addNode("127.0.0.1:8082");
+
+    // Insertion order must not change ownership, so every node computes the same owner
+    for (uint64_t k = 0; k < 1000; ++k) {
+        uint64_t h = ConsistentHashRing::hashString("key" + std::to_string(k));
+        EXPECT_EQ(ring.nodeFor(h), other.nodeFor(h));
+    }
+}
+
+TEST_F(ConsistentHashRingTest, KeysAreSpreadAcrossNodes) {
+    std::map<std::string, int> counts;
+    const int keys = 30000;
+    for (int k = 0; k < keys; ++k) {
+        counts[ring.nodeFor(ConsistentHashRing::hashString("key" + std::to_string(k)))]++;
+    }
+    ASSERT_EQ(counts.size(), 3u);
+    for (const auto& c : counts) {
+        EXPECT_GT(c.second, keys / 3 * 0.75) << c.first;
+        EXPECT_LT(c.second, keys / 3 * 1.25) << c.first;
+    }
+}
+
+TEST_F(ConsistentHashRingTest, RemovingNodeOnlyMovesItsKeys) {
+    std::map<uint64_t, std::string> before;
+    for (int k = 0; k < 5000; ++k) {
+        uint64_t h = ConsistentHashRing::hashString("key" + std::to_string(k));
+        before[h] = ring.nodeFor(h);
+    }
+
+    ring.removeNode("127.0.0.1:8082");
+    for (const auto& entry : before) {
+        if (entry.second != "127.0.0.1:8082") {
+            EXPECT_EQ(ring.nodeFor(entry.first), entry.second);
+        } else {
+            EXPECT_NE(ring.nodeFor(entry.first), "127.0.0.1:8082");
+        }
+    }
+}
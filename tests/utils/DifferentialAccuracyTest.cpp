@@ -0,0 +1,274 @@
+// Seeded, randomized differential tests of the fast pricing paths against their references:
+//
+//   ClosedFormFastPath   the erfc-based closed forms behind the analytic shortcut (reached
+//                        through priceRandomExpirationWithEngine) against the boost-based
+//                        calculateStandardCall and calculateBinaryCall
+//   Chain                calculateStandardCallChain, in each kernel variant, against
+//                        calculateStandardCall cell by cell
+//   KernelIsa            the AVX2 Gauss-Laguerre kernels against the scalar ones, same table
+//   RoutedEngines        every routed random expiration price (shortcut, Gauss-Laguerre or
+//                        QAGIU) against referenceRandomExpirationPrice
+//
+// Every comparison runs over each region below, including the edges: tiny and huge volatility,
+// deep in and out of the money, very short and long maturities, and huge and tiny gamma shapes.
+// The worst error of each comparison and region is printed with the inputs that produced it, at
+// full precision, and a failure reports the same. Errors are taken relative to the reference,
+// floored at 1, as elsewhere in the service.
+//
+// The draws are seeded, so a run is reproducible. BSS_DIFF_SEED changes the seed, and
+// BSS_DIFF_SCALE multiplies every draw count: the default is about 20 seconds of ctest, and
+// BSS_DIFF_SCALE=20 runs millions of draws, which is the run to make before changing compiler
+// flags or kernels.
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "ReferencePricer.h"
+#include "utils/BlackScholesUtil.h"
+
+namespace {
+
+using BlackScholesUtil::KernelIsa;
+using BlackScholesUtil::PricingDiagnostics;
+using BlackScholesUtil::PricingEngine;
+
+constexpr uint64_t kDefaultSeed = 20261018;
+
+struct Range {
+    double lo, hi;
+};
+
+// Moneyness is K / S and cv is sigmaH / H. The maturity range is T for the fixed-maturity
+// options and H for the random expiration ones.
+struct Region {
+    const char* name;
+    Range moneyness, volatility, rate, maturity, cv;
+};
+
+const Region kRegions[] = {
+    {"typical",        {0.7, 1.4},   {0.1, 0.6},   {-0.01, 0.08}, {0.05, 5.0},   {0.05, 1.0}},
+    {"tiny_vol",       {0.7, 1.4},   {1e-4, 1e-2}, {-0.01, 0.08}, {0.05, 5.0},   {0.05, 1.0}},
+    {"huge_vol",       {0.7, 1.4},   {1.0, 4.0},   {-0.01, 0.08}, {0.05, 5.0},   {0.05, 1.0}},
+    {"deep_itm",       {0.01, 0.3},  {0.1, 0.6},   {-0.01, 0.08}, {0.05, 5.0},   {0.05, 1.0}},
+    {"deep_otm",       {3.0, 100.0}, {0.1, 0.6},   {-0.01, 0.08}, {0.05, 5.0},   {0.05, 1.0}},
+    {"short_maturity", {0.7, 1.4},   {0.1, 0.6},   {-0.01, 0.08}, {1e-5, 1e-2},  {0.05, 1.0}},
+    {"long_maturity",  {0.7, 1.4},   {0.1, 0.6},   {-0.01, 0.08}, {20.0, 100.0}, {0.05, 1.0}},
+    {"huge_alpha",     {0.7, 1.4},   {0.1, 0.6},   {-0.01, 0.08}, {0.05, 5.0},   {1e-3, 0.05}},
+    {"tiny_alpha",     {0.7, 1.4},   {0.1, 0.6},   {-0.01, 0.08}, {0.05, 5.0},   {1.5, 5.0}},
+};
+
+// What the default routing promises in every region. The analytic shortcut's error is the
+// term it drops, below about 1e-4 at the default ratio. The thresholds only route to
+// Gauss-Laguerre the shapes and volatilities it holds to about 1e-5, and send the rest,
+// including the near-step prices of tiny volatility, to QAGIU.
+constexpr double kRoutedTolerance = 2e-4;
+
+struct Contract {
+    double S, K, vol, r, T, H, sigmaH;
+};
+
+uint64_t seed() {
+    const char* value = std::getenv("BSS_DIFF_SEED");
+    return value ? std::strtoull(value, nullptr, 10) : kDefaultSeed;
+}
+
+size_t draws(size_t base) {
+    const char* value = std::getenv("BSS_DIFF_SCALE");
+    const double scale = value ? std::atof(value) : 1.0;
+    return std::max<size_t>(1, static_cast<size_t>(base * std::max(scale, 0.0)));
+}
+
+// Positive ranges spanning more than a decade are drawn log-uniformly
+double draw(std::mt19937_64& rng, const Range& range) {
+    if (range.lo > 0 && range.hi / range.lo > 10.0) {
+        return std::exp(std::uniform_real_distribution<double>(std::log(range.lo), std::log(range.hi))(rng));
+    }
+    return std::uniform_real_distribution<double>(range.lo, range.hi)(rng);
+}
+
+// Each comparison and region gets its own stream, so changing one leaves the others' draws alone
+std::mt19937_64 stream(const std::string& comparison, const Region& region) {
+    std::seed_seq sequence{seed(), static_cast<uint64_t>(std::hash<std::string>{}(comparison)),
+                           static_cast<uint64_t>(std::hash<std::string>{}(region.name))};
+    return std::mt19937_64(sequence);
+}
+
+Contract drawContract(std::mt19937_64& rng, const Region& region) {
+    Contract c;
+    c.S = draw(rng, {1.0, 1000.0});
+    c.K = c.S * draw(rng, region.moneyness);
+    c.vol = draw(rng, region.volatility);
+    c.r = draw(rng, region.rate);
+    c.T = draw(rng, region.maturity);
+    c.H = c.T;
+    c.sigmaH = c.H * draw(rng, region.cv);
+    return c;
+}
+
+double scaledError(double value, double reference) {
+    if (std::isnan(value) && std::isnan(reference)) return 0.0;
+    if (!std::isfinite(value) || !std::isfinite(reference)) return std::numeric_limits<double>::infinity();
+    return std::abs(value - reference) / std::max(1.0, std::abs(reference));
+}
+
+// Worst error of one comparison over one region, with what is needed to reproduce it
+class WorstCase {
+public:
+    WorstCase(std::string comparison, const Region& region) : comparison_(std::move(comparison)), region_(region.name) {}
+
+    void add(size_t draw, const Contract& contract, double value, double reference, const char* detail = "") {
+        ++count_;
+        const double error = scaledError(value, reference);
+        if (error > error_ || count_ == 1) {
+            error_ = error;
+            draw_ = draw;
+            contract_ = contract;
+            value_ = value;
+            reference_ = reference;
+            detail_ = detail;
+        }
+    }
+
+    double error() const { return error_; }
+
+    std::string describe() const {
+        char text[512];
+        std::snprintf(text, sizeof(text),
+                      "%s/%s: %zu draws, max error %.3g at draw %zu (seed %llu)%s%s\n"
+                      "  S=%.17g K=%.17g vol=%.17g r=%.17g T=H=%.17g sigmaH=%.17g\n"
+                      "  value=%.17g reference=%.17g",
+                      comparison_.c_str(), region_.c_str(), count_, error_, draw_,
+                      static_cast<unsigned long long>(seed()), detail_.empty() ? "" : ", ", detail_.c_str(),
+                      contract_.S, contract_.K, contract_.vol, contract_.r, contract_.H, contract_.sigmaH,
+                      value_, reference_);
+        return text;
+    }
+
+private:
+    std::string comparison_, region_, detail_;
+    size_t count_ = 0, draw_ = 0;
+    double error_ = 0.0, value_ = 0.0, reference_ = 0.0;
+    Contract contract_{};
+};
+
+void report(const WorstCase& worst, double tolerance) {
+    std::cout << worst.describe() << std::endl;
+    EXPECT_LE(worst.error(), tolerance) << worst.describe();
+}
+
+} // namespace
+
+TEST(DifferentialAccuracyTest, ClosedFormFastPath) {
+    const size_t n = draws(20000);
+    for (bool binary : {false, true}) {
+        const std::string comparison = binary ? "closed_form/binary" : "closed_form/call";
+        for (const Region& region : kRegions) {
+            std::mt19937_64 rng = stream(comparison, region);
+            WorstCase worst(comparison, region);
+            for (size_t i = 0; i < n; ++i) {
+                const Contract c = drawContract(rng, region);
+                const double fast = BlackScholesUtil::priceRandomExpirationWithEngine(
+                    PricingEngine::CLOSED_FORM, binary, c.S, c.K, c.vol, c.r, c.T, c.sigmaH);
+                const double reference = binary ? BlackScholesUtil::calculateBinaryCall(c.S, c.K, c.T, c.vol, c.r)
+                                                : BlackScholesUtil::calculateStandardCall(c.S, c.K, c.T, c.vol, c.r);
+                worst.add(i, c, fast, reference);
+            }
+            report(worst, 1e-12);
+        }
+    }
+}
+
+TEST(DifferentialAccuracyTest, Chain) {
+    // Chains share the underlying and rate; strikes and maturities vary per draw like contracts
+    const size_t chains = draws(16);
+    constexpr size_t kStrikes = 37, kMaturities = 8;
+    const KernelIsa original = BlackScholesUtil::kernelIsa();
+    for (KernelIsa isa : {KernelIsa::SCALAR, KernelIsa::AVX2}) {
+        if (!BlackScholesUtil::setKernelIsa(isa)) continue;
+        const std::string comparison = std::string("chain/") + BlackScholesUtil::kernelIsaName(isa);
+        for (const Region& region : kRegions) {
+            std::mt19937_64 rng = stream(comparison, region);
+            WorstCase worst(comparison, region);
+            for (size_t chain = 0; chain < chains; ++chain) {
+                const Contract base = drawContract(rng, region);
+                std::vector<double> strikes(kStrikes), maturities(kMaturities), vols(kStrikes * kMaturities);
+                for (double& K : strikes) K = base.S * draw(rng, region.moneyness);
+                for (double& T : maturities) T = draw(rng, region.maturity);
+                for (double& vol : vols) vol = draw(rng, region.volatility);
+                const std::vector<double> prices =
+                    BlackScholesUtil::calculateStandardCallChain(base.S, base.r, strikes, maturities, vols);
+                for (size_t cell = 0; cell < prices.size(); ++cell) {
+                    Contract c = base;
+                    c.K = strikes[cell % kStrikes];
+                    c.T = c.H = maturities[cell / kStrikes];
+                    c.vol = vols[cell];
+                    c.sigmaH = 0.0;
+                    worst.add(chain * prices.size() + cell, c, prices[cell],
+                              BlackScholesUtil::calculateStandardCall(c.S, c.K, c.T, c.vol, c.r));
+                }
+            }
+            report(worst, 1e-12);
+        }
+    }
+    BlackScholesUtil::setKernelIsa(original);
+}
+
+TEST(DifferentialAccuracyTest, KernelIsa) {
+    if (!BlackScholesUtil::kernelIsaSupported(KernelIsa::AVX2)) {
+        GTEST_SKIP() << "AVX2 kernels are not available on this build or CPU";
+    }
+    const KernelIsa original = BlackScholesUtil::kernelIsa();
+    // Contracts come in groups sharing a gamma shape, so both kernels read one node table
+    const size_t shapes = draws(2);
+    constexpr size_t kContractsPerShape = 128;
+    for (bool binary : {false, true}) {
+        const std::string comparison = binary ? "kernel_isa/binary" : "kernel_isa/call";
+        for (const Region& region : kRegions) {
+            std::mt19937_64 rng = stream(comparison, region);
+            WorstCase worst(comparison, region);
+            for (size_t shape = 0; shape < shapes; ++shape) {
+                const double cv = draw(rng, region.cv);
+                for (size_t j = 0; j < kContractsPerShape; ++j) {
+                    Contract c = drawContract(rng, region);
+                    c.sigmaH = cv * c.H;
+                    BlackScholesUtil::setKernelIsa(KernelIsa::SCALAR);
+                    const double scalar = BlackScholesUtil::priceRandomExpirationWithEngine(
+                        PricingEngine::GAUSS_LAGUERRE, binary, c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+                    BlackScholesUtil::setKernelIsa(KernelIsa::AVX2);
+                    const double avx2 = BlackScholesUtil::priceRandomExpirationWithEngine(
+                        PricingEngine::GAUSS_LAGUERRE, binary, c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+                    worst.add(shape * kContractsPerShape + j, c, avx2, scalar);
+                }
+            }
+            report(worst, 1e-12);
+        }
+    }
+    BlackScholesUtil::setKernelIsa(original);
+}
+
+TEST(DifferentialAccuracyTest, RoutedEngines) {
+    const size_t n = draws(40);
+    for (bool binary : {false, true}) {
+        const std::string comparison = binary ? "routed/binary" : "routed/call";
+        for (const Region& region : kRegions) {
+            std::mt19937_64 rng = stream(comparison, region);
+            WorstCase worst(comparison, region);
+            for (size_t i = 0; i < n; ++i) {
+                const Contract c = drawContract(rng, region);
+                PricingDiagnostics diagnostics;
+                const double routed =
+                    binary ? BlackScholesUtil::calculateRandomExpirationBinaryCall(c.S, c.K, c.vol, c.r, c.H, c.sigmaH, &diagnostics)
+                           : BlackScholesUtil::calculateRandomExpirationCall(c.S, c.K, c.vol, c.r, c.H, c.sigmaH, &diagnostics);
+                const double reference = referenceRandomExpirationPrice(binary, c.S, c.K, c.vol, c.r, c.H, c.sigmaH);
+                worst.add(i, c, routed, reference, BlackScholesUtil::engineName(diagnostics.engine));
+            }
+            report(worst, kRoutedTolerance);
+        }
+    }
+}
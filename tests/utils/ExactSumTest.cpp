@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+#include "utils/ExactSum.h"
+
+namespace {
+
+uint64_t bitsOf(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+double sumOf(std::initializer_list<double> values) {
+    ExactSum sum;
+    for (double x : values) sum.add(x);
+    return sum.value();
+}
+
+// Prices and Greeks of a book: mixed signs and magnitudes, with heavy cancellation
+std::vector<double> book(size_t n) {
+    std::mt19937_64 rng(20261018);
+    std::uniform_real_distribution<double> magnitude(-12.0, 12.0);
+    std::vector<double> values(n);
+    for (double& x : values) x = (rng() & 1 ? 1.0 : -1.0) * std::pow(10.0, magnitude(rng));
+    return values;
+}
+
+} // namespace
+
+TEST(ExactSumTest, RoundsTheExactSumOnce) {
+    EXPECT_EQ(sumOf({}), 0.0);
+    EXPECT_EQ(sumOf({1e100, 1.0, -1e100}), 1.0);
+    EXPECT_EQ(sumOf({0.1, 0.2}), 0.30000000000000004);
+    EXPECT_EQ(sumOf({-2.5, 1.0}), -1.5);
+
+    // Ten times 0.1 is 1 + 5.55e-17 exactly, which rounds to 1; adding in order gives 1 - 2^-53
+    ExactSum tenths;
+    double naive = 0.0;
+    for (int i = 0; i < 10; ++i) {
+        tenths.add(0.1);
+        naive += 0.1;
+    }
+    EXPECT_EQ(tenths.value(), 1.0);
+    EXPECT_NE(naive, 1.0);
+
+    // Ties go to even unless anything lies below the halfway bit
+    const double half_ulp = std::ldexp(1.0, -53);
+    EXPECT_EQ(sumOf({1.0, half_ulp}), 1.0);
+    EXPECT_EQ(sumOf({1.0, half_ulp, std::ldexp(1.0, -200)}), std::nextafter(1.0, 2.0));
+    EXPECT_EQ(sumOf({std::nextafter(1.0, 2.0), half_ulp}), std::nextafter(std::nextafter(1.0, 2.0), 2.0));
+}
+
+TEST(ExactSumTest, EdgesOfTheDoubleRange) {
+    const double denormal = std::numeric_limits<double>::denorm_min();
+    EXPECT_EQ(sumOf({denormal, denormal}), 2 * denormal);
+    EXPECT_EQ(sumOf({DBL_MIN, -denormal}), DBL_MIN - denormal);
+    EXPECT_EQ(sumOf({DBL_MAX, DBL_MAX, -DBL_MAX}), DBL_MAX);
+    EXPECT_EQ(sumOf({DBL_MAX, DBL_MAX}), std::numeric_limits<double>::infinity());
+    EXPECT_EQ(sumOf({-DBL_MAX, -DBL_MAX}), -std::numeric_limits<double>::infinity());
+    EXPECT_EQ(sumOf({DBL_MAX, denormal}), DBL_MAX);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    EXPECT_EQ(sumOf({1.0, inf}), inf);
+    EXPECT_EQ(sumOf({1.0, -inf}), -inf);
+    EXPECT_TRUE(std::isnan(sumOf({inf, -inf})));
+    EXPECT_TRUE(std::isnan(sumOf({1.0, std::numeric_limits<double>::quiet_NaN()})));
+    EXPECT_EQ(bitsOf(sumOf({-0.0})), bitsOf(0.0));
+}
+
+TEST(ExactSumTest, IndependentOfOrderAndSplit) {
+    std::vector<double> values = book(100000);
+    ExactSum serial;
+    serial.add(values.data(), values.size());
+    const double expected = serial.value();
+    EXPECT_EQ(serial.count(), values.size());
+
+    std::mt19937_64 rng(7);
+    for (int round = 0; round < 4; ++round) {
+        std::shuffle(values.begin(), values.end(), rng);
+        const size_t chunk = 1 + rng() % 5000;
+        ExactSum total;
+        for (size_t begin = 0; begin < values.size(); begin += chunk) {
+            ExactSum part;
+            part.add(values.data() + begin, std::min(chunk, values.size() - begin));
+            total.merge(part);
+        }
+        EXPECT_EQ(bitsOf(total.value()), bitsOf(expected)) << "chunk " << chunk;
+        EXPECT_EQ(total.count(), values.size());
+    }
+}
+
+TEST(ExactSumTest, BitwiseIdenticalAcrossThreadCounts) {
+    const std::vector<double> values = book(1 << 18);
+    ExactSum serial;
+    serial.add(values.data(), values.size());
+    const uint64_t expected = bitsOf(serial.value());
+
+    for (size_t threads : {1u, 2u, 3u, 8u}) {
+        std::vector<ExactSum> parts(threads);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (size_t i = t; i < values.size(); i += threads) parts[t].add(values[i]);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        ExactSum total;
+        for (size_t t = threads; t-- > 0;) total.merge(parts[t]);
+        EXPECT_EQ(bitsOf(total.value()), expected) << threads << " threads";
+    }
+}
+
+TEST(ExactSumTest, ManyAddsCarryCorrectly) {
+    // Enough same-signed adds to overflow a digit without carries in between
+    ExactSum sum;
+    const double x = std::ldexp(1.0, 31) - 1.0;
+    const uint64_t n = 3000000;
+    for (uint64_t i = 0; i < n; ++i) sum.add(x);
+    EXPECT_EQ(sum.value(), x * static_cast<double>(n));
+
+    ExactSum other;
+    for (uint64_t i = 0; i < n; ++i) other.add(-x);
+    sum.merge(other);
+    EXPECT_EQ(sum.value(), 0.0);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include "utils/MappedStore.h"
+
+class MappedStoreTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        char tmpl[] = "/tmp/mapped_store_testXXXXXX";
+        int fd = mkstemp(tmpl);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        path = tmpl;
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    struct Key {
+        int32_t id;
+        int32_t reserved;
+    };
+};
+
+TEST_F(MappedStoreTest, InsertAndLookup) {
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(path, 64, 32, "v1", error)) << error;
+
+    Key key{7, 0};
+    double value = 42.5;
+    EXPECT_TRUE(store.insert(1234, &key, sizeof(key), &value, sizeof(value)));
+
+    double out = 0.0;
+    size_t size = 0;
+    ASSERT_TRUE(store.lookup(1234, &key, sizeof(key), &out, sizeof(out), &size));
+    EXPECT_EQ(out, 42.5);
+    EXPECT_EQ(size, sizeof(double));
+
+    Key other{8, 0};
+    EXPECT_FALSE(store.lookup(1234, &other, sizeof(other), &out, sizeof(out)));
+}
+
+TEST_F(MappedStoreTest, SurvivesReopen) {
+    Key key{1, 0};
+    double value = 3.25;
+    {
+        MappedStore store;
+        std::string error;
+        ASSERT_TRUE(store.open(path, 64, 32, "v1", error)) << error;
+        ASSERT_TRUE(store.insert(99, &key, sizeof(key), &value, sizeof(value)));
+    }
+
+    MappedStore reopened;
+    std::string error;
+    ASSERT_TRUE(reopened.open(path, 64, 32, "v1", error)) << error;
+    double out = 0.0;
+    ASSERT_TRUE(reopened.lookup(99, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_EQ(out, 3.25);
+    EXPECT_EQ(reopened.countEntries(), 1u);
+}
+
+TEST_F(MappedStoreTest, VersionMismatchWipesStore) {
+    Key key{1, 0};
+    double value = 3.25;
+    {
+        MappedStore store;
+        std::string error;
+        ASSERT_TRUE(store.open(path, 64, 32, "engine-1", error)) << error;
+        ASSERT_TRUE(store.insert(99, &key, sizeof(key), &value, sizeof(value)));
+    }
+
+    MappedStore reopened;
+    std::string error;
+    ASSERT_TRUE(reopened.open(path, 64, 32, "engine-2", error)) << error;
+    double out = 0.0;
+    EXPECT_FALSE(reopened.lookup(99, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_EQ(reopened.countEntries(), 0u);
+}
+
+// A writer that read the epoch before a clear leaves a dead entry, not a revived one
+TEST_F(MappedStoreTest, ClearDropsEntriesOfEarlierEpochs) {
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(path, 64, 32, "v1", error)) << error;
+
+    Key key{1, 0};
+    double value = 3.25;
+    const uint32_t epoch = store.epoch();
+    ASSERT_TRUE(store.insert(99, &key, sizeof(key), &value, sizeof(value)));
+    store.reset("v2");
+    EXPECT_NE(store.epoch(), epoch);
+    EXPECT_EQ(store.countEntries(), 0u);
+
+    ASSERT_TRUE(store.insert(99, &key, sizeof(key), &value, sizeof(value), epoch));
+    double out = 0.0;
+    EXPECT_FALSE(store.lookup(99, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_EQ(store.countEntries(), 0u);
+
+    value = 4.5;
+    ASSERT_TRUE(store.insert(99, &key, sizeof(key), &value, sizeof(value)));
+    store.close();
+
+    // reset re-tagged the file, so it reopens warm under the new version
+    MappedStore reopened;
+    ASSERT_TRUE(reopened.open(path, 64, 32, "v2", error)) << error;
+    ASSERT_TRUE(reopened.lookup(99, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_EQ(out, 4.5);
+    EXPECT_EQ(reopened.countEntries(), 1u);
+}
+
+// Another process may still map the old file; replacing it must not pull pages from under it
+TEST_F(MappedStoreTest, MismatchReplacesTheFileInsteadOfTruncatingIt) {
+    MappedStore old_store;
+    std::string error;
+    ASSERT_TRUE(old_store.open(path, 64, 32, "engine-1", error)) << error;
+    Key key{1, 0};
+    double value = 3.25;
+    ASSERT_TRUE(old_store.insert(99, &key, sizeof(key), &value, sizeof(value)));
+
+    MappedStore new_store;
+    ASSERT_TRUE(new_store.open(path, 128, 32, "engine-2", error)) << error;
+    double out = 0.0;
+    EXPECT_FALSE(new_store.lookup(99, &key, sizeof(key), &out, sizeof(out)));
+
+    ASSERT_TRUE(old_store.lookup(99, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_EQ(out, 3.25);
+}
+
+// A writer that died mid-write leaves its slot claimed; the slot is free again two epochs on
+TEST_F(MappedStoreTest, AbandonedSlotIsReclaimed) {
+    Key key{1, 0};
+    double value = 3.25;
+    {
+        MappedStore store;
+        std::string error;
+        ASSERT_TRUE(store.open(path, 1, 32, "v1", error)) << error;
+        ASSERT_TRUE(store.insert(0, &key, sizeof(key), &value, sizeof(value)));
+    }
+    // Mark the only slot as claimed, as the crashed writer would have. Slots start at the
+    // first 64-byte boundary after the header and begin with their state word.
+    const int fd = ::open(path.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    uint64_t state = 0;
+    ASSERT_EQ(pread(fd, &state, sizeof(state), 192), static_cast<ssize_t>(sizeof(state)));
+    state |= 1;
+    ASSERT_EQ(pwrite(fd, &state, sizeof(state), 192), static_cast<ssize_t>(sizeof(state)));
+    ::close(fd);
+
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(path, 1, 32, "v1", error)) << error;
+    double out = 0.0;
+    EXPECT_FALSE(store.lookup(0, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_FALSE(store.insert(0, &key, sizeof(key), &value, sizeof(value)));
+    store.clear();
+    EXPECT_FALSE(store.insert(0, &key, sizeof(key), &value, sizeof(value)));
+    store.clear();
+    value = 4.5;
+    ASSERT_TRUE(store.insert(0, &key, sizeof(key), &value, sizeof(value)));
+    ASSERT_TRUE(store.lookup(0, &key, sizeof(key), &out, sizeof(out)));
+    EXPECT_EQ(out, 4.5);
+}
+
+TEST_F(MappedStoreTest, CollidingHashesAreProbed) {
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(path, 16, 32, "v1", error)) << error;
+
+    for (int32_t i = 0; i < 4; ++i) {
+        Key key{i, 0};
+        double value = i * 10.0;
+        ASSERT_TRUE(store.insert(5, &key, sizeof(key), &value, sizeof(value)));
+    }
+    for (int32_t i = 0; i < 4; ++i) {
+        Key key{i, 0};
+        double out = -1.0;
+        ASSERT_TRUE(store.lookup(5, &key, sizeof(key), &out, sizeof(out)));
+        EXPECT_EQ(out, i * 10.0);
+    }
+}
+
+TEST_F(MappedStoreTest, RejectsOversizedPayload) {
+    MappedStore store;
+    std::string error;
+    ASSERT_TRUE(store.open(path, 16, 16, "v1", error)) << error;
+
+    Key key{1, 0};
+    double values[2] = {1.0, 2.0};
+    EXPECT_FALSE(store.insert(1, &key, sizeof(key), values, sizeof(values)));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "utils/BlackScholesUtil.h"
+#include "utils/PerfCounters.h"
+
+using BlackScholesUtil::PricingEngine;
+
+class PerfCountersTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        PerfCounters::setEnabled(false);
+    }
+};
+
+TEST_F(PerfCountersTest, DisabledScopeRecordsNothing) {
+    PerfCounters::setEnabled(false);
+    const EngineCounters before = PerfCounters::totals(PricingEngine::GSL_QAGIU);
+
+    PerfScope scope;
+    scope.finish(PricingEngine::GSL_QAGIU);
+
+    EXPECT_EQ(PerfCounters::totals(PricingEngine::GSL_QAGIU).invocations, before.invocations);
+}
+
+TEST_F(PerfCountersTest, ScopeChargesTheFinishingEngine) {
+    PerfCounters::setEnabled(true);
+    const EngineCounters before = PerfCounters::totals(PricingEngine::GAUSS_LAGUERRE);
+
+    double sink = 0.0;
+    for (int i = 0; i < 100; ++i) {
+        PerfScope scope;
+        sink += BlackScholesUtil::calculateStandardCall(100.0, 90.0 + i * 0.1, 1.0, 0.2, 0.05);
+        scope.finish(PricingEngine::GAUSS_LAGUERRE);
+    }
+    EXPECT_GT(sink, 0.0);
+
+    const EngineCounters after = PerfCounters::totals(PricingEngine::GAUSS_LAGUERRE);
+    EXPECT_EQ(after.invocations - before.invocations, 100u);
+    EXPECT_GT(after.nanos, before.nanos);
+    if (PerfCounters::hardwareAvailable()) {
+        EXPECT_EQ(after.hardware_invocations - before.hardware_invocations, 100u);
+        EXPECT_GT(after.values[static_cast<size_t>(PerfCounter::INSTRUCTIONS)],
+                  before.values[static_cast<size_t>(PerfCounter::INSTRUCTIONS)]);
+    } else {
+        // Software fallback: timing only
+        EXPECT_EQ(after.hardware_invocations, before.hardware_invocations);
+    }
+}
+
+TEST_F(PerfCountersTest, FinishIsIdempotent) {
+    PerfCounters::setEnabled(true);
+    const EngineCounters before = PerfCounters::totals(PricingEngine::ANALYTIC_SHORTCUT);
+
+    PerfScope scope;
+    scope.finish(PricingEngine::ANALYTIC_SHORTCUT);
+    scope.finish(PricingEngine::ANALYTIC_SHORTCUT);
+
+    EXPECT_EQ(PerfCounters::totals(PricingEngine::ANALYTIC_SHORTCUT).invocations - before.invocations, 1u);
+}
+
+TEST_F(PerfCountersTest, TotalsSumAcrossThreads) {
+    PerfCounters::setEnabled(true);
+    const EngineCounters before = PerfCounters::totals(PricingEngine::CLOSED_FORM);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 250; ++i) {
+                PerfScope scope;
+                scope.finish(PricingEngine::CLOSED_FORM);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(PerfCounters::totals(PricingEngine::CLOSED_FORM).invocations - before.invocations, 1000u);
+}
+
+TEST_F(PerfCountersTest, JsonListsEveryEngine) {
+    PerfCounters::setEnabled(true);
+    PerfScope scope;
+    scope.finish(PricingEngine::CLOSED_FORM);
+
+    const Json::Value json = PerfCounters::toJson();
+    EXPECT_TRUE(json["enabled"].asBool());
+    EXPECT_EQ(json["hardware"].asBool(), PerfCounters::hardwareAvailable());
+    for (const char* engine : {"closed_form", "analytic_shortcut", "gauss_laguerre", "gsl_qagiu"}) {
+        ASSERT_TRUE(json["engines"].isMember(engine)) << engine;
+    }
+    const Json::Value& closed = json["engines"]["closed_form"];
+    EXPECT_GE(closed["invocations"].asUInt64(), 1u);
+    EXPECT_TRUE(closed["nanos_per_call"].isDouble());
+    EXPECT_TRUE(closed.isMember("cycles_per_call"));
+    EXPECT_TRUE(closed.isMember("branch_misses_per_call"));
+    EXPECT_TRUE(closed.isMember("ipc"));
+}
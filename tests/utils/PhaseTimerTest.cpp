@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "utils/PhaseTimer.h"
+
+TEST(PhaseTimerTest, CalibratedRateTracksWallClock) {
+    PhaseTimer::calibrate();
+    ASSERT_GT(PhaseTimer::nanosPerTick(), 0.0);
+
+    PhaseTimer timer;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    timer.mark(RequestPhase::PRICE);
+
+    const double millis = static_cast<double>(timer.nanos(RequestPhase::PRICE)) * 1e-6;
+    EXPECT_GE(millis, 15.0);
+    EXPECT_LT(millis, 500.0);
+}
+
+TEST(PhaseTimerTest, MarksChargeElapsedTimeToEachPhase) {
+    PhaseTimer timer;
+    timer.mark(RequestPhase::BODY);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    timer.mark(RequestPhase::PARSE);
+
+    EXPECT_TRUE(timer.reached(RequestPhase::BODY));
+    EXPECT_TRUE(timer.reached(RequestPhase::PARSE));
+    EXPECT_FALSE(timer.reached(RequestPhase::VALIDATE));
+    EXPECT_GT(timer.nanos(RequestPhase::PARSE), timer.nanos(RequestPhase::BODY));
+    EXPECT_EQ(timer.nanos(RequestPhase::SERIALIZE), 0u);
+}
+
+TEST(PhaseTimerTest, ServerTimingListsReachedPhases) {
+    PhaseTimer timer;
+    timer.mark(RequestPhase::BODY);
+    timer.mark(RequestPhase::PARSE);
+    timer.mark(RequestPhase::VALIDATE);
+
+    const std::string header = timer.serverTiming();
+    EXPECT_EQ(header.find("body;dur="), 0u);
+    EXPECT_NE(header.find(", parse;dur="), std::string::npos);
+    EXPECT_NE(header.find(", validate;dur="), std::string::npos);
+    EXPECT_EQ(header.find("price"), std::string::npos);
+}
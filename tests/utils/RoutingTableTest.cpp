@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "ReferencePricer.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/RoutingTable.h"
+#include "utils/TuningConfig.h"
+
+using BlackScholesUtil::PricingEngine;
+
+class RoutingTableTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::string error;
+        ASSERT_TRUE(TuningConfig::publish(TuningParameters{}, error)) << error;
+    }
+
+    static Json::Value cell(const char* engine, int order = 0) {
+        Json::Value json;
+        json["engine"] = engine;
+        if (order > 0) json["gl_order"] = order;
+        return json;
+    }
+
+    // cv bins split at 0.1 and 1.0; one bin on the other axes. Calls and binaries differ in
+    // the middle bin only.
+    static Json::Value sampleTable() {
+        Json::Value table;
+        table["version"] = RoutingTable::kVersion;
+        table["target_error"] = 1e-6;
+        table["axes"]["cv"].append(0.1);
+        table["axes"]["cv"].append(1.0);
+        table["axes"]["total_volatility"] = Json::Value(Json::arrayValue);
+        table["axes"]["log_moneyness"] = Json::Value(Json::arrayValue);
+        table["call"].append(cell("analytic_shortcut"));
+        table["call"].append(cell("gauss_laguerre", 12));
+        table["call"].append(cell("gsl_qagiu"));
+        table["binary"].append(cell("analytic_shortcut"));
+        table["binary"].append(cell("gauss_laguerre", 40));
+        table["binary"].append(cell("gsl_qagiu"));
+        return table;
+    }
+};
+
+TEST_F(RoutingTableTest, RoutesByCell) {
+    std::string error;
+    auto table = RoutingTable::fromJson(sampleTable(), error);
+    ASSERT_TRUE(table) << error;
+    EXPECT_EQ(table->cellCount(), 3u);
+    EXPECT_EQ(table->fingerprint().size(), 16u);
+
+    EXPECT_EQ(table->route(false, 100, 100, 0.2, 2.0, 0.1).engine, PricingEngine::ANALYTIC_SHORTCUT);
+    const RouteDecision gl = table->route(false, 100, 100, 0.2, 2.0, 1.0);
+    EXPECT_EQ(gl.engine, PricingEngine::GAUSS_LAGUERRE);
+    EXPECT_EQ(gl.gl_order, 12);
+    EXPECT_EQ(table->route(true, 100, 100, 0.2, 2.0, 1.0).gl_order, 40);
+    EXPECT_EQ(table->route(false, 100, 100, 0.2, 2.0, 4.0).engine, PricingEngine::GSL_QAGIU);
+    // A value on a boundary belongs to the upper bin
+    EXPECT_EQ(table->route(false, 100, 100, 0.2, 2.0, 0.2).engine, PricingEngine::GAUSS_LAGUERRE);
+}
+
+TEST_F(RoutingTableTest, RejectsMalformedTables) {
+    std::string error;
+    Json::Value table = sampleTable();
+    table["version"] = 2;
+    EXPECT_FALSE(RoutingTable::fromJson(table, error));
+
+    table = sampleTable();
+    table["axes"]["cv"][1] = 0.05;
+    EXPECT_FALSE(RoutingTable::fromJson(table, error));
+    EXPECT_EQ(error, "Routing table axis cv must hold ascending finite numbers");
+
+    table = sampleTable();
+    table["call"].append(cell("gsl_qagiu"));
+    EXPECT_FALSE(RoutingTable::fromJson(table, error));
+    EXPECT_EQ(error, "Routing table call must hold 3 cells");
+
+    table = sampleTable();
+    table["binary"][1] = cell("gauss_laguerre");
+    EXPECT_FALSE(RoutingTable::fromJson(table, error));
+
+    table = sampleTable();
+    table["call"][0] = cell("closed_form");
+    EXPECT_FALSE(RoutingTable::fromJson(table, error));
+    EXPECT_EQ(error, "Unknown routing table engine closed_form");
+}
+
+// A loaded table replaces the thresholds for the pricing functions and tags the engine version
+TEST_F(RoutingTableTest, PricingFollowsLoadedTable) {
+    const std::string thresholds_version = BlackScholesUtil::engineVersion();
+    BlackScholesUtil::PricingDiagnostics d;
+
+    // The thresholds send cv = 0.05 to Gauss-Laguerre
+    BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.2, 0.05, 2.0, 0.1, &d);
+    EXPECT_EQ(d.engine, PricingEngine::GAUSS_LAGUERRE);
+
+    TuningParameters params;
+    Json::Value overrides;
+    overrides["routing_table"] = sampleTable();
+    std::string error;
+    ASSERT_TRUE(params.mergeJson(overrides, error)) << error;
+    ASSERT_TRUE(TuningConfig::publish(params, error)) << error;
+    EXPECT_NE(BlackScholesUtil::engineVersion(), thresholds_version);
+    EXPECT_EQ(TuningConfig::current().toJson()["routing_table"], sampleTable());
+
+    const double shortcut = BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.2, 0.05, 2.0, 0.1, &d);
+    EXPECT_EQ(d.engine, PricingEngine::ANALYTIC_SHORTCUT);
+    EXPECT_DOUBLE_EQ(shortcut, BlackScholesUtil::priceRandomExpirationWithEngine(
+        PricingEngine::ANALYTIC_SHORTCUT, false, 100.0, 100.0, 0.2, 0.05, 2.0, 0.1));
+
+    BlackScholesUtil::calculateRandomExpirationBinaryCall(100.0, 100.0, 0.2, 0.05, 2.0, 1.0, &d);
+    EXPECT_EQ(d.engine, PricingEngine::GAUSS_LAGUERRE);
+    EXPECT_EQ(d.evaluations, 40);
+
+    BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.2, 0.05, 2.0, 4.0, &d);
+    EXPECT_EQ(d.engine, PricingEngine::GSL_QAGIU);
+
+    // null goes back to the thresholds
+    overrides["routing_table"] = Json::Value(Json::nullValue);
+    ASSERT_TRUE(params.mergeJson(overrides, error)) << error;
+    ASSERT_TRUE(TuningConfig::publish(params, error)) << error;
+    EXPECT_EQ(BlackScholesUtil::engineVersion(), thresholds_version);
+    BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.2, 0.05, 2.0, 0.1, &d);
+    EXPECT_EQ(d.engine, PricingEngine::GAUSS_LAGUERRE);
+}
+
+// A table tuned against a reference that lost narrow densities sent every low-cv cell to QAGIU,
+// which prices them at 0. The shortcut ratio and the alpha limit must still win.
+TEST_F(RoutingTableTest, LowCvPricesSurviveATunedTable) {
+    Json::Value table;
+    table["version"] = RoutingTable::kVersion;
+    table["target_error"] = 1e-6;
+    table["axes"]["cv"].append(0.02);
+    table["axes"]["cv"].append(0.05);
+    table["axes"]["total_volatility"] = Json::Value(Json::arrayValue);
+    table["axes"]["log_moneyness"] = Json::Value(Json::arrayValue);
+    for (int i = 0; i < 3; ++i) {
+        table["call"].append(cell("gsl_qagiu"));
+        table["binary"].append(cell("gsl_qagiu"));
+    }
+    Json::Value tuning;
+    tuning["routing_table"] = table;
+    const std::string path = ::testing::TempDir() + "routing_table_test.json";
+    std::ofstream(path) << tuning.toStyledString();
+
+    TuningParameters params;
+    std::string error;
+    ASSERT_TRUE(TuningConfig::loadFile(path, params, error)) << error;
+    ASSERT_TRUE(TuningConfig::publish(params, error)) << error;
+    std::remove(path.c_str());
+
+    struct Case {
+        double sigmaH;
+        PricingEngine engine;
+        double tolerance;
+    };
+    // H / sigmaH of 100, then alpha of 1600 and 400
+    const Case cases[] = {
+        {0.02, PricingEngine::ANALYTIC_SHORTCUT, 1e-3},
+        {0.05, PricingEngine::GAUSS_LAGUERRE, 1e-9},
+        {0.2, PricingEngine::GSL_QAGIU, 1e-8},
+    };
+    BlackScholesUtil::PricingDiagnostics d;
+    for (const Case& c : cases) {
+        for (bool binary : {false, true}) {
+            const double reference = referenceRandomExpirationPrice(binary, 100.0, 100.0, 0.2, 0.05, 2.0, c.sigmaH);
+            const double price = binary
+                ? BlackScholesUtil::calculateRandomExpirationBinaryCall(100.0, 100.0, 0.2, 0.05, 2.0, c.sigmaH, &d)
+                : BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.2, 0.05, 2.0, c.sigmaH, &d);
+            EXPECT_EQ(d.engine, c.engine) << "sigmaH " << c.sigmaH;
+            EXPECT_NEAR(price, reference, c.tolerance * reference) << "sigmaH " << c.sigmaH << " binary " << binary;
+        }
+    }
+}
+
+TEST_F(RoutingTableTest, InvalidTableLeavesParametersUnchanged) {
+    TuningParameters params;
+    Json::Value overrides;
+    overrides["gl_order"] = 48;
+    overrides["routing_table"] = "table.json";
+    std::string error;
+    EXPECT_FALSE(params.mergeJson(overrides, error));
+    EXPECT_EQ(params.gl_order, BSU_GL_ORDER);
+    EXPECT_FALSE(params.routing_table);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "utils/SlowRequestLog.h"
+
+namespace {
+
+std::string logPath(const char* name) {
+    return "/tmp/bss_slow_log_test_" + std::to_string(getpid()) + "_" + name + ".jsonl";
+}
+
+Json::Value record(double stock_price) {
+    Json::Value record;
+    record["total_ms"] = 7.5;
+    record["request"]["type"] = "regular";
+    record["request"]["stock_price"] = stock_price;
+    return record;
+}
+
+} // namespace
+
+TEST(SlowRequestLogTest, WritesOneRecordPerLineFromEveryThread) {
+    SlowLogConfig config;
+    config.path = logPath("threads");
+    std::remove(config.path.c_str());
+    std::string error;
+    ASSERT_TRUE(SlowRequestLog::start(config, error)) << error;
+    EXPECT_EQ(SlowRequestLog::thresholdNanos(), 5000000u);
+
+    const uint64_t written = SlowRequestLog::writtenRecords();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 50; ++i) EXPECT_TRUE(SlowRequestLog::submit(record(t * 100 + i + 1)));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    SlowRequestLog::stop();
+    EXPECT_EQ(SlowRequestLog::writtenRecords() - written, 200u);
+
+    std::vector<Json::Value> requests;
+    ASSERT_TRUE(SlowRequestLog::readRequests(config.path, requests, error)) << error;
+    ASSERT_EQ(requests.size(), 200u);
+    for (const auto& request : requests) {
+        EXPECT_EQ(request["type"].asString(), "regular");
+    }
+    std::remove(config.path.c_str());
+}
+
+TEST(SlowRequestLogTest, AppendsAcrossRestarts) {
+    SlowLogConfig config;
+    config.path = logPath("append");
+    std::remove(config.path.c_str());
+    std::string error;
+    for (int run = 0; run < 2; ++run) {
+        ASSERT_TRUE(SlowRequestLog::start(config, error)) << error;
+        SlowRequestLog::submit(record(run + 1));
+        SlowRequestLog::stop();
+    }
+
+    std::vector<Json::Value> requests;
+    ASSERT_TRUE(SlowRequestLog::readRequests(config.path, requests, error)) << error;
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_DOUBLE_EQ(requests[1]["stock_price"].asDouble(), 2.0);
+    std::remove(config.path.c_str());
+}
+
+TEST(SlowRequestLogTest, SubmitIsRejectedWhileStopped) {
+    EXPECT_FALSE(SlowRequestLog::enabled());
+    EXPECT_FALSE(SlowRequestLog::submit(record(1)));
+}
+
+TEST(SlowRequestLogTest, ReadRequestsReportsMalformedLines) {
+    const std::string path = logPath("malformed");
+    {
+        std::ofstream out(path);
+        out << "{\"request\": {\"type\": \"regular\"}}\n";
+        out << "{\"total_ms\": 3}\n";
+    }
+    std::vector<Json::Value> requests;
+    std::string error;
+    EXPECT_FALSE(SlowRequestLog::readRequests(path, requests, error));
+    EXPECT_EQ(error, "Malformed slow request record on line 2");
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(SlowRequestLog::readRequests(path, requests, error));
+    EXPECT_EQ(error, "Cannot open slow request log " + path);
+}
+
+TEST(SlowRequestLogTest, RejectsInvalidConfig) {
+    SlowLogConfig config;
+    config.path = logPath("invalid");
+    config.capacity = 0;
+    std::string error;
+    EXPECT_FALSE(SlowRequestLog::start(config, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(SlowRequestLog::enabled());
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <jsoncpp/json/json.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "utils/Tracer.h"
+
+namespace {
+
+std::string tracePath(const char* name) {
+    return "/tmp/bss_tracer_test_" + std::to_string(getpid()) + "_" + name + ".json";
+}
+
+Json::Value readTrace(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    Json::Value events;
+    Json::Reader reader;
+    EXPECT_TRUE(reader.parse(contents.str(), events)) << contents.str();
+    return events;
+}
+
+std::vector<Json::Value> eventsNamed(const Json::Value& events, const std::string& name) {
+    std::vector<Json::Value> matches;
+    for (const auto& event : events) {
+        if (event["name"].asString() == name) matches.push_back(event);
+    }
+    return matches;
+}
+
+TraceSpan batchSpan(uint32_t rows) {
+    TraceSpan span;
+    span.name = "batch";
+    span.trace_id = Tracer::newTraceId();
+    span.start_ns = 1000;
+    span.duration_ns = 2500;
+    span.batch_size = rows;
+    return span;
+}
+
+} // namespace
+
+TEST(TracerTest, WritesSpansFromEveryThreadAsChromeTrace) {
+    TraceConfig config;
+    config.path = tracePath("threads");
+    config.sample_rate = 1.0;
+    std::string error;
+    ASSERT_TRUE(Tracer::start(config, error)) << error;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 10; ++i) Tracer::record(batchSpan(t + 1));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    Tracer::stop();
+
+    const Json::Value events = readTrace(config.path);
+    ASSERT_TRUE(events.isArray());
+    ASSERT_EQ(events.size(), 40u);
+    for (const auto& event : events) {
+        EXPECT_EQ(event["name"].asString(), "batch");
+        EXPECT_EQ(event["ph"].asString(), "X");
+        EXPECT_DOUBLE_EQ(event["ts"].asDouble(), 1.0);
+        EXPECT_DOUBLE_EQ(event["dur"].asDouble(), 2.5);
+        EXPECT_EQ(event["args"]["trace_id"].asString().size(), 16u);
+        EXPECT_GE(event["args"]["batch_size"].asUInt(), 1u);
+    }
+    std::remove(config.path.c_str());
+}
+
+TEST(TracerTest, HeadSampledRequestEmitsPhaseSpans) {
+    TraceConfig config;
+    config.path = tracePath("head");
+    config.sample_rate = 1.0;
+    config.slow_ms = 1000.0;
+    std::string error;
+    ASSERT_TRUE(Tracer::start(config, error)) << error;
+
+    PhaseTimer timer;
+    timer.mark(RequestPhase::BODY);
+    timer.mark(RequestPhase::PARSE);
+    timer.mark(RequestPhase::VALIDATE);
+    timer.mark(RequestPhase::PRICE);
+    timer.mark(RequestPhase::SERIALIZE);
+
+    RequestSpanAttributes attributes;
+    attributes.head_sampled = Tracer::sampleHead();
+    attributes.queue_ns = 20000;
+    attributes.option_type = "regular";
+    attributes.engine = "closed_form";
+    EXPECT_TRUE(attributes.head_sampled);
+    Tracer::recordRequest(timer, attributes);
+    Tracer::stop();
+
+    const Json::Value events = readTrace(config.path);
+    for (const char* name : {"request", "queue", "body", "parse", "validate", "price", "serialize"}) {
+        ASSERT_EQ(eventsNamed(events, name).size(), 1u) << name;
+    }
+    const Json::Value request = eventsNamed(events, "request")[0];
+    const Json::Value queue = eventsNamed(events, "queue")[0];
+    EXPECT_EQ(request["args"]["type"].asString(), "regular");
+    EXPECT_EQ(request["args"]["engine"].asString(), "closed_form");
+    EXPECT_EQ(queue["args"]["trace_id"].asString(), request["args"]["trace_id"].asString());
+    EXPECT_DOUBLE_EQ(queue["ts"].asDouble(), request["ts"].asDouble());
+    EXPECT_GE(request["dur"].asDouble(), queue["dur"].asDouble());
+    std::remove(config.path.c_str());
+}
+
+TEST(TracerTest, TailSamplingKeepsOnlySlowRequests) {
+    TraceConfig config;
+    config.path = tracePath("tail");
+    config.sample_rate = 0.0;
+    config.slow_ms = 1.0;
+    std::string error;
+    ASSERT_TRUE(Tracer::start(config, error)) << error;
+
+    PhaseTimer fast;
+    fast.mark(RequestPhase::BODY);
+    RequestSpanAttributes attributes;
+    attributes.head_sampled = Tracer::sampleHead();
+    EXPECT_FALSE(attributes.head_sampled);
+    Tracer::recordRequest(fast, attributes);
+
+    PhaseTimer slow;
+    slow.mark(RequestPhase::BODY);
+    attributes.queue_ns = 2000000;
+    Tracer::recordRequest(slow, attributes);
+    Tracer::stop();
+
+    const Json::Value events = readTrace(config.path);
+    EXPECT_EQ(eventsNamed(events, "request").size(), 1u);
+    EXPECT_EQ(eventsNamed(events, "queue").size(), 1u);
+    std::remove(config.path.c_str());
+}
+
+TEST(TracerTest, RecordIsIgnoredWhileStopped) {
+    EXPECT_FALSE(Tracer::enabled());
+    EXPECT_FALSE(Tracer::sampleHead());
+    const uint64_t written = Tracer::writtenSpans();
+    Tracer::record(batchSpan(1));
+    Tracer::flush();
+    EXPECT_EQ(Tracer::writtenSpans(), written);
+}
+
+TEST(TracerTest, FullRingCountsDroppedSpans) {
+    TraceConfig config;
+    config.path = tracePath("dropped");
+    config.buffer_spans = 8;
+    config.flush_interval_ms = 60000.0;
+    std::string error;
+    ASSERT_TRUE(Tracer::start(config, error)) << error;
+
+    const uint64_t dropped = Tracer::droppedSpans();
+    // A fresh thread gets a ring sized by this session's config
+    std::thread([] {
+        for (int i = 0; i < 20; ++i) Tracer::record(batchSpan(1));
+    }).join();
+    EXPECT_EQ(Tracer::droppedSpans() - dropped, 12u);
+    Tracer::stop();
+
+    EXPECT_EQ(readTrace(config.path).size(), 8u);
+    std::remove(config.path.c_str());
+}
+
+TEST(TracerTest, RejectsInvalidConfig) {
+    TraceConfig config;
+    config.path = tracePath("invalid");
+    config.sample_rate = 1.5;
+    std::string error;
+    EXPECT_FALSE(Tracer::start(config, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(Tracer::enabled());
+}
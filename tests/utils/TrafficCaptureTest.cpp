@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "utils/TrafficCapture.h"
+
+namespace {
+
+std::string capturePath(const char* name) {
+    return "/tmp/bss_capture_test_" + std::to_string(getpid()) + "_" + name + ".bin";
+}
+
+uint64_t steadyNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+TEST(TrafficCaptureTest, RoundTripsRequestsInArrivalOrder) {
+    CaptureConfig config;
+    config.path = capturePath("roundtrip");
+    std::string error;
+    ASSERT_TRUE(TrafficCapture::start(config, error)) << error;
+
+    const uint64_t base = steadyNanos();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, base] {
+            for (int i = 0; i < 25; ++i) {
+                // Interleave arrival offsets across threads
+                const uint64_t started = base + static_cast<uint64_t>(i * 4 + t) * 1000;
+                const std::string body = "{\"n\":" + std::to_string(i * 4 + t) + "}";
+                TrafficCapture::record(started, started + 5000, t == 0 ? 400 : 200, body);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    TrafficCapture::stop();
+    EXPECT_EQ(TrafficCapture::capturedRequests(), 100u);
+
+    std::vector<CapturedRequest> requests;
+    ASSERT_TRUE(TrafficCapture::readFile(config.path, requests, error)) << error;
+    ASSERT_EQ(requests.size(), 100u);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        EXPECT_EQ(requests[i].body, "{\"n\":" + std::to_string(i) + "}");
+        EXPECT_EQ(requests[i].duration_ns, 5000u);
+        EXPECT_EQ(requests[i].status, i % 4 == 0 ? 400 : 200);
+        if (i > 0) {
+            EXPECT_EQ(requests[i].offset_ns - requests[i - 1].offset_ns, 1000u);
+        }
+    }
+    std::remove(config.path.c_str());
+}
+
+TEST(TrafficCaptureTest, DropsOversizedBodiesAndOverflow) {
+    CaptureConfig config;
+    config.path = capturePath("dropped");
+    config.buffer_requests = 4;
+    config.flush_interval_ms = 60000.0;
+    std::string error;
+    ASSERT_TRUE(TrafficCapture::start(config, error)) << error;
+
+    const uint64_t dropped = TrafficCapture::droppedRequests();
+    // A fresh thread gets a ring sized by this capture's config
+    std::thread([] {
+        const uint64_t now = steadyNanos();
+        TrafficCapture::record(now, now, 200, std::string(TrafficCapture::kMaxBodyBytes + 1, 'x'));
+        for (int i = 0; i < 10; ++i) TrafficCapture::record(now, now, 200, "{}");
+    }).join();
+    EXPECT_EQ(TrafficCapture::droppedRequests() - dropped, 7u);
+    TrafficCapture::stop();
+
+    std::vector<CapturedRequest> requests;
+    ASSERT_TRUE(TrafficCapture::readFile(config.path, requests, error)) << error;
+    EXPECT_EQ(requests.size(), 4u);
+    std::remove(config.path.c_str());
+}
+
+TEST(TrafficCaptureTest, RecordIsIgnoredWhileStopped) {
+    EXPECT_FALSE(TrafficCapture::enabled());
+    const uint64_t dropped = TrafficCapture::droppedRequests();
+    TrafficCapture::record(1, 2, 200, "{}");
+    EXPECT_EQ(TrafficCapture::droppedRequests(), dropped);
+}
+
+TEST(TrafficCaptureTest, ReadFileRejectsForeignAndTruncatedFiles) {
+    const std::string path = capturePath("corrupt");
+    std::vector<CapturedRequest> requests;
+    std::string error;
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a capture file";
+    }
+    EXPECT_FALSE(TrafficCapture::readFile(path, requests, error));
+    EXPECT_EQ(error, "Not a capture file: " + path);
+
+    CaptureConfig config;
+    config.path = path;
+    ASSERT_TRUE(TrafficCapture::start(config, error)) << error;
+    TrafficCapture::record(steadyNanos(), steadyNanos(), 200, "{\"stock_price\":100}");
+    TrafficCapture::stop();
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 3));
+    }
+    EXPECT_FALSE(TrafficCapture::readFile(path, requests, error));
+    EXPECT_EQ(error, "Truncated capture record 0 in " + path);
+    std::remove(path.c_str());
+}
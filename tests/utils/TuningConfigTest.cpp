@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include "services/ResultCache.h"
+#include "services/TuningService.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/TuningConfig.h"
+
+class TuningConfigTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::string error;
+        ASSERT_TRUE(TuningConfig::publish(TuningParameters{}, error)) << error;
+    }
+};
+
+TEST_F(TuningConfigTest, DefaultsMatchHistoricalConstants) {
+    const TuningParameters& params = TuningConfig::current();
+    EXPECT_EQ(params.gsl_cv_threshold, 0.5);
+    EXPECT_EQ(params.gsl_alpha_threshold, 0.5);
+    EXPECT_EQ(params.analytic_shortcut_ratio, 50.0);
+    EXPECT_EQ(params.gl_order, BSU_GL_ORDER);
+    EXPECT_EQ(params.qagiu_epsabs, 1e-9);
+    EXPECT_EQ(params.qagiu_limit, 8192);
+}
+
+TEST_F(TuningConfigTest, MergeJsonOverridesOnlyGivenFields) {
+    TuningParameters params;
+    Json::Value overrides;
+    overrides["gl_order"] = 48;
+    overrides["qagiu_epsrel"] = 1e-7;
+
+    std::string error;
+    ASSERT_TRUE(params.mergeJson(overrides, error)) << error;
+    EXPECT_EQ(params.gl_order, 48);
+    EXPECT_EQ(params.qagiu_epsrel, 1e-7);
+    EXPECT_EQ(params.gsl_cv_threshold, 0.5);
+}
+
+TEST_F(TuningConfigTest, InvalidValuesAreRejectedWithoutPartialUpdate) {
+    TuningParameters params;
+    Json::Value overrides;
+    overrides["gl_order"] = 48;
+    overrides["qagiu_epsabs"] = -1.0;
+
+    std::string error;
+    EXPECT_FALSE(params.mergeJson(overrides, error));
+    EXPECT_EQ(error, "Field qagiu_epsabs must be a positive number");
+    EXPECT_EQ(params.gl_order, BSU_GL_ORDER);
+
+    Json::Value order;
+    order["gl_order"] = 1000;
+    EXPECT_FALSE(params.mergeJson(order, error));
+}
+
+TEST_F(TuningConfigTest, QagiuSettingsAreBounded) {
+    TuningParameters params;
+    std::string error;
+    Json::Value limit;
+    limit["qagiu_limit"] = 1 << 20;
+    EXPECT_FALSE(params.mergeJson(limit, error));
+    EXPECT_EQ(error, "qagiu_limit must be between 1 and 65536");
+
+    for (double tolerance : {1e-300, 1e-13, 0.1}) {
+        Json::Value tight;
+        tight["qagiu_epsabs"] = tolerance;
+        EXPECT_FALSE(params.mergeJson(tight, error)) << tolerance;
+    }
+    EXPECT_EQ(params.qagiu_epsabs, 1e-9);
+    EXPECT_EQ(params.qagiu_limit, 8192);
+
+    Json::Value edge;
+    edge["qagiu_epsrel"] = 1e-12;
+    edge["qagiu_limit"] = 65536;
+    EXPECT_TRUE(params.mergeJson(edge, error)) << error;
+}
+
+TEST_F(TuningConfigTest, PublishIsVisibleToPricing) {
+    const double before = BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 5.0);
+
+    // Lowering the shortcut ratio below H/sigmaH = 1 prices as a fixed-maturity option
+    TuningParameters params;
+    params.analytic_shortcut_ratio = 0.5;
+    std::string error;
+    ASSERT_TRUE(TuningConfig::publish(params, error)) << error;
+
+    const double after = BlackScholesUtil::calculateRandomExpirationCall(100.0, 100.0, 0.9, 0.05, 5.0, 5.0);
+    EXPECT_NEAR(after, BlackScholesUtil::calculateStandardCall(100.0, 100.0, 5.0, 0.9, 0.05), 1e-9);
+    EXPECT_NE(before, after);
+}
+
+TEST_F(TuningConfigTest, ReadersNeverSeeTornSnapshots) {
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::string error;
+
+    TuningParameters initial;
+    initial.gl_order = 2;
+    initial.qagiu_epsabs = initial.qagiu_epsrel = 2e-9;
+    ASSERT_TRUE(TuningConfig::publish(initial, error)) << error;
+
+    // Every published snapshot keeps qagiu_epsabs == qagiu_epsrel and gl_order tied to them
+    std::thread reader([&] {
+        while (!stop.load()) {
+            const TuningParameters& p = TuningConfig::current();
+            if (p.qagiu_epsabs != p.qagiu_epsrel || p.gl_order != static_cast<int>(std::lround(p.qagiu_epsabs * 1e9))) {
+                torn.fetch_add(1);
+            }
+        }
+    });
+
+    for (int i = 2; i < 2000; ++i) {
+        TuningParameters params;
+        params.gl_order = 2 + i % 100;
+        params.qagiu_epsabs = params.qagiu_epsrel = params.gl_order * 1e-9;
+        ASSERT_TRUE(TuningConfig::publish(params, error)) << error;
+    }
+    stop.store(true);
+    reader.join();
+    EXPECT_EQ(torn.load(), 0);
+}
+
+TEST_F(TuningConfigTest, ServiceReloadsFileAndInvalidatesResults) {
+    char tmpl[] = "/tmp/tuning_fileXXXXXX";
+    int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    {
+        std::ofstream out(tmpl);
+        out << "{\"gl_order\": 24, \"analytic_shortcut_ratio\": 40}";
+    }
+
+    auto key = ResultCacheKey::make(ResultCacheKey::RANDOM_EXPIRATION_CALL, 100.0, 100.0, 0.9, 0.05, 5.0, 5.0);
+    ResultCache::instance().insert(key, 1.0, TuningConfig::current().generation);
+
+    std::string error;
+    ASSERT_TRUE(TuningService::reloadIfChanged(tmpl, error)) << error;
+    EXPECT_EQ(TuningConfig::current().gl_order, 24);
+    EXPECT_EQ(TuningConfig::current().analytic_shortcut_ratio, 40.0);
+
+    double value = 0.0;
+    EXPECT_FALSE(ResultCache::instance().lookup(key, value));
+
+    // Unchanged file is not reloaded
+    EXPECT_FALSE(TuningService::reloadIfChanged(tmpl, error));
+    std::remove(tmpl);
+}
+
+TEST_F(TuningConfigTest, ServiceRejectsInvalidOverrides) {
+    Json::Value overrides;
+    overrides["gl_order"] = "many";
+    std::string error;
+    EXPECT_FALSE(TuningService::applyJson(overrides, error));
+    EXPECT_EQ(error, "Field gl_order must be an integer");
+    EXPECT_EQ(TuningConfig::current().gl_order, BSU_GL_ORDER);
+}
+
+// Fields a tuning file omits come from the baseline, not the built-in defaults
+TEST_F(TuningConfigTest, ServiceLayersFileOnBaseline) {
+    char tmpl[] = "/tmp/tuning_fileXXXXXX";
+    int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    {
+        std::ofstream out(tmpl);
+        out << "{\"analytic_shortcut_ratio\": 30}";
+    }
+
+    TuningParameters baseline;
+    baseline.gl_order = 48;
+    TuningService::setBaseline(baseline);
+
+    std::string error;
+    ASSERT_TRUE(TuningService::reloadFile(tmpl, error)) << error;
+    EXPECT_EQ(TuningConfig::current().gl_order, 48);
+    EXPECT_EQ(TuningConfig::current().analytic_shortcut_ratio, 30.0);
+
+    TuningService::setBaseline(TuningParameters{});
+    std::remove(tmpl);
+}
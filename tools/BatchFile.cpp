@@ -0,0 +1,383 @@
+#include "BatchFile.h"
+#include <algorithm>
+#include <bitset>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const kColumnNames[kBatchColumnCount] = {
+    "stock_price", "strike_price", "volatility", "risk_free_rate",
+    "time_to_maturity", "holding_period", "volatility_around_holding_period",
+};
+
+constexpr uint32_t kColumnBits = (1u << kBatchColumnCount) - 1;
+
+void trim(const char*& begin, const char*& end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+}
+
+bool positive(const BatchRow& row, BatchColumn column, std::string& error) {
+    const double value = row[column];
+    if (std::isnan(value)) {
+        error = std::string("Missing required field: ") + batchColumnName(column);
+        return false;
+    }
+    if (!(value > 0) || std::isinf(value)) {
+        error = std::string("Field ") + batchColumnName(column) + " must be positive";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::openRead(const std::string& path, std::string& error) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) != 0) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) return true;
+    base_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (base_ == MAP_FAILED) {
+        base_ = nullptr;
+        error = "Cannot map " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    // Every chunk is read once, front to back
+    madvise(base_, size_, MADV_SEQUENTIAL);
+    return true;
+}
+
+bool MappedFile::create(const std::string& path, size_t bytes, std::string& error) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0 || ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+        error = "Cannot create " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    size_ = bytes;
+    if (size_ == 0) return true;
+    base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base_ == MAP_FAILED) {
+        base_ = nullptr;
+        error = "Cannot map " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (base_) munmap(base_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    base_ = nullptr;
+    size_ = 0;
+    fd_ = -1;
+}
+
+const char* batchColumnName(BatchColumn column) {
+    return kColumnNames[static_cast<int>(column)];
+}
+
+bool parseOptionTypeName(const std::string& name, dto::OptionType& type) {
+    for (auto candidate : {dto::OptionType::REGULAR, dto::OptionType::BINARY, dto::OptionType::RANDOM_EXPIRATION_CALL,
+                           dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL}) {
+        if (name == dto::optionTypeName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool validateBatchRow(BatchRow& row, std::string& error) {
+    if (!positive(row, BatchColumn::STOCK_PRICE, error) || !positive(row, BatchColumn::STRIKE_PRICE, error) ||
+        !positive(row, BatchColumn::VOLATILITY, error)) {
+        return false;
+    }
+    if (std::isnan(row[BatchColumn::RISK_FREE_RATE])) {
+        error = "Missing required field: risk_free_rate";
+        return false;
+    }
+    if (std::isinf(row[BatchColumn::RISK_FREE_RATE])) {
+        error = "Field risk_free_rate must be finite";
+        return false;
+    }
+
+    switch (row.type) {
+        case dto::OptionType::REGULAR:
+        case dto::OptionType::BINARY:
+            return positive(row, BatchColumn::TIME_TO_MATURITY, error);
+
+        case dto::OptionType::RANDOM_EXPIRATION_CALL:
+        case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL:
+            if (!positive(row, BatchColumn::HOLDING_PERIOD, error)) return false;
+            if (std::isnan(row[BatchColumn::VOLATILITY_AROUND_HOLDING_PERIOD])) {
+                row[BatchColumn::VOLATILITY_AROUND_HOLDING_PERIOD] = row[BatchColumn::HOLDING_PERIOD];
+            }
+            return positive(row, BatchColumn::VOLATILITY_AROUND_HOLDING_PERIOD, error);
+    }
+    return true;
+}
+
+bool CsvBatchFormat::parseHeader(const char* data, size_t size, std::optional<dto::OptionType> default_type,
+                                 std::string& error) {
+    fields_.clear();
+    default_type_ = default_type;
+    const char* begin = data;
+    const char* line;
+    const char* line_end;
+    if (!nextLine(begin, data + size, line, line_end)) {
+        error = "The input has no header row";
+        return false;
+    }
+    body_offset_ = static_cast<size_t>(begin - data);
+
+    bool has_type = false;
+    std::bitset<kBatchColumnCount> seen;
+    for (const char* cell = line; cell <= line_end;) {
+        const char* cell_end = std::find(cell, line_end, ',');
+        const char* name_begin = cell;
+        const char* name_end = cell_end;
+        trim(name_begin, name_end);
+        const std::string name(name_begin, name_end);
+
+        int field = kIgnored;
+        if (name == "type") {
+            if (has_type) {
+                error = "The header names type twice";
+                return false;
+            }
+            has_type = true;
+            field = kType;
+        }
+        for (int c = 0; c < kBatchColumnCount; ++c) {
+            if (name != kColumnNames[c]) continue;
+            if (seen[c]) {
+                error = "The header names " + name + " twice";
+                return false;
+            }
+            seen[c] = true;
+            field = c;
+        }
+        fields_.push_back(field);
+        cell = cell_end + 1;
+    }
+    if (!has_type && !default_type_) {
+        error = "The header has no type column and no default type was given";
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::pair<size_t, size_t>> CsvBatchFormat::chunks(const char* data, size_t size, size_t chunk_bytes) const {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t begin = body_offset_;
+    while (begin < size) {
+        size_t end = size;
+        if (size - begin > chunk_bytes) {
+            const void* newline = std::memchr(data + begin + chunk_bytes, '\n', size - begin - chunk_bytes);
+            if (newline) end = static_cast<size_t>(static_cast<const char*>(newline) - data) + 1;
+        }
+        ranges.emplace_back(begin, end);
+        begin = end;
+    }
+    return ranges;
+}
+
+size_t CsvBatchFormat::countRows(const char* begin, const char* end) {
+    size_t rows = 0;
+    const char* line;
+    const char* line_end;
+    while (nextLine(begin, end, line, line_end)) ++rows;
+    return rows;
+}
+
+bool CsvBatchFormat::nextLine(const char*& begin, const char* end, const char*& line, const char*& line_end) {
+    while (begin < end) {
+        const void* newline = std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+        line = begin;
+        line_end = newline ? static_cast<const char*>(newline) : end;
+        begin = newline ? line_end + 1 : end;
+        if (line_end > line && line_end[-1] == '\r') --line_end;
+        if (line_end > line) return true;
+    }
+    return false;
+}
+
+bool CsvBatchFormat::parseLine(const char* line, const char* line_end, BatchRow& row, std::string& error) const {
+    std::fill(std::begin(row.values), std::end(row.values), std::numeric_limits<double>::quiet_NaN());
+    if (default_type_) row.type = *default_type_;
+
+    size_t field = 0;
+    for (const char* cell = line; cell <= line_end; ++field) {
+        const char* cell_end = std::find(cell, line_end, ',');
+        if (field >= fields_.size()) {
+            error = "The row has more cells than the header";
+            return false;
+        }
+        const char* value = cell;
+        const char* value_end = cell_end;
+        trim(value, value_end);
+        cell = cell_end + 1;
+
+        const int column = fields_[field];
+        if (column == kIgnored) continue;
+        if (column == kType) {
+            if (!parseOptionTypeName(std::string(value, value_end), row.type)) {
+                error = "Unknown option type " + std::string(value, value_end);
+                return false;
+            }
+            continue;
+        }
+        if (value == value_end) continue;   // left NaN; validation decides whether that is fine
+        const auto parsed = std::from_chars(value, value_end, row.values[column]);
+        if (parsed.ec != std::errc() || parsed.ptr != value_end) {
+            error = std::string("Field ") + kColumnNames[column] + " must be numeric";
+            return false;
+        }
+    }
+    if (field != fields_.size()) {
+        error = "The row has fewer cells than the header";
+        return false;
+    }
+    return true;
+}
+
+const char BinaryBatchFormat::kMagic[8] = {'B', 'S', 'B', 'A', 'T', 'C', 'H', '1'};
+
+size_t BinaryBatchFormat::fileSize(size_t rows, uint32_t column_mask) {
+    const size_t columns = std::bitset<32>(column_mask & kColumnBits).count();
+    return sizeof(BinaryBatchHeader) + columns * rows * sizeof(double) +
+           ((column_mask & kTypeColumnBit) ? rows : 0);
+}
+
+bool BinaryBatchFormat::open(const char* data, size_t size, std::string& error) {
+    BinaryBatchHeader header;
+    if (size < sizeof(header)) {
+        error = "The file is too short for a batch header";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "The file is not a binary batch (bad magic)";
+        return false;
+    }
+    if (header.option_type > static_cast<uint32_t>(dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL) ||
+        (header.column_mask & ~(kColumnBits | kTypeColumnBit)) != 0) {
+        error = "The batch header has an unknown option type or column";
+        return false;
+    }
+    if (header.rows > (size - sizeof(header)) || size < fileSize(header.rows, header.column_mask)) {
+        error = "The file is shorter than its header announces";
+        return false;
+    }
+
+    rows_ = header.rows;
+    default_type_ = static_cast<dto::OptionType>(header.option_type);
+    const char* p = data + sizeof(header);
+    for (int c = 0; c < kBatchColumnCount; ++c) {
+        columns_[c] = nullptr;
+        if (!(header.column_mask & (1u << c))) continue;
+        columns_[c] = reinterpret_cast<const double*>(p);
+        p += rows_ * sizeof(double);
+    }
+    types_ = nullptr;
+    if (header.column_mask & kTypeColumnBit) {
+        types_ = reinterpret_cast<const uint8_t*>(p);
+        const uint8_t highest = static_cast<uint8_t>(dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL);
+        if (std::any_of(types_, types_ + rows_, [highest](uint8_t t) { return t > highest; })) {
+            error = "The type column holds an unknown option type";
+            return false;
+        }
+    }
+    return true;
+}
+
+void BinaryBatchFormat::row(size_t index, BatchRow& row) const {
+    row.type = types_ ? static_cast<dto::OptionType>(types_[index]) : default_type_;
+    for (int c = 0; c < kBatchColumnCount; ++c) {
+        row.values[c] = columns_[c] ? columns_[c][index] : std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+void BinaryBatchFormat::write(char* out, const std::vector<BatchRow>& rows, uint32_t column_mask,
+                              dto::OptionType default_type) {
+    const BinaryBatchWriter writer(out, rows.size(), column_mask, default_type);
+    for (size_t i = 0; i < rows.size(); ++i) writer.write(i, rows[i]);
+}
+
+BinaryBatchWriter::BinaryBatchWriter(char* out, size_t rows, uint32_t column_mask, dto::OptionType default_type) {
+    BinaryBatchHeader header;
+    std::memcpy(header.magic, BinaryBatchFormat::kMagic, sizeof(BinaryBatchFormat::kMagic));
+    header.option_type = static_cast<uint32_t>(default_type);
+    header.column_mask = column_mask;
+    header.rows = rows;
+    std::memcpy(out, &header, sizeof(header));
+    char* p = out + sizeof(header);
+    for (int c = 0; c < kBatchColumnCount; ++c) {
+        if (!(column_mask & (1u << c))) continue;
+        columns_[c] = p;
+        p += rows * sizeof(double);
+    }
+    if (column_mask & kTypeColumnBit) types_ = p;
+}
+
+void BinaryBatchWriter::write(size_t index, const BatchRow& row) const {
+    for (int c = 0; c < kBatchColumnCount; ++c) {
+        if (columns_[c]) std::memcpy(columns_[c] + index * sizeof(double), &row.values[c], sizeof(double));
+    }
+    if (types_) types_[index] = static_cast<char>(row.type);
+}
+
+const char PriceOutput::kTextHeader[] = "price\n";
+const char PriceOutput::kBinaryMagic[8] = {'B', 'S', 'P', 'R', 'I', 'C', 'E', '1'};
+
+size_t PriceOutput::textSize(size_t rows) {
+    return sizeof(kTextHeader) - 1 + rows * kTextWidth;
+}
+
+size_t PriceOutput::binarySize(size_t rows) {
+    return sizeof(BinaryPriceHeader) + rows * sizeof(double);
+}
+
+void PriceOutput::writeTextHeader(char* out) {
+    std::memcpy(out, kTextHeader, sizeof(kTextHeader) - 1);
+}
+
+void PriceOutput::writeBinaryHeader(char* out, size_t rows) {
+    BinaryPriceHeader header;
+    std::memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    header.rows = rows;
+    std::memcpy(out, &header, sizeof(header));
+}
+
+void PriceOutput::formatText(double price, char* line) {
+    char digits[kTextWidth];
+    const auto written = std::to_chars(digits, digits + sizeof(digits), price, std::chars_format::general, 17);
+    const size_t length = static_cast<size_t>(written.ptr - digits);
+    const size_t pad = kTextWidth - 1 - length;
+    std::memset(line, ' ', pad);
+    std::memcpy(line + pad, digits, length);
+    line[kTextWidth - 1] = '\n';
+}
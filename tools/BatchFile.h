@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "requests/BlackScholesRequestDto.h"
+
+// Input and output formats of the offline batch pricer (tools/batch.cpp).
+//
+// CSV input has a header row naming its columns after the /api/calculate fields: stock_price,
+// strike_price, volatility, risk_free_rate, time_to_maturity, holding_period,
+// volatility_around_holding_period and type. Other columns are ignored. Without a type
+// column every row has the default type. An empty volatility_around_holding_period defaults
+// to holding_period, as in the API.
+//
+// Binary columnar input is a BinaryBatchHeader followed by one little-endian double array per
+// column present in column_mask, in BatchColumn order. If kTypeColumnBit is set, a byte array
+// of dto::OptionType values follows, one per row; otherwise every row has option_type.
+//
+// Prices are written either as text, a "price" header line then one fixed-width line per
+// row, or as a BinaryPriceHeader followed by one double per row. Both layouts put row i at a
+// fixed offset, so threads can write their rows straight into a mapped file.
+
+// Memory-mapped file, either an existing one read-only or a new one of a given size
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool openRead(const std::string& path, std::string& error);
+    // Creates or truncates the file to bytes and maps it for writing
+    bool create(const std::string& path, size_t bytes, std::string& error);
+    void close();
+
+    char* data() const { return static_cast<char*>(base_); }
+    size_t size() const { return size_; }
+
+private:
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+};
+
+enum class BatchColumn : int {
+    STOCK_PRICE,
+    STRIKE_PRICE,
+    VOLATILITY,
+    RISK_FREE_RATE,
+    TIME_TO_MATURITY,
+    HOLDING_PERIOD,
+    VOLATILITY_AROUND_HOLDING_PERIOD
+};
+
+constexpr int kBatchColumnCount = 7;
+constexpr uint32_t kTypeColumnBit = 1u << 31;
+
+// The API field name of a column
+const char* batchColumnName(BatchColumn column);
+bool parseOptionTypeName(const std::string& name, dto::OptionType& type);
+
+struct BatchRow {
+    dto::OptionType type = dto::OptionType::REGULAR;
+    double values[kBatchColumnCount];   // NaN where the input has no value
+
+    double& operator[](BatchColumn column) { return values[static_cast<int>(column)]; }
+    double operator[](BatchColumn column) const { return values[static_cast<int>(column)]; }
+};
+
+// Applies the API's rules (positive prices, volatility and times; a finite rate) and fills in
+// the default volatility_around_holding_period
+bool validateBatchRow(BatchRow& row, std::string& error);
+
+class CsvBatchFormat {
+public:
+    // Reads the header line; default_type is required when there is no type column
+    bool parseHeader(const char* data, size_t size, std::optional<dto::OptionType> default_type,
+                     std::string& error);
+    size_t bodyOffset() const { return body_offset_; }
+
+    // Splits [bodyOffset(), size) into byte ranges of about chunk_bytes that start and end on
+    // line boundaries
+    std::vector<std::pair<size_t, size_t>> chunks(const char* data, size_t size, size_t chunk_bytes) const;
+
+    // Rows in [begin, end), which starts on a line boundary; blank lines are not rows
+    static size_t countRows(const char* begin, const char* end);
+    // Moves begin past the next row and returns it as [line, line_end) without the line break;
+    // false when only blank lines are left
+    static bool nextLine(const char*& begin, const char* end, const char*& line, const char*& line_end);
+
+    // Parses the fields of one line; missing or malformed cells fail
+    bool parseLine(const char* line, const char* line_end, BatchRow& row, std::string& error) const;
+
+private:
+    static constexpr int kIgnored = -1;
+    static constexpr int kType = -2;
+
+    std::vector<int> fields_;   // BatchColumn, kIgnored or kType for each header field
+    std::optional<dto::OptionType> default_type_;
+    size_t body_offset_ = 0;
+};
+
+struct BinaryBatchHeader {
+    char magic[8];               // "BSBATCH1"
+    uint32_t option_type;        // dto::OptionType of rows without a type column
+    uint32_t column_mask;        // bit i for BatchColumn i, plus kTypeColumnBit
+    uint64_t rows;
+};
+
+class BinaryBatchFormat {
+public:
+    static const char kMagic[8];
+
+    // Validates the header and that the file holds every column it announces
+    bool open(const char* data, size_t size, std::string& error);
+    size_t rows() const { return rows_; }
+    void row(size_t index, BatchRow& row) const;
+
+    // Bytes of a file with the given rows and columns
+    static size_t fileSize(size_t rows, uint32_t column_mask);
+    // Writes the header and rows into a buffer of fileSize() bytes
+    static void write(char* out, const std::vector<BatchRow>& rows, uint32_t column_mask, dto::OptionType default_type);
+
+private:
+    const double* columns_[kBatchColumnCount] = {};
+    const uint8_t* types_ = nullptr;
+    dto::OptionType default_type_ = dto::OptionType::REGULAR;
+    size_t rows_ = 0;
+};
+
+// Fills a buffer of BinaryBatchFormat::fileSize() bytes one row at a time. A row goes straight
+// to its place in every column, so rows may be written in any order and by several threads.
+class BinaryBatchWriter {
+public:
+    // Writes the header
+    BinaryBatchWriter(char* out, size_t rows, uint32_t column_mask, dto::OptionType default_type);
+    void write(size_t index, const BatchRow& row) const;
+
+private:
+    char* columns_[kBatchColumnCount] = {};
+    char* types_ = nullptr;
+};
+
+struct BinaryPriceHeader {
+    char magic[8];               // "BSPRICE1"
+    uint64_t rows;
+};
+
+// Output offsets and encoding of both price layouts
+struct PriceOutput {
+    static const char kTextHeader[];           // "price\n"
+    static constexpr size_t kTextWidth = 25;   // 24 characters and a newline
+    static const char kBinaryMagic[8];
+
+    static size_t textSize(size_t rows);
+    static size_t binarySize(size_t rows);
+    static void writeTextHeader(char* out);
+    static void writeBinaryHeader(char* out, size_t rows);
+    // Writes the price right-aligned with 17 significant digits, "nan" for invalid rows
+    static void formatText(double price, char* line);
+};
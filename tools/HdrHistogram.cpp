@@ -0,0 +1,103 @@
+#include "HdrHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+int floorLog2(uint64_t value) {
+    return 63 - __builtin_clzll(value);
+}
+
+} // namespace
+
+HdrHistogram::HdrHistogram(uint64_t lowest, uint64_t highest, int significant_digits) : highest_(highest) {
+    if (lowest < 1 || highest < 2 * lowest || significant_digits < 1 || significant_digits > 5) {
+        throw std::invalid_argument("Invalid HdrHistogram range or precision");
+    }
+    // Enough linear sub-buckets per power of two to tell apart values one unit apart in the
+    // last significant digit
+    const uint64_t largest_single_unit = 2 * static_cast<uint64_t>(std::pow(10.0, significant_digits));
+    const int sub_bucket_count_magnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largest_single_unit))));
+    sub_bucket_half_count_magnitude_ = std::max(sub_bucket_count_magnitude, 1) - 1;
+    unit_magnitude_ = floorLog2(lowest);
+    const uint64_t sub_bucket_count = uint64_t{1} << (sub_bucket_half_count_magnitude_ + 1);
+    sub_bucket_half_count_ = sub_bucket_count / 2;
+    sub_bucket_mask_ = (sub_bucket_count - 1) << unit_magnitude_;
+
+    size_t bucket_count = 1;
+    for (uint64_t smallest_untrackable = sub_bucket_count << unit_magnitude_; smallest_untrackable <= highest;
+         smallest_untrackable <<= 1) {
+        ++bucket_count;
+        if (smallest_untrackable > (~uint64_t{0} >> 2)) break;
+    }
+    counts_.assign((bucket_count + 1) * sub_bucket_half_count_, 0);
+}
+
+size_t HdrHistogram::indexFor(uint64_t value) const {
+    const int pow2_ceiling = floorLog2(value | sub_bucket_mask_) + 1;
+    const int bucket = pow2_ceiling - unit_magnitude_ - (sub_bucket_half_count_magnitude_ + 1);
+    const uint64_t sub_bucket = value >> (bucket + unit_magnitude_);
+    return (static_cast<size_t>(bucket + 1) << sub_bucket_half_count_magnitude_) +
+           static_cast<size_t>(sub_bucket - sub_bucket_half_count_);
+}
+
+uint64_t HdrHistogram::lowestEquivalent(size_t index, uint64_t& width) const {
+    int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+    uint64_t sub_bucket = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+    if (bucket < 0) {
+        sub_bucket -= sub_bucket_half_count_;
+        bucket = 0;
+    }
+    width = uint64_t{1} << (bucket + unit_magnitude_);
+    return sub_bucket << (bucket + unit_magnitude_);
+}
+
+uint64_t HdrHistogram::highestEquivalent(size_t index) const {
+    uint64_t width;
+    const uint64_t lowest = lowestEquivalent(index, width);
+    return lowest + width - 1;
+}
+
+void HdrHistogram::record(uint64_t value) {
+    value = std::min(value, highest_);
+    ++counts_[indexFor(value)];
+    ++total_;
+    max_ = std::max(max_, value);
+    sum_ += static_cast<double>(value);
+}
+
+void HdrHistogram::add(const HdrHistogram& other) {
+    if (other.counts_.size() != counts_.size() || other.unit_magnitude_ != unit_magnitude_ ||
+        other.sub_bucket_half_count_magnitude_ != sub_bucket_half_count_magnitude_) {
+        throw std::invalid_argument("HdrHistogram layouts differ");
+    }
+    for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+    total_ += other.total_;
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+uint64_t HdrHistogram::min() const {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        uint64_t width;
+        if (counts_[i]) return lowestEquivalent(i, width);
+    }
+    return 0;
+}
+
+double HdrHistogram::mean() const {
+    return total_ ? sum_ / static_cast<double>(total_) : 0.0;
+}
+
+uint64_t HdrHistogram::valueAtPercentile(double percentile) const {
+    if (total_ == 0) return 0;
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t wanted = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= wanted) return std::min(highestEquivalent(i), max_);
+    }
+    return max_;
+}
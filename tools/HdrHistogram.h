@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// High dynamic range histogram with the bucket layout of HdrHistogram: every power-of-two
+// range holds the same number of linear sub-buckets, so any recorded value is reported within
+// a fixed number of significant decimal digits up to the highest trackable value. The lowest
+// value is also the unit of resolution: recording nanoseconds with lowest 1000 keeps
+// microsecond precision. Values above the highest are clamped to it. Not thread-safe; keep one
+// per thread and add() them together.
+class HdrHistogram {
+public:
+    HdrHistogram(uint64_t lowest, uint64_t highest, int significant_digits);
+
+    void record(uint64_t value);
+    void add(const HdrHistogram& other);
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const;
+    uint64_t max() const { return max_; }
+    double mean() const;
+
+    // Smallest recorded value at or above the given percentage of all values, reported as the
+    // highest value equivalent to it at the histogram's precision; 0 when empty
+    uint64_t valueAtPercentile(double percentile) const;
+
+private:
+    size_t indexFor(uint64_t value) const;
+    // Range of values counted at an index: [lowest, lowest + width)
+    uint64_t lowestEquivalent(size_t index, uint64_t& width) const;
+    uint64_t highestEquivalent(size_t index) const;
+
+    uint64_t highest_;
+    int unit_magnitude_;
+    int sub_bucket_half_count_magnitude_;
+    uint64_t sub_bucket_half_count_;
+    uint64_t sub_bucket_mask_;
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+    double sum_ = 0.0;
+};
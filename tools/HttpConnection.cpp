@@ -0,0 +1,128 @@
+#include "HttpConnection.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+HttpConnection::HttpConnection(std::string host, uint16_t port) : host_(std::move(host)), port_(port) {}
+
+HttpConnection::~HttpConnection() {
+    close();
+}
+
+void HttpConnection::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    buffer_.clear();
+}
+
+bool HttpConnection::connect(std::string& error) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const int rc = getaddrinfo(host_.c_str(), std::to_string(port_).c_str(), &hints, &addresses);
+    if (rc != 0) {
+        error = "Cannot resolve " + host_ + ": " + gai_strerror(rc);
+        return false;
+    }
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        fd_ = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd_ < 0) continue;
+        if (::connect(fd_, a->ai_addr, a->ai_addrlen) == 0) break;
+        ::close(fd_);
+        fd_ = -1;
+    }
+    freeaddrinfo(addresses);
+    if (fd_ < 0) {
+        error = "Cannot connect to " + host_ + ":" + std::to_string(port_) + ": " + std::strerror(errno);
+        return false;
+    }
+    const int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return true;
+}
+
+bool HttpConnection::post(const std::string& path, const std::string& body, int& status, std::string& response,
+                          std::string& error) {
+    std::string request = "POST " + path + " HTTP/1.1\r\nHost: " + host_ +
+                          "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+                          "\r\nConnection: keep-alive\r\n\r\n" + body;
+    const bool reused = fd_ >= 0;
+    if (!reused && !connect(error)) return false;
+    if (exchange(request, status, response, error)) return true;
+    // A kept-alive connection may have been closed by the server in the meantime
+    close();
+    if (!reused || !connect(error)) return false;
+    return exchange(request, status, response, error);
+}
+
+bool HttpConnection::exchange(const std::string& request, int& status, std::string& response, std::string& error) {
+    size_t sent = 0;
+    while (sent < request.size()) {
+        const ssize_t n = ::send(fd_, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            error = std::string("send failed: ") + std::strerror(errno);
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+
+    char chunk[16384];
+    size_t header_end = std::string::npos;
+    size_t content_length = 0;
+    for (;;) {
+        if (header_end == std::string::npos) {
+            header_end = buffer_.find("\r\n\r\n");
+            if (header_end != std::string::npos) {
+                if (buffer_.compare(0, 5, "HTTP/") != 0 || buffer_.size() < 12) {
+                    error = "Malformed response status line";
+                    return false;
+                }
+                status = std::atoi(buffer_.c_str() + 9);
+                const std::string headers = buffer_.substr(0, header_end);
+                size_t pos = 0;
+                while ((pos = headers.find("\r\n", pos)) != std::string::npos) {
+                    pos += 2;
+                    if (strncasecmp(headers.c_str() + pos, "content-length:", 15) == 0) {
+                        content_length = std::strtoull(headers.c_str() + pos + 15, nullptr, 10);
+                    }
+                }
+                header_end += 4;
+            }
+        }
+        if (header_end != std::string::npos && buffer_.size() >= header_end + content_length) {
+            response = buffer_.substr(header_end, content_length);
+            buffer_.erase(0, header_end + content_length);
+            return true;
+        }
+        const ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            error = n == 0 ? "Connection closed by server" : std::string("recv failed: ") + std::strerror(errno);
+            return false;
+        }
+        buffer_.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+bool parseTarget(const std::string& target, std::string& host, uint16_t& port, std::string& error) {
+    const size_t colon = target.rfind(':');
+    if (colon == std::string::npos || colon + 1 == target.size()) {
+        error = "Target must be host:port, got " + target;
+        return false;
+    }
+    host = colon == 0 ? "127.0.0.1" : target.substr(0, colon);
+    const long value = std::strtol(target.c_str() + colon + 1, nullptr, 10);
+    if (value <= 0 || value > 65535) {
+        error = "Invalid port in " + target;
+        return false;
+    }
+    port = static_cast<uint16_t>(value);
+    return true;
+}
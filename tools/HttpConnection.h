@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Minimal blocking HTTP/1.1 client connection for the benchmark and replay tools. Keeps the
+// connection alive between requests and reconnects once when the server has closed it.
+class HttpConnection {
+public:
+    HttpConnection(std::string host, uint16_t port);
+    ~HttpConnection();
+    HttpConnection(const HttpConnection&) = delete;
+    HttpConnection& operator=(const HttpConnection&) = delete;
+
+    // Sends a JSON POST and reads the full response; returns false on a transport error
+    bool post(const std::string& path, const std::string& body, int& status, std::string& response,
+              std::string& error);
+
+private:
+    bool connect(std::string& error);
+    bool exchange(const std::string& request, int& status, std::string& response, std::string& error);
+    void close();
+
+    std::string host_;
+    uint16_t port_;
+    int fd_ = -1;
+    std::string buffer_;    // bytes read past the previous response
+};
+
+// "host:port" or ":port"; the host defaults to 127.0.0.1
+bool parseTarget(const std::string& target, std::string& host, uint16_t& port, std::string& error);
@@ -0,0 +1,77 @@
+#include "ReferencePricer.h"
+#include <cmath>
+#include <vector>
+#include <boost/math/distributions/gamma.hpp>
+#include "utils/BlackScholesUtil.h"
+
+namespace {
+
+constexpr int kReferenceNodes = 16;
+constexpr int kReferenceInteriorPanels = 128;
+constexpr int kReferenceTailDecades = 15;   // panels reach to 1e-15 of either end
+
+struct LegendreRule {
+    std::vector<double> nodes, weights;
+};
+
+// Gauss-Legendre nodes and weights on [-1, 1] by Newton iteration on the Legendre polynomial
+LegendreRule legendreRule(int n) {
+    LegendreRule rule;
+    rule.nodes.resize(n);
+    rule.weights.resize(n);
+    for (int i = 0; i < n; ++i) {
+        double x = std::cos(M_PI * (i + 0.75) / (n + 0.5));
+        double derivative = 1.0;
+        for (int iteration = 0; iteration < 100; ++iteration) {
+            double p0 = 1.0, p1 = x;
+            for (int k = 2; k <= n; ++k) {
+                const double p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+                p0 = p1;
+                p1 = p2;
+            }
+            derivative = n * (x * p1 - p0) / (x * x - 1.0);
+            const double step = p1 / derivative;
+            x -= step;
+            if (std::abs(step) < 1e-16) break;
+        }
+        rule.nodes[i] = x;
+        rule.weights[i] = 2.0 / ((1.0 - x * x) * derivative * derivative);
+    }
+    return rule;
+}
+
+// Panel edges in u: geometric towards 0 and 1, uniform over [0.01, 0.99]. The last panel
+// stops at 1 - 1e-15, where the quantile would overflow; what it leaves out is below 1e-15 * S.
+std::vector<double> referencePanels() {
+    std::vector<double> edges{0.0};
+    for (int k = kReferenceTailDecades; k >= 3; --k) edges.push_back(std::pow(10.0, -k));
+    for (int i = 0; i <= kReferenceInteriorPanels; ++i) edges.push_back(0.01 + 0.98 * i / kReferenceInteriorPanels);
+    for (int k = 3; k <= kReferenceTailDecades; ++k) edges.push_back(1.0 - std::pow(10.0, -k));
+    return edges;
+}
+
+} // namespace
+
+double referenceRandomExpirationPrice(bool binary, double stock_price, double strike_price,
+                                      double volatility, double risk_free_rate,
+                                      double holding_period, double volatility_around_holding_period) {
+    static const LegendreRule rule = legendreRule(kReferenceNodes);
+    static const std::vector<double> edges = referencePanels();
+
+    const double ratio = holding_period / volatility_around_holding_period;
+    const double alpha = ratio * ratio;
+    const boost::math::gamma_distribution<double> expiration(alpha, holding_period / alpha);
+    double sum = 0.0;
+    for (size_t p = 0; p + 1 < edges.size(); ++p) {
+        const double half = 0.5 * (edges[p + 1] - edges[p]);
+        const double mid = 0.5 * (edges[p + 1] + edges[p]);
+        for (int i = 0; i < kReferenceNodes; ++i) {
+            const double T = boost::math::quantile(expiration, mid + half * rule.nodes[i]);
+            const double price =
+                binary ? BlackScholesUtil::calculateBinaryCall(stock_price, strike_price, T, volatility, risk_free_rate)
+                       : BlackScholesUtil::calculateStandardCall(stock_price, strike_price, T, volatility, risk_free_rate);
+            sum += half * rule.weights[i] * price;
+        }
+    }
+    return sum;
+}
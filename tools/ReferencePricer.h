@@ -0,0 +1,13 @@
+#pragma once
+
+// Reference prices of the random expiration options, for the accuracy tools and tests.
+//
+// The reference integrates the fixed-maturity price (the boost-based calculateStandardCall or
+// calculateBinaryCall) over the gamma quantile function, E[f(T)] = integral of f(Q(u)) du over
+// (0, 1), with 16-point Gauss-Legendre panels graded geometrically towards both ends. Unlike
+// QAGIU at a tight tolerance, it does not lose the spike of a very narrow density (sigmaH / H
+// of 0.02 or less), and elsewhere the two agree to about 1e-13. It costs a few thousand
+// quantile evaluations per price.
+double referenceRandomExpirationPrice(bool binary, double stock_price, double strike_price,
+                                      double volatility, double risk_free_rate,
+                                      double holding_period, double volatility_around_holding_period);
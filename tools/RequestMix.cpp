@@ -0,0 +1,105 @@
+#include "RequestMix.h"
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <jsoncpp/json/json.h>
+
+namespace {
+
+struct Range {
+    double lo, hi;
+};
+
+bool regimeRange(const std::string& regime, Range& cv) {
+    if (regime == "gauss_laguerre") cv = {0.5, 0.5};
+    else if (regime == "analytic_shortcut") cv = {0.001, 0.015};
+    else if (regime == "gsl_qagiu") cv = {1.6, 4.0};
+    else if (regime == "mixed") cv = {0.005, 3.0};
+    else return false;
+    return true;
+}
+
+double draw(std::mt19937_64& rng, Range range) {
+    if (range.lo == range.hi) return range.lo;
+    return std::uniform_real_distribution<double>(range.lo, range.hi)(rng);
+}
+
+} // namespace
+
+bool RequestMix::parseWeights(const std::string& spec, std::string& error) {
+    RequestMix parsed = *this;
+    parsed.regular = parsed.binary = parsed.random_expiration = parsed.random_expiration_binary = 0;
+    std::stringstream in(spec);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const size_t eq = item.find('=');
+        const std::string type = item.substr(0, eq);
+        char* end = nullptr;
+        const double weight = eq == std::string::npos ? -1 : std::strtod(item.c_str() + eq + 1, &end);
+        if (eq == std::string::npos || *end != '\0' || !(weight >= 0)) {
+            error = "Invalid mix entry " + item;
+            return false;
+        }
+        if (type == "regular") parsed.regular = weight;
+        else if (type == "binary") parsed.binary = weight;
+        else if (type == "randomExpirationCall") parsed.random_expiration = weight;
+        else if (type == "randomExpirationBinaryCall") parsed.random_expiration_binary = weight;
+        else {
+            error = "Unknown option type " + type;
+            return false;
+        }
+    }
+    *this = parsed;
+    return true;
+}
+
+bool RequestMix::validate(std::string& error) const {
+    Range cv;
+    if (!regimeRange(regime, cv)) {
+        error = "Unknown regime " + regime;
+        return false;
+    }
+    if (!(regular + binary + random_expiration + random_expiration_binary > 0)) {
+        error = "The mix needs at least one option type with a positive weight";
+        return false;
+    }
+    if (!(diagnostics >= 0 && diagnostics <= 1) || !(invalid >= 0 && invalid <= 1)) {
+        error = "Fractions must be between 0 and 1";
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> RequestMix::bodies(size_t count, uint64_t seed) const {
+    static const char* kTypes[] = {"regular", "binary", "randomExpirationCall", "randomExpirationBinaryCall"};
+    Range cv{0.5, 0.5};
+    regimeRange(regime, cv);
+    std::mt19937_64 rng(seed);
+    const double weights[] = {regular, binary, random_expiration, random_expiration_binary};
+    std::discrete_distribution<int> pick(std::begin(weights), std::end(weights));
+    Json::FastWriter writer;
+
+    std::vector<std::string> bodies;
+    bodies.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int type = pick(rng);
+        Json::Value body;
+        body["type"] = kTypes[type];
+        const double stock = draw(rng, {90, 110});
+        body["stock_price"] = stock;
+        body["strike_price"] = stock * draw(rng, {0.8, 1.2});
+        body["volatility"] = draw(rng, {0.15, 0.35});
+        body["risk_free_rate"] = draw(rng, {0.0, 0.05});
+        if (type < 2) {
+            body["time_to_maturity"] = draw(rng, {0.25, 2.0});
+        } else {
+            const double holding_period = draw(rng, {0.5, 5.0});
+            body["holding_period"] = holding_period;
+            body["volatility_around_holding_period"] = holding_period * draw(rng, cv);
+        }
+        if (draw(rng, {0, 1}) < diagnostics) body["diagnostics"] = true;
+        if (draw(rng, {0, 1}) < invalid) body["stock_price"] = -stock;
+        bodies.push_back(writer.write(body));
+    }
+    return bodies;
+}
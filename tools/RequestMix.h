@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Synthetic /api/calculate bodies for the load generator. The option types are drawn with
+// the given weights; the random expiration types draw sigmaH / H from the regime's range,
+// which decides the engine the service routes them to:
+//
+//   gauss_laguerre     sigmaH / H fixed at 0.5: Gauss-Laguerre on one warm node table
+//   analytic_shortcut  at most 0.015: priced at the holding period
+//   gsl_qagiu          1.6 to 4: adaptive QAGIU
+//   mixed              0.005 to 3: all three engines, and node table rebuilds
+struct RequestMix {
+    double regular = 45;
+    double binary = 20;
+    double random_expiration = 25;
+    double random_expiration_binary = 10;
+    std::string regime = "gauss_laguerre";
+    double diagnostics = 0.0;   // fraction of requests asking for diagnostics
+    double invalid = 0.0;       // fraction that fails validation (negative stock price)
+
+    // "regular=45,binary=20,randomExpirationCall=25,randomExpirationBinaryCall=10"; types left
+    // out get weight 0
+    bool parseWeights(const std::string& spec, std::string& error);
+    bool validate(std::string& error) const;
+
+    // count bodies from a fixed seed, so the same options give the same traffic
+    std::vector<std::string> bodies(size_t count, uint64_t seed) const;
+};
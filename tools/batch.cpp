@@ -0,0 +1,586 @@
+// Offline batch pricer: prices every row of a CSV or binary columnar book without HTTP.
+//
+//   black_scholes_batch --input FILE --output FILE [--type NAME] [--output-format text|binary]
+//                       [--threads N | --workers N] [--chunk-mb N] [--quiet]
+//   black_scholes_batch --input FILE.csv --output FILE.bin --convert-to-binary [--type NAME]
+//
+// The formats are described in BatchFile.h; a binary input is recognized by its magic. The
+// input is memory-mapped and cut into chunks of about --chunk-mb (CSV chunks end on line
+// boundaries). Worker threads count the CSV rows of every chunk first, so each chunk knows
+// where its rows go. They then parse their chunks, group each block of rows by option type,
+// price the groups with the BlackScholesUtil batch kernels and write the prices straight into
+// the memory-mapped output at their row offsets. Output rows follow input order, so line i of
+// a text output is the price of data row i.
+//
+// Rows the API would reject (a non-positive price, say) get NaN and are counted; the first
+// one is reported with its row number, and the exit status is 1. A malformed CSV row stops
+// the run. Progress goes to stderr once a second unless --quiet is given.
+//
+// The book value, the sum of every priced row, is printed to stdout. Each chunk sums its prices
+// in an ExactSum and the chunk sums are merged, so the total is bitwise the same for any
+// --threads and --chunk-mb, and for the CSV and binary forms of a book.
+//
+// --workers N prices the chunks in N forked processes instead of threads, through
+// ShardedBatchExecutor: a worker that crashes is replaced and its chunk priced again. The
+// workers share the run state and the per-chunk results with this process through an
+// anonymous shared mapping, and write prices into the shared output mapping as threads do.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "BatchFile.h"
+#include "services/ShardedBatchExecutor.h"
+#include "utils/ExactSum.h"
+#include "utils/BlackScholesUtil.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kBlockRows = 4096;   // rows parsed, grouped and priced together
+
+struct Options {
+    std::string input;
+    std::string output;
+    std::optional<dto::OptionType> type;
+    std::string output_format;   // empty: text for CSV input, binary for binary input
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t workers = 0;          // forked worker processes; 0 prices on threads
+    size_t chunk_bytes = 16u << 20;
+    bool convert = false;
+    bool quiet = false;
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: black_scholes_batch --input FILE --output FILE [--type NAME] [--output-format text|binary]\n"
+        "                           [--threads N | --workers N] [--chunk-mb N] [--quiet]\n"
+        "       black_scholes_batch --input FILE.csv --output FILE.bin --convert-to-binary [--type NAME]\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--quiet") {
+            options.quiet = true;
+            continue;
+        }
+        if (arg == "--convert-to-binary") {
+            options.convert = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--input") {
+            options.input = value;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--type") {
+            dto::OptionType type;
+            if (!parseOptionTypeName(value, type)) {
+                error = "Unknown option type " + value;
+                return false;
+            }
+            options.type = type;
+        } else if (arg == "--output-format") {
+            if (value != "text" && value != "binary") return false;
+            options.output_format = value;
+        } else if (arg == "--threads") {
+            options.threads = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--workers") {
+            options.workers = std::strtoull(value.c_str(), nullptr, 10);
+            if (options.workers == 0) {
+                error = "--workers must be positive";
+                return false;
+            }
+        } else if (arg == "--chunk-mb") {
+            options.chunk_bytes = std::strtoull(value.c_str(), nullptr, 10) << 20;
+        } else {
+            return false;
+        }
+    }
+    if (options.input.empty() || options.output.empty()) return false;
+    if (options.threads == 0 || options.chunk_bytes == 0) {
+        error = "--threads and --chunk-mb must be positive";
+        return false;
+    }
+    return true;
+}
+
+// A chunk of the input: bytes [begin, end) of a CSV, or rows [begin, end) of a binary file
+struct Chunk {
+    size_t begin, end;
+    size_t first_row = 0;
+    size_t rows = 0;
+};
+
+// Reads the rows of one chunk in order, from either format
+class ChunkReader {
+public:
+    ChunkReader(const MappedFile& input, const CsvBatchFormat* csv, const BinaryBatchFormat* binary,
+                const Chunk& chunk)
+        : csv_(csv), binary_(binary), chunk_(chunk), next_(chunk.begin),
+          cursor_(input.data() + chunk.begin), end_(input.data() + chunk.end) {}
+
+    // False at the end of the chunk, or with error set for a malformed row
+    bool next(BatchRow& row, std::string& error) {
+        error.clear();
+        if (binary_) {
+            if (next_ >= chunk_.end) return false;
+            binary_->row(next_++, row);
+            return true;
+        }
+        const char* line;
+        const char* line_end;
+        if (!CsvBatchFormat::nextLine(cursor_, end_, line, line_end)) return false;
+        return csv_->parseLine(line, line_end, row, error);
+    }
+
+private:
+    const CsvBatchFormat* csv_;
+    const BinaryBatchFormat* binary_;
+    Chunk chunk_;
+    size_t next_;
+    const char* cursor_;
+    const char* end_;
+};
+
+// Rows of one option type within a block, as the batch kernels take them
+struct TypeGroup {
+    std::vector<double> S, K, vol, r, T, H, sigmaH;
+    std::vector<size_t> rows;   // offsets within the block
+
+    void clear() {
+        for (auto* column : {&S, &K, &vol, &r, &T, &H, &sigmaH}) column->clear();
+        rows.clear();
+    }
+
+    void add(const BatchRow& row, size_t offset) {
+        S.push_back(row[BatchColumn::STOCK_PRICE]);
+        K.push_back(row[BatchColumn::STRIKE_PRICE]);
+        vol.push_back(row[BatchColumn::VOLATILITY]);
+        r.push_back(row[BatchColumn::RISK_FREE_RATE]);
+        T.push_back(row[BatchColumn::TIME_TO_MATURITY]);
+        H.push_back(row[BatchColumn::HOLDING_PERIOD]);
+        sigmaH.push_back(row[BatchColumn::VOLATILITY_AROUND_HOLDING_PERIOD]);
+        rows.push_back(offset);
+    }
+
+    std::vector<double> price(dto::OptionType type) const {
+        switch (type) {
+            case dto::OptionType::REGULAR:
+                return BlackScholesUtil::calculateMultipleStandardCalls(S, K, T, vol, r);
+            case dto::OptionType::BINARY:
+                return BlackScholesUtil::calculateMultipleBinaryCalls(S, K, T, vol, r);
+            case dto::OptionType::RANDOM_EXPIRATION_CALL:
+                return BlackScholesUtil::calculateMultipleRandomExpirationCalls(S, K, vol, r, H, sigmaH);
+            case dto::OptionType::RANDOM_EXPIRATION_BINARY_CALL:
+                return BlackScholesUtil::calculateMultipleRandomExpirationBinaryCalls(S, K, vol, r, H, sigmaH);
+        }
+        return {};
+    }
+};
+
+constexpr int kTypeCount = 4;
+
+// Shared by the workers, whether threads or processes, so it holds only lock-free atomics
+struct RunState {
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<size_t> rows_done{0};
+    std::atomic<bool> failed{false};
+};
+
+// What pricing one chunk produced. Each chunk is priced by a single worker, so an outcome has
+// one writer; the outcomes are merged in chunk order, which keeps the reported first invalid
+// row and first failure the same for any number of workers.
+struct ChunkOutcome {
+    ExactSum total;
+    size_t invalid = 0;
+    size_t first_invalid_row = SIZE_MAX;
+    char first_invalid[256] = {};
+    char failure[256] = {};
+
+    void noteInvalid(size_t row, const std::string& error) {
+        if (invalid++ == 0) {
+            first_invalid_row = row;
+            std::snprintf(first_invalid, sizeof(first_invalid), "%s", error.c_str());
+        }
+    }
+
+    void fail(RunState& state, const std::string& error) {
+        std::snprintf(failure, sizeof(failure), "%s", error.c_str());
+        state.failed = true;
+    }
+};
+
+// The run state and one outcome per chunk in an anonymous shared mapping, visible to forked
+// workers as well as threads
+class SharedRun {
+public:
+    SharedRun() = default;
+    SharedRun(const SharedRun&) = delete;
+    SharedRun& operator=(const SharedRun&) = delete;
+    ~SharedRun() {
+        if (base_) munmap(base_, bytes_);
+    }
+
+    bool map(size_t chunk_count, std::string& error) {
+        const size_t state_bytes = (sizeof(RunState) + alignof(ChunkOutcome) - 1) / alignof(ChunkOutcome) *
+                                   alignof(ChunkOutcome);
+        bytes_ = state_bytes + chunk_count * sizeof(ChunkOutcome);
+        void* base = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            error = std::string("Failed to map the shared run state: ") + std::strerror(errno);
+            return false;
+        }
+        base_ = base;
+        state_ = new (base_) RunState;
+        outcomes_ = reinterpret_cast<ChunkOutcome*>(static_cast<char*>(base_) + state_bytes);
+        for (size_t c = 0; c < chunk_count; ++c) new (&outcomes_[c]) ChunkOutcome;
+        return true;
+    }
+
+    RunState& state() { return *state_; }
+    ChunkOutcome& outcome(size_t chunk) { return outcomes_[chunk]; }
+
+private:
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+    RunState* state_ = nullptr;
+    ChunkOutcome* outcomes_ = nullptr;
+};
+
+// Runs fn(chunk_index) over all chunks on the given number of threads
+template <typename Fn>
+void forEachChunk(size_t chunk_count, size_t threads, RunState& state, Fn fn) {
+    state.next_chunk = 0;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < std::min(threads, std::max<size_t>(chunk_count, 1)); ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = state.next_chunk.fetch_add(1); i < chunk_count && !state.failed;
+                 i = state.next_chunk.fetch_add(1)) {
+                fn(i);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+void writePrices(const Options& options, char* out, size_t first_row, const double* prices, size_t count) {
+    if (options.output_format == "binary") {
+        std::memcpy(out + sizeof(BinaryPriceHeader) + first_row * sizeof(double), prices, count * sizeof(double));
+        return;
+    }
+    char* line = out + PriceOutput::textSize(first_row);
+    for (size_t i = 0; i < count; ++i, line += PriceOutput::kTextWidth) PriceOutput::formatText(prices[i], line);
+}
+
+void priceChunk(const Options& options, const MappedFile& input, const CsvBatchFormat* csv,
+                const BinaryBatchFormat* binary, const Chunk& chunk, char* out, ChunkOutcome& outcome,
+                RunState& state) {
+    outcome = ChunkOutcome{};   // a chunk retried after its worker died starts over
+    ChunkReader reader(input, csv, binary, chunk);
+    TypeGroup groups[kTypeCount];
+    std::vector<double> prices;
+    BatchRow row;
+    std::string error;
+
+    for (size_t block_start = 0; block_start < chunk.rows; block_start += kBlockRows) {
+        const size_t block_rows = std::min(kBlockRows, chunk.rows - block_start);
+        for (auto& group : groups) group.clear();
+        prices.assign(block_rows, std::numeric_limits<double>::quiet_NaN());
+
+        for (size_t i = 0; i < block_rows; ++i) {
+            const size_t row_number = chunk.first_row + block_start + i + 1;
+            if (!reader.next(row, error)) {
+                outcome.fail(state, "Row " + std::to_string(row_number) + ": " +
+                           (error.empty() ? std::string("the input changed while it was read") : error));
+                return;
+            }
+            if (!validateBatchRow(row, error)) {
+                outcome.noteInvalid(row_number, error);
+                continue;
+            }
+            groups[static_cast<int>(row.type)].add(row, i);
+        }
+        for (int t = 0; t < kTypeCount; ++t) {
+            if (groups[t].rows.empty()) continue;
+            const std::vector<double> priced = groups[t].price(static_cast<dto::OptionType>(t));
+            for (size_t j = 0; j < priced.size(); ++j) prices[groups[t].rows[j]] = priced[j];
+            outcome.total.add(priced.data(), priced.size());
+        }
+        writePrices(options, out, chunk.first_row + block_start, prices.data(), block_rows);
+        state.rows_done.fetch_add(block_rows, std::memory_order_relaxed);
+    }
+}
+
+// Prints rows done, throughput and ETA to stderr once a second until stopped
+class ProgressReporter {
+public:
+    ProgressReporter(size_t total_rows, size_t input_bytes, const RunState& state, bool enabled)
+        : total_rows_(total_rows), input_bytes_(input_bytes), state_(state), started_(Clock::now()) {
+        if (!enabled || total_rows == 0) return;
+        interactive_ = isatty(STDERR_FILENO);
+        thread_ = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_.wait_for(lock, std::chrono::seconds(1), [this]() { return stopping_; })) print();
+        });
+    }
+
+    ~ProgressReporter() {
+        if (!thread_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        stop_.notify_one();
+        thread_.join();
+        if (interactive_) std::fputc('\n', stderr);
+    }
+
+private:
+    void print() const {
+        const size_t done = state_.rows_done.load(std::memory_order_relaxed);
+        const double seconds = std::chrono::duration<double>(Clock::now() - started_).count();
+        const double fraction = static_cast<double>(done) / static_cast<double>(total_rows_);
+        const double rate = seconds > 0 ? done / seconds : 0.0;
+        const double eta = rate > 0 ? (total_rows_ - done) / rate : 0.0;
+        std::fprintf(stderr, "%s%zu / %zu rows (%.1f%%), %.2f M rows/s, %.0f MB/s of input, eta %.0f s%s",
+                     interactive_ ? "\r" : "", done, total_rows_, 100.0 * fraction, rate * 1e-6,
+                     seconds > 0 ? fraction * input_bytes_ / seconds / 1e6 : 0.0, eta, interactive_ ? "   " : "\n");
+        std::fflush(stderr);
+    }
+
+    size_t total_rows_;
+    size_t input_bytes_;
+    const RunState& state_;
+    Clock::time_point started_;
+    bool interactive_ = false;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_;
+    bool stopping_ = false;
+};
+
+// Columns and option types used by the rows of one chunk
+struct ChunkColumns {
+    uint32_t mask = 0;
+    uint32_t types = 0;     // bit t for dto::OptionType t
+    int first_type = -1;    // of the chunk's first row
+};
+
+// Writes the CSV rows as a binary columnar file, keeping only columns that hold values. A
+// first pass over the chunks finds those columns and the types; the second parses each chunk
+// again and writes its rows straight into the mapped output, so no more than a row per thread
+// is held in memory.
+int convert(const Options& options, const MappedFile& input, const CsvBatchFormat& csv,
+            const std::vector<Chunk>& chunks, size_t total_rows, RunState& state) {
+    std::vector<ChunkOutcome> outcomes(chunks.size());
+    auto forEachRow = [&](size_t c, const auto& fn) {
+        ChunkReader reader(input, &csv, nullptr, chunks[c]);
+        BatchRow row;
+        std::string error;
+        for (size_t i = 0; i < chunks[c].rows; ++i) {
+            if (!reader.next(row, error)) {
+                outcomes[c].fail(state, "Row " + std::to_string(chunks[c].first_row + i + 1) + ": " +
+                                        (error.empty() ? std::string("the input changed while it was read") : error));
+                return;
+            }
+            fn(i, row);
+        }
+    };
+    auto reportFailure = [&]() {
+        for (const ChunkOutcome& outcome : outcomes) {
+            if (outcome.failure[0]) {
+                std::fprintf(stderr, "%s\n", outcome.failure);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<ChunkColumns> columns(chunks.size());
+    forEachChunk(chunks.size(), options.threads, state, [&](size_t c) {
+        forEachRow(c, [&](size_t i, const BatchRow& row) {
+            for (int k = 0; k < kBatchColumnCount; ++k) {
+                if (!std::isnan(row.values[k])) columns[c].mask |= 1u << k;
+            }
+            columns[c].types |= 1u << static_cast<int>(row.type);
+            if (i == 0) columns[c].first_type = static_cast<int>(row.type);
+        });
+    });
+    if (reportFailure()) return 1;
+
+    dto::OptionType default_type = options.type.value_or(dto::OptionType::REGULAR);
+    if (!options.type) {
+        for (const ChunkColumns& chunk : columns) {
+            if (chunk.first_type < 0) continue;
+            default_type = static_cast<dto::OptionType>(chunk.first_type);
+            break;
+        }
+    }
+    uint32_t mask = 0;
+    for (const ChunkColumns& chunk : columns) {
+        mask |= chunk.mask;
+        if (chunk.types & ~(1u << static_cast<int>(default_type))) mask |= kTypeColumnBit;
+    }
+
+    MappedFile output;
+    std::string error;
+    if (!output.create(options.output, BinaryBatchFormat::fileSize(total_rows, mask), error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const BinaryBatchWriter writer(output.data(), total_rows, mask, default_type);
+    forEachChunk(chunks.size(), options.threads, state, [&](size_t c) {
+        forEachRow(c, [&](size_t i, const BatchRow& row) { writer.write(chunks[c].first_row + i, row); });
+    });
+    if (reportFailure()) return 1;
+    if (!options.quiet) std::fprintf(stderr, "Wrote %zu rows to %s\n", total_rows, options.output.c_str());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parseOptions(argc, argv, options, error)) {
+        if (!error.empty()) std::fprintf(stderr, "%s\n", error.c_str());
+        usage();
+        return 2;
+    }
+
+    const auto started = Clock::now();
+    MappedFile input;
+    if (!input.openRead(options.input, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const bool is_binary = input.size() >= sizeof(BinaryBatchFormat::kMagic) &&
+                           std::memcmp(input.data(), BinaryBatchFormat::kMagic, sizeof(BinaryBatchFormat::kMagic)) == 0;
+    CsvBatchFormat csv;
+    BinaryBatchFormat binary;
+    if (is_binary ? !binary.open(input.data(), input.size(), error)
+                  : !csv.parseHeader(input.data(), input.size(), options.type, error)) {
+        std::fprintf(stderr, "%s: %s\n", options.input.c_str(), error.c_str());
+        return 1;
+    }
+    if (options.convert && is_binary) {
+        std::fprintf(stderr, "%s is already a binary batch\n", options.input.c_str());
+        return 2;
+    }
+    if (options.output_format.empty()) options.output_format = is_binary ? "binary" : "text";
+
+    // Chunks, and where each one's rows start
+    std::vector<Chunk> chunks;
+    size_t total_rows = 0;
+    if (is_binary) {
+        const size_t chunk_rows = std::max<size_t>(kBlockRows, options.chunk_bytes / (kBatchColumnCount * sizeof(double)));
+        for (size_t begin = 0; begin < binary.rows(); begin += chunk_rows) {
+            const size_t end = std::min(binary.rows(), begin + chunk_rows);
+            chunks.push_back({begin, end, begin, end - begin});
+        }
+        total_rows = binary.rows();
+    } else {
+        for (const auto& range : csv.chunks(input.data(), input.size(), options.chunk_bytes)) {
+            chunks.push_back({range.first, range.second});
+        }
+        RunState state;
+        forEachChunk(chunks.size(), options.threads, state, [&](size_t c) {
+            chunks[c].rows = CsvBatchFormat::countRows(input.data() + chunks[c].begin, input.data() + chunks[c].end);
+        });
+        for (auto& chunk : chunks) {
+            chunk.first_row = total_rows;
+            total_rows += chunk.rows;
+        }
+    }
+
+    SharedRun run;
+    if (!run.map(chunks.size(), error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    RunState& state = run.state();
+    if (options.convert) return convert(options, input, csv, chunks, total_rows, state);
+
+    const bool binary_output = options.output_format == "binary";
+    MappedFile output;
+    if (!output.create(options.output,
+                       binary_output ? PriceOutput::binarySize(total_rows) : PriceOutput::textSize(total_rows), error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (binary_output) {
+        PriceOutput::writeBinaryHeader(output.data(), total_rows);
+    } else {
+        PriceOutput::writeTextHeader(output.data());
+    }
+
+    {
+        auto price = [&](size_t c) {
+            priceChunk(options, input, is_binary ? nullptr : &csv, is_binary ? &binary : nullptr, chunks[c],
+                       output.data(), run.outcome(c), state);
+        };
+        // The reporter thread only prints; glibc's fork() takes the stdio and malloc locks, so
+        // the forked workers never inherit them held
+        ProgressReporter progress(total_rows, input.size(), state, !options.quiet);
+        if (options.workers > 0) {
+            ShardedBatchOptions sharding;
+            sharding.worker_count = static_cast<int>(options.workers);
+            if (!ShardedBatchExecutor::runShards(chunks.size(), sharding, [&](size_t c) {
+                    if (!state.failed) price(c);
+                }, error)) {
+                std::fprintf(stderr, "%s: %s\n", options.input.c_str(), error.c_str());
+                return 1;
+            }
+        } else {
+            forEachChunk(chunks.size(), options.threads, state, price);
+        }
+    }
+
+    ExactSum book;
+    size_t invalid = 0;
+    const ChunkOutcome* first_invalid = nullptr;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        const ChunkOutcome& outcome = run.outcome(c);
+        if (outcome.failure[0]) {
+            std::fprintf(stderr, "%s: %s\n", options.input.c_str(), outcome.failure);
+            return 1;
+        }
+        if (outcome.invalid > 0 && !first_invalid) first_invalid = &outcome;
+        invalid += outcome.invalid;
+        book.merge(outcome.total);
+    }
+    std::printf("book_value %.17g\npriced_rows %llu\n", book.value(), static_cast<unsigned long long>(book.count()));
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    if (!options.quiet) {
+        std::fprintf(stderr, "Priced %zu rows in %.2f s (%.2f M rows/s, %.0f MB/s of input) on %zu %s\n",
+                     total_rows, seconds, seconds > 0 ? total_rows / seconds * 1e-6 : 0.0,
+                     seconds > 0 ? input.size() / seconds / 1e6 : 0.0,
+                     options.workers > 0 ? options.workers : options.threads,
+                     options.workers > 0 ? "worker processes" : "threads");
+    }
+    if (invalid > 0) {
+        std::fprintf(stderr, "%zu invalid rows priced as NaN; first at row %zu: %s\n", invalid,
+                     first_invalid->first_invalid_row, first_invalid->first_invalid);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+// Open-loop HTTP load generator for capacity tests against a running service.
+//
+//   black_scholes_loadgen --rate N [--duration S] [--warmup S] [--connections N]
+//                         [--target host:port] [--path /api/calculate]
+//                         [--mix regular=45,binary=20,...] [--regime NAME]
+//                         [--diagnostics F] [--invalid F] [--bodies FILE] [--seed N] [--json]
+//
+// Requests are scheduled at a constant rate, one every 1/N seconds, whether or not earlier
+// ones have completed, and spread over keep-alive connections. Latency is measured from each
+// request's scheduled send time, so a stalled server or a backlog on busy connections counts
+// against the tail instead of silently lowering the offered load (coordinated omission). The
+// time from the actual send is reported next to it; a large gap between the two means the
+// connections, not the service, were the bottleneck. Latencies go into HDR histograms with
+// three significant digits. Requests still unsent when the schedule ends are recorded in the
+// latency histogram with the time from their scheduled send to the end of the run, a lower
+// bound on what they would have seen, so a service that falls behind cannot drop its worst
+// requests from the tail.
+//
+// Bodies come from a seeded RequestMix (see RequestMix.h) or, with --bodies, one per line
+// from a file, so any endpoint and payload shape can be driven. Requests scheduled during
+// the warmup are sent but not recorded.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include "HdrHistogram.h"
+#include "HttpConnection.h"
+#include "RequestMix.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Nanosecond resolution up to 60 s, at three significant digits
+constexpr uint64_t kLowestNanos = 1;
+constexpr uint64_t kHighestNanos = 60ull * 1000 * 1000 * 1000;
+constexpr int kSignificantDigits = 3;
+constexpr size_t kGeneratedBodies = 4096;
+const double kPercentiles[] = {50.0, 75.0, 90.0, 99.0, 99.9, 99.99};
+
+struct Options {
+    std::string target = "127.0.0.1:8080";
+    std::string path = "/api/calculate";
+    double rate = 0.0;          // requests per second
+    double duration = 30.0;     // seconds recorded, after the warmup
+    double warmup = 5.0;
+    size_t connections = 16;
+    RequestMix mix;
+    std::string bodies_file;
+    uint64_t seed = 1;
+    bool json = false;
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: black_scholes_loadgen --rate N [--duration S] [--warmup S] [--connections N]\n"
+        "                             [--target host:port] [--path /api/calculate]\n"
+        "                             [--mix regular=45,binary=20,randomExpirationCall=25,...]\n"
+        "                             [--regime gauss_laguerre|analytic_shortcut|gsl_qagiu|mixed]\n"
+        "                             [--diagnostics F] [--invalid F] [--bodies FILE] [--seed N] [--json]\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--json") {
+            options.json = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--target") {
+            options.target = value;
+        } else if (arg == "--path") {
+            options.path = value;
+        } else if (arg == "--rate") {
+            options.rate = std::atof(value.c_str());
+        } else if (arg == "--duration") {
+            options.duration = std::atof(value.c_str());
+        } else if (arg == "--warmup") {
+            options.warmup = std::atof(value.c_str());
+        } else if (arg == "--connections") {
+            options.connections = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--mix") {
+            if (!options.mix.parseWeights(value, error)) return false;
+        } else if (arg == "--regime") {
+            options.mix.regime = value;
+        } else if (arg == "--diagnostics") {
+            options.mix.diagnostics = std::atof(value.c_str());
+        } else if (arg == "--invalid") {
+            options.mix.invalid = std::atof(value.c_str());
+        } else if (arg == "--bodies") {
+            options.bodies_file = value;
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    if (!(options.rate > 0) || !(options.duration > 0) || !(options.warmup >= 0) || options.connections == 0) {
+        error = "--rate and --duration must be positive, --warmup non-negative and --connections at least 1";
+        return false;
+    }
+    return options.mix.validate(error);
+}
+
+bool readBodies(const std::string& path, std::vector<std::string>& bodies, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty()) bodies.push_back(line);
+    }
+    if (bodies.empty()) {
+        error = path + " holds no request bodies";
+        return false;
+    }
+    return true;
+}
+
+// What one connection saw; merged once all connections finish
+struct ConnectionStats {
+    HdrHistogram corrected{kLowestNanos, kHighestNanos, kSignificantDigits};    // from the scheduled time
+    HdrHistogram uncorrected{kLowestNanos, kHighestNanos, kSignificantDigits};  // from the actual send
+    std::map<int, uint64_t> statuses;
+    uint64_t failures = 0;
+    uint64_t sent = 0;
+    std::vector<uint64_t> abandoned;   // requests taken from the schedule after it ended
+    std::string first_error;
+};
+
+uint64_t nanosBetween(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count()));
+}
+
+Json::Value histogramJson(const HdrHistogram& histogram) {
+    Json::Value json;
+    json["count"] = Json::UInt64(histogram.count());
+    json["mean_us"] = histogram.mean() * 1e-3;
+    json["max_us"] = histogram.max() * 1e-3;
+    for (double p : kPercentiles) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "p%g_us", p);
+        json[name] = histogram.valueAtPercentile(p) * 1e-3;
+    }
+    return json;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parseOptions(argc, argv, options, error)) {
+        if (!error.empty()) std::fprintf(stderr, "%s\n", error.c_str());
+        usage();
+        return 2;
+    }
+
+    std::string host;
+    uint16_t port;
+    if (!parseTarget(options.target, host, port, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::vector<std::string> bodies;
+    if (!options.bodies_file.empty()) {
+        if (!readBodies(options.bodies_file, bodies, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    } else {
+        bodies = options.mix.bodies(kGeneratedBodies, options.seed);
+    }
+
+    const double interval_ns = 1e9 / options.rate;
+    const uint64_t warmup_requests = static_cast<uint64_t>(options.warmup * options.rate);
+    const uint64_t total_requests = warmup_requests + static_cast<uint64_t>(options.duration * options.rate);
+    if (!options.json) {
+        std::printf("Offering %.1f req/s for %.1f s (+%.1f s warmup) over %zu connections to %s%s\n",
+                    options.rate, options.duration, options.warmup, options.connections,
+                    options.target.c_str(), options.path.c_str());
+    }
+
+    std::vector<ConnectionStats> stats(options.connections);
+    std::atomic<uint64_t> next{0};
+    const Clock::time_point started = Clock::now() + std::chrono::milliseconds(10);
+    auto scheduledAt = [&](uint64_t i) {
+        return started + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(i) * interval_ns));
+    };
+    const Clock::time_point deadline =
+        started + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(total_requests) * interval_ns));
+    std::vector<std::thread> workers;
+    for (size_t c = 0; c < options.connections; ++c) {
+        workers.emplace_back([&, c]() {
+            ConnectionStats& mine = stats[c];
+            HttpConnection connection(host, port);
+            std::string response, request_error;
+            // Each connection takes the next scheduled request once it is free, so a backlog
+            // shows up as latency from the scheduled time. Whatever is still queued when the
+            // schedule ends is left unsent rather than drained at whatever rate the service
+            // manages, and recorded below.
+            for (uint64_t i = next.fetch_add(1); i < total_requests; i = next.fetch_add(1)) {
+                const Clock::time_point scheduled = scheduledAt(i);
+                if (Clock::now() > deadline) {
+                    mine.abandoned.push_back(i);
+                    break;
+                }
+                std::this_thread::sleep_until(scheduled);
+                const Clock::time_point sent = Clock::now();
+                int status = 0;
+                const bool ok = connection.post(options.path, bodies[i % bodies.size()], status, response, request_error);
+                const Clock::time_point done = Clock::now();
+                if (i < warmup_requests) continue;
+
+                ++mine.sent;
+                if (!ok) {
+                    ++mine.failures;
+                    if (mine.first_error.empty()) mine.first_error = request_error;
+                    continue;
+                }
+                ++mine.statuses[status];
+                mine.corrected.record(nanosBetween(scheduled, done));
+                mine.uncorrected.record(nanosBetween(sent, done));
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    const Clock::time_point finished = Clock::now();
+
+    ConnectionStats total;
+    for (const auto& s : stats) {
+        total.corrected.add(s.corrected);
+        total.uncorrected.add(s.uncorrected);
+        for (const auto& entry : s.statuses) total.statuses[entry.first] += entry.second;
+        total.failures += s.failures;
+        total.sent += s.sent;
+        total.abandoned.insert(total.abandoned.end(), s.abandoned.begin(), s.abandoned.end());
+        if (total.first_error.empty()) total.first_error = s.first_error;
+    }
+    const uint64_t completed = total.corrected.count();
+
+    // Unsent requests are the ones connections took after the deadline plus those nobody took
+    for (uint64_t i = std::min<uint64_t>(next.load(), total_requests); i < total_requests; ++i) {
+        total.abandoned.push_back(i);
+    }
+    uint64_t unsent = 0;
+    for (uint64_t i : total.abandoned) {
+        if (i < warmup_requests) continue;
+        total.corrected.record(nanosBetween(scheduledAt(i), finished));
+        ++unsent;
+    }
+
+    // The recorded window runs from the first recorded request's scheduled time to the end
+    const double recorded_seconds =
+        std::chrono::duration<double>(finished - started).count() - static_cast<double>(warmup_requests) / options.rate;
+    const double achieved = recorded_seconds > 0 ? static_cast<double>(completed) / recorded_seconds : 0.0;
+    // Open-loop load that the service keeps up with completes at the offered rate
+    const bool saturated = unsent > 0 || achieved < 0.99 * options.rate;
+
+    if (options.json) {
+        Json::Value json;
+        json["target"] = options.target + options.path;
+        json["offered_rate"] = options.rate;
+        json["achieved_rate"] = achieved;
+        json["saturated"] = saturated;
+        json["connections"] = Json::UInt64(options.connections);
+        json["duration_s"] = options.duration;
+        json["sent"] = Json::UInt64(total.sent);
+        json["failed"] = Json::UInt64(total.failures);
+        json["unsent"] = Json::UInt64(unsent);
+        for (const auto& entry : total.statuses) {
+            json["statuses"][std::to_string(entry.first)] = Json::UInt64(entry.second);
+        }
+        json["latency"] = histogramJson(total.corrected);
+        json["service_time"] = histogramJson(total.uncorrected);
+        std::printf("%s", json.toStyledString().c_str());
+    } else {
+        std::printf("sent            %llu\n", static_cast<unsigned long long>(total.sent));
+        std::printf("failed          %llu\n", static_cast<unsigned long long>(total.failures));
+        std::printf("unsent          %llu\n", static_cast<unsigned long long>(unsent));
+        for (const auto& entry : total.statuses) {
+            std::printf("status %-8d %llu\n", entry.first, static_cast<unsigned long long>(entry.second));
+        }
+        std::printf("throughput      %.1f req/s of %.1f offered%s\n", achieved, options.rate,
+                    saturated ? " (saturated: the service did not keep up)" : "");
+        std::printf("%-15s %14s %14s\n", "", "latency", "service time");
+        for (double p : kPercentiles) {
+            std::printf("p%-14g %11.1f us %11.1f us\n", p, total.corrected.valueAtPercentile(p) * 1e-3,
+                        total.uncorrected.valueAtPercentile(p) * 1e-3);
+        }
+        std::printf("%-15s %11.1f us %11.1f us\n", "max", total.corrected.max() * 1e-3, total.uncorrected.max() * 1e-3);
+        std::printf("%-15s %11.1f us %11.1f us\n", "mean", total.corrected.mean() * 1e-3, total.uncorrected.mean() * 1e-3);
+    }
+    if (!total.first_error.empty()) std::fprintf(stderr, "first error: %s\n", total.first_error.c_str());
+    return total.failures == 0 ? 0 : 1;
+}
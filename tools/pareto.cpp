@@ -0,0 +1,301 @@
+// Accuracy-versus-speed sweep of every random expiration engine, per parameter regime.
+//
+//   black_scholes_pareto [--output-dir DIR] [--samples N] [--repetitions N] [--seed N]
+//                        [--regimes a,b,...] [--orders 8,16,32,...] [--tolerances 1e-4,1e-8,...]
+//
+// Each regime is a seeded sample of contracts (S = 100; strike, volatility, rate, holding
+// period and its dispersion drawn from the regime's ranges). Every candidate (the analytic
+// shortcut, Gauss-Laguerre at each order and QAGIU at each tolerance) prices the sample for
+// calls and binary calls and is compared with a reference price. The error of a price is taken
+// relative to the reference, floored at 1 as in the startup autotuner and the routing tuner.
+// Time per option is the best of the timed passes. Gauss-Laguerre times include node
+// table rebuilds wherever the regime varies the gamma shape, since the service pays them too.
+//
+// The reference is referenceRandomExpirationPrice (ReferencePricer.h). Unlike QAGIU at a tight
+// tolerance, which the routing tuner uses, it does not lose the spike of a very narrow density.
+//
+// A candidate is on the Pareto frontier when no other candidate is at least as fast and at
+// least as accurate (by max error) while being strictly better at one of them. The frontier of
+// every regime is printed; with --output-dir, each regime and product also gets a CSV of all
+// candidates, <product>_<regime>.csv, with columns for failed (non-finite) prices and frontier
+// membership.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ReferencePricer.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/TuningConfig.h"
+
+namespace {
+
+using BlackScholesUtil::PricingEngine;
+using Clock = std::chrono::steady_clock;
+
+struct Range {
+    double lo, hi;
+};
+
+// Contracts of one regime; cv is sigmaH / H and moneyness K / S. With a fixed cv every
+// contract shares the gamma shape, so Gauss-Laguerre keeps one warm node table.
+struct Regime {
+    const char* name;
+    Range moneyness, volatility, rate, holding, cv;
+};
+
+const Regime kRegimes[] = {
+    {"fixed_cv",     {0.8, 1.2}, {0.15, 0.4}, {0.0, 0.05}, {0.5, 5.0},   {0.5, 0.5}},
+    {"low_cv",       {0.8, 1.2}, {0.15, 0.4}, {0.0, 0.05}, {0.5, 5.0},   {0.005, 0.05}},
+    {"moderate_cv",  {0.8, 1.2}, {0.15, 0.4}, {0.0, 0.05}, {0.5, 5.0},   {0.05, 0.5}},
+    {"high_cv",      {0.8, 1.2}, {0.15, 0.4}, {0.0, 0.05}, {0.5, 5.0},   {0.5, 1.5}},
+    {"extreme_cv",   {0.8, 1.2}, {0.15, 0.4}, {0.0, 0.05}, {0.5, 5.0},   {1.5, 4.0}},
+    {"deep_otm",     {1.5, 5.0}, {0.1, 0.6},  {0.0, 0.05}, {0.5, 5.0},   {0.1, 1.0}},
+    {"long_holding", {0.8, 1.2}, {0.15, 0.4}, {0.0, 0.08}, {10.0, 50.0}, {0.1, 1.0}},
+};
+
+const double kStockPrice = 100.0;
+
+struct Options {
+    std::string output_dir;
+    int samples = 32;
+    int repetitions = 3;
+    uint64_t seed = 1;
+    std::vector<std::string> regimes;     // empty runs them all
+    std::vector<int> orders = {4, 8, 12, 16, 24, 32, 48, 64, 96, 128};
+    std::vector<double> tolerances = {1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10, 1e-11};
+};
+
+struct Sample {
+    double K, vol, r, H, sigmaH;
+};
+
+// One way of pricing; a new integrator only needs an entry in candidates()
+struct Candidate {
+    std::string engine;
+    std::string parameter;   // order, tolerance, or empty
+    std::function<double(bool binary, const Sample&)> price;
+};
+
+struct Result {
+    const Candidate* candidate;
+    double max_error;
+    double mean_error;
+    double ns_per_option;
+    int failed;   // prices that came out NaN or infinite; any makes max_error infinite
+    bool pareto;
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: black_scholes_pareto [--output-dir DIR] [--samples N] [--repetitions N] [--seed N]\n"
+        "                            [--regimes a,b,...] [--orders 8,16,...] [--tolerances 1e-4,1e-8,...]\n");
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--output-dir") {
+            options.output_dir = value;
+        } else if (arg == "--samples") {
+            options.samples = std::atoi(value.c_str());
+            if (options.samples < 1) return false;
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::atoi(value.c_str());
+            if (options.repetitions < 1) return false;
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--regimes") {
+            options.regimes = splitList(value);
+            for (const auto& name : options.regimes) {
+                if (std::none_of(std::begin(kRegimes), std::end(kRegimes),
+                                 [&](const Regime& r) { return name == r.name; })) {
+                    return false;
+                }
+            }
+        } else if (arg == "--orders") {
+            options.orders.clear();
+            for (const auto& item : splitList(value)) {
+                const int order = std::atoi(item.c_str());
+                if (order < 2 || order > TuningConfig::kMaxGLOrder) return false;
+                options.orders.push_back(order);
+            }
+        } else if (arg == "--tolerances") {
+            options.tolerances.clear();
+            for (const auto& item : splitList(value)) {
+                const double tolerance = std::atof(item.c_str());
+                if (!(tolerance > 0)) return false;
+                options.tolerances.push_back(tolerance);
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Candidate> candidates(const Options& options) {
+    std::vector<Candidate> all;
+    all.push_back({"analytic_shortcut", "", [](bool binary, const Sample& s) {
+        return BlackScholesUtil::priceRandomExpirationWithEngine(PricingEngine::ANALYTIC_SHORTCUT, binary, kStockPrice,
+                                                                 s.K, s.vol, s.r, s.H, s.sigmaH);
+    }});
+    for (int order : options.orders) {
+        all.push_back({"gauss_laguerre", std::to_string(order), [order](bool binary, const Sample& s) {
+            return BlackScholesUtil::priceRandomExpirationWithEngine(PricingEngine::GAUSS_LAGUERRE, binary, kStockPrice,
+                                                                     s.K, s.vol, s.r, s.H, s.sigmaH, order);
+        }});
+    }
+    for (double tolerance : options.tolerances) {
+        char label[32];
+        std::snprintf(label, sizeof(label), "%g", tolerance);
+        all.push_back({"gsl_qagiu", label, [tolerance](bool binary, const Sample& s) {
+            return BlackScholesUtil::priceRandomExpirationWithEngine(PricingEngine::GSL_QAGIU, binary, kStockPrice,
+                                                                     s.K, s.vol, s.r, s.H, s.sigmaH, 0, tolerance);
+        }});
+    }
+    return all;
+}
+
+double draw(std::mt19937_64& rng, Range range) {
+    if (range.lo == range.hi) return range.lo;
+    return std::uniform_real_distribution<double>(range.lo, range.hi)(rng);
+}
+
+std::vector<Sample> regimeSamples(const Regime& regime, int count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Sample> samples;
+    for (int i = 0; i < count; ++i) {
+        Sample s;
+        s.K = kStockPrice * draw(rng, regime.moneyness);
+        s.vol = draw(rng, regime.volatility);
+        s.r = draw(rng, regime.rate);
+        s.H = draw(rng, regime.holding);
+        s.sigmaH = s.H * draw(rng, regime.cv);
+        samples.push_back(s);
+    }
+    return samples;
+}
+
+double referencePrice(bool binary, const Sample& s) {
+    return referenceRandomExpirationPrice(binary, kStockPrice, s.K, s.vol, s.r, s.H, s.sigmaH);
+}
+
+double scaledError(double value, double reference) {
+    if (!std::isfinite(value)) return std::numeric_limits<double>::infinity();
+    return std::abs(value - reference) / std::max(1.0, std::abs(reference));
+}
+
+Result evaluate(const Candidate& candidate, bool binary, const std::vector<Sample>& samples,
+                const std::vector<double>& reference, int repetitions) {
+    Result result{&candidate, 0.0, 0.0, std::numeric_limits<double>::infinity(), 0, false};
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const double price = candidate.price(binary, samples[i]);
+        if (!std::isfinite(price)) ++result.failed;
+        const double error = scaledError(price, reference[i]);
+        result.max_error = std::max(result.max_error, error);
+        result.mean_error += error / static_cast<double>(samples.size());
+    }
+    volatile double sink = 0.0;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        const auto started = Clock::now();
+        for (const auto& sample : samples) sink = sink + candidate.price(binary, sample);
+        const double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count());
+        result.ns_per_option = std::min(result.ns_per_option, ns / static_cast<double>(samples.size()));
+    }
+    return result;
+}
+
+void markFrontier(std::vector<Result>& results) {
+    for (auto& a : results) {
+        a.pareto = std::none_of(results.begin(), results.end(), [&](const Result& b) {
+            const bool no_worse = b.ns_per_option <= a.ns_per_option && b.max_error <= a.max_error;
+            const bool better = b.ns_per_option < a.ns_per_option || b.max_error < a.max_error;
+            return &b != &a && no_worse && better;
+        });
+    }
+}
+
+bool writeCsv(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "engine,parameter,max_error,mean_error,ns_per_option,failed,pareto\n";
+    out.precision(6);
+    for (const auto& r : results) {
+        out << r.candidate->engine << ',' << r.candidate->parameter << ',' << r.max_error << ','
+            << r.mean_error << ',' << r.ns_per_option << ',' << r.failed << ',' << (r.pareto ? 1 : 0) << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    const std::vector<Candidate> all = candidates(options);
+    for (const auto& regime : kRegimes) {
+        if (!options.regimes.empty() &&
+            std::find(options.regimes.begin(), options.regimes.end(), regime.name) == options.regimes.end()) {
+            continue;
+        }
+        const std::vector<Sample> samples = regimeSamples(regime, options.samples, options.seed);
+        for (bool binary : {false, true}) {
+            const char* product = binary ? "binary" : "call";
+            std::vector<double> reference;
+            for (const auto& s : samples) reference.push_back(referencePrice(binary, s));
+
+            std::vector<Result> results;
+            for (const auto& candidate : all) {
+                results.push_back(evaluate(candidate, binary, samples, reference, options.repetitions));
+            }
+            markFrontier(results);
+
+            std::vector<Result> frontier;
+            std::copy_if(results.begin(), results.end(), std::back_inserter(frontier),
+                         [](const Result& r) { return r.pareto; });
+            std::sort(frontier.begin(), frontier.end(),
+                      [](const Result& a, const Result& b) { return a.ns_per_option < b.ns_per_option; });
+            std::printf("%s / %s: %zu of %zu candidates on the frontier\n", regime.name, product, frontier.size(),
+                        results.size());
+            std::printf("  %-20s %-10s %12s %12s %14s\n", "engine", "parameter", "max error", "mean error", "ns/option");
+            for (const auto& r : frontier) {
+                std::printf("  %-20s %-10s %12.3g %12.3g %14.1f\n", r.candidate->engine.c_str(),
+                            r.candidate->parameter.c_str(), r.max_error, r.mean_error, r.ns_per_option);
+            }
+
+            if (!options.output_dir.empty()) {
+                const std::string path = options.output_dir + "/" + product + "_" + regime.name + ".csv";
+                if (!writeCsv(path, results)) {
+                    std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
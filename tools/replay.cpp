@@ -0,0 +1,209 @@
+// Replays a traffic capture (see utils/TrafficCapture.h) or a slow request log (see
+// utils/SlowRequestLog.h) against a running service.
+//
+//   black_scholes_replay --capture FILE [--target host:port] [--speed N|max] [--connections N]
+//   black_scholes_replay --slow-log FILE [--target host:port] [--connections N]
+//
+// Requests are issued at their captured arrival offsets divided by the speed factor, over as
+// many keep-alive connections as the capture had requests in flight at its peak. Latency is
+// measured from each request's scheduled time, so a backlog on the client side counts against
+// the service instead of hiding it.
+//
+// A slow request log has no arrival times, so its requests are sent back to back, over one
+// connection unless --connections says otherwise, and latency runs from each send.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include "HttpConnection.h"
+#include "utils/SlowRequestLog.h"
+#include "utils/TrafficCapture.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string capture;
+    std::string slow_log;
+    std::string target = "127.0.0.1:8080";
+    std::string path = "/api/calculate";
+    double speed = 1.0;      // 0 replays as fast as the connections allow
+    size_t connections = 0;  // 0 takes the capture's peak concurrency
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: black_scholes_replay --capture FILE [--target host:port] [--speed N|max]\n"
+        "                            [--connections N] [--path /api/calculate]\n"
+        "       black_scholes_replay --slow-log FILE [--target host:port] [--connections N]\n"
+        "                            [--path /api/calculate]\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--capture") {
+            options.capture = value;
+        } else if (arg == "--slow-log") {
+            options.slow_log = value;
+        } else if (arg == "--target") {
+            options.target = value;
+        } else if (arg == "--path") {
+            options.path = value;
+        } else if (arg == "--speed") {
+            options.speed = value == "max" ? 0.0 : std::atof(value.c_str());
+            if (options.speed < 0.0 || (options.speed == 0.0 && value != "max")) return false;
+        } else if (arg == "--connections") {
+            options.connections = std::strtoull(value.c_str(), nullptr, 10);
+            if (options.connections == 0) return false;
+        } else {
+            return false;
+        }
+    }
+    return options.capture.empty() != options.slow_log.empty();
+}
+
+// The request bodies of a slow request log, as requests with no arrival time or expected status
+bool readSlowLog(const std::string& path, std::vector<CapturedRequest>& requests, std::string& error) {
+    std::vector<Json::Value> bodies;
+    if (!SlowRequestLog::readRequests(path, bodies, error)) return false;
+    Json::FastWriter writer;
+    writer.omitEndingLineFeed();
+    requests.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) requests[i].body = writer.write(bodies[i]);
+    return true;
+}
+
+// Most requests the capture had in flight at once
+size_t peakConcurrency(const std::vector<CapturedRequest>& requests) {
+    std::vector<std::pair<uint64_t, int>> events;
+    events.reserve(requests.size() * 2);
+    for (const auto& request : requests) {
+        events.emplace_back(request.offset_ns, 1);
+        events.emplace_back(request.offset_ns + request.duration_ns, -1);
+    }
+    // Ends sort before starts at the same instant
+    std::sort(events.begin(), events.end());
+    int64_t current = 0, peak = 1;
+    for (const auto& event : events) {
+        current += event.second;
+        peak = std::max(peak, current);
+    }
+    return static_cast<size_t>(peak);
+}
+
+double percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return static_cast<double>(sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)]);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    std::string error;
+    std::string host;
+    uint16_t port;
+    std::vector<CapturedRequest> requests;
+    const bool slow_log = !options.slow_log.empty();
+    if (!parseTarget(options.target, host, port, error) ||
+        !(slow_log ? readSlowLog(options.slow_log, requests, error)
+                   : TrafficCapture::readFile(options.capture, requests, error))) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (requests.empty()) {
+        std::fprintf(stderr, "%s holds no requests\n", slow_log ? options.slow_log.c_str() : options.capture.c_str());
+        return 1;
+    }
+    if (slow_log) options.speed = 0.0;
+
+    const size_t connections = options.connections ? options.connections
+                               : slow_log ? 1 : peakConcurrency(requests);
+    if (options.speed > 0.0) {
+        std::printf("Replaying %zu requests over %zu connections at %gx\n", requests.size(), connections, options.speed);
+    } else {
+        std::printf("Replaying %zu requests over %zu connections at maximum speed\n", requests.size(), connections);
+    }
+
+    std::vector<uint64_t> latencies(requests.size(), 0);
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> mismatches{0};
+    std::mutex error_mutex;
+    std::string first_error;
+
+    const Clock::time_point started = Clock::now();
+    std::vector<std::thread> workers;
+    for (size_t c = 0; c < connections; ++c) {
+        workers.emplace_back([&]() {
+            HttpConnection connection(host, port);
+            std::string response, request_error;
+            for (size_t i = next.fetch_add(1); i < requests.size(); i = next.fetch_add(1)) {
+                const CapturedRequest& request = requests[i];
+                Clock::time_point scheduled = Clock::now();
+                if (options.speed > 0.0) {
+                    scheduled = started + std::chrono::nanoseconds(
+                        static_cast<int64_t>(static_cast<double>(request.offset_ns) / options.speed));
+                    std::this_thread::sleep_until(scheduled);
+                }
+                int status = 0;
+                if (!connection.post(options.path, request.body, status, response, request_error)) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (first_error.empty()) first_error = request_error;
+                    continue;
+                }
+                latencies[i] = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - scheduled).count());
+                if (request.status != 0 && status != request.status) mismatches.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    std::vector<uint64_t> sorted;
+    sorted.reserve(latencies.size());
+    for (uint64_t latency : latencies) {
+        if (latency > 0) sorted.push_back(latency);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    const CapturedRequest& last = requests.back();
+    const double captured_seconds = static_cast<double>(last.offset_ns + last.duration_ns) * 1e-9;
+    std::printf("completed       %zu\n", sorted.size());
+    std::printf("failed          %llu\n", static_cast<unsigned long long>(failures.load()));
+    std::printf("status changed  %llu\n", static_cast<unsigned long long>(mismatches.load()));
+    if (slow_log) {
+        std::printf("elapsed         %.3f s\n", elapsed);
+    } else {
+        std::printf("elapsed         %.3f s (captured %.3f s)\n", elapsed, captured_seconds);
+    }
+    std::printf("throughput      %.1f req/s\n", static_cast<double>(sorted.size()) / elapsed);
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        std::printf("p%-14g %.1f us\n", p, percentile(sorted, p) * 1e-3);
+    }
+    std::printf("max             %.1f us\n", sorted.empty() ? 0.0 : static_cast<double>(sorted.back()) * 1e-3);
+    if (!first_error.empty()) std::fprintf(stderr, "first error: %s\n", first_error.c_str());
+    return failures.load() == 0 ? 0 : 1;
+}
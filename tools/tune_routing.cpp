@@ -0,0 +1,300 @@
+// Measures every random expiration engine across the (cv, total volatility, log-moneyness)
+// space and writes the cheapest routing table that meets a target error (see
+// utils/RoutingTable.h).
+//
+//   black_scholes_tune_routing --output FILE [--target-error E] [--samples N]
+//                              [--repetitions N] [--orders 8,16,32,...]
+//
+// Within each cell the tool prices a grid of interior points at two holding periods and two
+// rates with the analytic shortcut, every candidate Gauss-Laguerre order and QAGIU, and
+// compares them with the quantile quadrature of ReferencePricer.h. QAGIU itself is no
+// reference: for sigmaH / H of a few percent it misses the density's peak. The error of a
+// price is taken relative to the reference, floored at 1 as in the startup autotuner. A cell
+// gets the fastest candidate whose worst error stays within the target; where none does, the
+// most accurate one. The output is a tuning file: load it through BSS_TUNING_FILE or POST it
+// to /admin/tuning.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include "ReferencePricer.h"
+#include "utils/BlackScholesUtil.h"
+#include "utils/RoutingTable.h"
+#include "utils/TuningConfig.h"
+
+namespace {
+
+using BlackScholesUtil::PricingEngine;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string output;
+    double target_error = 1e-6;
+    int samples = 2;          // interior points per axis per cell
+    int repetitions = 3;      // timed passes per candidate
+    std::vector<int> orders = {8, 12, 16, 24, 32, 48, 64, 96, 128};
+};
+
+// Bin boundaries and the outer extents sampled beyond the first and last boundary
+struct Axis {
+    const char* name;
+    std::vector<double> bounds;
+    double lo, hi;
+    bool logarithmic;
+
+    size_t bins() const { return bounds.size() + 1; }
+
+    double point(size_t bin, double fraction) const {
+        const double a = bin == 0 ? lo : bounds[bin - 1];
+        const double b = bin == bounds.size() ? hi : bounds[bin];
+        return logarithmic ? a * std::pow(b / a, fraction) : a + (b - a) * fraction;
+    }
+};
+
+const double kStockPrice = 100.0;
+const double kHoldingPeriods[] = {0.5, 5.0};
+const double kRates[] = {0.0, 0.08};
+
+struct Sample {
+    double K, vol, r, H, sigmaH;
+};
+
+struct Candidate {
+    PricingEngine engine;
+    int gl_order;
+};
+
+struct CellChoice {
+    Candidate candidate;
+    double max_error;
+    double ns_per_price;
+    bool meets_target;
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: black_scholes_tune_routing --output FILE [--target-error E] [--samples N]\n"
+        "                                  [--repetitions N] [--orders 8,16,32,...]\n");
+}
+
+bool parseOrders(const std::string& list, std::vector<int>& orders) {
+    orders.clear();
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const int order = std::atoi(item.c_str());
+        if (order < 2 || order > TuningConfig::kMaxGLOrder) return false;
+        orders.push_back(order);
+    }
+    return !orders.empty();
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--target-error") {
+            options.target_error = std::atof(value.c_str());
+            if (!(options.target_error > 0)) return false;
+        } else if (arg == "--samples") {
+            options.samples = std::atoi(value.c_str());
+            if (options.samples < 1) return false;
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::atoi(value.c_str());
+            if (options.repetitions < 1) return false;
+        } else if (arg == "--orders") {
+            if (!parseOrders(value, options.orders)) return false;
+        } else {
+            return false;
+        }
+    }
+    return !options.output.empty();
+}
+
+std::vector<Sample> cellSamples(const Axis axes[3], const size_t bins[3], int points) {
+    std::vector<Sample> samples;
+    for (int i = 0; i < points; ++i) {
+        for (int j = 0; j < points; ++j) {
+            for (int k = 0; k < points; ++k) {
+                const double cv = axes[0].point(bins[0], (i + 0.5) / points);
+                const double total_vol = axes[1].point(bins[1], (j + 0.5) / points);
+                const double moneyness = axes[2].point(bins[2], (k + 0.5) / points);
+                for (double H : kHoldingPeriods) {
+                    for (double r : kRates) {
+                        samples.push_back({kStockPrice * std::exp(-moneyness), total_vol / std::sqrt(H), r, H, cv * H});
+                    }
+                }
+            }
+        }
+    }
+    return samples;
+}
+
+double price(const Candidate& candidate, bool binary, const Sample& s) {
+    return BlackScholesUtil::priceRandomExpirationWithEngine(candidate.engine, binary, kStockPrice, s.K, s.vol, s.r,
+                                                             s.H, s.sigmaH, candidate.gl_order);
+}
+
+double scaledError(double value, double reference) {
+    return std::abs(value - reference) / std::max(1.0, std::abs(reference));
+}
+
+double elapsedNanos(Clock::time_point since) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count());
+}
+
+CellChoice chooseCell(const std::vector<Candidate>& candidates, bool binary, const std::vector<Sample>& samples,
+                      const std::vector<double>& reference, const Options& options) {
+    CellChoice best{candidates.front(), std::numeric_limits<double>::infinity(),
+                    std::numeric_limits<double>::infinity(), false};
+    volatile double sink = 0.0;
+    for (const auto& candidate : candidates) {
+        double max_error = 0.0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            max_error = std::max(max_error, scaledError(price(candidate, binary, samples[i]), reference[i]));
+        }
+        const auto started = Clock::now();
+        for (int rep = 0; rep < options.repetitions; ++rep) {
+            for (const auto& sample : samples) sink = sink + price(candidate, binary, sample);
+        }
+        const double ns = elapsedNanos(started) / (static_cast<double>(samples.size()) * options.repetitions);
+
+        const bool meets = max_error <= options.target_error;
+        const bool better = meets ? (!best.meets_target || ns < best.ns_per_price)
+                                  : (!best.meets_target && max_error < best.max_error);
+        if (better) best = {candidate, max_error, ns, meets};
+    }
+    return best;
+}
+
+Json::Value cellJson(const Candidate& candidate) {
+    Json::Value cell;
+    cell["engine"] = BlackScholesUtil::engineName(candidate.engine);
+    if (candidate.engine == PricingEngine::GAUSS_LAGUERRE) cell["gl_order"] = candidate.gl_order;
+    return cell;
+}
+
+std::string candidateLabel(const Candidate& candidate) {
+    std::string label = BlackScholesUtil::engineName(candidate.engine);
+    if (candidate.engine == PricingEngine::GAUSS_LAGUERRE) label += "/" + std::to_string(candidate.gl_order);
+    return label;
+}
+
+// Worst error and total cost of one way of routing over all swept samples
+struct Totals {
+    double max_error = 0.0;
+    double nanos = 0.0;
+    size_t prices = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    const Axis axes[3] = {
+        {"cv", {0.02, 0.05, 0.1, 0.2, 0.35, 0.5, 0.75, 1.0, 1.5, 2.5}, 0.005, 5.0, true},
+        {"total_volatility", {0.1, 0.2, 0.4, 0.8, 1.6}, 0.02, 3.2, true},
+        {"log_moneyness", {-0.5, -0.15, 0.15, 0.5}, -1.5, 1.5, false},
+    };
+
+    std::vector<Candidate> candidates = {{PricingEngine::ANALYTIC_SHORTCUT, 0}};
+    for (int order : options.orders) candidates.push_back({PricingEngine::GAUSS_LAGUERRE, order});
+    candidates.push_back({PricingEngine::GSL_QAGIU, 0});
+
+    Json::Value table;
+    table["version"] = RoutingTable::kVersion;
+    table["target_error"] = options.target_error;
+    for (const auto& axis : axes) {
+        Json::Value bounds(Json::arrayValue);
+        for (double bound : axis.bounds) bounds.append(bound);
+        table["axes"][axis.name] = bounds;
+    }
+
+    for (bool binary : {false, true}) {
+        const char* product = binary ? "binary" : "call";
+        Json::Value cells(Json::arrayValue);
+        std::map<std::string, size_t> chosen;
+        size_t missed = 0;
+        Totals heuristic, tuned;
+
+        size_t bins[3];
+        for (bins[0] = 0; bins[0] < axes[0].bins(); ++bins[0]) {
+            std::fprintf(stderr, "%s: cv bin %zu of %zu\n", product, bins[0] + 1, axes[0].bins());
+            for (bins[1] = 0; bins[1] < axes[1].bins(); ++bins[1]) {
+                for (bins[2] = 0; bins[2] < axes[2].bins(); ++bins[2]) {
+                    const std::vector<Sample> samples = cellSamples(axes, bins, options.samples);
+                    std::vector<double> reference;
+                    for (const auto& s : samples) {
+                        reference.push_back(
+                            referenceRandomExpirationPrice(binary, kStockPrice, s.K, s.vol, s.r, s.H, s.sigmaH));
+                    }
+
+                    const CellChoice choice = chooseCell(candidates, binary, samples, reference, options);
+                    cells.append(cellJson(choice.candidate));
+                    ++chosen[candidateLabel(choice.candidate)];
+                    if (!choice.meets_target) ++missed;
+                    tuned.max_error = std::max(tuned.max_error, choice.max_error);
+                    tuned.nanos += choice.ns_per_price * samples.size();
+                    tuned.prices += samples.size();
+
+                    // The service's routing without a table
+                    auto routed = [binary](const Sample& s) {
+                        return binary
+                            ? BlackScholesUtil::calculateRandomExpirationBinaryCall(kStockPrice, s.K, s.vol, s.r, s.H, s.sigmaH)
+                            : BlackScholesUtil::calculateRandomExpirationCall(kStockPrice, s.K, s.vol, s.r, s.H, s.sigmaH);
+                    };
+                    for (size_t i = 0; i < samples.size(); ++i) {
+                        heuristic.max_error = std::max(heuristic.max_error, scaledError(routed(samples[i]), reference[i]));
+                    }
+                    volatile double sink = 0.0;
+                    const auto started = Clock::now();
+                    for (int rep = 0; rep < options.repetitions; ++rep) {
+                        for (const auto& sample : samples) sink = sink + routed(sample);
+                    }
+                    heuristic.nanos += elapsedNanos(started) / options.repetitions;
+                    heuristic.prices += samples.size();
+                }
+            }
+        }
+        table[product] = cells;
+
+        std::printf("%s: %u cells, %zu miss the target\n", product, cells.size(), missed);
+        for (const auto& entry : chosen) std::printf("  %-20s %zu\n", entry.first.c_str(), entry.second);
+        std::printf("  thresholds: max error %.3g, %.0f ns per price\n",
+                    heuristic.max_error, heuristic.nanos / std::max<size_t>(heuristic.prices, 1));
+        std::printf("  table:      max error %.3g, %.0f ns per price\n",
+                    tuned.max_error, tuned.nanos / std::max<size_t>(tuned.prices, 1));
+    }
+
+    std::string error;
+    if (!RoutingTable::fromJson(table, error)) {
+        std::fprintf(stderr, "Generated an invalid routing table: %s\n", error.c_str());
+        return 1;
+    }
+    Json::Value tuning;
+    tuning["routing_table"] = table;
+    std::ofstream out(options.output);
+    out << tuning.toStyledString();
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", options.output.c_str());
+    return 0;
+}